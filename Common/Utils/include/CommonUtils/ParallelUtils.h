@@ -0,0 +1,92 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ParallelUtils.h
+/// \brief  Minimal task loop for running independent tasks on a few threads
+///
+
+#ifndef ALICEO2_PARALLELUTILS_H
+#define ALICEO2_PARALLELUTILS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace o2
+{
+namespace utils
+{
+
+/// Runs task(order[i]) for all i on up to nThreads threads, the calling thread being one of them.
+/// Tasks are picked up in the given order. After the first exception no new task is started and
+/// the exception is rethrown once all threads are done.
+template <typename F>
+void runParallel(int nThreads, const std::vector<size_t>& order, F&& task)
+{
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    try {
+      for (size_t i; (i = next++) < order.size();) {
+        task(order[i]);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next = order.size();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min<size_t>(std::max(nThreads, 1), order.size()); i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/// Runs task(i) for i in [0, nTasks) on up to nThreads threads, see above
+template <typename F>
+void runParallel(int nThreads, size_t nTasks, F&& task)
+{
+  std::vector<size_t> order(nTasks);
+  std::iota(order.begin(), order.end(), 0);
+  runParallel(nThreads, order, std::forward<F>(task));
+}
+
+/// Runs task(i) for each of the sizes.size() tasks on up to nThreads threads, the largest first
+/// to balance the load, see above
+template <typename F>
+void runParallelLargestFirst(int nThreads, const std::vector<size_t>& sizes, F&& task)
+{
+  std::vector<size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+  runParallel(nThreads, order, std::forward<F>(task));
+}
+
+} // namespace utils
+} // namespace o2
+
+#endif
@@ -0,0 +1,57 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ParallelUtils
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "CommonUtils/ParallelUtils.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace o2;
+
+BOOST_AUTO_TEST_CASE(ParallelUtils_runsEveryTaskOnce)
+{
+  for (int nThreads : {0, 1, 4, 100}) {
+    std::vector<std::atomic<int>> counts(37);
+    utils::runParallel(nThreads, counts.size(), [&counts](size_t i) { counts[i]++; });
+    for (const auto& count : counts) {
+      BOOST_CHECK_EQUAL(count.load(), 1);
+    }
+  }
+  int nCalls = 0;
+  utils::runParallel(4, size_t(0), [&nCalls](size_t) { nCalls++; });
+  BOOST_CHECK_EQUAL(nCalls, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelUtils_largestFirst)
+{
+  std::vector<size_t> sizes{3, 10, 1, 10, 7};
+  std::vector<size_t> order;
+  utils::runParallelLargestFirst(1, sizes, [&order](size_t i) { order.push_back(i); });
+  std::vector<size_t> expected{1, 3, 4, 0, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(ParallelUtils_rethrows)
+{
+  auto failing = [](size_t i) {
+    if (i == 10) {
+      throw std::runtime_error("task failed");
+    }
+  };
+  BOOST_CHECK_THROW(utils::runParallel(4, size_t(1000), failing), std::runtime_error);
+  // no new task is started after the first failure
+  int nCalls = 0;
+  BOOST_CHECK_THROW(utils::runParallel(1, size_t(1000), [&nCalls, &failing](size_t i) { nCalls++; failing(i); }), std::runtime_error);
+  BOOST_CHECK_EQUAL(nCalls, 11);
+}
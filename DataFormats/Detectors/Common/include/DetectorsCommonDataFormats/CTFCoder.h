@@ -0,0 +1,94 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFCoder.h
+/// @brief  Encoder and decoder of the CTF of a detector from its column decomposition
+
+#ifndef O2_CTF_CTFCODER_H
+#define O2_CTF_CTFCODER_H
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+/// @class CTFCoder
+/// @brief Moves the columns of a detector in and out of the CTF.
+///
+/// A detector describes its data as the column decomposition Traits:
+///   using Header = ...;                            // trivially copyable, e.g. counters and first orbit
+///   using Columns = std::tuple<std::vector<T>...>; // T: 8, 16 or 32 bit integers
+/// Its coder fills the columns from the data (with deltas, split bit fields, ...)
+/// and calls encode, and does the inverse after decode. One block is written per column.
+template <typename Traits>
+class CTFCoder
+{
+ public:
+  using Header = typename Traits::Header;
+  using Columns = typename Traits::Columns;
+  static constexpr size_t NColumns = std::tuple_size<Columns>::value;
+  static_assert(std::is_trivially_copyable<Header>::value, "the detector header must be trivially copyable");
+
+  /// encode the header and the columns, replacing the content of the output
+  static void encode(o2::detectors::DetID det, const Header& header, const Columns& columns, std::vector<char>& output, int nThreads = 1)
+  {
+    EncodedBlocks::encode(det, &header, sizeof(Header), getColumnRefs(const_cast<Columns&>(columns)), output, nThreads);
+  }
+
+  /// decode the CTF of the detector into the header and the columns.
+  /// Throws std::runtime_error if the CTF is not consistent or not of this detector.
+  static void decode(o2::detectors::DetID det, const char* data, size_t size, Header& header, Columns& columns, int nThreads = 1)
+  {
+    EncodedBlocks blocks(data, size);
+    if (blocks.getDetector() != det) {
+      throw std::runtime_error(std::string("CTF: data of ") + blocks.getDetector().getName() + " instead of " + det.getName());
+    }
+    if (blocks.getNBlocks() != NColumns || blocks.getDetectorHeaderSize() != sizeof(Header)) {
+      throw std::runtime_error(std::string("CTF: layout of the ") + det.getName() + " data does not match the decoder");
+    }
+    std::memcpy(&header, blocks.getDetectorHeader(), sizeof(Header));
+    resize(columns, blocks, std::make_index_sequence<NColumns>{});
+    blocks.decode(getColumnRefs(columns), nThreads);
+  }
+
+ private:
+  template <typename T>
+  static ColumnRef getColumnRef(std::vector<T>& column)
+  {
+    static_assert(std::is_integral<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4), "only 8, 16 and 32 bit integers are supported");
+    return ColumnRef{column.data(), column.size(), sizeof(T)};
+  }
+
+  static std::vector<ColumnRef> getColumnRefs(Columns& columns)
+  {
+    return std::apply([](auto&... column) { return std::vector<ColumnRef>{getColumnRef(column)...}; }, columns);
+  }
+
+  template <size_t... I>
+  static void resize(Columns& columns, const EncodedBlocks& blocks, std::index_sequence<I...>)
+  {
+    (std::get<I>(columns).resize(blocks.getMetadata(I).nElements), ...);
+  }
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif // O2_CTF_CTFCODER_H
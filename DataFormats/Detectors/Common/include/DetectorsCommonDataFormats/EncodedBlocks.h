@@ -0,0 +1,105 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   EncodedBlocks.h
+/// @brief  Container of the entropy coded blocks of a compressed time frame (CTF)
+
+#ifndef O2_CTF_ENCODEDBLOCKS_H
+#define O2_CTF_ENCODEDBLOCKS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DetectorsCommonDataFormats/DetID.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+/// Header of the CTF of one detector for one time frame.
+///
+/// Layout of the CTF: CTFHeader, the detector header padded to 8 bytes, one
+/// BlockMetadata per block, then the payloads of the blocks in the same order.
+/// The buffer is accessed with memcpy and does not need to be aligned.
+struct CTFHeader {
+  static constexpr uint32_t Magic = 0x00465443; // "CTF"
+
+  uint32_t magic = Magic;
+  uint16_t version = 1;
+  uint8_t detector = 0; // DetID
+  uint8_t reserved = 0;
+  uint32_t nBlocks = 0;
+  uint32_t detHeaderSize = 0; // bytes of the detector header, before padding
+  uint64_t size = 0;          // bytes of the CTF, including this header
+};
+
+/// how the payload of a block is stored
+enum class BlockCoding : uint8_t {
+  Raw = 0, // the elements as they are
+  RANS = 1 // a rANS block of o2::rans::BlockCoder
+};
+
+struct BlockMetadata {
+  uint64_t nElements = 0;
+  uint64_t payloadSize = 0; // bytes
+  uint8_t elementSize = 0;  // 1, 2 or 4 bytes
+  BlockCoding coding = BlockCoding::Raw;
+  uint16_t reserved = 0;
+  uint32_t reserved2 = 0;
+};
+
+/// reference to the array of a column, the blocks are decoded into it
+struct ColumnRef {
+  void* data = nullptr;
+  size_t nElements = 0;
+  size_t elementSize = 0;
+};
+
+/// @class EncodedBlocks
+/// @brief Read access to a CTF, and encoding of the columns of a detector into a CTF.
+///
+/// Every column of integers becomes one block, entropy coded with rANS unless
+/// the raw elements are smaller (e.g. tiny or random columns). The blocks are
+/// independent and are encoded and decoded in parallel by nThreads threads.
+class EncodedBlocks
+{
+ public:
+  /// encode the columns with the detector header into a CTF, replacing the content of the output
+  static void encode(o2::detectors::DetID det, const void* detHeader, size_t detHeaderSize,
+                     const std::vector<ColumnRef>& columns, std::vector<char>& output, int nThreads = 1);
+
+  /// view of the CTF in the buffer, which must outlive this object.
+  /// Throws std::runtime_error if the layout of the CTF is not consistent.
+  EncodedBlocks(const char* data, size_t size);
+
+  const CTFHeader& getHeader() const { return mHeader; }
+  o2::detectors::DetID getDetector() const { return o2::detectors::DetID(mHeader.detector); }
+  const char* getDetectorHeader() const { return mDetHeader; }
+  size_t getDetectorHeaderSize() const { return mHeader.detHeaderSize; }
+  size_t getNBlocks() const { return mMetadata.size(); }
+  const BlockMetadata& getMetadata(size_t i) const { return mMetadata[i]; }
+  /// size of the CTF in bytes
+  size_t size() const { return mHeader.size; }
+
+  /// decode the blocks into the columns, one per block, with the sizes given by the metadata
+  void decode(const std::vector<ColumnRef>& columns, int nThreads = 1) const;
+
+ private:
+  CTFHeader mHeader;
+  const char* mDetHeader = nullptr;
+  std::vector<BlockMetadata> mMetadata;
+  std::vector<const char*> mPayloads;
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif // O2_CTF_ENCODEDBLOCKS_H
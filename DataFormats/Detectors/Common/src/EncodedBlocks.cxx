@@ -0,0 +1,173 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   EncodedBlocks.cxx
+/// @brief  Container of the entropy coded blocks of a compressed time frame (CTF)
+
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "rANS/BlockCoder.h"
+#include "CommonUtils/ParallelUtils.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace o2::ctf;
+
+namespace
+{
+size_t padded(size_t size)
+{
+  return (size + 7) & ~size_t(7);
+}
+
+std::vector<size_t> getSizes(const std::vector<ColumnRef>& columns)
+{
+  std::vector<size_t> sizes;
+  for (const auto& column : columns) {
+    sizes.push_back(column.nElements * column.elementSize);
+  }
+  return sizes;
+}
+
+void checkColumn(const ColumnRef& column)
+{
+  if (column.elementSize != 1 && column.elementSize != 2 && column.elementSize != 4) {
+    throw std::runtime_error("CTF: unsupported element size " + std::to_string(column.elementSize));
+  }
+  if (column.nElements && !column.data) {
+    throw std::runtime_error("CTF: invalid nullptr to column of " + std::to_string(column.nElements) + " element(s)");
+  }
+}
+} // namespace
+
+void EncodedBlocks::encode(o2::detectors::DetID det, const void* detHeader, size_t detHeaderSize,
+                           const std::vector<ColumnRef>& columns, std::vector<char>& output, int nThreads)
+{
+  for (const auto& column : columns) {
+    checkColumn(column);
+  }
+  std::vector<BlockMetadata> metadata(columns.size());
+  std::vector<std::vector<char>> blocks(columns.size());
+  o2::utils::runParallelLargestFirst(nThreads, getSizes(columns), [&columns, &metadata, &blocks](size_t i) {
+    const auto& column = columns[i];
+    auto& md = metadata[i];
+    md.nElements = column.nElements;
+    md.elementSize = column.elementSize;
+    size_t rawSize = column.nElements * column.elementSize;
+    if (column.nElements) {
+      o2::rans::encode(column.data, column.nElements, column.elementSize, blocks[i]);
+    }
+    if (column.nElements && blocks[i].size() < rawSize) {
+      md.coding = BlockCoding::RANS;
+      md.payloadSize = blocks[i].size();
+    } else {
+      // not worth the entropy coding, the block refers to the column itself
+      blocks[i].clear();
+      md.coding = BlockCoding::Raw;
+      md.payloadSize = rawSize;
+    }
+  });
+
+  CTFHeader header;
+  header.detector = det.getID();
+  header.nBlocks = columns.size();
+  header.detHeaderSize = detHeaderSize;
+  header.size = sizeof(CTFHeader) + padded(detHeaderSize) + columns.size() * sizeof(BlockMetadata);
+  for (const auto& md : metadata) {
+    header.size += md.payloadSize;
+  }
+  output.assign(header.size, 0);
+  char* ptr = output.data();
+  std::memcpy(ptr, &header, sizeof(CTFHeader));
+  ptr += sizeof(CTFHeader);
+  if (detHeaderSize) {
+    std::memcpy(ptr, detHeader, detHeaderSize);
+  }
+  ptr += padded(detHeaderSize);
+  std::memcpy(ptr, metadata.data(), metadata.size() * sizeof(BlockMetadata));
+  ptr += metadata.size() * sizeof(BlockMetadata);
+  for (size_t i = 0; i < columns.size(); i++) {
+    if (metadata[i].payloadSize) {
+      std::memcpy(ptr, metadata[i].coding == BlockCoding::RANS ? blocks[i].data() : columns[i].data, metadata[i].payloadSize);
+    }
+    ptr += metadata[i].payloadSize;
+  }
+}
+
+EncodedBlocks::EncodedBlocks(const char* data, size_t size)
+{
+  if (size < sizeof(CTFHeader)) {
+    throw std::runtime_error("CTF: buffer of " + std::to_string(size) + " bytes is too small");
+  }
+  std::memcpy(&mHeader, data, sizeof(CTFHeader));
+  if (mHeader.magic != CTFHeader::Magic || mHeader.version != 1) {
+    throw std::runtime_error("CTF: unknown format");
+  }
+  if (mHeader.detector >= o2::detectors::DetID::nDetectors) {
+    throw std::runtime_error("CTF: unknown detector " + std::to_string(mHeader.detector));
+  }
+  if (mHeader.size != size) {
+    throw std::runtime_error("CTF: size " + std::to_string(mHeader.size) + " in the header, buffer of " + std::to_string(size) + " bytes");
+  }
+  size_t offset = sizeof(CTFHeader);
+  if (padded(mHeader.detHeaderSize) + uint64_t(mHeader.nBlocks) * sizeof(BlockMetadata) > size - offset) {
+    throw std::runtime_error("CTF: truncated header of " + std::to_string(mHeader.nBlocks) + " blocks");
+  }
+  mDetHeader = data + offset;
+  offset += padded(mHeader.detHeaderSize);
+  mMetadata.resize(mHeader.nBlocks);
+  std::memcpy(mMetadata.data(), data + offset, mMetadata.size() * sizeof(BlockMetadata));
+  offset += mMetadata.size() * sizeof(BlockMetadata);
+  for (size_t i = 0; i < mMetadata.size(); i++) {
+    const auto& md = mMetadata[i];
+    if ((md.elementSize != 1 && md.elementSize != 2 && md.elementSize != 4) ||
+        (md.coding != BlockCoding::Raw && md.coding != BlockCoding::RANS) ||
+        (md.coding == BlockCoding::Raw && (md.payloadSize % md.elementSize || md.nElements != md.payloadSize / md.elementSize)) ||
+        md.payloadSize > size - offset) {
+      throw std::runtime_error("CTF: invalid metadata of block " + std::to_string(i));
+    }
+    if (md.coding == BlockCoding::RANS) { // the columns are sized from the metadata, it must agree with the block itself
+      auto blockHeader = o2::rans::getHeader(data + offset, md.payloadSize);
+      if (blockHeader.blockSize != md.payloadSize || blockHeader.nElements != md.nElements || blockHeader.elementSize != md.elementSize) {
+        throw std::runtime_error("CTF: metadata of block " + std::to_string(i) + " does not match its rANS header");
+      }
+    }
+    mPayloads.push_back(data + offset);
+    offset += md.payloadSize;
+  }
+  if (offset != size) {
+    throw std::runtime_error("CTF: " + std::to_string(size - offset) + " trailing bytes");
+  }
+}
+
+void EncodedBlocks::decode(const std::vector<ColumnRef>& columns, int nThreads) const
+{
+  if (columns.size() != mMetadata.size()) {
+    throw std::runtime_error("CTF: " + std::to_string(columns.size()) + " columns for " + std::to_string(mMetadata.size()) + " blocks");
+  }
+  for (size_t i = 0; i < columns.size(); i++) {
+    checkColumn(columns[i]);
+    if (columns[i].nElements != mMetadata[i].nElements || columns[i].elementSize != mMetadata[i].elementSize) {
+      throw std::runtime_error("CTF: column " + std::to_string(i) + " does not match its block");
+    }
+  }
+  o2::utils::runParallelLargestFirst(nThreads, getSizes(columns), [this, &columns](size_t i) {
+    const auto& md = mMetadata[i];
+    if (md.coding == BlockCoding::RANS) {
+      auto blockSize = o2::rans::decode(mPayloads[i], md.payloadSize, columns[i].data, md.nElements, md.elementSize);
+      if (blockSize != md.payloadSize) {
+        throw std::runtime_error("CTF: block " + std::to_string(i) + " has " + std::to_string(md.payloadSize - blockSize) + " trailing bytes");
+      }
+    } else if (md.payloadSize) {
+      std::memcpy(columns[i].data, mPayloads[i], md.payloadSize);
+    }
+  });
+}
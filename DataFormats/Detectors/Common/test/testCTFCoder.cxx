@@ -0,0 +1,112 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFCoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include "DetectorsCommonDataFormats/CTFCoder.h"
+
+using namespace o2::ctf;
+using o2::detectors::DetID;
+
+namespace
+{
+struct TestTraits {
+  struct Header {
+    uint32_t nEntries = 0;
+    uint16_t firstBC = 0;
+  };
+  using Columns = std::tuple<std::vector<uint8_t>, std::vector<uint16_t>, std::vector<int32_t>, std::vector<uint32_t>>;
+};
+using TestCoder = CTFCoder<TestTraits>;
+
+TestTraits::Columns makeColumns(size_t n)
+{
+  std::mt19937 gen(n);
+  std::geometric_distribution<int> small(0.3);
+  TestTraits::Columns columns;
+  for (size_t i = 0; i < n; i++) {
+    std::get<0>(columns).push_back(small(gen));
+    std::get<1>(columns).push_back(1000 + small(gen));
+    std::get<2>(columns).push_back(int(small(gen)) - 5);
+    std::get<3>(columns).push_back(gen()); // random, not worth coding
+  }
+  return columns;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CTFCoder_roundtrip)
+{
+  for (size_t n : {0, 1, 7, 1000, 100000}) {
+    TestTraits::Header header;
+    header.nEntries = n;
+    header.firstBC = 3563;
+    auto columns = makeColumns(n);
+    for (int nThreads : {1, 3}) {
+      std::vector<char> ctf;
+      TestCoder::encode(DetID::ITS, header, columns, ctf, nThreads);
+
+      EncodedBlocks blocks(ctf.data(), ctf.size());
+      BOOST_CHECK(blocks.getDetector() == DetID::ITS);
+      BOOST_CHECK_EQUAL(blocks.getNBlocks(), TestCoder::NColumns);
+      BOOST_CHECK_EQUAL(blocks.size(), ctf.size());
+      if (n >= 1000) {
+        BOOST_CHECK(blocks.getMetadata(0).coding == BlockCoding::RANS);
+        BOOST_CHECK(blocks.getMetadata(3).coding == BlockCoding::Raw);
+      }
+
+      TestTraits::Header decodedHeader;
+      TestTraits::Columns decoded;
+      TestCoder::decode(DetID::ITS, ctf.data(), ctf.size(), decodedHeader, decoded, nThreads);
+      BOOST_CHECK_EQUAL(decodedHeader.nEntries, header.nEntries);
+      BOOST_CHECK_EQUAL(decodedHeader.firstBC, header.firstBC);
+      BOOST_CHECK(decoded == columns);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CTFCoder_errors)
+{
+  TestTraits::Header header;
+  auto columns = makeColumns(1000);
+  std::vector<char> ctf;
+  TestCoder::encode(DetID::TOF, header, columns, ctf);
+
+  TestTraits::Columns decoded;
+  BOOST_CHECK_THROW(TestCoder::decode(DetID::ITS, ctf.data(), ctf.size(), header, decoded), std::runtime_error);
+  BOOST_CHECK_THROW(TestCoder::decode(DetID::TOF, ctf.data(), ctf.size() - 1, header, decoded), std::runtime_error);
+  BOOST_CHECK_THROW(TestCoder::decode(DetID::TOF, ctf.data(), 10, header, decoded), std::runtime_error);
+  auto corrupted = ctf;
+  corrupted[0] ^= 1;
+  BOOST_CHECK_THROW(TestCoder::decode(DetID::TOF, corrupted.data(), corrupted.size(), header, decoded), std::runtime_error);
+  corrupted = ctf;
+  corrupted.push_back(0);
+  BOOST_CHECK_THROW(EncodedBlocks(corrupted.data(), corrupted.size()), std::runtime_error);
+
+  // a corrupted number of elements must not size the columns
+  const size_t metadataOffset = sizeof(CTFHeader) + ((sizeof(TestTraits::Header) + 7) & ~size_t(7));
+  for (size_t iBlock : {0, 3}) { // a rANS and a raw block
+    for (uint64_t nElements : {uint64_t(1001), uint64_t(1) << 62, ~uint64_t(0)}) {
+      corrupted = ctf;
+      std::memcpy(corrupted.data() + metadataOffset + iBlock * sizeof(BlockMetadata) + offsetof(BlockMetadata, nElements), &nElements, sizeof(nElements));
+      BOOST_CHECK_THROW(TestCoder::decode(DetID::TOF, corrupted.data(), corrupted.size(), header, decoded), std::runtime_error);
+    }
+  }
+
+  // a CTF with a different decomposition
+  std::vector<char> other;
+  EncodedBlocks::encode(DetID::TOF, &header, sizeof(header), {ColumnRef{std::get<0>(columns).data(), 10, 1}}, other);
+  BOOST_CHECK_THROW(TestCoder::decode(DetID::TOF, other.data(), other.size(), header, decoded), std::runtime_error);
+}
@@ -16,6 +16,7 @@
 #define ALICEO2_DATAFORMATS_MCTRUTH_H_
 
 #include "GPUCommonRtypes.h" // to have the ClassDef macros
+#include <algorithm>
 #include <cstdint>           // uint8_t etc
 #include <cassert>
 #include <stdexcept>
@@ -120,15 +121,29 @@ class MCTruthContainer
   MCTruthContainer& operator=(MCTruthContainer&& other) = default;
 
   using self_type = MCTruthContainer<TruthElement>;
+  /// Describes the flat layout: the FlatHeader is followed by the header
+  /// elements and then by the truth elements. Since version 2, the truth
+  /// elements start at a multiple of truthAlignment from the beginning of
+  /// the buffer, so that they can be used in place.
   struct FlatHeader {
-    uint8_t version = 1;
+    uint8_t version = 2;
     uint8_t sizeofHeaderElement = sizeof(MCTruthHeaderElement);
     uint8_t sizeofTruthElement = sizeof(TruthElement);
-    uint8_t reserved = 0;
+    uint8_t truthAlignment = alignof(TruthElement); // reserved, i.e. 0, in version 1
     uint32_t nofHeaderElements;
     uint32_t nofTruthElements;
   };
 
+  /// @return the offset of the truth elements in a flat buffer
+  static size_t getFlatTruthOffset(FlatHeader const& flatheader)
+  {
+    size_t offset = sizeof(FlatHeader) + flatheader.sizeofHeaderElement * flatheader.nofHeaderElements;
+    if (flatheader.version >= 2 && flatheader.truthAlignment > 1) {
+      offset = ((offset + flatheader.truthAlignment - 1) / flatheader.truthAlignment) * flatheader.truthAlignment;
+    }
+    return offset;
+  }
+
   // access
   MCTruthHeaderElement const& getMCTruthHeader(uint dataindex) const { return mHeaderArray[dataindex]; }
   // access the element directly (can be encapsulated better away)... needs proper element index
@@ -146,7 +161,7 @@ class MCTruthContainer
     if (dataindex >= getIndexedSize()) {
       return gsl::span<TruthElement>();
     }
-    return gsl::span<TruthElement>(&mTruthArray[getMCTruthHeader(dataindex).index], getSize(dataindex));
+    return gsl::span<TruthElement>(mTruthArray.data() + getMCTruthHeader(dataindex).index, getSize(dataindex));
   }
 
   // get individual const "view" container for a given data index
@@ -156,7 +171,7 @@ class MCTruthContainer
     if (dataindex >= getIndexedSize()) {
       return gsl::span<const TruthElement>();
     }
-    return gsl::span<const TruthElement>(&mTruthArray[getMCTruthHeader(dataindex).index], getSize(dataindex));
+    return gsl::span<const TruthElement>(mTruthArray.data() + getMCTruthHeader(dataindex).index, getSize(dataindex));
   }
 
   void clear()
@@ -178,14 +193,8 @@ class MCTruthContainer
     } else {
       // assert(dataindex == mHeaderArray.size());
 
-      // add empty holes
-      int holes = dataindex - mHeaderArray.size();
-      assert(holes >= 0);
-      for (int i = 0; i < holes; ++i) {
-        mHeaderArray.emplace_back(mTruthArray.size());
-      }
-      // add a new one
-      mHeaderArray.emplace_back(mTruthArray.size());
+      // add empty holes and a new one in one go
+      mHeaderArray.resize(dataindex + 1, MCTruthHeaderElement(mTruthArray.size()));
     }
     mTruthArray.emplace_back(element);
   }
@@ -215,7 +224,8 @@ class MCTruthContainer
   // Add element at last position or for a previous index
   // (at random access position).
   // This might be a slow process since data has to be moved internally
-  // so this function should be used with care.
+  // so this function should be used with care. When many labels arrive out
+  // of order, collect them with a MCTruthContainerBuilder instead.
   void addElementRandomAccess(uint dataindex, TruthElement const& element)
   {
     if (dataindex >= mHeaderArray.size()) {
@@ -243,14 +253,8 @@ class MCTruthContainer
       auto lastindex = currentindex + getSize(dataindex);
       assert(currentindex >= 0);
 
-      // resize truth array
-      mTruthArray.resize(mTruthArray.size() + 1);
-      // move data (have to do from right to left)
-      for (int i = mTruthArray.size() - 1; i > lastindex; --i) {
-        mTruthArray[i] = mTruthArray[i - 1];
-      }
-      // insert new element
-      mTruthArray[lastindex] = element;
+      // insert new element, moving the data on the right in one block
+      mTruthArray.insert(mTruthArray.begin() + lastindex, element);
 
       // fix headers
       for (uint i = dataindex + 1; i < mHeaderArray.size(); ++i) {
@@ -274,8 +278,8 @@ class MCTruthContainer
     const auto oldheadersize = mHeaderArray.size();
 
     // copy from other
-    std::copy(other.mHeaderArray.begin(), other.mHeaderArray.end(), std::back_inserter(mHeaderArray));
-    std::copy(other.mTruthArray.begin(), other.mTruthArray.end(), std::back_inserter(mTruthArray));
+    mHeaderArray.insert(mHeaderArray.end(), other.mHeaderArray.begin(), other.mHeaderArray.end());
+    mTruthArray.insert(mTruthArray.end(), other.mTruthArray.begin(), other.mTruthArray.end());
 
     // adjust information of newly attached part
     for (uint i = oldheadersize; i < mHeaderArray.size(); ++i) {
@@ -287,25 +291,27 @@ class MCTruthContainer
   /// Copies the content of the two vectors of PODs to a contiguous container.
   /// The flattened data starts with a specific header @ref FlatHeader describing
   /// size and content of the two vectors within the raw buffer.
+  /// The container can be the message of a DPL output, e.g. the vector returned
+  /// by DataAllocator::make<std::vector<char>>, in which case the flat buffer
+  /// is produced in place and can be read on the receiver side with a
+  /// @ref MCTruthContainerView without copying.
   template <typename ContainerType>
   size_t flatten_to(ContainerType& container)
   {
-    size_t bufferSize = sizeof(FlatHeader) + sizeof(MCTruthHeaderElement) * mHeaderArray.size() + sizeof(TruthElement) * mTruthArray.size();
-    container.resize((bufferSize / sizeof(typename ContainerType::value_type)) + ((bufferSize % sizeof(typename ContainerType::value_type)) > 0 ? 1 : 0));
-    char* target = reinterpret_cast<char*>(container.data());
-    auto& flatheader = *reinterpret_cast<FlatHeader*>(target);
-    target += sizeof(FlatHeader);
-    flatheader.version = 1;
-    flatheader.sizeofHeaderElement = sizeof(MCTruthHeaderElement);
-    flatheader.sizeofTruthElement = sizeof(TruthElement);
-    flatheader.reserved = 0;
+    FlatHeader flatheader;
     flatheader.nofHeaderElements = mHeaderArray.size();
     flatheader.nofTruthElements = mTruthArray.size();
+    const auto truthOffset = getFlatTruthOffset(flatheader);
+    size_t bufferSize = truthOffset + sizeof(TruthElement) * mTruthArray.size();
+    container.resize((bufferSize / sizeof(typename ContainerType::value_type)) + ((bufferSize % sizeof(typename ContainerType::value_type)) > 0 ? 1 : 0));
+    char* target = reinterpret_cast<char*>(container.data());
+    memcpy(target, &flatheader, sizeof(FlatHeader));
     size_t copySize = flatheader.sizeofHeaderElement * flatheader.nofHeaderElements;
-    memcpy(target, mHeaderArray.data(), copySize);
-    target += copySize;
+    memcpy(target + sizeof(FlatHeader), mHeaderArray.data(), copySize);
+    // zero the padding so that the buffer content is reproducible
+    memset(target + sizeof(FlatHeader) + copySize, 0, truthOffset - sizeof(FlatHeader) - copySize);
     copySize = flatheader.sizeofTruthElement * flatheader.nofTruthElements;
-    memcpy(target, mTruthArray.data(), copySize);
+    memcpy(target + truthOffset, mTruthArray.data(), copySize);
     return bufferSize;
   }
 
@@ -317,10 +323,10 @@ class MCTruthContainer
     if (buffer == nullptr || bufferSize < sizeof(FlatHeader)) {
       return;
     }
-    auto* source = buffer;
-    auto& flatheader = *reinterpret_cast<FlatHeader const*>(source);
-    source += sizeof(FlatHeader);
-    if (bufferSize < sizeof(FlatHeader) + flatheader.sizeofHeaderElement * flatheader.nofHeaderElements + flatheader.sizeofTruthElement * flatheader.nofTruthElements) {
+    FlatHeader flatheader;
+    memcpy(&flatheader, buffer, sizeof(FlatHeader));
+    const auto truthOffset = getFlatTruthOffset(flatheader);
+    if (bufferSize < truthOffset + flatheader.sizeofTruthElement * flatheader.nofTruthElements) {
       throw std::runtime_error("inconsistent buffer size: too small");
       return;
     }
@@ -328,18 +334,13 @@ class MCTruthContainer
       // not yet handled
       throw std::runtime_error("member element sizes don't match");
     }
-    // TODO: with a spectator memory ressource the vectors can be built directly
-    // over the original buffer, there is the implementation for a memory ressource
-    // working on a FairMQ message, here we would need two memory resources over
-    // the two ranges of the input buffer
-    // for now doing a copy
+    // if only reading is needed, a MCTruthContainerView avoids this copy
     mHeaderArray.resize(flatheader.nofHeaderElements);
     mTruthArray.resize(flatheader.nofTruthElements);
     size_t copySize = flatheader.sizeofHeaderElement * flatheader.nofHeaderElements;
-    memcpy(mHeaderArray.data(), source, copySize);
-    source += copySize;
+    memcpy(mHeaderArray.data(), buffer + sizeof(FlatHeader), copySize);
     copySize = flatheader.sizeofTruthElement * flatheader.nofTruthElements;
-    memcpy(mTruthArray.data(), source, copySize);
+    memcpy(mTruthArray.data(), buffer + truthOffset, copySize);
   }
 
   /// Print some info
@@ -383,6 +384,183 @@ class MCTruthContainer
   ClassDefNV(MCTruthContainer, 2);
 }; // end class
 
+/// @class MCTruthContainerBuilder
+/// @brief Collects labels in any order and builds a MCTruthContainer in one pass
+///
+/// Labels are appended as (dataindex, label) pairs. finalize() sorts them by
+/// data index with a counting sort, keeping the insertion order of the labels
+/// of a given index, which is the same result as adding them one by one with
+/// MCTruthContainer::addElementRandomAccess, but in linear time.
+///
+/// A builder is not thread safe. Parallel producers should use one builder
+/// each and finalize them together, in the order in which they should be
+/// concatenated, e.g.
+/// <pre>
+///    std::vector<MCTruthContainerBuilder<MCCompLabel>> builders(nThreads);
+///    // ... each thread fills builders[thread] ...
+///    MCTruthContainerBuilder<MCCompLabel>::finalize(builders, container);
+/// </pre>
+template <typename TruthElement>
+class MCTruthContainerBuilder
+{
+ public:
+  using container_type = MCTruthContainer<TruthElement>;
+
+  void reserve(size_t nElements)
+  {
+    mIndices.reserve(nElements);
+    mElements.reserve(nElements);
+  }
+
+  void clear()
+  {
+    mIndices.clear();
+    mElements.clear();
+    mIndexedSize = 0;
+  }
+
+  // add element for a particular dataindex, in any order
+  void addElement(uint dataindex, TruthElement const& element)
+  {
+    mIndices.emplace_back(dataindex);
+    mElements.emplace_back(element);
+    mIndexedSize = std::max<size_t>(mIndexedSize, dataindex + 1);
+  }
+
+  template <typename CompatibleLabel>
+  void addElements(uint dataindex, gsl::span<CompatibleLabel> elements)
+  {
+    for (auto& e : elements) {
+      addElement(dataindex, e);
+    }
+  }
+
+  // append the content of another builder, e.g. the one of another thread
+  void append(MCTruthContainerBuilder const& other)
+  {
+    mIndices.insert(mIndices.end(), other.mIndices.begin(), other.mIndices.end());
+    mElements.insert(mElements.end(), other.mElements.begin(), other.mElements.end());
+    mIndexedSize = std::max(mIndexedSize, other.mIndexedSize);
+  }
+
+  // the number of data indices, i.e. the largest index added + 1
+  size_t getIndexedSize() const { return mIndexedSize; }
+  // the number of collected elements
+  size_t getNElements() const { return mElements.size(); }
+
+  /// Replace the content of @a target with the collected elements. The target
+  /// has at least @a indexedSize data indices, the missing ones being empty.
+  void finalize(container_type& target, size_t indexedSize = 0) const
+  {
+    finalize(gsl::span<const MCTruthContainerBuilder>(this, 1), target, indexedSize);
+  }
+
+  container_type finalize(size_t indexedSize = 0) const
+  {
+    container_type target;
+    finalize(target, indexedSize);
+    return target;
+  }
+
+  /// Build @a target from several builders as if their elements were added
+  /// to a single one, in order.
+  static void finalize(gsl::span<const MCTruthContainerBuilder> builders, container_type& target, size_t indexedSize = 0)
+  {
+    size_t nElements = 0;
+    for (auto& builder : builders) {
+      indexedSize = std::max(indexedSize, builder.mIndexedSize);
+      nElements += builder.mElements.size();
+    }
+    // counting sort: count the labels per index, the prefix sum gives the
+    // start of each index in the truth array
+    std::vector<MCTruthHeaderElement> header(indexedSize, MCTruthHeaderElement(0));
+    std::vector<uint> cursors(indexedSize + 1, 0);
+    for (auto& builder : builders) {
+      for (auto index : builder.mIndices) {
+        cursors[index + 1]++;
+      }
+    }
+    for (size_t i = 0; i < indexedSize; ++i) {
+      cursors[i + 1] += cursors[i];
+      header[i].index = cursors[i];
+    }
+    std::vector<TruthElement> truth(nElements);
+    for (auto& builder : builders) {
+      for (size_t i = 0; i < builder.mIndices.size(); ++i) {
+        truth[cursors[builder.mIndices[i]]++] = builder.mElements[i];
+      }
+    }
+    target.setFrom(header, truth);
+  }
+
+ private:
+  std::vector<uint> mIndices;
+  std::vector<TruthElement> mElements;
+  size_t mIndexedSize = 0;
+};
+
+/// @class MCTruthContainerView
+/// @brief Read only access to the flat representation of a MCTruthContainer
+///
+/// The view borrows the memory of the buffer, e.g. the payload of an incoming
+/// message, which must outlive it. The DPL InputRecord builds it directly
+/// over the message with get<MCTruthContainerView<T>>, when the container was
+/// sent with MCTruthContainer::flatten_to.
+template <typename TruthElement>
+class MCTruthContainerView
+{
+ public:
+  using FlatHeader = typename MCTruthContainer<TruthElement>::FlatHeader;
+  /// tells the framework that the type can be built over a flat buffer
+  using is_flat_view = std::true_type;
+
+  MCTruthContainerView() = default;
+  MCTruthContainerView(gsl::span<const char> buffer)
+  {
+    if (buffer.size() == 0) {
+      return;
+    }
+    if (buffer.size() < sizeof(FlatHeader)) {
+      throw std::runtime_error("MCTruthContainerView: buffer too small");
+    }
+    FlatHeader flatheader;
+    memcpy(&flatheader, buffer.data(), sizeof(FlatHeader));
+    if (flatheader.sizeofHeaderElement != sizeof(MCTruthHeaderElement) || flatheader.sizeofTruthElement != sizeof(TruthElement)) {
+      throw std::runtime_error("MCTruthContainerView: member element sizes don't match");
+    }
+    const auto truthOffset = MCTruthContainer<TruthElement>::getFlatTruthOffset(flatheader);
+    if (buffer.size() < truthOffset + sizeof(TruthElement) * flatheader.nofTruthElements) {
+      throw std::runtime_error("MCTruthContainerView: inconsistent buffer size: too small");
+    }
+    auto truthData = buffer.data() + truthOffset;
+    if (reinterpret_cast<uintptr_t>(truthData) % alignof(TruthElement) != 0) {
+      // e.g. version 1 buffers, which have no padding
+      throw std::runtime_error("MCTruthContainerView: truth elements are not aligned, use MCTruthContainer::restore_from");
+    }
+    mHeaders = gsl::span<const MCTruthHeaderElement>(reinterpret_cast<MCTruthHeaderElement const*>(buffer.data() + sizeof(FlatHeader)), flatheader.nofHeaderElements);
+    mTruths = gsl::span<const TruthElement>(reinterpret_cast<TruthElement const*>(truthData), flatheader.nofTruthElements);
+  }
+
+  MCTruthHeaderElement const& getMCTruthHeader(uint dataindex) const { return mHeaders[dataindex]; }
+  TruthElement const& getElement(uint elementindex) const { return mTruths[elementindex]; }
+  size_t getIndexedSize() const { return mHeaders.size(); }
+  size_t getNElements() const { return mTruths.size(); }
+
+  gsl::span<const TruthElement> getLabels(uint dataindex) const
+  {
+    if (dataindex >= getIndexedSize()) {
+      return gsl::span<const TruthElement>();
+    }
+    const auto start = mHeaders[dataindex].index;
+    const auto end = (dataindex < getIndexedSize() - 1) ? mHeaders[dataindex + 1].index : getNElements();
+    return mTruths.subspan(start, end - start);
+  }
+
+ private:
+  gsl::span<const MCTruthHeaderElement> mHeaders;
+  gsl::span<const TruthElement> mTruths;
+};
+
 } // namespace dataformats
 } // namespace o2
 
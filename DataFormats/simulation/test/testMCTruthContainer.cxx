@@ -173,6 +173,124 @@ BOOST_AUTO_TEST_CASE(MCTruthContainer_flatten)
   BOOST_CHECK(restoredContainer.getElement(3) == 10);
 }
 
+BOOST_AUTO_TEST_CASE(MCTruthContainer_view)
+{
+  using TruthElement = long;
+  using TruthContainer = dataformats::MCTruthContainer<TruthElement>;
+  TruthContainer container;
+  container.addElement(0, TruthElement(1));
+  container.addElement(0, TruthElement(2));
+  container.addElement(1, TruthElement(10));
+
+  // two header elements, the truth elements need to be padded
+  std::vector<char> buffer;
+  auto size = container.flatten_to(buffer);
+  auto& header = *reinterpret_cast<TruthContainer::FlatHeader*>(buffer.data());
+  BOOST_CHECK(header.version == 2);
+  BOOST_CHECK(TruthContainer::getFlatTruthOffset(header) % alignof(TruthElement) == 0);
+  BOOST_CHECK(size == TruthContainer::getFlatTruthOffset(header) + 3 * sizeof(TruthElement));
+
+  dataformats::MCTruthContainerView<TruthElement> view(gsl::span<const char>(buffer.data(), buffer.size()));
+  BOOST_CHECK(view.getIndexedSize() == 2);
+  BOOST_CHECK(view.getNElements() == 3);
+  BOOST_CHECK(view.getMCTruthHeader(1).index == 2);
+  auto labels = view.getLabels(0);
+  BOOST_REQUIRE(labels.size() == 2);
+  BOOST_CHECK(labels[0] == 1);
+  BOOST_CHECK(labels[1] == 2);
+  BOOST_CHECK(view.getLabels(1)[0] == 10);
+  BOOST_CHECK(view.getLabels(2).size() == 0);
+  // the view borrows the memory
+  BOOST_CHECK(reinterpret_cast<char const*>(labels.data()) == buffer.data() + TruthContainer::getFlatTruthOffset(header));
+
+  BOOST_CHECK_THROW((dataformats::MCTruthContainerView<TruthElement>(gsl::span<const char>(buffer.data(), size - 1))), std::runtime_error);
+
+  // version 1 buffers without padding can still be restored
+  std::vector<char> bufferV1(sizeof(TruthContainer::FlatHeader) + 2 * sizeof(dataformats::MCTruthHeaderElement) + 3 * sizeof(TruthElement));
+  TruthContainer::FlatHeader headerV1 = header;
+  headerV1.version = 1;
+  headerV1.truthAlignment = 0;
+  memcpy(bufferV1.data(), &headerV1, sizeof(headerV1));
+  memcpy(bufferV1.data() + sizeof(headerV1), buffer.data() + sizeof(header), 2 * sizeof(dataformats::MCTruthHeaderElement));
+  memcpy(bufferV1.data() + sizeof(headerV1) + 2 * sizeof(dataformats::MCTruthHeaderElement), buffer.data() + TruthContainer::getFlatTruthOffset(header), 3 * sizeof(TruthElement));
+  TruthContainer restoredContainer;
+  restoredContainer.restore_from(bufferV1.data(), bufferV1.size());
+  BOOST_CHECK(restoredContainer.getIndexedSize() == 2);
+  BOOST_CHECK(restoredContainer.getElement(2) == 10);
+  BOOST_CHECK(restoredContainer.getLabels(1)[0] == 10);
+}
+
+BOOST_AUTO_TEST_CASE(MCTruthContainer_builder)
+{
+  using TruthElement = long;
+  using TruthContainer = dataformats::MCTruthContainer<TruthElement>;
+  using Builder = dataformats::MCTruthContainerBuilder<TruthElement>;
+
+  // same sequence with random access insertion and with the builder
+  std::vector<std::pair<uint, TruthElement>> sequence{{0, 1}, {2, 20}, {0, 2}, {4, 40}, {2, 21}, {0, 3}, {4, 41}};
+  TruthContainer reference;
+  for (auto& [index, label] : sequence) {
+    if (index >= reference.getIndexedSize()) {
+      reference.addElement(index, label);
+    } else {
+      reference.addElementRandomAccess(index, label);
+    }
+  }
+
+  Builder builder;
+  for (auto& [index, label] : sequence) {
+    builder.addElement(index, label);
+  }
+  BOOST_CHECK(builder.getIndexedSize() == 5);
+  auto container = builder.finalize();
+  BOOST_REQUIRE(container.getIndexedSize() == reference.getIndexedSize());
+  BOOST_REQUIRE(container.getNElements() == reference.getNElements());
+  for (uint i = 0; i < container.getIndexedSize(); ++i) {
+    BOOST_CHECK(container.getMCTruthHeader(i).index == reference.getMCTruthHeader(i).index);
+  }
+  for (uint i = 0; i < container.getNElements(); ++i) {
+    BOOST_CHECK(container.getElement(i) == reference.getElement(i));
+  }
+  BOOST_CHECK(container.getLabels(1).size() == 0);
+  BOOST_CHECK(container.getLabels(3).size() == 0);
+
+  // split among several builders, e.g. one per thread
+  std::vector<Builder> builders(3);
+  for (size_t i = 0; i < sequence.size(); ++i) {
+    builders[i * builders.size() / sequence.size()].addElement(sequence[i].first, sequence[i].second);
+  }
+  TruthContainer merged;
+  Builder::finalize(builders, merged, 7);
+  BOOST_CHECK(merged.getIndexedSize() == 7);
+  BOOST_CHECK(merged.getLabels(6).size() == 0);
+  for (uint i = 0; i < reference.getNElements(); ++i) {
+    BOOST_CHECK(merged.getElement(i) == reference.getElement(i));
+  }
+  // the trailing empty indices start at the end of the flat truth array
+  std::vector<char> mergedBuffer;
+  merged.flatten_to(mergedBuffer);
+  dataformats::MCTruthContainerView<TruthElement> mergedView(gsl::span<const char>(mergedBuffer.data(), mergedBuffer.size()));
+  BOOST_CHECK(mergedView.getLabels(4).size() == 2);
+  BOOST_CHECK(mergedView.getLabels(5).size() == 0);
+  BOOST_CHECK(mergedView.getLabels(6).size() == 0);
+
+  Builder appended;
+  for (auto& b : builders) {
+    appended.append(b);
+  }
+  BOOST_CHECK(appended.getNElements() == sequence.size());
+  auto fromAppended = appended.finalize();
+  for (uint i = 0; i < reference.getNElements(); ++i) {
+    BOOST_CHECK(fromAppended.getElement(i) == reference.getElement(i));
+  }
+
+  // merging at back shifts the indices of the attached part
+  container.mergeAtBack(reference);
+  BOOST_CHECK(container.getIndexedSize() == 10);
+  BOOST_CHECK(container.getMCTruthHeader(5).index == reference.getNElements());
+  BOOST_CHECK(container.getLabels(9)[1] == 41);
+}
+
 BOOST_AUTO_TEST_CASE(LabelContainer_noncont)
 {
   using TruthElement = long;
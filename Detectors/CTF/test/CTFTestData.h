@@ -0,0 +1,147 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFTestData.h
+/// @brief  Synthetic ITS clusters and TOF compressed raw data for the tests and benchmarks of the CTF coders
+
+#ifndef O2_CTF_TESTDATA_H
+#define O2_CTF_TESTDATA_H
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "Headers/RAWDataHeader.h"
+
+namespace o2
+{
+namespace ctf
+{
+namespace test
+{
+
+/// ROFs of 594 BCs with on average nClusters clusters, ordered by chip and column,
+/// about 1% of them with an explicit pattern
+inline void makeITSData(int nROFs, int nClusters, unsigned seed, std::vector<o2::itsmft::ROFRecord>& rofs,
+                        std::vector<o2::itsmft::CompClusterExt>& clusters, std::vector<unsigned char>& patterns)
+{
+  using o2::itsmft::CompCluster;
+  using o2::itsmft::CompClusterExt;
+  std::mt19937 gen(seed);
+  std::poisson_distribution<int> nClustersROF(nClusters);
+  std::uniform_int_distribution<int> chip(0, 24119), row(0, 511), col(0, 1023), span(1, 4);
+  std::geometric_distribution<int> pattID(0.05);
+  std::uniform_int_distribution<int> percent(0, 99), byte(0, 255);
+  rofs.clear();
+  clusters.clear();
+  patterns.clear();
+  o2::InteractionRecord ir(0, 1000);
+  std::vector<CompClusterExt> rofClusters;
+  for (int i = 0; i < nROFs; i++) {
+    rofClusters.clear();
+    for (int n = nClustersROF(gen); n--;) {
+      auto patt = std::min(pattID(gen), CompCluster::InvalidPatternID - 1);
+      rofClusters.emplace_back(row(gen), col(gen), patt, chip(gen));
+      if (percent(gen) == 0) {
+        rofClusters.back().setPatternID(CompCluster::InvalidPatternID);
+      }
+    }
+    std::sort(rofClusters.begin(), rofClusters.end(), [](const CompClusterExt& a, const CompClusterExt& b) {
+      return a.getChipID() < b.getChipID() || (a.getChipID() == b.getChipID() && a.getCol() < b.getCol());
+    });
+    for (const auto& cl : rofClusters) {
+      if (cl.getPatternID() == CompCluster::InvalidPatternID) {
+        int rowSpan = span(gen), colSpan = span(gen);
+        patterns.push_back(rowSpan);
+        patterns.push_back(colSpan);
+        for (int b = (rowSpan * colSpan + 7) / 8; b--;) {
+          patterns.push_back(byte(gen));
+        }
+      }
+    }
+    rofs.emplace_back(ir, i, int(clusters.size()), int(rofClusters.size()));
+    clusters.insert(clusters.end(), rofClusters.begin(), rofClusters.end());
+    ir.bc += 594;
+    if (ir.bc >= 3564) {
+      ir.bc -= 3564;
+      ir.orbit++;
+    }
+  }
+}
+
+/// one CRAWDATA message per crate, as written by the Compressor: per orbit a page
+/// with the crate data and on average nHits hits, and an empty page closing the HBF
+inline std::vector<std::vector<char>> makeTOFData(int nCrates, int nOrbits, int nHits, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::poisson_distribution<int> nFrames(std::max(1., nHits / 2.5)); // 2.5 hits per frame
+  std::geometric_distribution<int> nHitsFrame(0.4);
+  std::uniform_int_distribution<int> trm(3, 12), frameID(0, 255), time(0, 8191), channel(0, 7), tdc(0, 14), chain(0, 1), percent(0, 99);
+  std::normal_distribution<double> tot(400., 100.);
+  std::vector<std::vector<char>> messages;
+  for (int crate = 0; crate < nCrates; crate++) {
+    std::vector<char> message;
+    o2::header::RAWDataHeader rdh;
+    rdh.feeId = crate;
+    rdh.linkID = crate % 12;
+    rdh.cruID = crate / 12;
+    uint8_t packetCounter = 0;
+    uint32_t eventCounter = 0;
+    auto addPage = [&message, &rdh, &packetCounter](const std::vector<uint32_t>& words, bool stop) {
+      rdh.memorySize = sizeof(rdh) + 4 * words.size();
+      rdh.offsetToNext = rdh.memorySize;
+      rdh.packetCounter = packetCounter++;
+      rdh.stop = stop;
+      rdh.pageCnt = stop;
+      auto offset = message.size();
+      message.resize(offset + rdh.memorySize);
+      std::memcpy(message.data() + offset, &rdh, sizeof(rdh));
+      if (!words.empty()) {
+        std::memcpy(message.data() + offset + sizeof(rdh), words.data(), 4 * words.size());
+      }
+    };
+    for (int orbit = 0; orbit < nOrbits; orbit++) {
+      rdh.triggerOrbit = rdh.heartbeatOrbit = 1000 + orbit;
+      std::vector<uint32_t> words;
+      words.push_back(0x80000000 | (crate << 24) | (0x7ff << 12) | (orbit % 8));
+      words.push_back(rdh.heartbeatOrbit);
+      std::vector<uint32_t> frames;
+      for (int n = nFrames(gen); n--;) {
+        frames.push_back((trm(gen) << 24) | (frameID(gen) << 16));
+      }
+      std::sort(frames.begin(), frames.end());
+      for (auto frame : frames) {
+        uint32_t n = 1 + nHitsFrame(gen);
+        words.push_back(frame | n);
+        while (n--) {
+          uint32_t t = std::min(std::max(int(tot(gen)), 0), 2047);
+          words.push_back(t | (time(gen) << 11) | (channel(gen) << 24) | (tdc(gen) << 27) | (uint32_t(chain(gen)) << 31));
+        }
+      }
+      uint32_t nDiag = percent(gen) < 5;
+      words.push_back(0x80000000 | ((eventCounter++ & 0xfff) << 4) | nDiag);
+      if (nDiag) {
+        words.push_back(0x20000000 | trm(gen)); // slot ID and a CRC fault
+      }
+      addPage(words, false);
+      addPage({}, true);
+    }
+    messages.push_back(std::move(message));
+  }
+  return messages;
+}
+
+} // namespace test
+} // namespace ctf
+} // namespace o2
+
+#endif // O2_CTF_TESTDATA_H
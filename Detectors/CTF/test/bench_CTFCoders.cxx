@@ -0,0 +1,121 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_CTFCoders.cxx
+/// @brief  Throughput and compression ratio of the ITS/MFT and TOF CTF coders
+
+#include "benchmark/benchmark.h"
+#include "ITSMFTReconstruction/CTFCoder.h"
+#include "TOFCompression/CTFCoder.h"
+#include "CTFTestData.h"
+
+using namespace o2;
+using o2::detectors::DetID;
+
+namespace
+{
+struct ITSData {
+  std::vector<itsmft::ROFRecord> rofs;
+  std::vector<itsmft::CompClusterExt> clusters;
+  std::vector<unsigned char> patterns;
+  size_t size() const { return clusters.size() * sizeof(itsmft::CompClusterExt) + rofs.size() * sizeof(itsmft::ROFRecord) + patterns.size(); }
+};
+
+ITSData makeITSData(int nROFs)
+{
+  ITSData data;
+  ctf::test::makeITSData(nROFs, 300, 1, data.rofs, data.clusters, data.patterns);
+  return data;
+}
+
+std::vector<tof::CTFCoder::Message> getMessages(const std::vector<std::vector<char>>& payloads, size_t& size)
+{
+  std::vector<tof::CTFCoder::Message> messages;
+  size = 0;
+  for (size_t i = 0; i < payloads.size(); i++) {
+    messages.push_back(tof::CTFCoder::Message{uint32_t(i), payloads[i].data(), payloads[i].size()});
+    size += payloads[i].size();
+  }
+  return messages;
+}
+} // namespace
+
+// arguments: number of ROFs, number of threads
+static void BM_ITSEncode(benchmark::State& state)
+{
+  auto data = makeITSData(state.range(0));
+  std::vector<char> ctf;
+  for (auto _ : state) {
+    itsmft::CTFCoder::encode(DetID::ITS, data.rofs, data.clusters, data.patterns, ctf, state.range(1));
+    benchmark::DoNotOptimize(ctf.data());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+  state.counters["ratio"] = double(data.size()) / ctf.size();
+}
+
+static void BM_ITSDecode(benchmark::State& state)
+{
+  auto data = makeITSData(state.range(0));
+  std::vector<char> ctf;
+  itsmft::CTFCoder::encode(DetID::ITS, data.rofs, data.clusters, data.patterns, ctf, state.range(1));
+  ITSData decoded;
+  for (auto _ : state) {
+    itsmft::CTFCoder::decode(DetID::ITS, ctf.data(), ctf.size(), decoded.rofs, decoded.clusters, decoded.patterns, state.range(1));
+    benchmark::DoNotOptimize(decoded.clusters.data());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+// arguments: number of orbits, number of threads; 72 crates with 20 hits per orbit
+static void BM_TOFEncode(benchmark::State& state)
+{
+  auto payloads = ctf::test::makeTOFData(72, state.range(0), 20, 1);
+  size_t size = 0;
+  auto messages = getMessages(payloads, size);
+  std::vector<char> ctf;
+  for (auto _ : state) {
+    tof::CTFCoder::encode(messages, ctf, state.range(1));
+    benchmark::DoNotOptimize(ctf.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["ratio"] = double(size) / ctf.size();
+}
+
+static void BM_TOFDecode(benchmark::State& state)
+{
+  auto payloads = ctf::test::makeTOFData(72, state.range(0), 20, 1);
+  size_t size = 0;
+  auto messages = getMessages(payloads, size);
+  std::vector<char> ctf;
+  tof::CTFCoder::encode(messages, ctf, state.range(1));
+  std::vector<uint32_t> subSpecs;
+  std::vector<std::vector<char>> decoded;
+  for (auto _ : state) {
+    tof::CTFCoder::decode(ctf.data(), ctf.size(), subSpecs, decoded, state.range(1));
+    benchmark::DoNotOptimize(decoded.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int n : {16, 256}) {
+    for (int nThreads : {1, 4}) {
+      bench->Args({n, nThreads});
+    }
+  }
+}
+
+BENCHMARK(BM_ITSEncode)->Apply(CustomArguments)->UseRealTime();
+BENCHMARK(BM_ITSDecode)->Apply(CustomArguments)->UseRealTime();
+BENCHMARK(BM_TOFEncode)->Apply(CustomArguments)->UseRealTime();
+BENCHMARK(BM_TOFDecode)->Apply(CustomArguments)->UseRealTime();
+
+BENCHMARK_MAIN();
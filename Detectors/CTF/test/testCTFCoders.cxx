@@ -0,0 +1,127 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFCoders
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include "ITSMFTReconstruction/CTFCoder.h"
+#include "TOFCompression/CTFCoder.h"
+#include "CTFTestData.h"
+
+using namespace o2;
+using o2::detectors::DetID;
+
+namespace
+{
+void checkEqual(const std::vector<itsmft::ROFRecord>& rofs, const std::vector<itsmft::CompClusterExt>& clusters,
+                const std::vector<itsmft::ROFRecord>& decodedROFs, const std::vector<itsmft::CompClusterExt>& decodedClusters)
+{
+  BOOST_REQUIRE_EQUAL(rofs.size(), decodedROFs.size());
+  for (size_t i = 0; i < rofs.size(); i++) {
+    BOOST_CHECK(rofs[i].getBCData() == decodedROFs[i].getBCData());
+    BOOST_CHECK_EQUAL(rofs[i].getROFrame(), decodedROFs[i].getROFrame());
+    BOOST_CHECK_EQUAL(rofs[i].getFirstEntry(), decodedROFs[i].getFirstEntry());
+    BOOST_CHECK_EQUAL(rofs[i].getNEntries(), decodedROFs[i].getNEntries());
+  }
+  BOOST_REQUIRE_EQUAL(clusters.size(), decodedClusters.size());
+  size_t nDifferent = 0;
+  for (size_t i = 0; i < clusters.size(); i++) {
+    const auto &a = clusters[i], &b = decodedClusters[i];
+    nDifferent += a.getChipID() != b.getChipID() || a.getRow() != b.getRow() || a.getCol() != b.getCol() ||
+                  a.getPatternID() != b.getPatternID() || a.getFlag() != b.getFlag();
+  }
+  BOOST_CHECK_EQUAL(nDifferent, 0);
+}
+
+std::vector<tof::CTFCoder::Message> getMessages(const std::vector<std::vector<char>>& payloads)
+{
+  std::vector<tof::CTFCoder::Message> messages;
+  for (size_t i = 0; i < payloads.size(); i++) {
+    messages.push_back(tof::CTFCoder::Message{uint32_t(100 + i), payloads[i].data(), payloads[i].size()});
+  }
+  return messages;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CTFCoders_ITSMFT)
+{
+  std::vector<itsmft::ROFRecord> rofs;
+  std::vector<itsmft::CompClusterExt> clusters;
+  std::vector<unsigned char> patterns;
+  ctf::test::makeITSData(200, 300, 1, rofs, clusters, patterns);
+  // unusual content: flags, a ROF out of sequence, an empty ROF
+  clusters[10].setFlag(true);
+  rofs[5].setROFrame(3);
+  rofs[7].getBCData().orbit += 1000;
+  rofs[8].setNEntries(0);
+  rofs[9].setFirstEntry(rofs[9].getFirstEntry() - 5);
+
+  for (DetID det : {DetID::ITS, DetID::MFT}) {
+    for (int nThreads : {1, 4}) {
+      std::vector<char> ctf;
+      itsmft::CTFCoder::encode(det, rofs, clusters, patterns, ctf, nThreads);
+      BOOST_TEST_MESSAGE(det.getName() << " CTF " << ctf.size() << " bytes for " << clusters.size() * sizeof(itsmft::CompClusterExt) << " bytes of clusters");
+      // the positions are random, the synthetic clusters do not compress as well as real ones
+      BOOST_CHECK(ctf.size() < clusters.size() * sizeof(itsmft::CompClusterExt) * 3 / 5);
+
+      std::vector<itsmft::ROFRecord> decodedROFs;
+      std::vector<itsmft::CompClusterExt> decodedClusters;
+      std::vector<unsigned char> decodedPatterns;
+      itsmft::CTFCoder::decode(det, ctf.data(), ctf.size(), decodedROFs, decodedClusters, decodedPatterns, nThreads);
+      checkEqual(rofs, clusters, decodedROFs, decodedClusters);
+      BOOST_CHECK(patterns == decodedPatterns);
+    }
+  }
+
+  // empty time frame
+  std::vector<char> ctf;
+  itsmft::CTFCoder::encode(DetID::ITS, {}, {}, {}, ctf);
+  itsmft::CTFCoder::decode(DetID::ITS, ctf.data(), ctf.size(), rofs, clusters, patterns);
+  BOOST_CHECK(rofs.empty() && clusters.empty() && patterns.empty());
+  BOOST_CHECK_THROW(itsmft::CTFCoder::decode(DetID::MFT, ctf.data(), ctf.size(), rofs, clusters, patterns), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(CTFCoders_TOF)
+{
+  auto payloads = ctf::test::makeTOFData(12, 128, 20, 1);
+  size_t inputSize = 0;
+  for (const auto& payload : payloads) {
+    inputSize += payload.size();
+  }
+  // a page which is not a sequence of crates and a message which is not a sequence of pages
+  payloads[3][64 + 3] ^= 0x80; // crate header without its word type bit
+  payloads.emplace_back(1000, 'x');
+  payloads.emplace_back();
+
+  for (int nThreads : {1, 4}) {
+    std::vector<char> ctf;
+    tof::CTFCoder::encode(getMessages(payloads), ctf, nThreads);
+    BOOST_TEST_MESSAGE("TOF CTF " << ctf.size() << " bytes for " << inputSize << " bytes of messages");
+    BOOST_CHECK(ctf.size() < inputSize / 2);
+    tof::CTFTraits::Header header;
+    tof::CTFTraits::Columns columns;
+    tof::CTFCoder::Coder::decode(DetID::TOF, ctf.data(), ctf.size(), header, columns);
+    BOOST_CHECK_EQUAL(header.nMessages, payloads.size());
+    BOOST_CHECK_EQUAL(header.nPages, 12 * 128 * 2);
+    BOOST_CHECK_EQUAL(header.nRawPages, 1);
+
+    std::vector<uint32_t> subSpecs;
+    std::vector<std::vector<char>> decoded;
+    tof::CTFCoder::decode(ctf.data(), ctf.size(), subSpecs, decoded, nThreads);
+    BOOST_REQUIRE_EQUAL(decoded.size(), payloads.size());
+    for (size_t i = 0; i < payloads.size(); i++) {
+      BOOST_CHECK_EQUAL(subSpecs[i], 100 + i);
+      BOOST_CHECK(decoded[i] == payloads[i]);
+    }
+    BOOST_CHECK_THROW(tof::CTFCoder::decode(ctf.data(), ctf.size() - 1, subSpecs, decoded, nThreads), std::runtime_error);
+  }
+}
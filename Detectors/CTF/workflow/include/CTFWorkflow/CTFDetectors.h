@@ -0,0 +1,43 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFDetectors.h
+/// @brief  Detectors with a CTF coder and their selection in the CTF workflows
+
+#ifndef O2_CTF_DETECTORS
+#define O2_CTF_DETECTORS
+
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "Headers/DataHeader.h"
+#include <string>
+
+namespace o2
+{
+namespace ctf
+{
+
+/// detectors for which a CTF encoder and decoder exist
+inline o2::detectors::DetID::mask_t getSupportedDetectors()
+{
+  return o2::detectors::DetID::getMask(o2::detectors::DetID::ITS) | o2::detectors::DetID::getMask(o2::detectors::DetID::MFT) |
+         o2::detectors::DetID::getMask(o2::detectors::DetID::TOF);
+}
+
+/// data origin of the messages of the detector, e.g. ITS/CTFDATA
+o2::header::DataOrigin getDataOrigin(o2::detectors::DetID det);
+
+/// mask of the comma separated detector names, "all" for all the supported detectors.
+/// Throws std::runtime_error for unknown or unsupported detectors.
+o2::detectors::DetID::mask_t parseDetectors(const std::string& names);
+
+} // namespace ctf
+} // namespace o2
+
+#endif /* O2_CTF_DETECTORS */
@@ -0,0 +1,54 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFReaderSpec.h
+/// @brief  Reader of the CTFs of the detectors from the file of the CTF writer
+
+#ifndef O2_CTFREADER_SPEC
+#define O2_CTFREADER_SPEC
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "Framework/DataProcessorSpec.h"
+#include "Framework/Task.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace o2
+{
+namespace ctf
+{
+
+class CTFReaderSpec : public o2::framework::Task
+{
+ public:
+  CTFReaderSpec(o2::detectors::DetID::mask_t dm) : mDets(dm) {}
+  ~CTFReaderSpec() override = default;
+  void init(o2::framework::InitContext& ic) final;
+  void run(o2::framework::ProcessingContext& pc) final;
+
+ private:
+  o2::detectors::DetID::mask_t mDets;
+  std::unique_ptr<TFile> mFile;
+  std::unique_ptr<TTree> mTree;
+  std::array<std::vector<char>, o2::detectors::DetID::nDetectors> mBuffers;
+  std::array<std::vector<char>*, o2::detectors::DetID::nDetectors> mBufferPtrs{};
+};
+
+/// create a processor spec sending, per time frame, the <DET>/CTFDATA messages of the detectors of the mask
+framework::DataProcessorSpec getCTFReaderSpec(o2::detectors::DetID::mask_t dets);
+
+} // namespace ctf
+} // namespace o2
+
+#endif /* O2_CTFREADER_SPEC */
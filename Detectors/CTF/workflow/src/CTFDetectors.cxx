@@ -0,0 +1,51 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFDetectors.cxx
+/// @brief  Detectors with a CTF coder and their selection in the CTF workflows
+
+#include "CTFWorkflow/CTFDetectors.h"
+#include <sstream>
+#include <stdexcept>
+
+using DetID = o2::detectors::DetID;
+
+o2::header::DataOrigin o2::ctf::getDataOrigin(DetID det)
+{
+  o2::header::DataOrigin origin;
+  origin.runtimeInit(det.getName());
+  return origin;
+}
+
+DetID::mask_t o2::ctf::parseDetectors(const std::string& names)
+{
+  DetID::mask_t mask;
+  std::istringstream stream(names);
+  for (std::string name; std::getline(stream, name, ',');) {
+    if (name.empty()) {
+      continue;
+    }
+    if (name == "all") {
+      mask |= getSupportedDetectors();
+      continue;
+    }
+    DetID::ID id = DetID::First;
+    for (; id <= DetID::Last && name != DetID::getName(id); id++) {
+    }
+    if (id > DetID::Last) {
+      throw std::runtime_error("unknown detector " + name);
+    }
+    if ((DetID::getMask(id) & getSupportedDetectors()).none()) {
+      throw std::runtime_error(std::string("no CTF coder for ") + name);
+    }
+    mask |= DetID::getMask(id);
+  }
+  return mask;
+}
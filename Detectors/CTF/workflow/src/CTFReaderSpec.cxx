@@ -0,0 +1,90 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFReaderSpec.cxx
+/// @brief  Reader of the CTFs of the detectors from the file of the CTF writer
+
+#include <vector>
+
+#include "Framework/ControlService.h"
+#include "Framework/ConfigParamRegistry.h"
+#include "CTFWorkflow/CTFReaderSpec.h"
+#include "CTFWorkflow/CTFDetectors.h"
+#include "CommonUtils/StringUtils.h"
+
+using namespace o2::framework;
+using DetID = o2::detectors::DetID;
+
+namespace o2
+{
+namespace ctf
+{
+
+void CTFReaderSpec::init(InitContext& ic)
+{
+  auto filename = ic.options().get<std::string>("ctf-infile");
+  mFile.reset(TFile::Open(filename.c_str()));
+  if (!mFile || mFile->IsZombie()) {
+    throw std::runtime_error(o2::utils::concat_string("failed to open CTF input file ", filename));
+  }
+  mTree.reset((TTree*)mFile->Get("ctf"));
+  if (!mTree) {
+    throw std::runtime_error(o2::utils::concat_string("no CTF tree in ", filename));
+  }
+  for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+    if (mDets[id]) {
+      if (!mTree->GetBranch(DetID::getName(id))) {
+        throw std::runtime_error(o2::utils::concat_string("no CTF of ", DetID::getName(id), " in ", filename));
+      }
+      mBufferPtrs[id] = &mBuffers[id];
+      mTree->SetBranchAddress(DetID::getName(id), &mBufferPtrs[id]);
+    }
+  }
+  LOG(INFO) << "Loaded CTF tree from " << filename << " with " << mTree->GetEntries() << " entries";
+}
+
+void CTFReaderSpec::run(ProcessingContext& pc)
+{
+  auto ent = mTree->GetReadEntry() + 1;
+  if (ent < mTree->GetEntries()) {
+    mTree->GetEntry(ent);
+    for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+      if (mDets[id]) {
+        pc.outputs().snapshot(Output{getDataOrigin(id), "CTFDATA", 0, Lifetime::Timeframe}, mBuffers[id]);
+      }
+    }
+    LOG(INFO) << "CTFReader pushes the CTFs of entry " << ent;
+  }
+  if (mTree->GetReadEntry() + 1 >= mTree->GetEntries()) {
+    pc.services().get<ControlService>().endOfStream();
+    pc.services().get<ControlService>().readyToQuit(QuitRequest::Me);
+  }
+}
+
+DataProcessorSpec getCTFReaderSpec(DetID::mask_t dets)
+{
+  std::vector<OutputSpec> outputs;
+  for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+    if (dets[id]) {
+      outputs.emplace_back(getDataOrigin(id), "CTFDATA", 0, Lifetime::Timeframe);
+    }
+  }
+
+  return DataProcessorSpec{
+    "ctf-reader",
+    Inputs{},
+    outputs,
+    AlgorithmSpec{adaptFromTask<CTFReaderSpec>(dets)},
+    Options{
+      {"ctf-infile", VariantType::String, "o2_ctf.root", {"Name of the input CTF file"}}}};
+}
+
+} // namespace ctf
+} // namespace o2
@@ -0,0 +1,91 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFWriterSpec.cxx
+/// @brief  Writer of the CTFs of the detectors to a ROOT file, one tree entry per time frame
+
+#include <vector>
+
+#include "Framework/ConfigParamRegistry.h"
+#include "CTFWorkflow/CTFWriterSpec.h"
+#include "CTFWorkflow/CTFDetectors.h"
+#include "CommonUtils/StringUtils.h"
+
+using namespace o2::framework;
+using DetID = o2::detectors::DetID;
+
+namespace o2
+{
+namespace ctf
+{
+
+void CTFWriterSpec::init(InitContext& ic)
+{
+  auto filename = ic.options().get<std::string>("ctf-outfile");
+  // the CTFs are entropy coded already, ROOT compression would only cost time
+  mFile = std::make_unique<TFile>(filename.c_str(), "RECREATE", "", 0);
+  if (!mFile->IsOpen()) {
+    throw std::runtime_error(o2::utils::concat_string("failed to open CTF output file ", filename));
+  }
+  mTree = std::make_unique<TTree>("ctf", "Tree with the CTFs of the detectors");
+  for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+    if (mDets[id]) {
+      mBufferPtrs[id] = &mBuffers[id];
+      mTree->Branch(DetID::getName(id), &mBufferPtrs[id]);
+    }
+  }
+}
+
+void CTFWriterSpec::run(ProcessingContext& pc)
+{
+  for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+    if (mDets[id]) {
+      auto ctf = pc.inputs().get<gsl::span<char>>(DetID::getName(id));
+      mBuffers[id].assign(ctf.begin(), ctf.end());
+      mTotalSizes[id] += ctf.size();
+    }
+  }
+  mTree->Fill();
+  mNTFs++;
+}
+
+void CTFWriterSpec::endOfStream(EndOfStreamContext& ec)
+{
+  LOG(INFO) << "Finalizing CTF writing of " << mNTFs << " time frame(s)";
+  for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+    if (mDets[id]) {
+      LOG(INFO) << DetID::getName(id) << ": " << mTotalSizes[id] << " bytes";
+    }
+  }
+  mTree->Write();
+  mTree.release()->Delete();
+  mFile->Close();
+}
+
+DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets)
+{
+  std::vector<InputSpec> inputs;
+  for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+    if (dets[id]) {
+      inputs.emplace_back(DetID::getName(id), getDataOrigin(id), "CTFDATA", 0, Lifetime::Timeframe);
+    }
+  }
+
+  return DataProcessorSpec{
+    "ctf-writer",
+    inputs,
+    Outputs{},
+    AlgorithmSpec{adaptFromTask<CTFWriterSpec>(dets)},
+    Options{
+      {"ctf-outfile", VariantType::String, "o2_ctf.root", {"Name of the output CTF file"}}}};
+}
+
+} // namespace ctf
+} // namespace o2
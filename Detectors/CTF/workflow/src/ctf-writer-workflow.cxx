@@ -0,0 +1,48 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   ctf-writer-workflow.cxx
+/// @brief  Workflow encoding the data of the detectors and writing the CTFs
+
+#include "Framework/WorkflowSpec.h"
+#include "Framework/ConfigParamSpec.h"
+#include "CTFWorkflow/CTFDetectors.h"
+#include "CTFWorkflow/CTFWriterSpec.h"
+#include "ITSMFTWorkflow/EntropyEncoderSpec.h"
+#include "TOFWorkflow/EntropyEncoderSpec.h"
+
+using namespace o2::framework;
+using DetID = o2::detectors::DetID;
+
+// we need to add workflow options before including Framework/runDataProcessing
+void customize(std::vector<ConfigParamSpec>& workflowOptions)
+{
+  workflowOptions.push_back(ConfigParamSpec{"onlyDet", VariantType::String, "all", {"comma separated list of the detectors to encode and write (ITS, MFT, TOF), or all"}});
+}
+
+#include "Framework/runDataProcessing.h"
+
+WorkflowSpec defineDataProcessing(ConfigContext const& configcontext)
+{
+  auto dets = o2::ctf::parseDetectors(configcontext.options().get<std::string>("onlyDet"));
+  WorkflowSpec specs;
+  for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+    if (!dets[id]) {
+      continue;
+    }
+    if (id == DetID::ITS || id == DetID::MFT) {
+      specs.push_back(o2::itsmft::getEntropyEncoderSpec(id));
+    } else if (id == DetID::TOF) {
+      specs.push_back(o2::tof::getEntropyEncoderSpec());
+    }
+  }
+  specs.push_back(o2::ctf::getCTFWriterSpec(dets));
+  return std::move(specs);
+}
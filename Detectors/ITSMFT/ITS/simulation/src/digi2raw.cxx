@@ -35,7 +35,7 @@ using MAP = o2::itsmft::ChipMappingITS;
 namespace bpo = boost::program_options;
 
 void setupLinks(o2::itsmft::MC2RawEncoder<MAP>& m2r, std::string_view outDir, std::string_view outPrefix, bool filePerCRU);
-void digi2raw(std::string_view inpName, std::string_view outDir, bool filePerCRU, int verbosity, int superPageSizeInB = 1024 * 1024);
+void digi2raw(std::string_view inpName, std::string_view outDir, bool filePerCRU, int verbosity, bool asyncIO = false, bool directIO = false, int superPageSizeInB = 1024 * 1024);
 
 int main(int argc, char** argv)
 {
@@ -53,6 +53,8 @@ int main(int argc, char** argv)
     add_option("input-file,i", bpo::value<std::string>()->default_value("itsdigits.root"), "input ITS digits file");
     add_option("file-per-cru,c", bpo::value<bool>()->default_value(false)->implicit_value(true), "create output file per CRU (default: per layer)");
     add_option("output-dir,o", bpo::value<std::string>()->default_value("./"), "Output directory for raw data");
+    add_option("async-io", bpo::value<bool>()->default_value(false)->implicit_value(true), "write superpages from a dedicated I/O thread");
+    add_option("direct-io", bpo::value<bool>()->default_value(false)->implicit_value(true), "bypass the page cache (O_DIRECT) in asynchronous mode");
 
     opt_all.add(opt_general).add(opt_hidden);
     bpo::store(bpo::command_line_parser(argc, argv).options(opt_all).positional(opt_pos).run(), vm);
@@ -76,12 +78,14 @@ int main(int argc, char** argv)
   digi2raw(vm["input-file"].as<std::string>(),
            vm["output-dir"].as<std::string>(),
            vm["file-per-cru"].as<bool>(),
-           vm["verbosity"].as<uint32_t>());
+           vm["verbosity"].as<uint32_t>(),
+           vm["async-io"].as<bool>(),
+           vm["direct-io"].as<bool>());
 
   return 0;
 }
 
-void digi2raw(std::string_view inpName, std::string_view outDir, bool filePerCRU, int verbosity, int superPageSizeInB)
+void digi2raw(std::string_view inpName, std::string_view outDir, bool filePerCRU, int verbosity, bool asyncIO, bool directIO, int superPageSizeInB)
 {
   TStopwatch swTot;
   swTot.Start();
@@ -117,6 +121,7 @@ void digi2raw(std::string_view inpName, std::string_view outDir, bool filePerCRU
   m2r.setDefaultSinkName(o2::utils::concat_string(MAP::getName(), ".raw"));
   m2r.setMinMaxRUSW(ruSWMin, ruSWMax);
   m2r.getWriter().setSuperPageSize(superPageSizeInB);
+  m2r.getWriter().setAsyncIO(asyncIO, directIO);
 
   m2r.setVerbosity(verbosity);
   setupLinks(m2r, outDir, MAP::getName(), filePerCRU);
@@ -148,6 +153,9 @@ void digi2raw(std::string_view inpName, std::string_view outDir, bool filePerCRU
   //
   swTot.Stop();
   swTot.Print();
+  auto nBytes = m2r.getWriter().getNBytesWritten();
+  LOGF(INFO, "Wrote %zu bytes of raw data (%s I/O): %.1f MB/s", nBytes, asyncIO ? (directIO ? "asynchronous direct" : "asynchronous") : "synchronous",
+       swTot.RealTime() > 0 ? nBytes / swTot.RealTime() / 1e6 : 0.);
 }
 
 void setupLinks(o2::itsmft::MC2RawEncoder<MAP>& m2r, std::string_view outDir, std::string_view outPrefix, bool filePerCRU)
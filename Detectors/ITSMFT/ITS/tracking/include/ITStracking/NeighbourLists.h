@@ -0,0 +1,100 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file NeighbourLists.h
+/// \brief Lists of neighbours in one flat array
+///
+
+#ifndef TRACKINGITSU_INCLUDE_NEIGHBOURLISTS_H_
+#define TRACKINGITSU_INCLUDE_NEIGHBOURLISTS_H_
+
+#include <utility>
+#include <vector>
+
+namespace o2
+{
+namespace its
+{
+
+/// The neighbours of all the elements are stored in compressed sparse row format:
+/// those of element i are mNeighbours[mOffsets[i]] ... mNeighbours[mOffsets[i + 1] - 1].
+/// The (element, neighbour) pairs are collected with add() and grouped by build(),
+/// the buffers keep their capacity when cleared.
+class NeighbourLists
+{
+ public:
+  class List
+  {
+   public:
+    List(const int* first, const int* last) : mFirst{first}, mLast{last} {}
+    int size() const { return mLast - mFirst; }
+    int operator[](int i) const { return mFirst[i]; }
+    const int* begin() const { return mFirst; }
+    const int* end() const { return mLast; }
+
+   private:
+    const int* mFirst;
+    const int* mLast;
+  };
+
+  void clear();
+  void add(int element, int neighbour) { mPairs.emplace_back(element, neighbour); }
+  /// groups the added neighbours of elements [0, nElements) keeping their order of addition
+  void build(int nElements);
+
+  int getElementsNum() const { return mOffsets.empty() ? 0 : mOffsets.size() - 1; }
+  /// neighbours of the element, empty for the elements beyond the built ones
+  List operator[](int element) const;
+
+ private:
+  std::vector<std::pair<int, int>> mPairs;
+  std::vector<int> mOffsets;
+  std::vector<int> mNeighbours;
+};
+
+inline void NeighbourLists::clear()
+{
+  mPairs.clear();
+  mOffsets.clear();
+  mNeighbours.clear();
+}
+
+inline void NeighbourLists::build(int nElements)
+{
+  // count the neighbours of each element, the offsets are then used as insertion cursors
+  mOffsets.assign(nElements + 1, 0);
+  for (const auto& pair : mPairs) {
+    ++mOffsets[pair.first + 1];
+  }
+  for (int iElement{0}; iElement < nElements; ++iElement) {
+    mOffsets[iElement + 1] += mOffsets[iElement];
+  }
+  mNeighbours.resize(mPairs.size());
+  for (const auto& pair : mPairs) {
+    mNeighbours[mOffsets[pair.first]++] = pair.second;
+  }
+  for (int iElement{nElements}; iElement > 0; --iElement) {
+    mOffsets[iElement] = mOffsets[iElement - 1];
+  }
+  mOffsets[0] = 0;
+}
+
+inline NeighbourLists::List NeighbourLists::operator[](int element) const
+{
+  if (element >= getElementsNum()) {
+    return List{nullptr, nullptr};
+  }
+  return List{mNeighbours.data() + mOffsets[element], mNeighbours.data() + mOffsets[element + 1]};
+}
+
+} // namespace its
+} // namespace o2
+
+#endif /* TRACKINGITSU_INCLUDE_NEIGHBOURLISTS_H_ */
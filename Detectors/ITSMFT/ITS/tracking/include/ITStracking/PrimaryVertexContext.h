@@ -24,6 +24,7 @@
 #include "ITStracking/Configuration.h"
 #include "ITStracking/Constants.h"
 #include "ITStracking/Definitions.h"
+#include "ITStracking/NeighbourLists.h"
 #include "ITStracking/Road.h"
 #include "ITStracking/Tracklet.h"
 
@@ -32,6 +33,19 @@ namespace o2
 namespace its
 {
 
+/// The cluster coordinates read by the tracklet finding, one array per field in the
+/// index table order of the layer, together with the usage flags
+struct ClusterColumns {
+  std::vector<float> phi;
+  std::vector<float> r;
+  std::vector<float> z;
+  std::vector<unsigned char> used;
+  std::vector<int> sortedIndex; ///< position in the columns of each clusterId
+
+  void clear();
+  void resize(int clustersNum);
+};
+
 class PrimaryVertexContext
 {
  public:
@@ -48,8 +62,9 @@ class PrimaryVertexContext
   std::array<std::vector<Cluster>, constants::its::LayersNumber>& getClusters();
   std::array<std::vector<Cell>, constants::its::CellsPerRoad>& getCells();
   std::array<std::vector<int>, constants::its::CellsPerRoad - 1>& getCellsLookupTable();
-  std::array<std::vector<std::vector<int>>, constants::its::CellsPerRoad - 1>& getCellsNeighbours();
+  std::array<NeighbourLists, constants::its::CellsPerRoad - 1>& getCellsNeighbours();
   std::vector<Road>& getRoads();
+  const std::array<ClusterColumns, constants::its::LayersNumber>& getClusterColumns() const;
 
   bool isClusterUsed(int layer, int clusterId) const;
   void markUsedCluster(int layer, int clusterId);
@@ -69,10 +84,10 @@ class PrimaryVertexContext
   float3 mPrimaryVertex;
   std::array<std::vector<Cluster>, constants::its::LayersNumber> mUnsortedClusters;
   std::array<std::vector<Cluster>, constants::its::LayersNumber> mClusters;
-  std::array<std::vector<bool>, constants::its::LayersNumber> mUsedClusters;
+  std::array<ClusterColumns, constants::its::LayersNumber> mClusterColumns;
   std::array<std::vector<Cell>, constants::its::CellsPerRoad> mCells;
   std::array<std::vector<int>, constants::its::CellsPerRoad - 1> mCellsLookupTable;
-  std::array<std::vector<std::vector<int>>, constants::its::CellsPerRoad - 1> mCellsNeighbours;
+  std::array<NeighbourLists, constants::its::CellsPerRoad - 1> mCellsNeighbours;
   std::vector<Road> mRoads;
 
   std::array<std::array<int, constants::index_table::ZBins * constants::index_table::PhiBins + 1>,
@@ -82,8 +97,35 @@ class PrimaryVertexContext
   std::array<std::vector<int>, constants::its::CellsPerRoad> mTrackletsLookupTable;
 
   std::vector<std::pair<unsigned long long, bool>> mRoadLabels;
+
+ private:
+  struct ClusterHelper {
+    float phi;
+    float r;
+    int bin;
+    int ind;
+  };
+  std::vector<ClusterHelper> mClusterHelpers; ///< sorting scratch, kept to reuse its memory
 };
 
+inline void ClusterColumns::clear()
+{
+  phi.clear();
+  r.clear();
+  z.clear();
+  used.clear();
+  sortedIndex.clear();
+}
+
+inline void ClusterColumns::resize(int clustersNum)
+{
+  phi.resize(clustersNum);
+  r.resize(clustersNum);
+  z.resize(clustersNum);
+  used.resize(clustersNum, 0);
+  sortedIndex.resize(clustersNum);
+}
+
 inline const float3& PrimaryVertexContext::getPrimaryVertex() const { return mPrimaryVertex; }
 
 inline std::array<std::vector<Cluster>, constants::its::LayersNumber>& PrimaryVertexContext::getClusters()
@@ -98,20 +140,29 @@ inline std::array<std::vector<int>, constants::its::CellsPerRoad - 1>& PrimaryVe
   return mCellsLookupTable;
 }
 
-inline std::array<std::vector<std::vector<int>>, constants::its::CellsPerRoad - 1>&
-  PrimaryVertexContext::getCellsNeighbours()
+inline std::array<NeighbourLists, constants::its::CellsPerRoad - 1>& PrimaryVertexContext::getCellsNeighbours()
 {
   return mCellsNeighbours;
 }
 
 inline std::vector<Road>& PrimaryVertexContext::getRoads() { return mRoads; }
 
+inline const std::array<ClusterColumns, constants::its::LayersNumber>& PrimaryVertexContext::getClusterColumns() const
+{
+  return mClusterColumns;
+}
+
 inline bool PrimaryVertexContext::isClusterUsed(int layer, int clusterId) const
 {
-  return mUsedClusters[layer][clusterId];
+  const auto& columns = mClusterColumns[layer];
+  return columns.used[columns.sortedIndex[clusterId]];
 }
 
-inline void PrimaryVertexContext::markUsedCluster(int layer, int clusterId) { mUsedClusters[layer][clusterId] = true; }
+inline void PrimaryVertexContext::markUsedCluster(int layer, int clusterId)
+{
+  auto& columns = mClusterColumns[layer];
+  columns.used[columns.sortedIndex[clusterId]] = 1;
+}
 
 inline std::array<std::array<int, constants::index_table::ZBins * constants::index_table::PhiBins + 1>,
                   constants::its::TrackletsPerRoad>&
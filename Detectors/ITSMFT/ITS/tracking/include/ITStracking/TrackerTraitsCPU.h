@@ -42,11 +42,18 @@ class TrackerTraitsCPU : public TrackerTraits
   TrackerTraitsCPU() { mPrimaryVertexContext = new PrimaryVertexContext; }
   ~TrackerTraitsCPU() override { delete mPrimaryVertexContext; }
 
-  void computeLayerCells() final;
-  void computeLayerTracklets() final;
+  void computeLayerCells() override;
+  void computeLayerTracklets() override;
   void refitTracks(const std::array<std::vector<TrackingFrameInfo>, 7>& tf, std::vector<TrackITSExt>& tracks) final;
 
  protected:
+  /// tracklets of the clusters [firstCluster, lastCluster) of the layer, appended to the vector.
+  /// The tracklets lookup table is filled with indices into this vector
+  void computeTracklets(int iLayer, int firstCluster, int lastCluster, std::vector<Tracklet>& tracklets);
+  /// cells of the tracklets [firstTracklet, lastTracklet) of the layer, appended to the vector.
+  /// The cells lookup table is filled with indices into this vector
+  void computeCells(int iLayer, int firstTracklet, int lastTracklet, std::vector<Cell>& cells);
+
   std::vector<std::vector<Tracklet>> mTracklets;
   std::vector<std::vector<Cell>> mCells;
 };
@@ -0,0 +1,52 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file TrackerTraitsMT.h
+/// \brief Multi-threaded tracklet and cell finding
+///
+
+#ifndef TRACKINGITSU_INCLUDE_TRACKERTRAITSMT_H_
+#define TRACKINGITSU_INCLUDE_TRACKERTRAITSMT_H_
+
+#include "ITStracking/TrackerTraitsCPU.h"
+
+#include <vector>
+
+namespace o2
+{
+namespace its
+{
+
+/// The tracklets and cells of all layers are searched in parallel, one task per
+/// layer and phi bin of the index table. Each task fills its own output vector,
+/// the outputs are then concatenated in phi bin order: the result is the same
+/// as the one of TrackerTraitsCPU for any number of threads.
+class TrackerTraitsMT : public TrackerTraitsCPU
+{
+ public:
+  explicit TrackerTraitsMT(int nThreads = 1) { setNThreads(nThreads); }
+
+  void computeLayerCells() final;
+  void computeLayerTracklets() final;
+
+  void setNThreads(int nThreads) { mNThreads = nThreads > 0 ? nThreads : 1; }
+  int getNThreads() const { return mNThreads; }
+
+ private:
+  int mNThreads = 1;
+  // per task outputs, cleared but not released between ROframes
+  std::vector<std::vector<Tracklet>> mTaskTracklets;
+  std::vector<std::vector<Cell>> mTaskCells;
+};
+
+} // namespace its
+} // namespace o2
+
+#endif /* TRACKINGITSU_INCLUDE_TRACKERTRAITSMT_H_ */
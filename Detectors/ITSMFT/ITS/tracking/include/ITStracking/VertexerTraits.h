@@ -143,6 +143,13 @@ class VertexerTraits
   unsigned int getDebugFlags() const { return static_cast<unsigned int>(mDBGFlags); }
 
  protected:
+  // tracklets of the layer 1 clusters in [firstCluster, lastCluster), the found tracklets buffers must be sized
+  void computeTracklets(int firstCluster, int lastCluster, std::vector<Tracklet>& comb01, std::vector<Tracklet>& comb12);
+  // lines of the same clusters, offsets are the positions of their first tracklets in mComb01 and mComb12
+  void computeTrackletMatching(int firstCluster, int lastCluster, int offset01, int offset12, std::vector<Line>& lines);
+  // merges the clusters of lines with close centroids and stores the vertices
+  void mergeTrackletClusters();
+
   unsigned char mIsGPU;
 
   std::vector<Line> mTracklets;
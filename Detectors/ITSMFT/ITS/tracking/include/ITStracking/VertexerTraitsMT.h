@@ -0,0 +1,82 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file VertexerTraitsMT.h
+/// \brief Multi-threaded tracklet finding and line clustering of the ITS vertexer
+///
+
+#ifndef O2_ITS_TRACKING_VERTEXER_TRAITS_MT_H_
+#define O2_ITS_TRACKING_VERTEXER_TRAITS_MT_H_
+
+#include "ITStracking/VertexerTraits.h"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace o2
+{
+namespace its
+{
+
+/// The tracklets and their matching are computed in parallel, one task per phi bin
+/// of the layer 1 clusters, and concatenated in phi bin order. The line clustering
+/// keeps the greedy order of VertexerTraits::computeVertices: the first compatible
+/// line of each line is searched in parallel on blocks of lines stored by coordinate,
+/// and the lines added to a cluster are only searched among those whose z at the beam
+/// axis is compatible with the cluster centroid. The vertices are the same as the
+/// ones of VertexerTraits for any number of threads.
+class VertexerTraitsMT : public VertexerTraits
+{
+ public:
+  explicit VertexerTraitsMT(int nThreads = 1) { setNThreads(nThreads); }
+
+  void computeTracklets() final;
+  void computeTrackletMatching() final;
+  void computeVertices() final;
+
+  void setNThreads(int nThreads) { mNThreads = nThreads > 0 ? nThreads : 1; }
+  int getNThreads() const { return mNThreads; }
+
+ private:
+  using VertexerTraits::computeTrackletMatching;
+  using VertexerTraits::computeTracklets;
+
+  /// first line in [first, last) with a DCA to line iLine within the pair cut, -1 if none
+  int findCompatibleLine(int iLine, int first, int last, bool skipUsed) const;
+  /// sorts the lines by their z at the beam axis, in classes of |cot(theta)|
+  void fillLinesGrid();
+  /// first unused line from first on closer than the pair cut to the point, -1 if none
+  int findLineCloseToPoint(const std::array<float, 3>& point, int first);
+  /// lines which may be close to the points around center, sorted by index
+  void fillLinesWindow(const std::array<float, 3>& center);
+
+  int mNThreads = 1;
+  // per task outputs, cleared but not released between ROframes
+  std::vector<std::vector<Tracklet>> mTaskComb01;
+  std::vector<std::vector<Tracklet>> mTaskComb12;
+  std::vector<std::vector<Line>> mTaskLines;
+  // the lines by coordinate, for the distance computations
+  std::array<std::vector<float>, 3> mLineOrigins;
+  std::array<std::vector<float>, 3> mLineDirections;
+  std::vector<unsigned char> mUsedTracklets;
+  std::vector<int> mCompatibleTracklets; ///< first compatible line of each line, used or not
+  // the lines by z at the beam axis, for the lines close to a point
+  static constexpr int CotClasses{8};
+  std::array<std::vector<std::pair<float, int>>, CotClasses> mLinesGrid;
+  std::array<float, CotClasses> mLinesGridMaxCot;
+  std::vector<int> mLinesWindow;
+  std::array<float, 3> mLinesWindowCenter;
+};
+
+} // namespace its
+} // namespace o2
+
+#endif /* O2_ITS_TRACKING_VERTEXER_TRAITS_MT_H_ */
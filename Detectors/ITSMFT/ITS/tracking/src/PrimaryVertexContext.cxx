@@ -24,20 +24,10 @@ namespace its
 void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const std::array<std::vector<Cluster>, constants::its::LayersNumber>& cl,
                                       const std::array<float, 3>& pVtx, const int iteration)
 {
-
-  struct ClusterHelper {
-    float phi;
-    float r;
-    int bin;
-    int ind;
-  };
-
   mPrimaryVertex = {pVtx[0], pVtx[1], pVtx[2]};
 
   if (iteration == 0) {
 
-    std::vector<ClusterHelper> cHelper;
-
     for (int iLayer{0}; iLayer < constants::its::LayersNumber; ++iLayer) {
 
       const auto& currentLayer{cl[iLayer]};
@@ -45,8 +35,9 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const st
 
       mClusters[iLayer].clear();
       mClusters[iLayer].resize(clustersNum);
-      mUsedClusters[iLayer].clear();
-      mUsedClusters[iLayer].resize(clustersNum, false);
+      auto& columns = mClusterColumns[iLayer];
+      columns.clear();
+      columns.resize(clustersNum);
 
       constexpr int _size = constants::index_table::PhiBins * constants::index_table::ZBins;
       std::array<int, _size> clsPerBin;
@@ -54,12 +45,12 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const st
         clsPerBin[iB] = 0;
       }
 
-      cHelper.clear();
-      cHelper.resize(clustersNum);
+      mClusterHelpers.clear();
+      mClusterHelpers.resize(clustersNum);
 
       for (int iCluster{0}; iCluster < clustersNum; ++iCluster) {
         const Cluster& c = currentLayer[iCluster];
-        ClusterHelper& h = cHelper[iCluster];
+        ClusterHelper& h = mClusterHelpers[iCluster];
         float x = c.xCoordinate - mPrimaryVertex.x;
         float y = c.yCoordinate - mPrimaryVertex.y;
         float phi = math_utils::calculatePhiCoordinate(x, y);
@@ -78,7 +69,7 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const st
       }
 
       for (int iCluster{0}; iCluster < clustersNum; ++iCluster) {
-        ClusterHelper& h = cHelper[iCluster];
+        ClusterHelper& h = mClusterHelpers[iCluster];
         Cluster& c = mClusters[iLayer][lutPerBin[h.bin] + h.ind];
         c = currentLayer[iCluster];
         c.phiCoordinate = h.phi;
@@ -86,6 +77,14 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const st
         c.indexTableBinIndex = h.bin;
       }
 
+      for (int iCluster{0}; iCluster < clustersNum; ++iCluster) {
+        const Cluster& c = mClusters[iLayer][iCluster];
+        columns.phi[iCluster] = c.phiCoordinate;
+        columns.r[iCluster] = c.rCoordinate;
+        columns.z[iCluster] = c.zCoordinate;
+        columns.sortedIndex[c.clusterId] = iCluster;
+      }
+
       if (iLayer > 0) {
         for (int iB{0}; iB < _size; ++iB) {
           mIndexTables[iLayer - 1][iB] = lutPerBin[iB];
@@ -28,12 +28,23 @@
 #include <dlfcn.h>
 #include <cstdlib>
 #include <string>
+#ifdef CA_DEBUG
+#include <mutex>
+#endif
 
 namespace o2
 {
 namespace its
 {
 
+#ifdef CA_DEBUG
+namespace
+{
+/// the debug printouts of ROframes tracked concurrently must not interleave
+std::mutex debugOutputMutex;
+} // namespace
+#endif
+
 Tracker::Tracker(o2::its::TrackerTraits* traits)
 {
   /// Initialise standard configuration with 1 iteration
@@ -97,6 +108,8 @@ void Tracker::findCellsNeighbours(int& iteration)
     }
 
     int layerCellsNum{static_cast<int>(mPrimaryVertexContext->getCells()[iLayer].size())};
+    const int nextLayerCellsNum{static_cast<int>(mPrimaryVertexContext->getCells()[iLayer + 1].size())};
+    auto& cellsNeighbours = mPrimaryVertexContext->getCellsNeighbours()[iLayer];
 
     for (int iCell{0}; iCell < layerCellsNum; ++iCell) {
 
@@ -107,9 +120,6 @@ void Tracker::findCellsNeighbours(int& iteration)
           mPrimaryVertexContext->getCells()[iLayer + 1][nextLayerFirstCellIndex].getFirstTrackletIndex() ==
             nextLayerTrackletIndex) {
 
-        const int nextLayerCellsNum{static_cast<int>(mPrimaryVertexContext->getCells()[iLayer + 1].size())};
-        mPrimaryVertexContext->getCellsNeighbours()[iLayer].resize(nextLayerCellsNum);
-
         for (int iNextLayerCell{nextLayerFirstCellIndex};
              iNextLayerCell < nextLayerCellsNum &&
              mPrimaryVertexContext->getCells()[iLayer + 1][iNextLayerCell].getFirstTrackletIndex() ==
@@ -131,7 +141,7 @@ void Tracker::findCellsNeighbours(int& iteration)
           if (deltaNormalVectorsModulus < mTrkParams[iteration].NeighbourMaxDeltaN[iLayer] &&
               deltaCurvature < mTrkParams[iteration].NeighbourMaxDeltaCurvature[iLayer]) {
 
-            mPrimaryVertexContext->getCellsNeighbours()[iLayer][iNextLayerCell].push_back(iCell);
+            cellsNeighbours.add(iNextLayerCell, iCell);
 
             const int currentCellLevel{currentCell.getLevel()};
 
@@ -143,6 +153,7 @@ void Tracker::findCellsNeighbours(int& iteration)
         }
       }
     }
+    cellsNeighbours.build(nextLayerCellsNum);
   }
 }
 
@@ -203,6 +214,7 @@ void Tracker::findRoads(int& iteration)
     }
 #ifdef CA_DEBUG
     nRoads += mPrimaryVertexContext->getRoads().size();
+    std::lock_guard<std::mutex> lock(debugOutputMutex);
     std::cout << "+++ Roads with " << iLevel + 2 << " clusters: " << nRoads << " / " << mPrimaryVertexContext->getRoads().size() << std::endl;
 #endif
   }
@@ -338,6 +350,7 @@ void Tracker::findTracks(const ROframe& event)
   }
 
 #ifdef CA_DEBUG
+  std::lock_guard<std::mutex> lock(debugOutputMutex);
   std::cout << "+++ Found candidates with 4, 5, 6 and 7 clusters:\t";
   for (int count : roadCounters)
     std::cout << count << "\t";
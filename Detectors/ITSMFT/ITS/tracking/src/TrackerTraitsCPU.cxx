@@ -38,69 +38,74 @@ void TrackerTraitsCPU::computeLayerTracklets()
     if (primaryVertexContext->getClusters()[iLayer].empty() || primaryVertexContext->getClusters()[iLayer + 1].empty()) {
       return;
     }
+    computeTracklets(iLayer, 0, primaryVertexContext->getClusters()[iLayer].size(), primaryVertexContext->getTracklets()[iLayer]);
+  }
+}
 
-    const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
-    const int currentLayerClustersNum{static_cast<int>(primaryVertexContext->getClusters()[iLayer].size())};
-
-    for (int iCluster{0}; iCluster < currentLayerClustersNum; ++iCluster) {
-      const Cluster& currentCluster{primaryVertexContext->getClusters()[iLayer][iCluster]};
-
-      if (primaryVertexContext->isClusterUsed(iLayer, currentCluster.clusterId)) {
-        continue;
-      }
-
-      const float tanLambda{(currentCluster.zCoordinate - primaryVertex.z) / currentCluster.rCoordinate};
-      const float directionZIntersection{tanLambda * (constants::its::LayersRCoordinate()[iLayer + 1] -
-                                                      currentCluster.rCoordinate) +
-                                         currentCluster.zCoordinate};
-
-      const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer, directionZIntersection,
-                                              mTrkParams.TrackletMaxDeltaZ[iLayer], mTrkParams.TrackletMaxDeltaPhi)};
+void TrackerTraitsCPU::computeTracklets(int iLayer, int firstCluster, int lastCluster, std::vector<Tracklet>& tracklets)
+{
+  PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
+  const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
+  const std::vector<Cluster>& currentLayer{primaryVertexContext->getClusters()[iLayer]};
+  const std::vector<Cluster>& nextLayer{primaryVertexContext->getClusters()[iLayer + 1]};
+  const ClusterColumns& currentColumns{primaryVertexContext->getClusterColumns()[iLayer]};
+  const ClusterColumns& nextColumns{primaryVertexContext->getClusterColumns()[iLayer + 1]};
+  const auto& indexTable = primaryVertexContext->getIndexTables()[iLayer];
+
+  for (int iCluster{firstCluster}; iCluster < lastCluster; ++iCluster) {
+    if (currentColumns.used[iCluster]) {
+      continue;
+    }
+    const Cluster& currentCluster{currentLayer[iCluster]};
 
-      if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
-        continue;
-      }
+    const float tanLambda{(currentCluster.zCoordinate - primaryVertex.z) / currentCluster.rCoordinate};
+    const float directionZIntersection{tanLambda * (constants::its::LayersRCoordinate()[iLayer + 1] -
+                                                    currentCluster.rCoordinate) +
+                                       currentCluster.zCoordinate};
 
-      int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
+    const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer, directionZIntersection,
+                                            mTrkParams.TrackletMaxDeltaZ[iLayer], mTrkParams.TrackletMaxDeltaPhi)};
 
-      if (phiBinsNum < 0) {
-        phiBinsNum += constants::index_table::PhiBins;
-      }
+    if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
+      continue;
+    }
 
-      for (int iPhiBin{selectedBinsRect.y}, iPhiCount{0}; iPhiCount < phiBinsNum;
-           iPhiBin = ++iPhiBin == constants::index_table::PhiBins ? 0 : iPhiBin, iPhiCount++) {
-        const int firstBinIndex{index_table_utils::getBinIndex(selectedBinsRect.x, iPhiBin)};
-        const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
-        const int firstRowClusterIndex = primaryVertexContext->getIndexTables()[iLayer][firstBinIndex];
-        const int maxRowClusterIndex = primaryVertexContext->getIndexTables()[iLayer][maxBinIndex];
+    int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
 
-        for (int iNextLayerCluster{firstRowClusterIndex}; iNextLayerCluster < maxRowClusterIndex;
-             ++iNextLayerCluster) {
+    if (phiBinsNum < 0) {
+      phiBinsNum += constants::index_table::PhiBins;
+    }
 
-          const Cluster& nextCluster{primaryVertexContext->getClusters()[iLayer + 1][iNextLayerCluster]};
+    for (int iPhiBin{selectedBinsRect.y}, iPhiCount{0}; iPhiCount < phiBinsNum;
+         iPhiBin = ++iPhiBin == constants::index_table::PhiBins ? 0 : iPhiBin, iPhiCount++) {
+      const int firstBinIndex{index_table_utils::getBinIndex(selectedBinsRect.x, iPhiBin)};
+      const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
+      const int firstRowClusterIndex = indexTable[firstBinIndex];
+      const int maxRowClusterIndex = indexTable[maxBinIndex];
 
-          if (primaryVertexContext->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
-            continue;
-          }
+      // the candidates are scanned on the columns, the clusters are only read for the accepted ones
+      for (int iNextLayerCluster{firstRowClusterIndex}; iNextLayerCluster < maxRowClusterIndex;
+           ++iNextLayerCluster) {
 
-          const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.rCoordinate - currentCluster.rCoordinate) +
-                                                     currentCluster.zCoordinate - nextCluster.zCoordinate)};
-          const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phiCoordinate - nextCluster.phiCoordinate)};
+        if (nextColumns.used[iNextLayerCluster]) {
+          continue;
+        }
 
-          if (deltaZ < mTrkParams.TrackletMaxDeltaZ[iLayer] &&
-              (deltaPhi < mTrkParams.TrackletMaxDeltaPhi ||
-               gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < mTrkParams.TrackletMaxDeltaPhi)) {
+        const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (nextColumns.r[iNextLayerCluster] - currentCluster.rCoordinate) +
+                                                   currentCluster.zCoordinate - nextColumns.z[iNextLayerCluster])};
+        const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phiCoordinate - nextColumns.phi[iNextLayerCluster])};
 
-            if (iLayer > 0 &&
-                primaryVertexContext->getTrackletsLookupTable()[iLayer - 1][iCluster] == constants::its::UnusedIndex) {
+        if (deltaZ < mTrkParams.TrackletMaxDeltaZ[iLayer] &&
+            (deltaPhi < mTrkParams.TrackletMaxDeltaPhi ||
+             gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < mTrkParams.TrackletMaxDeltaPhi)) {
 
-              primaryVertexContext->getTrackletsLookupTable()[iLayer - 1][iCluster] =
-                primaryVertexContext->getTracklets()[iLayer].size();
-            }
+          if (iLayer > 0 &&
+              primaryVertexContext->getTrackletsLookupTable()[iLayer - 1][iCluster] == constants::its::UnusedIndex) {
 
-            primaryVertexContext->getTracklets()[iLayer].emplace_back(iCluster, iNextLayerCluster, currentCluster,
-                                                                      nextCluster);
+            primaryVertexContext->getTrackletsLookupTable()[iLayer - 1][iCluster] = tracklets.size();
           }
+
+          tracklets.emplace_back(iCluster, iNextLayerCluster, currentCluster, nextLayer[iNextLayerCluster]);
         }
       }
     }
@@ -117,111 +122,115 @@ void TrackerTraitsCPU::computeLayerCells()
 
       return;
     }
+    computeCells(iLayer, 0, primaryVertexContext->getTracklets()[iLayer].size(), primaryVertexContext->getCells()[iLayer]);
+  }
+}
 
-    const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
-    const int currentLayerTrackletsNum{static_cast<int>(primaryVertexContext->getTracklets()[iLayer].size())};
+void TrackerTraitsCPU::computeCells(int iLayer, int firstTracklet, int lastTracklet, std::vector<Cell>& cells)
+{
+  PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
+  const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
+  const std::vector<Tracklet>& currentLayerTracklets{primaryVertexContext->getTracklets()[iLayer]};
+  const std::vector<Tracklet>& nextLayerTracklets{primaryVertexContext->getTracklets()[iLayer + 1]};
+  const std::vector<int>& trackletsLookupTable{primaryVertexContext->getTrackletsLookupTable()[iLayer]};
+  const int nextLayerTrackletsNum{static_cast<int>(nextLayerTracklets.size())};
 
-    for (int iTracklet{0}; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
+  for (int iTracklet{firstTracklet}; iTracklet < lastTracklet; ++iTracklet) {
 
-      const Tracklet& currentTracklet{primaryVertexContext->getTracklets()[iLayer][iTracklet]};
-      const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
-      const int nextLayerFirstTrackletIndex{
-        primaryVertexContext->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex]};
+    const Tracklet& currentTracklet{currentLayerTracklets[iTracklet]};
+    const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
+    const int nextLayerFirstTrackletIndex{trackletsLookupTable[nextLayerClusterIndex]};
 
-      if (nextLayerFirstTrackletIndex == constants::its::UnusedIndex) {
+    if (nextLayerFirstTrackletIndex == constants::its::UnusedIndex) {
 
-        continue;
-      }
+      continue;
+    }
+
+    const Cluster& firstCellCluster{primaryVertexContext->getClusters()[iLayer][currentTracklet.firstClusterIndex]};
+    const Cluster& secondCellCluster{
+      primaryVertexContext->getClusters()[iLayer + 1][currentTracklet.secondClusterIndex]};
+    const float firstCellClusterQuadraticRCoordinate{firstCellCluster.rCoordinate * firstCellCluster.rCoordinate};
+    const float secondCellClusterQuadraticRCoordinate{secondCellCluster.rCoordinate *
+                                                      secondCellCluster.rCoordinate};
+    const float3 firstDeltaVector{secondCellCluster.xCoordinate - firstCellCluster.xCoordinate,
+                                  secondCellCluster.yCoordinate - firstCellCluster.yCoordinate,
+                                  secondCellClusterQuadraticRCoordinate - firstCellClusterQuadraticRCoordinate};
+
+    for (int iNextLayerTracklet{nextLayerFirstTrackletIndex};
+         iNextLayerTracklet < nextLayerTrackletsNum &&
+         nextLayerTracklets[iNextLayerTracklet].firstClusterIndex == nextLayerClusterIndex;
+         ++iNextLayerTracklet) {
+
+      const Tracklet& nextTracklet{nextLayerTracklets[iNextLayerTracklet]};
+      const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
+      const float deltaPhi{std::abs(currentTracklet.phiCoordinate - nextTracklet.phiCoordinate)};
+
+      if (deltaTanLambda < mTrkParams.CellMaxDeltaTanLambda &&
+          (deltaPhi < mTrkParams.CellMaxDeltaPhi ||
+           std::abs(deltaPhi - constants::math::TwoPi) < mTrkParams.CellMaxDeltaPhi)) {
+
+        const float averageTanLambda{0.5f * (currentTracklet.tanLambda + nextTracklet.tanLambda)};
+        const float directionZIntersection{-averageTanLambda * firstCellCluster.rCoordinate +
+                                           firstCellCluster.zCoordinate};
+        const float deltaZ{std::abs(directionZIntersection - primaryVertex.z)};
+
+        if (deltaZ < mTrkParams.CellMaxDeltaZ[iLayer]) {
+
+          const Cluster& thirdCellCluster{
+            primaryVertexContext->getClusters()[iLayer + 2][nextTracklet.secondClusterIndex]};
+
+          const float thirdCellClusterQuadraticRCoordinate{thirdCellCluster.rCoordinate *
+                                                           thirdCellCluster.rCoordinate};
+
+          const float3 secondDeltaVector{thirdCellCluster.xCoordinate - firstCellCluster.xCoordinate,
+                                         thirdCellCluster.yCoordinate - firstCellCluster.yCoordinate,
+                                         thirdCellClusterQuadraticRCoordinate -
+                                           firstCellClusterQuadraticRCoordinate};
+
+          float3 cellPlaneNormalVector{math_utils::crossProduct(firstDeltaVector, secondDeltaVector)};
 
-      const Cluster& firstCellCluster{primaryVertexContext->getClusters()[iLayer][currentTracklet.firstClusterIndex]};
-      const Cluster& secondCellCluster{
-        primaryVertexContext->getClusters()[iLayer + 1][currentTracklet.secondClusterIndex]};
-      const float firstCellClusterQuadraticRCoordinate{firstCellCluster.rCoordinate * firstCellCluster.rCoordinate};
-      const float secondCellClusterQuadraticRCoordinate{secondCellCluster.rCoordinate *
-                                                        secondCellCluster.rCoordinate};
-      const float3 firstDeltaVector{secondCellCluster.xCoordinate - firstCellCluster.xCoordinate,
-                                    secondCellCluster.yCoordinate - firstCellCluster.yCoordinate,
-                                    secondCellClusterQuadraticRCoordinate - firstCellClusterQuadraticRCoordinate};
-      const int nextLayerTrackletsNum{static_cast<int>(primaryVertexContext->getTracklets()[iLayer + 1].size())};
-
-      for (int iNextLayerTracklet{nextLayerFirstTrackletIndex};
-           iNextLayerTracklet < nextLayerTrackletsNum &&
-           primaryVertexContext->getTracklets()[iLayer + 1][iNextLayerTracklet].firstClusterIndex ==
-             nextLayerClusterIndex;
-           ++iNextLayerTracklet) {
-
-        const Tracklet& nextTracklet{primaryVertexContext->getTracklets()[iLayer + 1][iNextLayerTracklet]};
-        const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
-        const float deltaPhi{std::abs(currentTracklet.phiCoordinate - nextTracklet.phiCoordinate)};
-
-        if (deltaTanLambda < mTrkParams.CellMaxDeltaTanLambda &&
-            (deltaPhi < mTrkParams.CellMaxDeltaPhi ||
-             std::abs(deltaPhi - constants::math::TwoPi) < mTrkParams.CellMaxDeltaPhi)) {
-
-          const float averageTanLambda{0.5f * (currentTracklet.tanLambda + nextTracklet.tanLambda)};
-          const float directionZIntersection{-averageTanLambda * firstCellCluster.rCoordinate +
-                                             firstCellCluster.zCoordinate};
-          const float deltaZ{std::abs(directionZIntersection - primaryVertex.z)};
-
-          if (deltaZ < mTrkParams.CellMaxDeltaZ[iLayer]) {
-
-            const Cluster& thirdCellCluster{
-              primaryVertexContext->getClusters()[iLayer + 2][nextTracklet.secondClusterIndex]};
-
-            const float thirdCellClusterQuadraticRCoordinate{thirdCellCluster.rCoordinate *
-                                                             thirdCellCluster.rCoordinate};
-
-            const float3 secondDeltaVector{thirdCellCluster.xCoordinate - firstCellCluster.xCoordinate,
-                                           thirdCellCluster.yCoordinate - firstCellCluster.yCoordinate,
-                                           thirdCellClusterQuadraticRCoordinate -
-                                             firstCellClusterQuadraticRCoordinate};
-
-            float3 cellPlaneNormalVector{math_utils::crossProduct(firstDeltaVector, secondDeltaVector)};
-
-            const float vectorNorm{std::sqrt(cellPlaneNormalVector.x * cellPlaneNormalVector.x +
-                                             cellPlaneNormalVector.y * cellPlaneNormalVector.y +
-                                             cellPlaneNormalVector.z * cellPlaneNormalVector.z)};
-
-            if (vectorNorm < constants::math::FloatMinThreshold ||
-                std::abs(cellPlaneNormalVector.z) < constants::math::FloatMinThreshold) {
-
-              continue;
-            }
-
-            const float inverseVectorNorm{1.0f / vectorNorm};
-            const float3 normalizedPlaneVector{cellPlaneNormalVector.x * inverseVectorNorm,
-                                               cellPlaneNormalVector.y * inverseVectorNorm,
-                                               cellPlaneNormalVector.z * inverseVectorNorm};
-            const float planeDistance{-normalizedPlaneVector.x * (secondCellCluster.xCoordinate - primaryVertex.x) -
-                                      (normalizedPlaneVector.y * secondCellCluster.yCoordinate - primaryVertex.y) -
-                                      normalizedPlaneVector.z * secondCellClusterQuadraticRCoordinate};
-            const float normalizedPlaneVectorQuadraticZCoordinate{normalizedPlaneVector.z * normalizedPlaneVector.z};
-            const float cellTrajectoryRadius{std::sqrt(
-              (1.0f - normalizedPlaneVectorQuadraticZCoordinate - 4.0f * planeDistance * normalizedPlaneVector.z) /
-              (4.0f * normalizedPlaneVectorQuadraticZCoordinate))};
-            const float2 circleCenter{-0.5f * normalizedPlaneVector.x / normalizedPlaneVector.z,
-                                      -0.5f * normalizedPlaneVector.y / normalizedPlaneVector.z};
-            const float distanceOfClosestApproach{std::abs(
-              cellTrajectoryRadius - std::sqrt(circleCenter.x * circleCenter.x + circleCenter.y * circleCenter.y))};
-
-            if (distanceOfClosestApproach >
-                mTrkParams.CellMaxDCA[iLayer]) {
-
-              continue;
-            }
-
-            const float cellTrajectoryCurvature{1.0f / cellTrajectoryRadius};
-            if (iLayer > 0 &&
-                primaryVertexContext->getCellsLookupTable()[iLayer - 1][iTracklet] == constants::its::UnusedIndex) {
-
-              primaryVertexContext->getCellsLookupTable()[iLayer - 1][iTracklet] =
-                primaryVertexContext->getCells()[iLayer].size();
-            }
-
-            primaryVertexContext->getCells()[iLayer].emplace_back(
-              currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
-              iTracklet, iNextLayerTracklet, normalizedPlaneVector, cellTrajectoryCurvature);
+          const float vectorNorm{std::sqrt(cellPlaneNormalVector.x * cellPlaneNormalVector.x +
+                                           cellPlaneNormalVector.y * cellPlaneNormalVector.y +
+                                           cellPlaneNormalVector.z * cellPlaneNormalVector.z)};
+
+          if (vectorNorm < constants::math::FloatMinThreshold ||
+              std::abs(cellPlaneNormalVector.z) < constants::math::FloatMinThreshold) {
+
+            continue;
           }
+
+          const float inverseVectorNorm{1.0f / vectorNorm};
+          const float3 normalizedPlaneVector{cellPlaneNormalVector.x * inverseVectorNorm,
+                                             cellPlaneNormalVector.y * inverseVectorNorm,
+                                             cellPlaneNormalVector.z * inverseVectorNorm};
+          const float planeDistance{-normalizedPlaneVector.x * (secondCellCluster.xCoordinate - primaryVertex.x) -
+                                    (normalizedPlaneVector.y * secondCellCluster.yCoordinate - primaryVertex.y) -
+                                    normalizedPlaneVector.z * secondCellClusterQuadraticRCoordinate};
+          const float normalizedPlaneVectorQuadraticZCoordinate{normalizedPlaneVector.z * normalizedPlaneVector.z};
+          const float cellTrajectoryRadius{std::sqrt(
+            (1.0f - normalizedPlaneVectorQuadraticZCoordinate - 4.0f * planeDistance * normalizedPlaneVector.z) /
+            (4.0f * normalizedPlaneVectorQuadraticZCoordinate))};
+          const float2 circleCenter{-0.5f * normalizedPlaneVector.x / normalizedPlaneVector.z,
+                                    -0.5f * normalizedPlaneVector.y / normalizedPlaneVector.z};
+          const float distanceOfClosestApproach{std::abs(
+            cellTrajectoryRadius - std::sqrt(circleCenter.x * circleCenter.x + circleCenter.y * circleCenter.y))};
+
+          if (distanceOfClosestApproach >
+              mTrkParams.CellMaxDCA[iLayer]) {
+
+            continue;
+          }
+
+          const float cellTrajectoryCurvature{1.0f / cellTrajectoryRadius};
+          if (iLayer > 0 &&
+              primaryVertexContext->getCellsLookupTable()[iLayer - 1][iTracklet] == constants::its::UnusedIndex) {
+
+            primaryVertexContext->getCellsLookupTable()[iLayer - 1][iTracklet] = cells.size();
+          }
+
+          cells.emplace_back(
+            currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
+            iTracklet, iNextLayerTracklet, normalizedPlaneVector, cellTrajectoryCurvature);
         }
       }
     }
@@ -0,0 +1,147 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file TrackerTraitsMT.cxx
+/// \brief
+///
+
+#include "ITStracking/TrackerTraitsMT.h"
+
+#include "ITStracking/Cell.h"
+#include "ITStracking/Constants.h"
+#include "ITStracking/Tracklet.h"
+#include "CommonUtils/ParallelUtils.h"
+
+#include <algorithm>
+
+namespace o2
+{
+namespace its
+{
+
+namespace
+{
+using o2::utils::runParallel;
+using PhiBinBoundaries = std::array<int, constants::index_table::PhiBins + 1>;
+
+/// first cluster of each phi bin: the clusters of a layer are sorted by index table bin, phi being the slow index
+PhiBinBoundaries getPhiBinBoundaries(const std::vector<Cluster>& clusters)
+{
+  PhiBinBoundaries boundaries;
+  for (int iPhiBin{0}; iPhiBin <= constants::index_table::PhiBins; ++iPhiBin) {
+    boundaries[iPhiBin] = std::lower_bound(clusters.begin(), clusters.end(), iPhiBin * constants::index_table::ZBins,
+                                           [](const Cluster& cluster, int bin) { return cluster.indexTableBinIndex < bin; }) -
+                          clusters.begin();
+  }
+  return boundaries;
+}
+
+/// shifts the lookup table entries of [first, last) from task-local to layer indices
+void shiftLookupTable(std::vector<int>& lookupTable, int first, int last, int offset)
+{
+  for (int i{first}; i < last; ++i) {
+    if (lookupTable[i] != constants::its::UnusedIndex) {
+      lookupTable[i] += offset;
+    }
+  }
+}
+} // namespace
+
+void TrackerTraitsMT::computeLayerTracklets()
+{
+  if (mNThreads == 1) {
+    TrackerTraitsCPU::computeLayerTracklets();
+    return;
+  }
+  PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
+  auto& clusters = primaryVertexContext->getClusters();
+  // as in the serial version, stop at the first empty layer
+  int nLayers{0};
+  while (nLayers < constants::its::TrackletsPerRoad && !clusters[nLayers].empty() && !clusters[nLayers + 1].empty()) {
+    ++nLayers;
+  }
+  constexpr int phiBins{constants::index_table::PhiBins};
+  std::array<PhiBinBoundaries, constants::its::TrackletsPerRoad> firstCluster;
+  for (int iLayer{0}; iLayer < nLayers; ++iLayer) {
+    firstCluster[iLayer] = getPhiBinBoundaries(clusters[iLayer]);
+  }
+
+  auto& tracklets = mTaskTracklets;
+  if (tracklets.size() < nLayers * phiBins) {
+    tracklets.resize(nLayers * phiBins);
+  }
+  runParallel(mNThreads, nLayers * phiBins, [&](int iTask) {
+    const int iLayer{iTask / phiBins}, iPhiBin{iTask % phiBins};
+    tracklets[iTask].clear();
+    computeTracklets(iLayer, firstCluster[iLayer][iPhiBin], firstCluster[iLayer][iPhiBin + 1], tracklets[iTask]);
+  });
+
+  for (int iLayer{0}; iLayer < nLayers; ++iLayer) {
+    auto& layerTracklets = primaryVertexContext->getTracklets()[iLayer];
+    for (int iPhiBin{0}; iPhiBin < phiBins; ++iPhiBin) {
+      const auto& binTracklets = tracklets[iLayer * phiBins + iPhiBin];
+      if (iLayer > 0 && !layerTracklets.empty()) {
+        shiftLookupTable(primaryVertexContext->getTrackletsLookupTable()[iLayer - 1], firstCluster[iLayer][iPhiBin],
+                         firstCluster[iLayer][iPhiBin + 1], layerTracklets.size());
+      }
+      layerTracklets.insert(layerTracklets.end(), binTracklets.begin(), binTracklets.end());
+    }
+  }
+}
+
+void TrackerTraitsMT::computeLayerCells()
+{
+  if (mNThreads == 1) {
+    TrackerTraitsCPU::computeLayerCells();
+    return;
+  }
+  PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
+  auto& tracklets = primaryVertexContext->getTracklets();
+  int nLayers{0};
+  while (nLayers < constants::its::CellsPerRoad && !tracklets[nLayers].empty() && !tracklets[nLayers + 1].empty()) {
+    ++nLayers;
+  }
+  // the tracklets are sorted by their first cluster, split them at the phi bins of these
+  constexpr int phiBins{constants::index_table::PhiBins};
+  std::array<PhiBinBoundaries, constants::its::CellsPerRoad> firstTracklet;
+  for (int iLayer{0}; iLayer < nLayers; ++iLayer) {
+    const auto firstCluster = getPhiBinBoundaries(primaryVertexContext->getClusters()[iLayer]);
+    for (int iPhiBin{0}; iPhiBin <= phiBins; ++iPhiBin) {
+      firstTracklet[iLayer][iPhiBin] = std::lower_bound(tracklets[iLayer].begin(), tracklets[iLayer].end(), firstCluster[iPhiBin],
+                                                        [](const Tracklet& tracklet, int cluster) { return tracklet.firstClusterIndex < cluster; }) -
+                                       tracklets[iLayer].begin();
+    }
+  }
+
+  auto& cells = mTaskCells;
+  if (cells.size() < nLayers * phiBins) {
+    cells.resize(nLayers * phiBins);
+  }
+  runParallel(mNThreads, nLayers * phiBins, [&](int iTask) {
+    const int iLayer{iTask / phiBins}, iPhiBin{iTask % phiBins};
+    cells[iTask].clear();
+    computeCells(iLayer, firstTracklet[iLayer][iPhiBin], firstTracklet[iLayer][iPhiBin + 1], cells[iTask]);
+  });
+
+  for (int iLayer{0}; iLayer < nLayers; ++iLayer) {
+    auto& layerCells = primaryVertexContext->getCells()[iLayer];
+    for (int iPhiBin{0}; iPhiBin < phiBins; ++iPhiBin) {
+      const auto& binCells = cells[iLayer * phiBins + iPhiBin];
+      if (iLayer > 0 && !layerCells.empty()) {
+        shiftLookupTable(primaryVertexContext->getCellsLookupTable()[iLayer - 1], firstTracklet[iLayer][iPhiBin],
+                         firstTracklet[iLayer][iPhiBin + 1], layerCells.size());
+      }
+      layerCells.insert(layerCells.end(), binCells.begin(), binCells.end());
+    }
+  }
+}
+
+} // namespace its
+} // namespace o2
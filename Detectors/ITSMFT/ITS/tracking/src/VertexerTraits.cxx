@@ -52,12 +52,13 @@ void trackleterKernelSerial(
   const float phiCut,
   std::vector<Tracklet>& Tracklets,
   std::vector<int>& foundTracklets,
+  const int firstClusterIndex,
+  const int lastClusterIndex,
   // const ROframe* evt = nullptr,
   const int maxTrackletsPerCluster = static_cast<int>(2e3))
 {
-  foundTracklets.resize(clustersCurrentLayer.size(), 0);
   // loop on layer1 clusters
-  for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < clustersCurrentLayer.size(); ++iCurrentLayerClusterIndex) {
+  for (int iCurrentLayerClusterIndex{firstClusterIndex}; iCurrentLayerClusterIndex < lastClusterIndex; ++iCurrentLayerClusterIndex) {
     int storedTracklets{0};
     const Cluster currentCluster{clustersCurrentLayer[iCurrentLayerClusterIndex]};
     const int layerIndex{pairOfLayers == LAYER0_TO_LAYER1 ? 0 : 2};
@@ -105,13 +106,15 @@ void trackletSelectionKernelSerial(
   StandaloneDebugger* debugger,
   ROframe* event,
 #endif
+  const int firstClusterIndex,
+  const int lastClusterIndex,
+  int offset01,
+  int offset12,
   const float tanLambdaCut = 0.025f,
   const float phiCut = 0.005f,
   const int maxTracklets = static_cast<int>(1e2))
 {
-  int offset01{0};
-  int offset12{0};
-  for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < clustersCurrentLayer.size(); ++iCurrentLayerClusterIndex) {
+  for (int iCurrentLayerClusterIndex{firstClusterIndex}; iCurrentLayerClusterIndex < lastClusterIndex; ++iCurrentLayerClusterIndex) {
     int validTracklets{0};
     for (int iTracklet12{offset12}; iTracklet12 < offset12 + foundTracklets12[iCurrentLayerClusterIndex]; ++iTracklet12) {
       for (int iTracklet01{offset01}; iTracklet01 < offset01 + foundTracklets01[iCurrentLayerClusterIndex]; ++iTracklet01) {
@@ -307,6 +310,19 @@ void VertexerTraits::computeTrackletsPureMontecarlo()
 }
 
 void VertexerTraits::computeTracklets()
+{
+  mFoundTracklets01.resize(mClusters[1].size(), 0);
+  mFoundTracklets12.resize(mClusters[1].size(), 0);
+  computeTracklets(0, mClusters[1].size(), mComb01, mComb12);
+
+#ifdef _ALLOW_DEBUG_TREES_ITS_
+  if (isDebugFlag(VertexerDebug::CombinatoricsTreeAll)) {
+    mDebugger->fillCombinatoricsTree(mClusters, mComb01, mComb12, mEvent);
+  }
+#endif
+}
+
+void VertexerTraits::computeTracklets(int firstCluster, int lastCluster, std::vector<Tracklet>& comb01, std::vector<Tracklet>& comb12)
 {
   trackleterKernelSerial(
     mClusters[0],
@@ -314,8 +330,10 @@ void VertexerTraits::computeTracklets()
     mIndexTables[0],
     LAYER0_TO_LAYER1,
     mVrtParams.phiCut,
-    mComb01,
-    mFoundTracklets01);
+    comb01,
+    mFoundTracklets01,
+    firstCluster,
+    lastCluster);
 
   trackleterKernelSerial(
     mClusters[2],
@@ -323,17 +341,29 @@ void VertexerTraits::computeTracklets()
     mIndexTables[2],
     LAYER1_TO_LAYER2,
     mVrtParams.phiCut,
-    mComb12,
-    mFoundTracklets12);
+    comb12,
+    mFoundTracklets12,
+    firstCluster,
+    lastCluster);
+}
 
+void VertexerTraits::computeTrackletMatching()
+{
+  computeTrackletMatching(0, mClusters[1].size(), 0, 0, mTracklets);
 #ifdef _ALLOW_DEBUG_TREES_ITS_
-  if (isDebugFlag(VertexerDebug::CombinatoricsTreeAll)) {
-    mDebugger->fillCombinatoricsTree(mClusters, mComb01, mComb12, mEvent);
+  if (isDebugFlag(VertexerDebug::TrackletTreeAll)) {
+    mDebugger->fillTrackletSelectionTree(mClusters, mComb01, mComb12, mAllowedTrackletPairs, mEvent);
+  }
+  if (isDebugFlag(VertexerDebug::LineTreeAll)) {
+    mDebugger->fillPairsInfoTree(mTracklets, mEvent);
+  }
+  if (isDebugFlag(VertexerDebug::LineSummaryAll)) {
+    mDebugger->fillLinesSummaryTree(mTracklets, mEvent);
   }
 #endif
 }
 
-void VertexerTraits::computeTrackletMatching()
+void VertexerTraits::computeTrackletMatching(int firstCluster, int lastCluster, int offset01, int offset12, std::vector<Line>& lines)
 {
   trackletSelectionKernelSerial(
     mClusters[0],
@@ -342,25 +372,18 @@ void VertexerTraits::computeTrackletMatching()
     mComb12,
     mFoundTracklets01,
     mFoundTracklets12,
-    mTracklets,
+    lines,
 #ifdef _ALLOW_DEBUG_TREES_ITS_
     mAllowedTrackletPairs,
     mDebugger,
     mEvent,
 #endif
+    firstCluster,
+    lastCluster,
+    offset01,
+    offset12,
     mVrtParams.tanLambdaCut,
     mVrtParams.phiCut);
-#ifdef _ALLOW_DEBUG_TREES_ITS_
-  if (isDebugFlag(VertexerDebug::TrackletTreeAll)) {
-    mDebugger->fillTrackletSelectionTree(mClusters, mComb01, mComb12, mAllowedTrackletPairs, mEvent);
-  }
-  if (isDebugFlag(VertexerDebug::LineTreeAll)) {
-    mDebugger->fillPairsInfoTree(mTracklets, mEvent);
-  }
-  if (isDebugFlag(VertexerDebug::LineSummaryAll)) {
-    mDebugger->fillLinesSummaryTree(mTracklets, mEvent);
-  }
-#endif
 }
 
 #ifdef _ALLOW_DEBUG_TREES_ITS_
@@ -423,6 +446,11 @@ void VertexerTraits::computeVertices()
       }
     }
   }
+  mergeTrackletClusters();
+}
+
+void VertexerTraits::mergeTrackletClusters()
+{
 #ifdef _ALLOW_DEBUG_TREES_ITS_
   if (isDebugFlag(VertexerDebug::LineSummaryAll)) {
     mDebugger->fillLineClustersTree(mTrackletClusters, mEvent);
@@ -0,0 +1,271 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file VertexerTraitsMT.cxx
+/// \brief
+///
+
+#include "ITStracking/VertexerTraitsMT.h"
+
+#include "ITStracking/ClusterLines.h"
+#include "ITStracking/Tracklet.h"
+#include "CommonUtils/ParallelUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace o2
+{
+namespace its
+{
+
+namespace
+{
+using o2::utils::runParallel;
+
+#ifdef _ALLOW_DEBUG_TREES_ITS_
+// the debug trees expect the tracklets of the whole ROframe at once
+constexpr bool SerialTracklets{true};
+#else
+constexpr bool SerialTracklets{false};
+#endif
+
+// the distances are computed on blocks of lines, the accepted ones are then checked one by one
+constexpr int LinesBlockSize{16};
+// the block computation may round differently from the Line one, this margin on the squared
+// cuts keeps all the lines the Line functions accept among the candidates
+constexpr float CutMargin{1.01f};
+// below this squared norm of their cross product, the lines are left to Line::getDCA
+constexpr float ParallelLinesNorm{1e-10f};
+// lines searched for their first compatible line by one task
+constexpr int LinesPerTask{64};
+// upper |cot(theta)| of the line classes of the grid, the last class takes the rest
+constexpr std::array<float, 7> CotClassLimits{0.25f, 0.5f, 1.f, 2.f, 4.f, 8.f, 16.f};
+// the window of lines stays valid while the centroid is closer than this to its center, in cm
+constexpr float WindowMargin{0.1f};
+// margin on the window for the rounding of the distance computations, in cm
+constexpr float WindowRounding{1e-3f};
+} // namespace
+
+void VertexerTraitsMT::computeTracklets()
+{
+  if (mNThreads == 1 || SerialTracklets) {
+    VertexerTraits::computeTracklets();
+    return;
+  }
+  // the layer 1 clusters are sorted by index table bin, phi being the slow index
+  auto firstCluster = [this](int iPhiBin) { return mIndexTables[1][iPhiBin * ZBins]; };
+
+  mFoundTracklets01.resize(mClusters[1].size(), 0);
+  mFoundTracklets12.resize(mClusters[1].size(), 0);
+  if (mTaskComb01.size() < static_cast<size_t>(PhiBins)) {
+    mTaskComb01.resize(PhiBins);
+    mTaskComb12.resize(PhiBins);
+  }
+  runParallel(mNThreads, PhiBins, [&](int iPhiBin) {
+    mTaskComb01[iPhiBin].clear();
+    mTaskComb12[iPhiBin].clear();
+    computeTracklets(firstCluster(iPhiBin), firstCluster(iPhiBin + 1), mTaskComb01[iPhiBin], mTaskComb12[iPhiBin]);
+  });
+
+  for (int iPhiBin{0}; iPhiBin < PhiBins; ++iPhiBin) {
+    mComb01.insert(mComb01.end(), mTaskComb01[iPhiBin].begin(), mTaskComb01[iPhiBin].end());
+    mComb12.insert(mComb12.end(), mTaskComb12[iPhiBin].begin(), mTaskComb12[iPhiBin].end());
+  }
+}
+
+void VertexerTraitsMT::computeTrackletMatching()
+{
+  if (mNThreads == 1 || SerialTracklets) {
+    VertexerTraits::computeTrackletMatching();
+    return;
+  }
+  auto firstCluster = [this](int iPhiBin) { return mIndexTables[1][iPhiBin * ZBins]; };
+
+  // position of the first tracklet of each phi bin
+  std::array<int, PhiBins + 1> offset01, offset12;
+  offset01[0] = offset12[0] = 0;
+  for (int iPhiBin{0}; iPhiBin < PhiBins; ++iPhiBin) {
+    offset01[iPhiBin + 1] = std::accumulate(mFoundTracklets01.begin() + firstCluster(iPhiBin),
+                                            mFoundTracklets01.begin() + firstCluster(iPhiBin + 1), offset01[iPhiBin]);
+    offset12[iPhiBin + 1] = std::accumulate(mFoundTracklets12.begin() + firstCluster(iPhiBin),
+                                            mFoundTracklets12.begin() + firstCluster(iPhiBin + 1), offset12[iPhiBin]);
+  }
+
+  if (mTaskLines.size() < static_cast<size_t>(PhiBins)) {
+    mTaskLines.resize(PhiBins);
+  }
+  runParallel(mNThreads, PhiBins, [&](int iPhiBin) {
+    mTaskLines[iPhiBin].clear();
+    computeTrackletMatching(firstCluster(iPhiBin), firstCluster(iPhiBin + 1), offset01[iPhiBin], offset12[iPhiBin], mTaskLines[iPhiBin]);
+  });
+
+  for (const auto& lines : mTaskLines) {
+    mTracklets.insert(mTracklets.end(), lines.begin(), lines.end());
+  }
+}
+
+void VertexerTraitsMT::computeVertices()
+{
+  const int numTracklets{static_cast<int>(mTracklets.size())};
+  for (int i{0}; i < 3; ++i) {
+    mLineOrigins[i].resize(numTracklets);
+    mLineDirections[i].resize(numTracklets);
+    for (int iLine{0}; iLine < numTracklets; ++iLine) {
+      mLineOrigins[i][iLine] = mTracklets[iLine].originPoint[i];
+      mLineDirections[i][iLine] = mTracklets[iLine].cosinesDirector[i];
+    }
+  }
+  mUsedTracklets.assign(numTracklets, 0);
+  fillLinesGrid();
+
+  // the first compatible line does not depend on the usage flags, search it for all lines in parallel
+  mCompatibleTracklets.resize(numTracklets);
+  runParallel(mNThreads, (numTracklets + LinesPerTask - 1) / LinesPerTask, [&](int iTask) {
+    const int lastLine{std::min(numTracklets, (iTask + 1) * LinesPerTask)};
+    for (int iLine{iTask * LinesPerTask}; iLine < lastLine; ++iLine) {
+      mCompatibleTracklets[iLine] = findCompatibleLine(iLine, iLine + 1, numTracklets, false);
+    }
+  });
+
+  // same greedy clustering as VertexerTraits::computeVertices
+  for (int tracklet1{0}; tracklet1 < numTracklets; ++tracklet1) {
+    if (mUsedTracklets[tracklet1]) {
+      continue;
+    }
+    int tracklet2{mCompatibleTracklets[tracklet1]};
+    if (tracklet2 >= 0 && mUsedTracklets[tracklet2]) {
+      tracklet2 = findCompatibleLine(tracklet1, tracklet2 + 1, numTracklets, true);
+    }
+    if (tracklet2 < 0) {
+      continue;
+    }
+    mTrackletClusters.emplace_back(tracklet1, mTracklets[tracklet1], tracklet2, mTracklets[tracklet2]);
+    std::array<float, 3> tmpVertex{mTrackletClusters.back().getVertex()};
+    if (tmpVertex[0] * tmpVertex[0] + tmpVertex[1] * tmpVertex[1] > 4.f) {
+      mTrackletClusters.pop_back();
+      continue;
+    }
+    mUsedTracklets[tracklet1] = 1;
+    mUsedTracklets[tracklet2] = 1;
+    fillLinesWindow(tmpVertex);
+    for (int tracklet3{findLineCloseToPoint(tmpVertex, 0)}; tracklet3 >= 0;
+         tracklet3 = findLineCloseToPoint(tmpVertex, tracklet3 + 1)) {
+      mTrackletClusters.back().add(tracklet3, mTracklets[tracklet3]);
+      mUsedTracklets[tracklet3] = 1;
+      tmpVertex = mTrackletClusters.back().getVertex();
+    }
+  }
+  mergeTrackletClusters();
+}
+
+int VertexerTraitsMT::findCompatibleLine(int iLine, int first, int last, bool skipUsed) const
+{
+  const float cut2{mVrtParams.pairCut * mVrtParams.pairCut * CutMargin};
+  const float* ox{mLineOrigins[0].data()};
+  const float* oy{mLineOrigins[1].data()};
+  const float* oz{mLineOrigins[2].data()};
+  const float* cx{mLineDirections[0].data()};
+  const float* cy{mLineDirections[1].data()};
+  const float* cz{mLineDirections[2].data()};
+  const float lineOx{ox[iLine]}, lineOy{oy[iLine]}, lineOz{oz[iLine]};
+  const float lineCx{cx[iLine]}, lineCy{cy[iLine]}, lineCz{cz[iLine]};
+
+  for (int begin{first}; begin < last; begin += LinesBlockSize) {
+    const int size{std::min(LinesBlockSize, last - begin)};
+    unsigned char candidates[LinesBlockSize];
+    for (int k{0}; k < size; ++k) {
+      const int j{begin + k};
+      const float normalX{lineCy * cz[j] - lineCz * cy[j]};
+      const float normalY{lineCz * cx[j] - lineCx * cz[j]};
+      const float normalZ{lineCx * cy[j] - lineCy * cx[j]};
+      const float norm{normalX * normalX + normalY * normalY + normalZ * normalZ};
+      const float distance{(ox[j] - lineOx) * normalX + (oy[j] - lineOy) * normalY + (oz[j] - lineOz) * normalZ};
+      candidates[k] = norm < ParallelLinesNorm || distance * distance <= cut2 * norm;
+    }
+    for (int k{0}; k < size; ++k) {
+      const int j{begin + k};
+      if (candidates[k] && !(skipUsed && mUsedTracklets[j]) && Line::getDCA(mTracklets[iLine], mTracklets[j]) <= mVrtParams.pairCut) {
+        return j;
+      }
+    }
+  }
+  return -1;
+}
+
+void VertexerTraitsMT::fillLinesGrid()
+{
+  static_assert(CotClassLimits.size() == CotClasses - 1, "one limit between each pair of classes");
+  for (int iClass{0}; iClass < CotClasses; ++iClass) {
+    mLinesGrid[iClass].clear();
+    mLinesGridMaxCot[iClass] = 0.f;
+  }
+  for (int iLine{0}; iLine < static_cast<int>(mTracklets.size()); ++iLine) {
+    const Line& line{mTracklets[iLine]};
+    const float transverse2{line.cosinesDirector[0] * line.cosinesDirector[0] + line.cosinesDirector[1] * line.cosinesDirector[1]};
+    // z and |cot(theta)| at the closest approach to the beam axis, a line along it goes to the last class
+    float zAtBeam{line.originPoint[2]};
+    float cot{std::numeric_limits<float>::infinity()};
+    if (transverse2 > 0.f) {
+      const float step{-(line.originPoint[0] * line.cosinesDirector[0] + line.originPoint[1] * line.cosinesDirector[1]) / transverse2};
+      zAtBeam += line.cosinesDirector[2] * step;
+      cot = std::abs(line.cosinesDirector[2]) / std::sqrt(transverse2);
+    }
+    const int iClass = std::lower_bound(CotClassLimits.begin(), CotClassLimits.end(), cot) - CotClassLimits.begin();
+    mLinesGrid[iClass].emplace_back(zAtBeam, iLine);
+    mLinesGridMaxCot[iClass] = std::max(mLinesGridMaxCot[iClass], cot);
+  }
+  for (auto& lines : mLinesGrid) {
+    std::sort(lines.begin(), lines.end());
+  }
+}
+
+void VertexerTraitsMT::fillLinesWindow(const std::array<float, 3>& center)
+{
+  // a line closer than the pair cut to a point P has its z at the beam axis within
+  // pairCut + (r(P) + pairCut) * |cot(theta)| of z(P): take the lines which are so
+  // for any point closer than the margin to the center
+  mLinesWindowCenter = center;
+  mLinesWindow.clear();
+  const float radius{std::sqrt(center[0] * center[0] + center[1] * center[1]) + WindowMargin};
+  for (int iClass{0}; iClass < CotClasses; ++iClass) {
+    const auto& lines = mLinesGrid[iClass];
+    const float halfWidth{mVrtParams.pairCut + WindowMargin + WindowRounding + (radius + mVrtParams.pairCut) * mLinesGridMaxCot[iClass]};
+    auto line = std::lower_bound(lines.begin(), lines.end(), center[2] - halfWidth,
+                                 [](const std::pair<float, int>& line, float z) { return line.first < z; });
+    for (; line != lines.end() && line->first <= center[2] + halfWidth; ++line) {
+      if (!mUsedTracklets[line->second]) {
+        mLinesWindow.push_back(line->second);
+      }
+    }
+  }
+  std::sort(mLinesWindow.begin(), mLinesWindow.end());
+}
+
+int VertexerTraitsMT::findLineCloseToPoint(const std::array<float, 3>& point, int first)
+{
+  const float deltaX{point[0] - mLinesWindowCenter[0]};
+  const float deltaY{point[1] - mLinesWindowCenter[1]};
+  const float deltaZ{point[2] - mLinesWindowCenter[2]};
+  if (deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ > WindowMargin * WindowMargin) {
+    fillLinesWindow(point);
+  }
+  for (auto line = std::lower_bound(mLinesWindow.begin(), mLinesWindow.end(), first); line != mLinesWindow.end(); ++line) {
+    if (!mUsedTracklets[*line] && Line::getDistanceFromPoint(mTracklets[*line], point) < mVrtParams.pairCut) {
+      return *line;
+    }
+  }
+  return -1;
+}
+
+} // namespace its
+} // namespace o2
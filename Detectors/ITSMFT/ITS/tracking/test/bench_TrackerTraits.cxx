@@ -0,0 +1,119 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   bench_TrackerTraits.cxx
+/// \brief  Context initialisation, tracklet and cell finding of the ITS CA tracker on a Pb-Pb ROframe
+
+#include "benchmark/benchmark.h"
+#include "ITStracking/Cluster.h"
+#include "ITStracking/Constants.h"
+#include "ITStracking/TrackerTraitsMT.h"
+
+#include <cmath>
+#include <random>
+
+using namespace o2::its;
+
+namespace
+{
+using LayerClusters = std::array<std::vector<Cluster>, constants::its::LayersNumber>;
+
+/// a central Pb-Pb collision: nTracks primaries with |eta| < 1 and an exponential pt spectrum
+/// of mean 0.5 GeV in a 0.5 T field, plus 20% of uncorrelated clusters on each layer
+LayerClusters makePbPbROframe(int nTracks)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> phiDist(0.f, constants::math::TwoPi), etaDist(-1.f, 1.f), uniform(-1.f, 1.f);
+  std::exponential_distribution<float> ptDist(2.f);
+  std::normal_distribution<float> resolution(0.f, constants::its::Resolution);
+  const auto radii = constants::its::LayersRCoordinate();
+  LayerClusters clusters;
+  for (int iTrack{0}; iTrack < nTracks; ++iTrack) {
+    const float phi0{phiDist(gen)}, cotTheta{std::sinh(etaDist(gen))};
+    const float radius{(0.1f + ptDist(gen)) * 666.7f * (uniform(gen) > 0 ? 1.f : -1.f)}; // cm
+    for (int iLayer{0}; iLayer < constants::its::LayersNumber; ++iLayer) {
+      const float phi{phi0 + std::asin(radii[iLayer] / (2.f * radius))};
+      clusters[iLayer].emplace_back(radii[iLayer] * std::cos(phi) + resolution(gen), radii[iLayer] * std::sin(phi) + resolution(gen),
+                                    radii[iLayer] * cotTheta + resolution(gen), clusters[iLayer].size());
+    }
+  }
+  for (int iLayer{0}; iLayer < constants::its::LayersNumber; ++iLayer) {
+    for (int iCluster{0}; iCluster < nTracks / 5; ++iCluster) {
+      const float phi{phiDist(gen)};
+      clusters[iLayer].emplace_back(radii[iLayer] * std::cos(phi), radii[iLayer] * std::sin(phi),
+                                    uniform(gen) * (constants::its::LayersZCoordinate()[iLayer] - 1.f), clusters[iLayer].size());
+    }
+  }
+  return clusters;
+}
+} // namespace
+
+// arguments: number of primaries, number of threads
+static void BM_Initialise(benchmark::State& state)
+{
+  const auto clusters = makePbPbROframe(state.range(0));
+  TrackerTraitsMT traits(state.range(1));
+  const std::array<float, 3> vertex{0.f, 0.f, 0.f};
+  for (auto _ : state) {
+    traits.getPrimaryVertexContext()->initialise(MemoryParameters{}, clusters, vertex, 0);
+  }
+}
+
+static void BM_Tracklets(benchmark::State& state)
+{
+  const auto clusters = makePbPbROframe(state.range(0));
+  TrackerTraitsMT traits(state.range(1));
+  traits.UpdateTrackingParameters(TrackingParameters{});
+  const std::array<float, 3> vertex{0.f, 0.f, 0.f};
+  size_t nTracklets{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    traits.getPrimaryVertexContext()->initialise(MemoryParameters{}, clusters, vertex, 0);
+    state.ResumeTiming();
+    traits.computeLayerTracklets();
+  }
+  for (const auto& tracklets : traits.getPrimaryVertexContext()->getTracklets()) {
+    nTracklets += tracklets.size();
+  }
+  state.counters["tracklets"] = nTracklets;
+}
+
+static void BM_Cells(benchmark::State& state)
+{
+  const auto clusters = makePbPbROframe(state.range(0));
+  TrackerTraitsMT traits(state.range(1));
+  traits.UpdateTrackingParameters(TrackingParameters{});
+  const std::array<float, 3> vertex{0.f, 0.f, 0.f};
+  size_t nCells{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    traits.getPrimaryVertexContext()->initialise(MemoryParameters{}, clusters, vertex, 0);
+    traits.computeLayerTracklets();
+    state.ResumeTiming();
+    traits.computeLayerCells();
+  }
+  for (const auto& cells : traits.getPrimaryVertexContext()->getCells()) {
+    nCells += cells.size();
+  }
+  state.counters["cells"] = nCells;
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int nThreads : {1, 4}) {
+    bench->Args({4000, nThreads});
+  }
+}
+
+BENCHMARK(BM_Initialise)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Tracklets)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Cells)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
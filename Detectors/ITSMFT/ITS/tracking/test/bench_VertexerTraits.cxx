@@ -0,0 +1,109 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   bench_VertexerTraits.cxx
+/// \brief  Tracklet finding, matching and line clustering of the ITS vertexer as a function of the pileup
+
+#include "benchmark/benchmark.h"
+#include "ITStracking/Constants.h"
+#include "ITStracking/ROframe.h"
+#include "ITStracking/VertexerTraitsMT.h"
+
+#include <cmath>
+#include <random>
+
+using namespace o2::its;
+
+namespace
+{
+/// nCollisions Pb-Pb collisions of nTracks primaries with |eta| < 1 in one ROframe, their z
+/// distributed as the luminous region, plus 20% of uncorrelated clusters on the vertexer layers
+ROframe makePileupROframe(int nCollisions, int nTracks)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> phiDist(0.f, constants::math::TwoPi), etaDist(-1.f, 1.f), uniform(-1.f, 1.f);
+  std::normal_distribution<float> zDist(0.f, 5.f), beamDist(0.f, 0.005f), resolution(0.f, constants::its::Resolution);
+  const auto radii = constants::its::LayersRCoordinate();
+  ROframe event(0);
+  int nClusters[constants::its::LayersNumberVertexer]{};
+  for (int iCollision{0}; iCollision < nCollisions; ++iCollision) {
+    const float vertexX{beamDist(gen)}, vertexY{beamDist(gen)}, vertexZ{zDist(gen)};
+    for (int iTrack{0}; iTrack < nTracks; ++iTrack) {
+      const float phi{phiDist(gen)}, cotTheta{std::sinh(etaDist(gen))};
+      for (int iLayer{0}; iLayer < constants::its::LayersNumberVertexer; ++iLayer) {
+        const float z{vertexZ + radii[iLayer] * cotTheta};
+        if (std::abs(z) < constants::its::LayersZCoordinate()[iLayer]) {
+          event.addClusterToLayer(iLayer, vertexX + radii[iLayer] * std::cos(phi) + resolution(gen),
+                                  vertexY + radii[iLayer] * std::sin(phi) + resolution(gen), z + resolution(gen), nClusters[iLayer]++);
+        }
+      }
+    }
+  }
+  for (int iLayer{0}; iLayer < constants::its::LayersNumberVertexer; ++iLayer) {
+    for (int iCluster{0}; iCluster < nCollisions * nTracks / 5; ++iCluster) {
+      const float phi{phiDist(gen)};
+      event.addClusterToLayer(iLayer, radii[iLayer] * std::cos(phi), radii[iLayer] * std::sin(phi),
+                              uniform(gen) * (constants::its::LayersZCoordinate()[iLayer] - 1.f), nClusters[iLayer]++);
+    }
+  }
+  return event;
+}
+
+void runVertexer(benchmark::State& state, VertexerTraits& traits)
+{
+  const ROframe reference{makePileupROframe(state.range(0), 500)};
+  size_t nVertices{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    ROframe event{reference}; // the vertices are added to the ROframe
+    state.ResumeTiming();
+    traits.initialise(&event);
+    traits.computeTracklets();
+    traits.computeTrackletMatching();
+    traits.computeVertices();
+    nVertices = traits.getVertices().size();
+  }
+  state.counters["vertices"] = nVertices;
+}
+} // namespace
+
+// arguments: number of collisions in the ROframe, number of threads
+static void BM_VertexerSerial(benchmark::State& state)
+{
+  VertexerTraits traits;
+  runVertexer(state, traits);
+}
+
+static void BM_VertexerMT(benchmark::State& state)
+{
+  VertexerTraitsMT traits(state.range(1));
+  runVertexer(state, traits);
+}
+
+static void SerialArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int nCollisions : {1, 5, 10, 20, 50}) {
+    bench->Args({nCollisions, 1});
+  }
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int nCollisions : {1, 5, 10, 20, 50}) {
+    for (int nThreads : {1, 4}) {
+      bench->Args({nCollisions, nThreads});
+    }
+  }
+}
+
+BENCHMARK(BM_VertexerSerial)->Apply(SerialArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_VertexerMT)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
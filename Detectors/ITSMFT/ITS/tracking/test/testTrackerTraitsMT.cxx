@@ -0,0 +1,135 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS TrackerTraitsMT
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITStracking/Constants.h"
+#include "ITStracking/ROframe.h"
+#include "ITStracking/Tracker.h"
+#include "ITStracking/TrackerTraitsCPU.h"
+#include "ITStracking/TrackerTraitsMT.h"
+
+#include <cmath>
+#include <random>
+#include <sstream>
+
+using namespace o2::its;
+
+namespace
+{
+/// nTracks primaries from the origin with |eta| < 1 and an exponential pt spectrum of mean 0.5 GeV
+/// in a 0.5 T field, plus 20% of uncorrelated clusters on each layer
+ROframe makeROframe(int nTracks)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> phiDist(0.f, constants::math::TwoPi), etaDist(-1.f, 1.f), uniform(-1.f, 1.f);
+  std::exponential_distribution<float> ptDist(2.f);
+  std::normal_distribution<float> resolution(0.f, constants::its::Resolution);
+  const auto radii = constants::its::LayersRCoordinate();
+  ROframe event(0);
+  auto addCluster = [&event](int iLayer, float x, float y, float z) {
+    // tracking frame of a sensor perpendicular to the radius at the cluster
+    const float alpha{std::atan2(y, x)};
+    const float xTF{x * std::cos(alpha) + y * std::sin(alpha)}, yTF{-x * std::sin(alpha) + y * std::cos(alpha)};
+    const float sigma2{constants::its::Resolution * constants::its::Resolution};
+    event.addTrackingFrameInfoToLayer(iLayer, x, y, z, xTF, alpha, std::array<float, 2>{yTF, z}, std::array<float, 3>{sigma2, 0.f, sigma2});
+    event.addClusterToLayer(iLayer, x, y, z, event.getClustersOnLayer(iLayer).size());
+  };
+  for (int iTrack{0}; iTrack < nTracks; ++iTrack) {
+    const float phi0{phiDist(gen)}, cotTheta{std::sinh(etaDist(gen))};
+    const float radius{(0.1f + ptDist(gen)) * 666.7f * (uniform(gen) > 0 ? 1.f : -1.f)}; // cm
+    for (int iLayer{0}; iLayer < constants::its::LayersNumber; ++iLayer) {
+      const float phi{phi0 + std::asin(radii[iLayer] / (2.f * radius))};
+      addCluster(iLayer, radii[iLayer] * std::cos(phi) + resolution(gen), radii[iLayer] * std::sin(phi) + resolution(gen),
+                 radii[iLayer] * cotTheta + resolution(gen));
+    }
+  }
+  for (int iLayer{0}; iLayer < constants::its::LayersNumber; ++iLayer) {
+    for (int iCluster{0}; iCluster < nTracks / 5; ++iCluster) {
+      const float phi{phiDist(gen)};
+      addCluster(iLayer, radii[iLayer] * std::cos(phi), radii[iLayer] * std::sin(phi),
+                 uniform(gen) * (constants::its::LayersZCoordinate()[iLayer] - 1.f));
+    }
+  }
+  event.addPrimaryVertex(0.f, 0.f, 0.f);
+  return event;
+}
+
+void checkEqualContexts(PrimaryVertexContext& serial, PrimaryVertexContext& parallel)
+{
+  for (int iLayer{0}; iLayer < constants::its::TrackletsPerRoad; ++iLayer) {
+    const auto &expected = serial.getTracklets()[iLayer], &tracklets = parallel.getTracklets()[iLayer];
+    BOOST_REQUIRE_EQUAL(tracklets.size(), expected.size());
+    for (size_t i{0}; i < expected.size(); ++i) {
+      BOOST_CHECK_EQUAL(tracklets[i].firstClusterIndex, expected[i].firstClusterIndex);
+      BOOST_CHECK_EQUAL(tracklets[i].secondClusterIndex, expected[i].secondClusterIndex);
+      BOOST_CHECK_EQUAL(tracklets[i].tanLambda, expected[i].tanLambda);
+      BOOST_CHECK_EQUAL(tracklets[i].phiCoordinate, expected[i].phiCoordinate);
+    }
+  }
+  for (int iLayer{0}; iLayer < constants::its::CellsPerRoad; ++iLayer) {
+    const auto &expected = serial.getTrackletsLookupTable()[iLayer], &lookupTable = parallel.getTrackletsLookupTable()[iLayer];
+    BOOST_CHECK_EQUAL_COLLECTIONS(lookupTable.begin(), lookupTable.end(), expected.begin(), expected.end());
+  }
+  for (int iLayer{0}; iLayer < constants::its::CellsPerRoad; ++iLayer) {
+    const auto &expected = serial.getCells()[iLayer], &cells = parallel.getCells()[iLayer];
+    BOOST_REQUIRE_EQUAL(cells.size(), expected.size());
+    for (size_t i{0}; i < expected.size(); ++i) {
+      BOOST_CHECK_EQUAL(cells[i].getFirstClusterIndex(), expected[i].getFirstClusterIndex());
+      BOOST_CHECK_EQUAL(cells[i].getSecondClusterIndex(), expected[i].getSecondClusterIndex());
+      BOOST_CHECK_EQUAL(cells[i].getThirdClusterIndex(), expected[i].getThirdClusterIndex());
+      BOOST_CHECK_EQUAL(cells[i].getFirstTrackletIndex(), expected[i].getFirstTrackletIndex());
+      BOOST_CHECK_EQUAL(cells[i].getSecondTrackletIndex(), expected[i].getSecondTrackletIndex());
+      BOOST_CHECK_EQUAL(cells[i].getLevel(), expected[i].getLevel());
+      BOOST_CHECK_EQUAL(cells[i].getCurvature(), expected[i].getCurvature());
+    }
+  }
+  for (int iLayer{0}; iLayer < constants::its::CellsPerRoad - 1; ++iLayer) {
+    const auto &expected = serial.getCellsLookupTable()[iLayer], &lookupTable = parallel.getCellsLookupTable()[iLayer];
+    BOOST_CHECK_EQUAL_COLLECTIONS(lookupTable.begin(), lookupTable.end(), expected.begin(), expected.end());
+  }
+}
+
+void checkEqualTracks(const std::vector<TrackITSExt>& expected, const std::vector<TrackITSExt>& tracks)
+{
+  BOOST_REQUIRE_EQUAL(tracks.size(), expected.size());
+  for (size_t i{0}; i < expected.size(); ++i) {
+    for (int iLayer{0}; iLayer < constants::its::LayersNumber; ++iLayer) {
+      BOOST_CHECK_EQUAL(tracks[i].getClusterIndex(iLayer), expected[i].getClusterIndex(iLayer));
+    }
+    for (int iParam{0}; iParam < 5; ++iParam) {
+      BOOST_CHECK_EQUAL(tracks[i].getParam(iParam), expected[i].getParam(iParam));
+    }
+    BOOST_CHECK_EQUAL(tracks[i].getChi2(), expected[i].getChi2());
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TrackerTraitsMT_sameAsSerial)
+{
+  const ROframe event{makeROframe(1000)};
+  std::ostringstream timeBenchmarkOutputStream;
+
+  TrackerTraitsCPU serialTraits;
+  Tracker serialTracker(&serialTraits);
+  serialTracker.clustersToTracks(event, timeBenchmarkOutputStream);
+  const auto& serialTracks = serialTracker.getTracks();
+  BOOST_CHECK(!serialTracks.empty());
+
+  for (int nThreads : {1, 3, 8}) {
+    TrackerTraitsMT traits(nThreads);
+    Tracker tracker(&traits);
+    tracker.clustersToTracks(event, timeBenchmarkOutputStream);
+    checkEqualContexts(*serialTraits.getPrimaryVertexContext(), *traits.getPrimaryVertexContext());
+    checkEqualTracks(serialTracks, tracker.getTracks());
+  }
+}
@@ -0,0 +1,93 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS VertexerTraitsMT
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITStracking/Constants.h"
+#include "ITStracking/ROframe.h"
+#include "ITStracking/VertexerTraits.h"
+#include "ITStracking/VertexerTraitsMT.h"
+
+#include <cmath>
+#include <random>
+
+using namespace o2::its;
+
+namespace
+{
+/// nCollisions collisions of nTracks primaries with |eta| < 1 in one ROframe, their z distributed
+/// as the luminous region, plus 20% of uncorrelated clusters on the vertexer layers
+ROframe makePileupROframe(int nCollisions, int nTracks)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> phiDist(0.f, constants::math::TwoPi), etaDist(-1.f, 1.f), uniform(-1.f, 1.f);
+  std::normal_distribution<float> zDist(0.f, 5.f), beamDist(0.f, 0.005f), resolution(0.f, constants::its::Resolution);
+  const auto radii = constants::its::LayersRCoordinate();
+  ROframe event(0);
+  int nClusters[constants::its::LayersNumberVertexer]{};
+  for (int iCollision{0}; iCollision < nCollisions; ++iCollision) {
+    const float vertexX{beamDist(gen)}, vertexY{beamDist(gen)}, vertexZ{zDist(gen)};
+    for (int iTrack{0}; iTrack < nTracks; ++iTrack) {
+      const float phi{phiDist(gen)}, cotTheta{std::sinh(etaDist(gen))};
+      for (int iLayer{0}; iLayer < constants::its::LayersNumberVertexer; ++iLayer) {
+        const float z{vertexZ + radii[iLayer] * cotTheta};
+        if (std::abs(z) < constants::its::LayersZCoordinate()[iLayer]) {
+          event.addClusterToLayer(iLayer, vertexX + radii[iLayer] * std::cos(phi) + resolution(gen),
+                                  vertexY + radii[iLayer] * std::sin(phi) + resolution(gen), z + resolution(gen), nClusters[iLayer]++);
+        }
+      }
+    }
+  }
+  for (int iLayer{0}; iLayer < constants::its::LayersNumberVertexer; ++iLayer) {
+    for (int iCluster{0}; iCluster < nCollisions * nTracks / 5; ++iCluster) {
+      const float phi{phiDist(gen)};
+      event.addClusterToLayer(iLayer, radii[iLayer] * std::cos(phi), radii[iLayer] * std::sin(phi),
+                              uniform(gen) * (constants::its::LayersZCoordinate()[iLayer] - 1.f), nClusters[iLayer]++);
+    }
+  }
+  return event;
+}
+
+std::vector<lightVertex> findVertices(const ROframe& reference, VertexerTraits& traits)
+{
+  ROframe event{reference};
+  traits.initialise(&event);
+  traits.computeTracklets();
+  traits.computeTrackletMatching();
+  traits.computeVertices();
+  return traits.getVertices();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(VertexerTraitsMT_sameAsSerial)
+{
+  for (int nCollisions : {1, 20}) {
+    const ROframe event{makePileupROframe(nCollisions, 500)};
+    VertexerTraits serialTraits;
+    const auto expected = findVertices(event, serialTraits);
+    BOOST_CHECK(!expected.empty());
+    for (int nThreads : {1, 3, 8}) {
+      VertexerTraitsMT traits(nThreads);
+      const auto vertices = findVertices(event, traits);
+      BOOST_REQUIRE_EQUAL(vertices.size(), expected.size());
+      for (size_t i{0}; i < expected.size(); ++i) {
+        BOOST_CHECK_EQUAL(vertices[i].mX, expected[i].mX);
+        BOOST_CHECK_EQUAL(vertices[i].mY, expected[i].mY);
+        BOOST_CHECK_EQUAL(vertices[i].mZ, expected[i].mZ);
+        BOOST_CHECK_EQUAL_COLLECTIONS(vertices[i].mRMS2.begin(), vertices[i].mRMS2.end(), expected[i].mRMS2.begin(), expected[i].mRMS2.end());
+        BOOST_CHECK_EQUAL(vertices[i].mAvgDistance2, expected[i].mAvgDistance2);
+        BOOST_CHECK_EQUAL(vertices[i].mContributors, expected[i].mContributors);
+        BOOST_CHECK_EQUAL(vertices[i].mTimeStamp, expected[i].mTimeStamp);
+      }
+    }
+  }
+}
@@ -15,20 +15,25 @@
 
 #include "DataFormatsParameters/GRPObject.h"
 #include "DataFormatsITSMFT/TopologyDictionary.h"
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
 
 #include "Framework/DataProcessorSpec.h"
 #include "Framework/Task.h"
 
 #include "ITStracking/Tracker.h"
 #include "ITStracking/TrackerTraitsCPU.h"
+#include "ITStracking/TrackerTraitsMT.h"
 #include "ITStracking/Vertexer.h"
-#include "ITStracking/VertexerTraits.h"
+#include "ITStracking/VertexerTraitsMT.h"
 
 #include "GPUO2Interface.h"
 #include "GPUReconstruction.h"
 #include "GPUChainITS.h"
 #include "CommonUtils/StringUtils.h"
 
+#include <functional>
+
 namespace o2
 {
 namespace its
@@ -43,12 +48,41 @@ class TrackerDPL : public framework::Task
   void run(framework::ProcessingContext& pc) final;
 
  private:
+  /// tracker and vertexer of a thread tracking ROframes concurrently
+  struct Worker {
+    std::unique_ptr<TrackerTraitsMT> trackerTraits;
+    std::unique_ptr<VertexerTraitsMT> vertexerTraits;
+    std::unique_ptr<Tracker> tracker;
+    std::unique_ptr<Vertexer> vertexer;
+  };
+
+  struct ROFrameOutput {
+    std::uint32_t roFrame = 0;
+    std::vector<Vertex> vertices;
+    std::vector<TrackITSExt> tracks;
+    dataformats::MCTruthContainer<MCCompLabel> trackLabels;
+  };
+
+  /// ROframes loaded at once per worker by trackROFramesConcurrently: the clusters of the whole batch
+  /// are in memory while it is tracked, a larger batch only helps balancing ROframes of different sizes
+  static constexpr size_t ROFramesPerWorker = 4;
+
+  /// tracks the ROframes with clusters concurrently and passes their vertices and tracks to store, in ROframe order
+  void trackROFramesConcurrently(gsl::span<const o2::itsmft::ROFRecord> rofs,
+                                 gsl::span<const o2::itsmft::CompClusterExt> compClusters,
+                                 gsl::span<const unsigned char>::iterator& pattIt,
+                                 const dataformats::MCTruthContainer<MCCompLabel>* labels,
+                                 const std::function<void(ROFrameOutput&)>& store);
+
   bool mIsMC = false;
+  int mNThreads = 1;
+  o2::gpu::GPUDataTypes::DeviceType mDeviceType;
   o2::itsmft::TopologyDictionary mDict;
   std::unique_ptr<o2::gpu::GPUReconstruction> mRecChain = nullptr;
   std::unique_ptr<parameters::GRPObject> mGRP = nullptr;
   std::unique_ptr<Tracker> mTracker = nullptr;
   std::unique_ptr<Vertexer> mVertexer = nullptr;
+  std::vector<Worker> mWorkers; ///< CPU tracking with more than one thread
 };
 
 /// create a processor spec
@@ -60,6 +60,7 @@ void ClustererDPL::init(InitContext& ic)
 
   mFullClusters = ic.options().get<bool>("full-clusters");
   mPatterns = !ic.options().get<bool>("no-patterns");
+  mClusterer->setNThreads(ic.options().get<int>("nthreads"));
 
   // settings for the fired pixel overflow masking
   const auto& alpParams = o2::itsmft::DPLAlpideParam<o2::detectors::DetID::ITS>::Instance();
@@ -162,7 +163,8 @@ DataProcessorSpec getClustererSpec(bool useMC)
       {"its-dictionary-path", VariantType::String, "", {"Path of the cluster-topology dictionary file"}},
       {"grp-file", VariantType::String, "o2sim_grp.root", {"Name of the grp file"}},
       {"full-clusters", o2::framework::VariantType::Bool, false, {"Produce full clusters"}},
-      {"no-patterns", o2::framework::VariantType::Bool, false, {"Do not save rare cluster patterns"}}}};
+      {"no-patterns", o2::framework::VariantType::Bool, false, {"Do not save rare cluster patterns"}},
+      {"nthreads", VariantType::Int, 1, {"number of threads clusterizing the chips in parallel"}}}};
 }
 
 } // namespace its
@@ -10,6 +10,7 @@
 
 /// @file   TrackerSpec.cxx
 
+#include <atomic>
 #include <vector>
 
 #include "TGeoGlobalMagField.h"
@@ -33,6 +34,7 @@
 #include "DetectorsBase/Propagator.h"
 #include "ITSBase/GeometryTGeo.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
+#include "CommonUtils/ParallelUtils.h"
 
 namespace o2
 {
@@ -42,6 +44,7 @@ namespace its
 using Vertex = o2::dataformats::Vertex<o2::dataformats::TimeStamp<int>>;
 
 TrackerDPL::TrackerDPL(bool isMC, o2::gpu::GPUDataTypes::DeviceType dType) : mIsMC{isMC},
+                                                                             mDeviceType{dType},
                                                                              mRecChain{o2::gpu::GPUReconstruction::CreateInstance(dType, true)}
 {
 }
@@ -72,6 +75,20 @@ void TrackerDPL::init(InitContext& ic)
     throw std::runtime_error(o2::utils::concat_string("Cannot retrieve GRP from the ", filename));
   }
 
+  mNThreads = std::max(1, ic.options().get<int>("nthreads"));
+  if (mNThreads > 1 && mDeviceType == o2::gpu::GPUDataTypes::DeviceType::CPU) {
+    mWorkers.resize(mNThreads);
+    for (auto& worker : mWorkers) {
+      worker.trackerTraits = std::make_unique<TrackerTraitsMT>();
+      worker.vertexerTraits = std::make_unique<VertexerTraitsMT>();
+      worker.tracker = std::make_unique<Tracker>(worker.trackerTraits.get());
+      worker.tracker->setBz(mTracker->getBz());
+      worker.vertexer = std::make_unique<Vertexer>(worker.vertexerTraits.get());
+      worker.vertexer->getGlobalConfiguration();
+    }
+    LOG(INFO) << "Tracker running on " << mNThreads << " threads";
+  }
+
   std::string dictPath = ic.options().get<std::string>("its-dictionary-path");
   std::string dictFile = o2::base::NameConf::getDictionaryFileName(o2::detectors::DetID::ITS, dictPath, ".bin");
   if (o2::base::NameConf::pathExists(dictFile)) {
@@ -109,7 +126,6 @@ void TrackerDPL::run(ProcessingContext& pc)
 
   std::vector<o2::its::TrackITSExt> tracks;
   auto& allClusIdx = pc.outputs().make<std::vector<int>>(Output{"ITS", "TRACKCLSID", 0, Lifetime::Timeframe});
-  o2::dataformats::MCTruthContainer<o2::MCCompLabel> trackLabels;
   auto& allTracks = pc.outputs().make<std::vector<o2::its::TrackITS>>(Output{"ITS", "TRACKS", 0, Lifetime::Timeframe});
   o2::dataformats::MCTruthContainer<o2::MCCompLabel> allTrackLabels;
 
@@ -134,8 +150,34 @@ void TrackerDPL::run(ProcessingContext& pc)
     }
   };
 
+  // snippet to store the tracks and vertices of a ROframe
+  auto storeROFrame = [&](std::uint32_t roFrame, std::vector<o2::its::TrackITSExt>& tracks, const std::vector<Vertex>& vtxVecLoc,
+                          const dataformats::MCTruthContainer<o2::MCCompLabel>& trackLabels) {
+    auto& rof = rofs[roFrame];
+    LOG(INFO) << "Found tracks: " << tracks.size();
+    int first = allTracks.size();
+    int number = tracks.size();
+    int shiftIdx = -rof.getFirstEntry();
+    rof.setFirstEntry(first);
+    rof.setNEntries(number);
+    copyTracks(tracks, allTracks, allClusIdx, shiftIdx);
+    allTrackLabels.mergeAtBack(trackLabels);
+
+    // for vertices output
+    auto& vtxROF = vertROFvec.emplace_back(rof); // register entry and number of vertices in the
+    vtxROF.setFirstEntry(vertices.size());       // dedicated ROFRecord
+    vtxROF.setNEntries(vtxVecLoc.size());
+    for (const auto& vtx : vtxVecLoc) {
+      vertices.push_back(vtx);
+    }
+  };
+
   gsl::span<const unsigned char>::iterator pattIt = patterns.begin();
-  if (continuous) {
+  if (continuous && !mWorkers.empty()) {
+    trackROFramesConcurrently(rofs, compClusters, pattIt, labels, [&storeROFrame](ROFrameOutput& output) {
+      storeROFrame(output.roFrame, output.tracks, output.vertices, output.trackLabels);
+    });
+  } else if (continuous) {
     for (const auto& rof : rofs) {
       int nclUsed = ioutils::loadROFrameData(rof, event, compClusters, pattIt, mDict, labels);
       if (nclUsed) {
@@ -146,33 +188,22 @@ void TrackerDPL::run(ProcessingContext& pc)
         mTracker->setROFrame(roFrame);
         mTracker->clustersToTracks(event);
         tracks.swap(mTracker->getTracks());
-        LOG(INFO) << "Found tracks: " << tracks.size();
-        int first = allTracks.size();
-        int number = tracks.size();
-        trackLabels = mTracker->getTrackLabels(); /// FIXME: assignment ctor is not optimal.
-        int shiftIdx = -rof.getFirstEntry();
-        rofs[roFrame].setFirstEntry(first);
-        rofs[roFrame].setNEntries(number);
-        copyTracks(tracks, allTracks, allClusIdx, shiftIdx);
-        allTrackLabels.mergeAtBack(trackLabels);
-
-        // for vertices output
-        auto& vtxROF = vertROFvec.emplace_back(rof); // register entry and number of vertices in the
-        vtxROF.setFirstEntry(vertices.size());       // dedicated ROFRecord
-        vtxROF.setNEntries(vtxVecLoc.size());
-        for (const auto& vtx : vtxVecLoc) {
-          vertices.push_back(vtx);
-        }
+        storeROFrame(roFrame, tracks, vtxVecLoc, mTracker->getTrackLabels());
       }
       roFrame++;
     }
   } else {
     ioutils::loadEventData(event, compClusters, pattIt, mDict, labels);
     event.addPrimaryVertex(0.f, 0.f, 0.f); //FIXME :  run an actual vertex finder !
-    mTracker->clustersToTracks(event);
-    tracks.swap(mTracker->getTracks());
+    // a single event: the threads are used in the tracklet and cell finding
+    auto& tracker = mWorkers.empty() ? *mTracker : *mWorkers[0].tracker;
+    if (!mWorkers.empty()) {
+      mWorkers[0].trackerTraits->setNThreads(mNThreads);
+    }
+    tracker.clustersToTracks(event);
+    tracks.swap(tracker.getTracks());
     copyTracks(tracks, allTracks, allClusIdx);
-    allTrackLabels = mTracker->getTrackLabels(); /// FIXME: assignment ctor is not optimal.
+    allTrackLabels = tracker.getTrackLabels(); /// FIXME: assignment ctor is not optimal.
   }
 
   LOG(INFO) << "ITSTracker pushed " << allTracks.size() << " tracks";
@@ -182,6 +213,60 @@ void TrackerDPL::run(ProcessingContext& pc)
   }
 }
 
+void TrackerDPL::trackROFramesConcurrently(gsl::span<const o2::itsmft::ROFRecord> rofs,
+                                           gsl::span<const o2::itsmft::CompClusterExt> compClusters,
+                                           gsl::span<const unsigned char>::iterator& pattIt,
+                                           const dataformats::MCTruthContainer<MCCompLabel>* labels,
+                                           const std::function<void(ROFrameOutput&)>& store)
+{
+  // the patterns are read sequentially: the ROframes are loaded in batches of ROFramesPerWorker per worker,
+  // so that only the clusters of one batch are in memory, then each worker picks the next ROframe of the batch
+  const size_t batchSize = ROFramesPerWorker * mWorkers.size();
+  std::vector<ROframe> events;
+  events.reserve(batchSize);
+  std::vector<ROFrameOutput> outputs;
+  std::uint32_t roFrame = 0;
+  while (roFrame < rofs.size()) {
+    events.clear();
+    for (; roFrame < rofs.size() && events.size() < batchSize; roFrame++) {
+      auto& event = events.emplace_back(roFrame);
+      int nclUsed = ioutils::loadROFrameData(rofs[roFrame], event, compClusters, pattIt, mDict, labels);
+      if (nclUsed) {
+        LOG(INFO) << "ROframe: " << roFrame << ", clusters loaded : " << nclUsed;
+      } else {
+        events.pop_back();
+      }
+    }
+
+    // the threads left over go to the tracklet and cell finding
+    outputs.clear();
+    outputs.resize(events.size());
+    const int nWorkers = std::min(mWorkers.size(), events.size());
+    std::atomic<size_t> nextEvent{0};
+    o2::utils::runParallel(nWorkers, size_t(nWorkers), [&](size_t iWorker) {
+      auto& worker = mWorkers[iWorker];
+      std::ostream timeBenchmarkOutputStream(nullptr); // the timing printouts of concurrent ROframes would interleave
+      worker.trackerTraits->setNThreads(mNThreads / nWorkers);
+      worker.vertexerTraits->setNThreads(mNThreads / nWorkers);
+      for (size_t iEvent; (iEvent = nextEvent++) < events.size();) {
+        auto& event = events[iEvent];
+        auto& output = outputs[iEvent];
+        output.roFrame = event.getROFrameId();
+        worker.vertexer->clustersToVertices(event, false, timeBenchmarkOutputStream);
+        output.vertices = worker.vertexer->exportVertices();
+        event.addPrimaryVertices(output.vertices);
+        worker.tracker->setROFrame(output.roFrame);
+        worker.tracker->clustersToTracks(event, timeBenchmarkOutputStream);
+        output.tracks.swap(worker.tracker->getTracks());
+        output.trackLabels = worker.tracker->getTrackLabels();
+      }
+    });
+    for (auto& output : outputs) {
+      store(output);
+    }
+  }
+}
+
 DataProcessorSpec getTrackerSpec(bool useMC, o2::gpu::GPUDataTypes::DeviceType dType)
 {
   std::vector<InputSpec> inputs;
@@ -211,7 +296,8 @@ DataProcessorSpec getTrackerSpec(bool useMC, o2::gpu::GPUDataTypes::DeviceType d
     AlgorithmSpec{adaptFromTask<TrackerDPL>(useMC, dType)},
     Options{
       {"grp-file", VariantType::String, "o2sim_grp.root", {"Name of the grp file"}},
-      {"its-dictionary-path", VariantType::String, "", {"Path of the cluster-topology dictionary file"}}}};
+      {"its-dictionary-path", VariantType::String, "", {"Path of the cluster-topology dictionary file"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads of the CPU tracker, ROframes are tracked concurrently"}}}};
 }
 
 } // namespace its
@@ -103,6 +103,18 @@ class AlpideCoder
 
   static bool isEmptyChip(uint8_t b) { return (b & CHIPEMPTY) == CHIPEMPTY; }
 
+  /// hits of a DATALONG hit map, split in the left and right columns of the double column, with their
+  /// rows relative to the row of the leading hit. Depends on the hit map and on the 2 lowest bits of the pixel ID
+  struct HitMapHits {
+    uint8_t nLeft = 0;
+    uint8_t nRight = 0;
+    uint8_t dRowLeft[4] = {};
+    uint8_t dRowRight[4] = {};
+  };
+
+  /// lookup table of HitMapHits, indexed by (pixID & 0x3) << HitMapSize | hitMap
+  static const HitMapHits* getHitMapTable();
+
   /// decode alpide data for the next non-empty chip from the buffer
   template <class T>
   static int decodeChip(ChipPixelData& chipData, T& buffer)
@@ -167,60 +179,68 @@ class AlpideCoder
       // hit info ?
       if ((expectInp & ExpectData)) {
         if (isData(dataC)) { // region header was seen, expect data
-                             // note that here we are checking on the byte rather than the short, need complete to ushort
-          dataS = dataC << 8;
-          if (!buffer.next(dataC)) {
-            return unexpectedEOF("CHIPDATA");
-          }
-          dataS |= dataC;
-          // we are decoding the pixel addres, if this is a DATALONG, we will fetch the mask later
-          uint16_t dColID = (dataS & MaskEncoder) >> 10;
-          uint16_t pixID = dataS & MaskPixID;
-
-          // convert data to usual row/pixel format
-          uint16_t row = pixID >> 1;
-          // abs id of left column in double column
-          uint16_t colD = (region * NDColInReg + dColID) << 1; // TODO consider <<4 instead of *NDColInReg?
-
-          // if we start new double column, transfer the hits accumulated in the right column buffer of prev. double column
-          if (colD != colDPrev) {
-            colDPrev++;
-            for (int ihr = 0; ihr < nRightCHits; ihr++) {
-              chipData.getData().emplace_back(rightColHits[ihr], colDPrev);
+          // the run of DATASHORT/DATALONG records following the region header is decoded directly from the buffer
+          auto ptr = buffer.getPtr() - 1; // on the 1st byte of the record
+          const auto end = buffer.getEnd();
+          const auto* hitMaps = getHitMapTable();
+          do {
+            uint32_t word; // record (and eventual hit map) in the 3 highest bytes
+            if (end - ptr >= 4) {
+              word = (uint32_t(ptr[0]) << 24) | (uint32_t(ptr[1]) << 16) | (uint32_t(ptr[2]) << 8) | ptr[3];
+            } else if (end - ptr >= 2) {
+              word = (uint32_t(ptr[0]) << 24) | (uint32_t(ptr[1]) << 16) | (end - ptr > 2 ? uint32_t(ptr[2]) << 8 : 0);
+            } else {
+              buffer.setPtr(end);
+              return unexpectedEOF("CHIPDATA");
+            }
+            dataS = word >> 16;
+            ptr += 2;
+            // we are decoding the pixel addres, if this is a DATALONG, we will fetch the mask later
+            uint16_t dColID = (dataS & MaskEncoder) >> 10;
+            uint16_t pixID = dataS & MaskPixID;
+
+            // convert data to usual row/pixel format
+            uint16_t row = pixID >> 1;
+            // abs id of left column in double column
+            uint16_t colD = (region * NDColInReg + dColID) << 1; // TODO consider <<4 instead of *NDColInReg?
+
+            // if we start new double column, transfer the hits accumulated in the right column buffer of prev. double column
+            if (colD != colDPrev) {
+              colDPrev++;
+              for (int ihr = 0; ihr < nRightCHits; ihr++) {
+                chipData.getData().emplace_back(rightColHits[ihr], colDPrev);
+              }
+              colDPrev = colD;
+              nRightCHits = 0; // reset the buffer
             }
-            colDPrev = colD;
-            nRightCHits = 0; // reset the buffer
-          }
-
-          bool rightC = (row & 0x1) ? !(pixID & 0x1) : (pixID & 0x1); // true for right column / lalse for left
 
-          // we want to have hits sorted in column/row, so the hits in right column of given double column
-          // are first collected in the temporary buffer
-          // real columnt id is col = colD + 1;
-          if (rightC) {
-            rightColHits[nRightCHits++] = row; // col = colD+1
-          } else {
-            chipData.getData().emplace_back(row, colD); // col = colD, left column hits are added directly to the container
-          }
+            bool rightC = (row & 0x1) ? !(pixID & 0x1) : (pixID & 0x1); // true for right column / lalse for left
 
-          if ((dataS & (~MaskDColID)) == DATALONG) { // multiple hits ?
-            uint8_t hitsPattern = 0;
-            if (!buffer.next(hitsPattern)) {
-              return unexpectedEOF("CHIP_DATA_LONG:Pattern");
+            // we want to have hits sorted in column/row, so the hits in right column of given double column
+            // are first collected in the temporary buffer
+            // real columnt id is col = colD + 1;
+            if (rightC) {
+              rightColHits[nRightCHits++] = row; // col = colD+1
+            } else {
+              chipData.getData().emplace_back(row, colD); // col = colD, left column hits are added directly to the container
             }
-            for (int ip = 0; ip < HitMapSize; ip++) {
-              if (hitsPattern & (0x1 << ip)) {
-                uint16_t addr = pixID + ip + 1, rowE = addr >> 1;
-                rightC = ((rowE & 0x1) ? !(addr & 0x1) : (addr & 0x1)); // true for right column / lalse for left
-                // the real columnt is int colE = colD + rightC;
-                if (rightC) { // same as above
-                  rightColHits[nRightCHits++] = rowE;
-                } else {
-                  chipData.getData().emplace_back(rowE, colD + rightC); // left column hits are added directly to the container
-                }
+
+            if ((dataS & (~MaskDColID)) == DATALONG) { // multiple hits ?
+              if (ptr == end) {
+                buffer.setPtr(end);
+                return unexpectedEOF("CHIP_DATA_LONG:Pattern");
+              }
+              ptr++;
+              const auto& hits = hitMaps[((pixID & 0x3) << HitMapSize) | ((word >> 8) & MaskHitMap)];
+              for (int ih = 0; ih < hits.nLeft; ih++) {
+                chipData.getData().emplace_back(row + hits.dRowLeft[ih], colD); // left column hits are added directly to the container
+              }
+              for (int ih = 0; ih < hits.nRight; ih++) {
+                rightColHits[nRightCHits++] = row + hits.dRowRight[ih];
               }
             }
-          }
+          } while (ptr < end && isData(*ptr));
+          buffer.setPtr(ptr);
         } else {
           LOG(ERROR) << "Expected DataShort or DataLong mask, got : " << dataS;
           return Error;
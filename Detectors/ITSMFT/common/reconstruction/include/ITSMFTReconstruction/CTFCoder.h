@@ -0,0 +1,86 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFCoder.h
+/// \brief Compressed time frame (CTF) coding of the ITS/MFT compact clusters
+
+#ifndef ALICEO2_ITSMFT_CTFCODER_H
+#define ALICEO2_ITSMFT_CTFCODER_H
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include <gsl/span>
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "DetectorsCommonDataFormats/CTFCoder.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+
+namespace o2
+{
+namespace itsmft
+{
+
+/// column decomposition of the ROF records, compact clusters and patterns of a time frame
+struct CTFTraits {
+  struct Header {
+    uint32_t nROFs = 0;
+    uint32_t nClusters = 0;
+    uint32_t nPatternBytes = 0;
+    uint32_t firstOrbit = 0;   // orbit of the 1st ROF
+    uint32_t firstROFrame = 0; // ROFrame of the 1st ROF
+    uint16_t firstBC = 0;      // BC of the 1st ROF
+    uint16_t reserved = 0;
+  };
+
+  enum Slots {
+    BLCorbitIncROF,    // orbit increment wrt the previous ROF
+    BLCbcIncROF,       // BC increment wrt the previous ROF in the same orbit, absolute BC otherwise
+    BLCnClustersROF,   // number of clusters of the ROF
+    BLCfirstEntryROF,  // 1st cluster of the ROF, wrt the end of the previous ROF
+    BLCrofIncROF,      // ROFrame increment wrt the previous ROF
+    BLCchipInc,        // chip increment wrt the previous cluster, 0 at the start of the ROF
+    BLCcolInc,         // column increment wrt the previous cluster on the same chip, absolute otherwise
+    BLCrow,            // row
+    BLCpattID,         // pattern ID, with the flag in bit 11
+    BLCpattern         // bytes of the explicit patterns
+  };
+
+  using Columns = std::tuple<std::vector<uint32_t>, std::vector<uint16_t>, std::vector<uint32_t>, std::vector<uint32_t>, std::vector<uint32_t>,
+                             std::vector<uint16_t>, std::vector<uint16_t>, std::vector<uint16_t>, std::vector<uint16_t>,
+                             std::vector<uint8_t>>;
+};
+
+/// @class CTFCoder
+/// @brief Encodes the clusters of ITS or MFT into the CTF of the detector and back.
+///
+/// The clusters of a ROF come ordered by chip and mostly by column, the increments
+/// of both are small and most of the CTF is taken by the row and the pattern ID.
+/// The conversion is lossless: ROF records, row, column, pattern ID, flag and chip of
+/// the clusters and the patterns are restored as they were.
+class CTFCoder
+{
+ public:
+  using Coder = o2::ctf::CTFCoder<CTFTraits>;
+
+  /// encode the clusters of the time frame, replacing the content of the output
+  static void encode(o2::detectors::DetID det, gsl::span<const ROFRecord> rofs, gsl::span<const CompClusterExt> clusters,
+                     gsl::span<const unsigned char> patterns, std::vector<char>& output, int nThreads = 1);
+
+  /// decode the CTF of the detector, replacing the content of the containers.
+  /// Throws std::runtime_error if the CTF is not consistent.
+  static void decode(o2::detectors::DetID det, const char* data, size_t size, std::vector<ROFRecord>& rofs,
+                     std::vector<CompClusterExt>& clusters, std::vector<unsigned char>& patterns, int nThreads = 1);
+};
+
+} // namespace itsmft
+} // namespace o2
+
+#endif // ALICEO2_ITSMFT_CTFCODER_H
@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 #include <cstring>
+#include <memory>
 #include "ITSMFTBase/GeometryTGeo.h"
 #include "ITSMFTBase/SegmentationAlpide.h"
 #include "DataFormatsITSMFT/Cluster.h"
@@ -27,8 +28,10 @@
 #include "ITSMFTReconstruction/PixelData.h"
 #include "ITSMFTReconstruction/LookUp.h"
 #include "SimulationDataFormat/MCCompLabel.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
 #include "CommonDataFormat/InteractionRecord.h"
 #include "CommonConstants/LHCConstants.h"
+#include "CommonUtils/ParallelUtils.h"
 #include "Rtypes.h"
 #include "TTree.h"
 
@@ -38,13 +41,6 @@
 
 namespace o2
 {
-class MCCompLabel;
-namespace dataformats
-{
-template <typename T>
-class MCTruthContainer;
-}
-
 namespace itsmft
 {
 class Clusterer
@@ -61,6 +57,120 @@ class Clusterer
   using BCData = o2::InteractionRecord;
 
  public:
+  ///< workspace for the clusterization of a range of chips of the batch, owning the output
+  ///< buffers of a task of the multi-threaded mode, concatenated in chip order once all tasks are done
+  struct ClustererThread {
+    explicit ClustererThread(Clusterer* par = nullptr) : parent(par), curr(column2 + 1), prev(column1 + 1)
+    {
+      std::fill(std::begin(column1), std::end(column1), -1);
+      std::fill(std::begin(column2), std::end(column2), -1);
+    }
+    ClustererThread(const ClustererThread&) = delete;
+    ClustererThread& operator=(const ClustererThread&) = delete;
+
+    Clusterer* parent = nullptr;       // owner of the settings, geometry, dictionary and chips batch
+    ChipPixelData* chipData = nullptr; //! pointer on the currently processed chip data
+
+    // buffers for entries in preClusterIndices in 2 columns, to avoid boundary checks, we reserve
+    // extra elements in the beginning and the end
+    int column1[SegmentationAlpide::NRows + 2];
+    int column2[SegmentationAlpide::NRows + 2];
+    int* curr = nullptr; // pointer on the 1st row of currently processed columnX
+    int* prev = nullptr; // pointer on the 1st row of previously processed columnX
+
+    // pixels[].first is the index of the next pixel of the same precluster in the pixels
+    // pixels[].second is the index of the referred pixel in the ChipPixelData
+    std::vector<std::pair<int, UInt_t>> pixels;
+    std::vector<int> preClusterHeads; // index of precluster head in the pixels
+    std::vector<int> preClusterIndices;
+    UShort_t col = 0xffff;    ///< Column being processed
+    bool noLeftColumn = true; ///< flag that there is no column on the left to check
+
+    std::array<Label, Cluster::maxLabels> labelsBuff;               //! temporary buffer for building cluster labels
+    std::array<PixelData, Cluster::kMaxPatternBits * 2> pixArrBuff; //! temporary buffer for pattern calc.
+
+    // output of a task of the multi-threaded mode
+    std::vector<Cluster> fullClusters;
+    std::vector<CompClusterExt> compClusters;
+    std::vector<unsigned char> patterns;
+    MCTruth labels;
+
+    ///< clusterize the chips [firstChip, lastChip) of the batch
+    template <class FullClusCont, class CompClusCont, class PatternCont>
+    void process(int firstChip, int lastChip, FullClusCont* fullClusPtr, CompClusCont* compClusPtr, PatternCont* patternsPtr,
+                 const MCTruth* labelsDigPtr, MCTruth* labelsClusPtr);
+
+    void initChip(UInt_t first);
+    void updateChip(UInt_t ip);
+
+    template <class FullClusCont, class CompClusCont, class PatternCont>
+    void finishChip(FullClusCont* fullClusPtr, CompClusCont* compClusPtr, PatternCont* patternsPtr,
+                    const MCTruth* labelsDigPtr = nullptr, MCTruth* labelsClusPtr = nullptr);
+
+    void fetchMCLabels(int digID, const MCTruth* labelsDig, int& nfilled);
+
+    void clearOutput()
+    {
+      fullClusters.clear();
+      compClusters.clear();
+      patterns.clear();
+      labels.clear();
+    }
+
+    ///< add new precluster at given row of current column for the fired pixel with index ip in the ChipPixelData
+    void addNewPrecluster(UInt_t ip, UShort_t row)
+    {
+      preClusterHeads.push_back(pixels.size());
+      // new head does not point yet (-1) on other pixels, store just the entry of the pixel in the ChipPixelData
+      pixels.emplace_back(-1, ip);
+      int lastIndex = preClusterIndices.size();
+      preClusterIndices.push_back(lastIndex);
+      curr[row] = lastIndex; // store index of the new precluster in the current column buffer
+    }
+
+    ///< add cluster at row (entry ip in the ChipPixeData) to the precluster with given index
+    void expandPreCluster(UInt_t ip, UShort_t row, int preClusIndex)
+    {
+      auto& firstIndex = preClusterHeads[preClusterIndices[preClusIndex]];
+      pixels.emplace_back(firstIndex, ip);
+      firstIndex = pixels.size() - 1;
+      curr[row] = preClusIndex;
+    }
+
+    ///< recalculate min max row and column of the cluster accounting for the position of pix
+    void adjustBoundingBox(const o2::itsmft::PixelData pix, UShort_t& rMin, UShort_t& rMax,
+                           UShort_t& cMin, UShort_t& cMax) const
+    {
+      if (pix.getRowDirect() < rMin) {
+        rMin = pix.getRowDirect();
+      }
+      if (pix.getRowDirect() > rMax) {
+        rMax = pix.getRowDirect();
+      }
+      if (pix.getCol() < cMin) {
+        cMin = pix.getCol();
+      }
+      if (pix.getCol() > cMax) {
+        cMax = pix.getCol();
+      }
+    }
+
+    ///< swap current and previous column buffers
+    void swapColumnBuffers()
+    {
+      int* tmp = curr;
+      curr = prev;
+      prev = tmp;
+    }
+
+    ///< reset column buffer, for the performance reasons we use memset
+    void resetColumn(int* buff)
+    {
+      std::memset(buff, -1, sizeof(int) * SegmentationAlpide::NRows);
+      //std::fill(buff, buff + SegmentationAlpide::NRows, -1);
+    }
+  };
+
   Clusterer();
   ~Clusterer();
 
@@ -90,6 +200,10 @@ class Clusterer
   bool getWantFullClusters() const { return mWantFullClusters; }
   bool getWantCompactClusters() const { return mWantCompactClusters; }
 
+  ///< number of threads clusterizing the chips of a batch of ROFs, the output does not depend on it
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   UInt_t getCurrROF() const { return mROFRef.getROFrame(); }
 
   void print() const;
@@ -99,8 +213,8 @@ class Clusterer
 
   void setNChips(int n)
   {
-    mChips.resize(n);
     mChipsOld.resize(n);
+    mChipLastInBatch.resize(n, -1);
   }
 
   ///< load the dictionary of cluster topologies
@@ -112,68 +226,13 @@ class Clusterer
   const TStopwatch& getTimer() const { return mTimer; }
 
  private:
-  void initChip(UInt_t first);
-
-  ///< add new precluster at given row of current column for the fired pixel with index ip in the ChipPixelData
-  void addNewPrecluster(UInt_t ip, UShort_t row)
-  {
-    mPreClusterHeads.push_back(mPixels.size());
-    // new head does not point yet (-1) on other pixels, store just the entry of the pixel in the ChipPixelData
-    mPixels.emplace_back(-1, ip);
-    int lastIndex = mPreClusterIndices.size();
-    mPreClusterIndices.push_back(lastIndex);
-    mCurr[row] = lastIndex; // store index of the new precluster in the current column buffer
-  }
-
-  ///< add cluster at row (entry ip in the ChipPixeData) to the precluster with given index
-  void expandPreCluster(UInt_t ip, UShort_t row, int preClusIndex)
-  {
-    auto& firstIndex = mPreClusterHeads[mPreClusterIndices[preClusIndex]];
-    mPixels.emplace_back(firstIndex, ip);
-    firstIndex = mPixels.size() - 1;
-    mCurr[row] = preClusIndex;
-  }
+  ///< the batch is clusterized once it has at least this number of chips per thread, or when the input is exhausted
+  static constexpr int MinChipsPerTask = 128;
 
-  ///< recalculate min max row and column of the cluster accounting for the position of pix
-  void adjustBoundingBox(const o2::itsmft::PixelData pix, UShort_t& rMin, UShort_t& rMax,
-                         UShort_t& cMin, UShort_t& cMax) const
-  {
-    if (pix.getRowDirect() < rMin) {
-      rMin = pix.getRowDirect();
-    }
-    if (pix.getRowDirect() > rMax) {
-      rMax = pix.getRowDirect();
-    }
-    if (pix.getCol() < cMin) {
-      cMin = pix.getCol();
-    }
-    if (pix.getCol() > cMax) {
-      cMax = pix.getCol();
-    }
-  }
-
-  ///< swap current and previous column buffers
-  void swapColumnBuffers()
-  {
-    int* tmp = mCurr;
-    mCurr = mPrev;
-    mPrev = tmp;
-  }
-
-  ///< reset column buffer, for the performance reasons we use memset
-  void resetColumn(int* buff)
-  {
-    std::memset(buff, -1, sizeof(int) * SegmentationAlpide::NRows);
-    //std::fill(buff, buff + SegmentationAlpide::NRows, -1);
-  }
-
-  void updateChip(UInt_t ip);
-
-  template <class FullClusCont, class CompClusCont, class PatternCont>
-  void finishChip(FullClusCont* fullClus, CompClusCont* compClus, PatternCont* patterns,
-                  const MCTruth* labelsDig = nullptr, MCTruth* labelsClus = nullptr);
-
-  void fetchMCLabels(int digID, const MCTruth* labelsDig, int& nfilled);
+  ///< clusterize the fetched chips and set the entries of the ROFs of the batch
+  template <class FullClusCont, class CompClusCont, class PatternCont, class ROFRecCont>
+  void processBatch(int nChips, size_t firstROF, FullClusCont* fullClus, CompClusCont* compClus, PatternCont* patterns,
+                    ROFRecCont* vecROFRec, const MCTruth* labelsDig, MCTruth* labelsCl);
 
   ///< flush cluster data accumulated so far into the tree
   template <class FullClusCont, class CompClusCont>
@@ -206,36 +265,24 @@ class Clusterer
   ///< mask continuosly fired pixels in frames separated by less than this amount of BCs (fired from hit in prev. ROF)
   int mMaxBCSeparationToMask = 6000. / o2::constants::lhc::LHCBunchSpacingNS + 10;
 
+  int mNThreads = 1;                                      ///< number of threads clusterizing a batch
+  std::vector<std::unique_ptr<ClustererThread>> mThreads; // workspace of each thread
+
   // aux data for clusterization
-  ChipPixelData* mChipData = nullptr; //! pointer on the current single chip data provided by the reader
+  std::vector<ChipPixelData> mChipsBatch; // chips fetched from the reader, not clusterized yet
+  std::vector<int> mChipNClusters;        // number of clusters found in each chip of the batch
+  std::vector<int> mBatchROFFirstChip;    // entry in the batch of the 1st chip of each ROF of the batch
+  std::vector<int> mTaskFirstChip;        // entry in the batch of the 1st chip of each task
+  std::vector<int> mChipLastInBatch;      // last entry of each chip ID in the batch, -1 if absent
 
-  ///< array of chips, at the moment index corresponds to chip ID.
-  ///< for the processing of fraction of chips only consider mapping of IDs range on mChips
-  std::vector<ChipPixelData> mChips;    // currently processed chips data
+  ///< array of chips, index corresponds to chip ID.
   std::vector<ChipPixelData> mChipsOld; // previously processed chips data (for masking)
 
-  // buffers for entries in mPreClusterIndices in 2 columns, to avoid boundary checks, we reserve
-  // extra elements in the beginning and the end
-  int mColumn1[SegmentationAlpide::NRows + 2];
-  int mColumn2[SegmentationAlpide::NRows + 2];
-  int* mCurr; // pointer on the 1st row of currently processed mColumnsX
-  int* mPrev; // pointer on the 1st row of previously processed mColumnsX
-
   o2::itsmft::ROFRecord mROFRef; // ROF reference
 
-  // mPixels[].first is the index of the next pixel of the same precluster in the mPixels
-  // mPixels[].second is the index of the referred pixel in the ChipPixelData (element of mChips)
-  std::vector<std::pair<int, UInt_t>> mPixels;
-  std::vector<int> mPreClusterHeads; // index of precluster head in the mPixels
-  std::vector<int> mPreClusterIndices;
-  UShort_t mCol = 0xffff; ///< Column being processed
-
-  bool mNoLeftColumn = true;                           ///< flag that there is no column on the left to check
   const o2::itsmft::GeometryTGeo* mGeometry = nullptr; //! ITS OR MFT upgrade geometry
 
-  TTree* mClusTree = nullptr;                                      //! externally provided tree to write clusters output (if needed)
-  std::array<Label, Cluster::maxLabels> mLabelsBuff;               //! temporary buffer for building cluster labels
-  std::array<PixelData, Cluster::kMaxPatternBits * 2> mPixArrBuff; //! temporary buffer for pattern calc.
+  TTree* mClusTree = nullptr; //! externally provided tree to write clusters output (if needed)
 
   LookUp mPattIdConverter; //! Convert the cluster topology to the corresponding entry in the dictionary.
 
@@ -252,191 +299,211 @@ void Clusterer::process(PixelReader& reader, FullClusCont* fullClus, CompClusCon
   mTimer.Start(kFALSE);
 #endif
 
-  o2::itsmft::ROFRecord* rof = nullptr;
-  auto clustersCount = compClus->size(); // RSTODO: in principle, the compClus is never supposed to be 0
-
-  while ((mChipData = reader.getNextChipData(mChips))) {
-    if (!rof || !(mChipData->getInteractionRecord() == rof->getBCData())) { // new ROF starts
-      if (rof) {                                                            // finalize previous slot
-        auto cntUpd = compClus->size();
-        rof->setNEntries(cntUpd - clustersCount); // update
-        clustersCount = cntUpd;
-        if (mClusTree) {  // if necessary, flush existing data
-          mROFRef = *rof; // just for the legacy way of writing to the tree
-          flushClusters(fullClus, compClus, labelsCl);
+  // The chips are fetched in batches of complete ROFs, masked against their data in the previous ROF
+  // (which may belong to the same batch) and clusterized in parallel once the batch is large enough
+  int nChips = 0;                    // number of chips fetched in the current batch
+  auto firstROF = vecROFRec->size(); // entry of the 1st ROF of the current batch
+  bool rofStarted = false;
+
+  while (true) {
+    if (nChips == int(mChipsBatch.size())) {
+      mChipsBatch.emplace_back();
+    }
+    bool fetched = reader.getNextChipData(mChipsBatch[nChips]);
+    if (!fetched || !rofStarted || !(mChipsBatch[nChips].getInteractionRecord() == vecROFRec->back().getBCData())) { // new ROF starts
+      if (nChips && (!fetched || mClusTree || nChips >= mNThreads * MinChipsPerTask)) { // clusterize complete ROFs
+        processBatch(nChips, firstROF, fullClus, compClus, patterns, vecROFRec, reader.getDigitsMCTruth(), labelsCl);
+        if (fetched) {
+          mChipsBatch[0].swap(mChipsBatch[nChips]); // the chip of the new ROF is the 1st one of the next batch
         }
+        nChips = 0;
+        firstROF = vecROFRec->size();
+      }
+      if (!fetched) {
+        break;
       }
-      rof = &vecROFRec->emplace_back(mChipData->getInteractionRecord(), mChipData->getROFrame(), clustersCount, 0); // create new ROF
+      const auto& chipData = mChipsBatch[nChips];
+      vecROFRec->emplace_back(chipData.getInteractionRecord(), chipData.getROFrame(), compClus->size(), 0); // entries are set by processBatch
+      mBatchROFFirstChip.push_back(nChips);
+      rofStarted = true;
     }
-    auto chipID = mChipData->getChipID();
-
+    auto& chipData = mChipsBatch[nChips];
     if (mMaxBCSeparationToMask > 0) { // mask pixels fired from the previous ROF
-      if (mChipsOld.size() < mChips.size()) {
-        mChipsOld.resize(mChips.size()); // expand buffer of previous ROF data
+      auto chipID = chipData.getChipID();
+      if (mChipsOld.size() <= chipID) {
+        setNChips(chipID + 1); // expand buffer of previous ROF data
       }
-      const auto& chipInPrevROF = mChipsOld[chipID];
-      if (std::abs(rof->getBCData().differenceInBC(chipInPrevROF.getInteractionRecord())) < mMaxBCSeparationToMask) {
-        mChipData->maskFiredInSample(mChipsOld[chipID]);
+      int prevEntry = mChipLastInBatch[chipID];
+      const auto& chipInPrevROF = prevEntry < 0 ? mChipsOld[chipID] : mChipsBatch[prevEntry];
+      if (std::abs(vecROFRec->back().getBCData().differenceInBC(chipInPrevROF.getInteractionRecord())) < mMaxBCSeparationToMask) {
+        chipData.maskFiredInSample(chipInPrevROF);
       }
+      mChipLastInBatch[chipID] = nChips;
     }
-    auto validPixID = mChipData->getFirstUnmasked();
-
-    if (validPixID < mChipData->getData().size()) { // chip data may have all of its pixels masked!
-      initChip(validPixID++);
-      for (; validPixID < mChipData->getData().size(); validPixID++) {
-        if (!mChipData->getData()[validPixID].isMasked()) {
-          updateChip(validPixID);
-        }
-      }
-      finishChip(fullClus, compClus, patterns, reader.getDigitsMCTruth(), labelsCl);
-    }
-    if (mMaxBCSeparationToMask > 0) { // current chip data will be used in the next ROF to mask overflow pixels
-      mChipsOld[chipID].swap(*mChipData);
-    }
-  }
-  // finalize last ROF
-  if (rof) {
-    auto cntUpd = compClus->size();
-    rof->setNEntries(cntUpd - clustersCount); // update
-    if (mClusTree) {                          // if necessary, flush existing data
-      mROFRef = *rof;
-      flushClusters(fullClus, compClus, labelsCl);
-    }
+    nChips++;
   }
 #ifdef _PERFORM_TIMING_
   mTimer.Stop();
 #endif
 }
 
-/*
 //__________________________________________________
-template<class FullClusCont, class  CompClusCont, class PatternCont, class ROFRecCont>
-void Clusterer::process(PixelReader& reader, FullClusCont* fullClus, CompClusCont* compClus,
-                        PatternCont* patterns, ROFRecCont* vecROFRec, MCTruth* labelsCl)
+template <class FullClusCont, class CompClusCont, class PatternCont, class ROFRecCont>
+void Clusterer::processBatch(int nChips, size_t firstROF, FullClusCont* fullClus, CompClusCont* compClus, PatternCont* patterns,
+                             ROFRecCont* vecROFRec, const MCTruth* labelsDig, MCTruth* labelsCl)
 {
-
-#ifdef _PERFORM_TIMING_
-  mTimer.Start(kFALSE);
-#endif
-  mClustersCount = compClus ? compClus->size() : (fullClus ? fullClus->size() : 0);
-
-  while ((mChipData = reader.getNextChipData(mChips))) { // read next chip data to corresponding
-    // vector in the mChips and return the pointer on it 
-    if (!(mChipData->getInteractionRecord() == mROFRef.getBCData())) { // new ROF starts
-      mROFRef.setNEntries(mClustersCount - mROFRef.getEntry().getFirstEntry()); // number of entries in previous ROF
-      if (!mROFRef.getBCData().isDummy()) {
-        if (mClusTree) { // if necessary, flush existing data
-          mROFRef.setFirstEntry(mClusTree->GetEntries());
-          flushClusters(fullClus, compClus, labelsCl);
-        }
-        if (vecROFRec) {
-          vecROFRec->emplace_back(mROFRef);
-        }
-      }
-      mROFRef.getEntry().setFirstEntry(mClustersCount);
-      mROFRef.getBCData() = mChipData->getInteractionRecord();
-      mROFRef.setROFrame(mChipData->getROFrame()); // TODO: outphase this
+  auto clustersCount = compClus->size();
+  mChipNClusters.resize(nChips);
+  int nTasks = std::min(mNThreads, (nChips + MinChipsPerTask - 1) / MinChipsPerTask);
+  if (nTasks < 2) { // write directly to the output
+    mThreads[0]->process(0, nChips, fullClus, compClus, patterns, labelsDig, labelsCl);
+  } else {
+    // split the batch in ranges of consecutive chips with similar numbers of pixels
+    size_t nPixels = 0, nPixelsCumul = 0;
+    for (int ic = 0; ic < nChips; ic++) {
+      nPixels += mChipsBatch[ic].getData().size();
     }
-
-    auto chipID = mChipData->getChipID();
-    
-    if (mMaxBCSeparationToMask > 0) { // mask pixels fired from the previous ROF
-      if (mChipsOld.size() < mChips.size()) {
-        mChipsOld.resize(mChips.size()); // expand buffer of previous ROF data
-      }
-      const auto& chipInPrevROF = mChipsOld[chipID];
-      if (std::abs(mROFRef.getBCData().differenceInBC(chipInPrevROF.getInteractionRecord())) < mMaxBCSeparationToMask) {
-        mChipData->maskFiredInSample(mChipsOld[chipID]);
+    mTaskFirstChip.resize(nTasks + 1);
+    mTaskFirstChip[0] = 0;
+    int iTask = 1;
+    for (int ic = 0; ic < nChips && iTask < nTasks; ic++) {
+      nPixelsCumul += mChipsBatch[ic].getData().size();
+      while (iTask < nTasks && nPixelsCumul * nTasks >= nPixels * iTask) {
+        mTaskFirstChip[iTask++] = ic + 1;
       }
     }
-    auto validPixID = mChipData->getFirstUnmasked();
-    
-    if (validPixID < mChipData->getData().size()) { // chip data may have all of its pixels masked!
-      initChip(validPixID++);
-      for (; validPixID < mChipData->getData().size(); validPixID++) {
-        if (!mChipData->getData()[validPixID].isMasked()) {
-          updateChip(validPixID);
+    for (; iTask <= nTasks; iTask++) {
+      mTaskFirstChip[iTask] = nChips;
+    }
+    o2::utils::runParallel(nTasks, size_t(nTasks), [&](size_t iTask) {
+      auto& thread = *mThreads[iTask];
+      thread.clearOutput();
+      thread.process(mTaskFirstChip[iTask], mTaskFirstChip[iTask + 1], fullClus ? &thread.fullClusters : nullptr, &thread.compClusters,
+                     patterns ? &thread.patterns : nullptr, labelsDig, labelsCl ? &thread.labels : nullptr);
+    });
+    for (int iTask = 0; iTask < nTasks; iTask++) { // concatenate in chip order
+      const auto& thread = *mThreads[iTask];
+      if (fullClus) {
+        fullClus->insert(fullClus->end(), thread.fullClusters.begin(), thread.fullClusters.end());
+      }
+      if (labelsCl) {
+        for (size_t i = 0; i < thread.labels.getIndexedSize(); i++) {
+          for (const auto& lbl : thread.labels.getLabels(i)) {
+            labelsCl->addElement(compClus->size() + i, lbl);
+          }
         }
       }
-      finishChip(fullClus, compClus, patterns, reader.getDigitsMCTruth(), labelsCl);
-    }
-    if (mMaxBCSeparationToMask > 0) { // current chip data will be used in the next ROF to mask overflow pixels
-      mChipsOld[chipID].swap(*mChipData);
+      compClus->insert(compClus->end(), thread.compClusters.begin(), thread.compClusters.end());
+      if (patterns) {
+        patterns->insert(patterns->end(), thread.patterns.begin(), thread.patterns.end());
+      }
     }
   }
-  mROFRef.setNEntries(mClustersCount - mROFRef.getEntry().getFirstEntry()); // number of entries in this ROF
 
-  // flush last ROF
-  if (!mROFRef.getBCData().isDummy()) {
-    if (mClusTree) { // if necessary, flush existing data
-      mROFRef.setFirstEntry(mClusTree->GetEntries());
+  for (auto irof = firstROF; irof < vecROFRec->size(); irof++) {
+    int rofInBatch = irof - firstROF;
+    int lastChip = rofInBatch + 1 < int(mBatchROFFirstChip.size()) ? mBatchROFFirstChip[rofInBatch + 1] : nChips;
+    int nClusters = 0;
+    for (int ic = mBatchROFFirstChip[rofInBatch]; ic < lastChip; ic++) {
+      nClusters += mChipNClusters[ic];
+    }
+    auto& rof = (*vecROFRec)[irof];
+    rof.setFirstEntry(clustersCount);
+    rof.setNEntries(nClusters);
+    clustersCount += nClusters;
+    if (mClusTree) { // if necessary, flush existing data, there is a single ROF per batch in this mode
+      mROFRef = rof; // just for the legacy way of writing to the tree
       flushClusters(fullClus, compClus, labelsCl);
     }
-    if (vecROFRec) {
-      vecROFRec->emplace_back(mROFRef); // the ROFrecords vector is stored outside, in a single entry of the tree
+  }
+  mBatchROFFirstChip.clear();
+
+  if (mMaxBCSeparationToMask > 0) { // last data of each chip will be used in the next batch to mask overflow pixels
+    for (int ic = 0; ic < nChips; ic++) {
+      auto chipID = mChipsBatch[ic].getChipID();
+      if (mChipLastInBatch[chipID] == ic) {
+        mChipsOld[chipID].swap(mChipsBatch[ic]);
+        mChipLastInBatch[chipID] = -1;
+      }
     }
   }
-#ifdef _PERFORM_TIMING_
-  mTimer.Stop();
-#endif
 }
 
- */
+//__________________________________________________
+template <class FullClusCont, class CompClusCont, class PatternCont>
+void Clusterer::ClustererThread::process(int firstChip, int lastChip, FullClusCont* fullClusPtr, CompClusCont* compClusPtr,
+                                         PatternCont* patternsPtr, const MCTruth* labelsDigPtr, MCTruth* labelsClusPtr)
+{
+  for (int ic = firstChip; ic < lastChip; ic++) {
+    chipData = &parent->mChipsBatch[ic];
+    auto nClustersBefore = compClusPtr->size();
+    auto validPixID = chipData->getFirstUnmasked();
+    if (validPixID < chipData->getData().size()) { // chip data may have all of its pixels masked!
+      initChip(validPixID++);
+      for (; validPixID < chipData->getData().size(); validPixID++) {
+        if (!chipData->getData()[validPixID].isMasked()) {
+          updateChip(validPixID);
+        }
+      }
+      finishChip(fullClusPtr, compClusPtr, patternsPtr, labelsDigPtr, labelsClusPtr);
+    }
+    parent->mChipNClusters[ic] = compClusPtr->size() - nClustersBefore;
+  }
+}
 
 //__________________________________________________
 template <class FullClusCont, class CompClusCont, class PatternCont>
-void Clusterer::finishChip(FullClusCont* fullClus, CompClusCont* compClus, PatternCont* patterns,
-                           const MCTruth* labelsDig, MCTruth* labelsClus)
+void Clusterer::ClustererThread::finishChip(FullClusCont* fullClusPtr, CompClusCont* compClusPtr, PatternCont* patternsPtr,
+                                            const MCTruth* labelsDigPtr, MCTruth* labelsClusPtr)
 {
   constexpr Float_t SigmaX2 = SegmentationAlpide::PitchRow * SegmentationAlpide::PitchRow / 12.; // FIXME
   constexpr Float_t SigmaY2 = SegmentationAlpide::PitchCol * SegmentationAlpide::PitchCol / 12.; // FIXME
-  auto clustersCount = compClus->size();
-  const auto& pixData = mChipData->getData();
-  int nadd = 0;
-  for (int i1 = 0; i1 < mPreClusterHeads.size(); ++i1) {
-    const auto ci = mPreClusterIndices[i1];
+  const auto& pixData = chipData->getData();
+  const auto& pattIdConverter = parent->mPattIdConverter;
+  for (int i1 = 0; i1 < preClusterHeads.size(); ++i1) {
+    const auto ci = preClusterIndices[i1];
     if (ci < 0) {
       continue;
     }
     UShort_t rowMax = 0, rowMin = 65535;
     UShort_t colMax = 0, colMin = 65535;
     int nlab = 0, npix = 0;
-    int next = mPreClusterHeads[i1];
+    int next = preClusterHeads[i1];
     while (next >= 0) {
-      const auto& pixEntry = mPixels[next];
+      const auto& pixEntry = pixels[next];
       const auto pix = pixData[pixEntry.second];
-      if (npix < mPixArrBuff.size()) {
-        mPixArrBuff[npix++] = pix; // needed for cluster topology
+      if (npix < pixArrBuff.size()) {
+        pixArrBuff[npix++] = pix; // needed for cluster topology
         adjustBoundingBox(pix, rowMin, rowMax, colMin, colMax);
-        if (labelsClus) { // the MCtruth for this pixel is at mChipData->startID+pixEntry.second
-          fetchMCLabels(pixEntry.second + mChipData->getStartID(), labelsDig, nlab);
+        if (labelsClusPtr) { // the MCtruth for this pixel is at chipData->startID+pixEntry.second
+          fetchMCLabels(pixEntry.second + chipData->getStartID(), labelsDigPtr, nlab);
         }
         next = pixEntry.first;
       }
     }
-    mPreClusterIndices[i1] = -1;
-    for (int i2 = i1 + 1; i2 < mPreClusterHeads.size(); ++i2) {
-      if (mPreClusterIndices[i2] != ci) {
+    preClusterIndices[i1] = -1;
+    for (int i2 = i1 + 1; i2 < preClusterHeads.size(); ++i2) {
+      if (preClusterIndices[i2] != ci) {
         continue;
       }
-      next = mPreClusterHeads[i2];
+      next = preClusterHeads[i2];
       while (next >= 0) {
-        const auto& pixEntry = mPixels[next];
+        const auto& pixEntry = pixels[next];
         const auto pix = pixData[pixEntry.second]; // PixelData
-        if (npix < mPixArrBuff.size()) {
-          mPixArrBuff[npix++] = pix; // needed for cluster topology
+        if (npix < pixArrBuff.size()) {
+          pixArrBuff[npix++] = pix; // needed for cluster topology
           adjustBoundingBox(pix, rowMin, rowMax, colMin, colMax);
-          if (labelsClus) { // the MCtruth for this pixel is at mChipData->startID+pixEntry.second
-            fetchMCLabels(pixEntry.second + mChipData->getStartID(), labelsDig, nlab);
+          if (labelsClusPtr) { // the MCtruth for this pixel is at chipData->startID+pixEntry.second
+            fetchMCLabels(pixEntry.second + chipData->getStartID(), labelsDigPtr, nlab);
           }
           next = pixEntry.first;
         }
       }
-      mPreClusterIndices[i2] = -1;
+      preClusterIndices[i2] = -1;
     }
     UShort_t rowSpan = rowMax - rowMin + 1, colSpan = colMax - colMin + 1;
     Cluster clus;
-    clus.setSensorID(mChipData->getChipID());
+    clus.setSensorID(chipData->getChipID());
     clus.setNxNzN(rowSpan, colSpan, npix);
     UShort_t colSpanW = colSpan, rowSpanW = rowSpan;
     if (colSpan * rowSpan > Cluster::kMaxPatternBits) { // need to store partial info
@@ -459,61 +526,61 @@ void Clusterer::finishChip(FullClusCont* fullClus, CompClusCont* compClus, Patte
     clus.setPatternRowMin(rowMin);
     clus.setPatternColMin(colMin);
     for (int i = 0; i < npix; i++) {
-      const auto pix = mPixArrBuff[i];
+      const auto pix = pixArrBuff[i];
       unsigned short ir = pix.getRowDirect() - rowMin, ic = pix.getCol() - colMin;
       if (ir < rowSpanW && ic < colSpanW) {
         clus.setPixel(ir, ic);
       }
     }
-#endif              //_ClusterTopology_
-    if (fullClus) { // do we need conventional clusters with full topology and coordinates?
-      fullClus->push_back(clus);
-      Cluster& c = fullClus->back();
+#endif                 //_ClusterTopology_
+    if (fullClusPtr) { // do we need conventional clusters with full topology and coordinates?
+      fullClusPtr->push_back(clus);
+      Cluster& c = fullClusPtr->back();
       Float_t x = 0., z = 0.;
       for (int i = npix; i--;) {
-        x += mPixArrBuff[i].getRowDirect();
-        z += mPixArrBuff[i].getCol();
+        x += pixArrBuff[i].getRowDirect();
+        z += pixArrBuff[i].getCol();
       }
       Point3D<float> xyzLoc;
       SegmentationAlpide::detectorToLocalUnchecked(x / npix, z / npix, xyzLoc);
-      auto xyzTra = mGeometry->getMatrixT2L(mChipData->getChipID()) ^ (xyzLoc); // inverse transform from Local to Tracking frame
+      auto xyzTra = parent->mGeometry->getMatrixT2L(chipData->getChipID()) ^ (xyzLoc); // inverse transform from Local to Tracking frame
       c.setPos(xyzTra);
       c.setErrors(SigmaX2, SigmaY2, 0.f);
     }
 
-    if (labelsClus) { // MC labels were requested
-      auto cnt = compClus->size();
+    if (labelsClusPtr) { // MC labels were requested
+      auto cnt = compClusPtr->size();
       for (int i = nlab; i--;) {
-        labelsClus->addElement(cnt, mLabelsBuff[i]);
+        labelsClusPtr->addElement(cnt, labelsBuff[i]);
       }
     }
 
     // add to compact clusters, which must be always filled
     unsigned char patt[Cluster::kMaxPatternBytes] = {0}; // RSTODO FIX pattern filling
     for (int i = 0; i < npix; i++) {
-      const auto pix = mPixArrBuff[i];
+      const auto pix = pixArrBuff[i];
       unsigned short ir = pix.getRowDirect() - rowMin, ic = pix.getCol() - colMin;
       if (ir < rowSpanW && ic < colSpanW) {
         int nbits = ir * colSpanW + ic;
         patt[nbits >> 3] |= (0x1 << (7 - (nbits % 8)));
       }
     }
-    UShort_t pattID = (mPattIdConverter.size() == 0) ? CompCluster::InvalidPatternID : mPattIdConverter.findGroupID(rowSpanW, colSpanW, patt);
-    if (pattID == CompCluster::InvalidPatternID || mPattIdConverter.isGroup(pattID)) {
+    UShort_t pattID = (pattIdConverter.size() == 0) ? CompCluster::InvalidPatternID : pattIdConverter.findGroupID(rowSpanW, colSpanW, patt);
+    if (pattID == CompCluster::InvalidPatternID || pattIdConverter.isGroup(pattID)) {
       float xCOG = 0., zCOG = 0.;
       ClusterPattern::getCOG(rowSpanW, colSpanW, patt, xCOG, zCOG);
       rowMin += round(xCOG);
       colMin += round(zCOG);
-      if (patterns) {
-        patterns->emplace_back((unsigned char)rowSpanW);
-        patterns->emplace_back((unsigned char)colSpanW);
+      if (patternsPtr) {
+        patternsPtr->emplace_back((unsigned char)rowSpanW);
+        patternsPtr->emplace_back((unsigned char)colSpanW);
         int nBytes = rowSpanW * colSpanW / 8;
         if (((rowSpanW * colSpanW) % 8) != 0)
           nBytes++;
-        patterns->insert(patterns->end(), std::begin(patt), std::begin(patt) + nBytes);
+        patternsPtr->insert(patternsPtr->end(), std::begin(patt), std::begin(patt) + nBytes);
       }
     }
-    compClus->emplace_back(rowMin, colMin, pattID, mChipData->getChipID());
+    compClusPtr->emplace_back(rowMin, colMin, pattID, chipData->getChipID());
   }
 }
 
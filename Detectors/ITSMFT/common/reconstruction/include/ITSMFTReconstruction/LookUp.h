@@ -35,13 +35,16 @@ class LookUp
   LookUp();
   LookUp(std::string fileName);
   static int groupFinder(int nRow, int nCol);
-  int findGroupID(int nRow, int nCol, const unsigned char patt[Cluster::kMaxPatternBytes]);
+  int findGroupID(int nRow, int nCol, const unsigned char patt[Cluster::kMaxPatternBytes]) const;
   int getTopologiesOverThreshold() { return mTopologiesOverThreshold; }
   void loadDictionary(std::string fileName);
   bool isGroup(int id) const;
   int size() const { return mDictionary.getSize(); }
 
  private:
+  /// ID of the group of a rare topology, CompCluster::InvalidPatternID if the dictionary has no such group
+  int findRareGroupID(int nRow, int nCol) const;
+
   TopologyDictionary mDictionary;
   int mTopologiesOverThreshold;
 
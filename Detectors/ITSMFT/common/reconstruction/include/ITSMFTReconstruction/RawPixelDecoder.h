@@ -63,6 +63,9 @@ class RawPixelDecoder : public PixelReader
   void setVerbosity(int v);
   int getVerbosity() const { return mVerbosity; }
 
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
   bool getDecodeNextAuto() const { return mDecodeNextAuto; }
   void setDecodeNextAuto(bool v) { mDecodeNextAuto = v; }
 
@@ -87,6 +90,8 @@ class RawPixelDecoder : public PixelReader
   GBTLink* getGBTLink(int i) { return i < 0 ? nullptr : &mGBTLinks[i]; }
   const GBTLink* getGBTLink(int i) const { return i < 0 ? nullptr : &mGBTLinks[i]; }
   RUDecodeData& getCreateRUDecode(int ruSW);
+  int decodeRUTrigger(int iru, int& linkIR);
+  void updateInteractionRecord(const GBTLink& link);
 
   static constexpr uint16_t NORUDECODED = 0xffff; // this must be > than max N RUs
 
@@ -98,6 +103,10 @@ class RawPixelDecoder : public PixelReader
   uint16_t mCurRUDecodeID = NORUDECODED;        // index of currently processed RUDecode container
   Mapping mMAP;                                 // chip mapping
   int mVerbosity = 0;
+  int mNThreads = 1; // number of threads decoding the RUs in parallel
+
+  std::vector<int> mRUNLinksWithData; // number of links with data of every RU in the current trigger
+  std::vector<int> mRULinkIR;         // link with the earliest interaction record of every RU in the current trigger
 
   // statistics
   o2::itsmft::ROFRecord::ROFtype mROFCounter = 0; // RSTODO is this needed? eliminate from ROFRecord ?
@@ -13,6 +13,7 @@
 
 #include "ITSMFTReconstruction/AlpideCoder.h"
 #include <TClass.h>
+#include <array>
 
 using namespace o2::itsmft;
 
@@ -30,6 +31,33 @@ void AlpideCoder::print() const
   }
 }
 
+//_____________________________________
+const AlpideCoder::HitMapHits* AlpideCoder::getHitMapTable()
+{
+  // hits of the hit map of the DATALONG record with given pixel ID, in the same order as the bits of the map
+  static const auto table = []() {
+    std::array<HitMapHits, 4 << HitMapSize> tbl;
+    for (int pixID = 0; pixID < 4; pixID++) {
+      for (int hitMap = 0; hitMap < (1 << HitMapSize); hitMap++) {
+        auto& hits = tbl[(pixID << HitMapSize) | hitMap];
+        for (int ip = 0; ip < HitMapSize; ip++) {
+          if (hitMap & (0x1 << ip)) {
+            int addr = pixID + ip + 1, dRow = (addr >> 1) - (pixID >> 1);
+            bool rightC = ((addr >> 1) & 0x1) ? !(addr & 0x1) : (addr & 0x1);
+            if (rightC) {
+              hits.dRowRight[hits.nRight++] = dRow;
+            } else {
+              hits.dRowLeft[hits.nLeft++] = dRow;
+            }
+          }
+        }
+      }
+    }
+    return tbl;
+  }();
+  return table.data();
+}
+
 //_____________________________________
 void AlpideCoder::reset()
 {
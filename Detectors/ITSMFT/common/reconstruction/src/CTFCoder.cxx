@@ -0,0 +1,164 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFCoder.cxx
+/// \brief Compressed time frame (CTF) coding of the ITS/MFT compact clusters
+
+#include "ITSMFTReconstruction/CTFCoder.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace o2::itsmft;
+
+namespace
+{
+/// flags the clusters starting a ROF, where the chip and column increments restart
+std::vector<bool> getROFStarts(gsl::span<const ROFRecord> rofs, size_t nClusters)
+{
+  std::vector<bool> starts(nClusters, false);
+  for (const auto& rof : rofs) {
+    if (rof.getFirstEntry() >= 0 && size_t(rof.getFirstEntry()) < nClusters) {
+      starts[rof.getFirstEntry()] = true;
+    }
+  }
+  return starts;
+}
+} // namespace
+
+void CTFCoder::encode(o2::detectors::DetID det, gsl::span<const ROFRecord> rofs, gsl::span<const CompClusterExt> clusters,
+                      gsl::span<const unsigned char> patterns, std::vector<char>& output, int nThreads)
+{
+  using T = CTFTraits;
+  CTFTraits::Header header;
+  header.nROFs = rofs.size();
+  header.nClusters = clusters.size();
+  header.nPatternBytes = patterns.size();
+  if (!rofs.empty()) {
+    header.firstOrbit = rofs[0].getBCData().orbit;
+    header.firstBC = rofs[0].getBCData().bc;
+    header.firstROFrame = rofs[0].getROFrame();
+  }
+
+  CTFTraits::Columns columns;
+  auto& orbitInc = std::get<T::BLCorbitIncROF>(columns);
+  auto& bcInc = std::get<T::BLCbcIncROF>(columns);
+  auto& nClusters = std::get<T::BLCnClustersROF>(columns);
+  auto& firstEntry = std::get<T::BLCfirstEntryROF>(columns);
+  auto& rofInc = std::get<T::BLCrofIncROF>(columns);
+  auto prevIR = o2::InteractionRecord(header.firstBC, header.firstOrbit);
+  uint32_t prevROFrame = header.firstROFrame;
+  uint32_t nextEntry = 0;
+  for (const auto& rof : rofs) {
+    const auto& ir = rof.getBCData();
+    orbitInc.push_back(ir.orbit - prevIR.orbit);
+    bcInc.push_back(ir.orbit == prevIR.orbit ? uint16_t(ir.bc - prevIR.bc) : ir.bc);
+    nClusters.push_back(rof.getNEntries());
+    firstEntry.push_back(uint32_t(rof.getFirstEntry()) - nextEntry);
+    rofInc.push_back(rof.getROFrame() - prevROFrame);
+    prevIR = ir;
+    prevROFrame = rof.getROFrame();
+    nextEntry = uint32_t(rof.getFirstEntry()) + uint32_t(rof.getNEntries());
+  }
+
+  auto& chipInc = std::get<T::BLCchipInc>(columns);
+  auto& colInc = std::get<T::BLCcolInc>(columns);
+  auto& row = std::get<T::BLCrow>(columns);
+  auto& pattID = std::get<T::BLCpattID>(columns);
+  chipInc.reserve(clusters.size());
+  colInc.reserve(clusters.size());
+  row.reserve(clusters.size());
+  pattID.reserve(clusters.size());
+  auto starts = getROFStarts(rofs, clusters.size());
+  uint16_t prevChip = 0, prevCol = 0;
+  for (size_t i = 0; i < clusters.size(); i++) {
+    const auto& cl = clusters[i];
+    if (starts[i]) {
+      prevChip = 0;
+      prevCol = 0;
+    }
+    chipInc.push_back(cl.getChipID() - prevChip);
+    colInc.push_back(cl.getChipID() == prevChip ? uint16_t(cl.getCol() - prevCol) : cl.getCol());
+    row.push_back(cl.getRow());
+    pattID.push_back(cl.getPatternID() | (cl.getFlag() << CompCluster::NBitsPattID));
+    prevChip = cl.getChipID();
+    prevCol = cl.getCol();
+  }
+  std::get<T::BLCpattern>(columns).assign(patterns.begin(), patterns.end());
+
+  Coder::encode(det, header, columns, output, nThreads);
+}
+
+void CTFCoder::decode(o2::detectors::DetID det, const char* data, size_t size, std::vector<ROFRecord>& rofs,
+                      std::vector<CompClusterExt>& clusters, std::vector<unsigned char>& patterns, int nThreads)
+{
+  using T = CTFTraits;
+  CTFTraits::Header header;
+  CTFTraits::Columns columns;
+  Coder::decode(det, data, size, header, columns, nThreads);
+
+  const auto& orbitInc = std::get<T::BLCorbitIncROF>(columns);
+  const auto& bcInc = std::get<T::BLCbcIncROF>(columns);
+  const auto& nClusters = std::get<T::BLCnClustersROF>(columns);
+  const auto& firstEntry = std::get<T::BLCfirstEntryROF>(columns);
+  const auto& rofInc = std::get<T::BLCrofIncROF>(columns);
+  if (orbitInc.size() != header.nROFs || bcInc.size() != header.nROFs || nClusters.size() != header.nROFs ||
+      firstEntry.size() != header.nROFs || rofInc.size() != header.nROFs) {
+    throw std::runtime_error(std::string("CTF: inconsistent ROF columns of ") + det.getName());
+  }
+  rofs.resize(header.nROFs);
+  auto prevIR = o2::InteractionRecord(header.firstBC, header.firstOrbit);
+  uint32_t prevROFrame = header.firstROFrame;
+  uint32_t nextEntry = 0;
+  for (size_t i = 0; i < rofs.size(); i++) {
+    auto ir = prevIR;
+    if (orbitInc[i]) {
+      ir.orbit += orbitInc[i];
+      ir.bc = bcInc[i];
+    } else {
+      ir.bc += bcInc[i];
+    }
+    auto& rof = rofs[i];
+    rof.setBCData(ir);
+    rof.setROFrame(prevROFrame + rofInc[i]);
+    rof.setFirstEntry(int(nextEntry + firstEntry[i]));
+    rof.setNEntries(int(nClusters[i]));
+    prevIR = ir;
+    prevROFrame = rof.getROFrame();
+    nextEntry = uint32_t(rof.getFirstEntry()) + nClusters[i];
+  }
+
+  const auto& chipInc = std::get<T::BLCchipInc>(columns);
+  const auto& colInc = std::get<T::BLCcolInc>(columns);
+  const auto& row = std::get<T::BLCrow>(columns);
+  const auto& pattID = std::get<T::BLCpattID>(columns);
+  if (chipInc.size() != header.nClusters || colInc.size() != header.nClusters || row.size() != header.nClusters ||
+      pattID.size() != header.nClusters || std::get<T::BLCpattern>(columns).size() != header.nPatternBytes) {
+    throw std::runtime_error(std::string("CTF: inconsistent cluster columns of ") + det.getName());
+  }
+  clusters.resize(header.nClusters);
+  auto starts = getROFStarts(rofs, clusters.size());
+  uint16_t prevChip = 0, prevCol = 0;
+  for (size_t i = 0; i < clusters.size(); i++) {
+    if (starts[i]) {
+      prevChip = 0;
+      prevCol = 0;
+    }
+    uint16_t chip = prevChip + chipInc[i];
+    uint16_t col = chip == prevChip ? uint16_t(prevCol + colInc[i]) : colInc[i];
+    auto& cl = clusters[i];
+    cl.set(row[i], col, pattID[i], chip);
+    cl.setFlag(pattID[i] >> CompCluster::NBitsPattID);
+    prevChip = chip;
+    prevCol = col;
+  }
+  const auto& pattern = std::get<T::BLCpattern>(columns);
+  patterns.assign(pattern.begin(), pattern.end());
+}
@@ -23,10 +23,9 @@ Clusterer::~Clusterer()
 }
 
 //__________________________________________________
-Clusterer::Clusterer() : mPattIdConverter(), mCurr(mColumn2 + 1), mPrev(mColumn1 + 1)
+Clusterer::Clusterer() : mPattIdConverter()
 {
-  std::fill(std::begin(mColumn1), std::end(mColumn1), -1);
-  std::fill(std::begin(mColumn2), std::end(mColumn2), -1);
+  mThreads.emplace_back(std::make_unique<ClustererThread>(this));
   mROFRef.clear();
 #ifdef _ClusterTopology_
   LOG(INFO) << "*********************************************************************";
@@ -40,57 +39,66 @@ Clusterer::Clusterer() : mPattIdConverter(), mCurr(mColumn2 + 1), mPrev(mColumn1
 }
 
 //__________________________________________________
-void Clusterer::initChip(UInt_t first)
+void Clusterer::setNThreads(int n)
 {
-  // init chip with the 1st unmasked pixel (entry "from" in the mChipData)
-  mPrev = mColumn1 + 1;
-  mCurr = mColumn2 + 1;
-  resetColumn(mCurr);
+  mNThreads = n > 0 ? n : 1;
+  while (int(mThreads.size()) < mNThreads) {
+    mThreads.emplace_back(std::make_unique<ClustererThread>(this));
+  }
+}
+
+//__________________________________________________
+void Clusterer::ClustererThread::initChip(UInt_t first)
+{
+  // init chip with the 1st unmasked pixel (entry "from" in the chipData)
+  prev = column1 + 1;
+  curr = column2 + 1;
+  resetColumn(curr);
 
-  mPixels.clear();
-  mPreClusterHeads.clear();
-  mPreClusterIndices.clear();
-  auto pix = mChipData->getData()[first];
-  mCol = pix.getCol();
+  pixels.clear();
+  preClusterHeads.clear();
+  preClusterIndices.clear();
+  auto pix = chipData->getData()[first];
+  col = pix.getCol();
 
   //addNewPrecluster(first, pix.getRowDirect()); // save on .size() calls ?
-  mCurr[pix.getRowDirect()] = 0; // can use getRowDirect since the pixel is not masked
+  curr[pix.getRowDirect()] = 0; // can use getRowDirect since the pixel is not masked
   // start the first pre-cluster
-  mPreClusterHeads.push_back(0);
-  mPreClusterIndices.push_back(0);
-  mPixels.emplace_back(-1, first); // id of current pixel
-  mNoLeftColumn = true;            // flag that there is no column on the left to check yet
+  preClusterHeads.push_back(0);
+  preClusterIndices.push_back(0);
+  pixels.emplace_back(-1, first); // id of current pixel
+  noLeftColumn = true;            // flag that there is no column on the left to check yet
 }
 
 //__________________________________________________
-void Clusterer::updateChip(UInt_t ip)
+void Clusterer::ClustererThread::updateChip(UInt_t ip)
 {
-  const auto pix = mChipData->getData()[ip];
+  const auto pix = chipData->getData()[ip];
   UShort_t row = pix.getRowDirect(); // can use getRowDirect since the pixel is not masked
-  if (mCol != pix.getCol()) {        // switch the buffers
+  if (col != pix.getCol()) {         // switch the buffers
     swapColumnBuffers();
-    resetColumn(mCurr);
-    mNoLeftColumn = false;
-    if (pix.getCol() > mCol + 1) {
+    resetColumn(curr);
+    noLeftColumn = false;
+    if (pix.getCol() > col + 1) {
       // no connection with previous column, this pixel cannot belong to any of the
       // existing preclusters, create a new precluster and flag to check only the row above for next pixels of this column
-      mCol = pix.getCol();
+      col = pix.getCol();
       addNewPrecluster(ip, row);
-      mNoLeftColumn = true;
+      noLeftColumn = true;
       return;
     }
-    mCol = pix.getCol();
+    col = pix.getCol();
   }
 
   Bool_t orphan = true;
 
-  if (mNoLeftColumn) { // check only the row above
-    if (mCurr[row - 1] >= 0) {
-      expandPreCluster(ip, row, mCurr[row - 1]); // attach to the precluster of the previous row
+  if (noLeftColumn) { // check only the row above
+    if (curr[row - 1] >= 0) {
+      expandPreCluster(ip, row, curr[row - 1]); // attach to the precluster of the previous row
       return;
     }
   } else {
-    int neighbours[]{mCurr[row - 1], mPrev[row], mPrev[row + 1], mPrev[row - 1]};
+    int neighbours[]{curr[row - 1], prev[row], prev[row + 1], prev[row - 1]};
     for (auto pci : neighbours) {
       if (pci < 0) {
         continue;
@@ -101,10 +109,10 @@ void Clusterer::updateChip(UInt_t ip)
         continue;
       }
       // reassign precluster index to smallest one
-      if (mPreClusterIndices[pci] < mPreClusterIndices[mCurr[row]]) {
-        mPreClusterIndices[mCurr[row]] = mPreClusterIndices[pci];
+      if (preClusterIndices[pci] < preClusterIndices[curr[row]]) {
+        preClusterIndices[curr[row]] = preClusterIndices[pci];
       } else {
-        mPreClusterIndices[pci] = mPreClusterIndices[mCurr[row]];
+        preClusterIndices[pci] = preClusterIndices[curr[row]];
       }
     }
   }
@@ -114,7 +122,7 @@ void Clusterer::updateChip(UInt_t ip)
 }
 
 //__________________________________________________
-void Clusterer::fetchMCLabels(int digID, const MCTruth* labelsDig, int& nfilled)
+void Clusterer::ClustererThread::fetchMCLabels(int digID, const MCTruth* labelsDig, int& nfilled)
 {
   // transfer MC labels to cluster
   if (nfilled >= Cluster::maxLabels) {
@@ -124,11 +132,11 @@ void Clusterer::fetchMCLabels(int digID, const MCTruth* labelsDig, int& nfilled)
   for (int i = lbls.size(); i--;) {
     int ic = nfilled;
     for (; ic--;) { // check if the label is already present
-      if (mLabelsBuff[ic] == lbls[i]) {
+      if (labelsBuff[ic] == lbls[i]) {
         return; // label is found, do nothing
       }
     }
-    mLabelsBuff[nfilled++] = lbls[i];
+    labelsBuff[nfilled++] = lbls[i];
     if (nfilled >= Cluster::maxLabels) {
       break;
     }
@@ -140,7 +148,6 @@ void Clusterer::fetchMCLabels(int digID, const MCTruth* labelsDig, int& nfilled)
 void Clusterer::clear()
 {
   // reset
-  mChipData = nullptr;
   mClusTree = nullptr;
   mROFRef.clear();
   mTimer.Stop();
@@ -152,6 +159,7 @@ void Clusterer::print() const
 {
   // print settings
   printf("Mask overflow pixels in strobes separated by < %d BCs\n", mMaxBCSeparationToMask);
+  printf("Clusterization of the chips on %d thread(s)\n", mNThreads);
 #ifdef _PERFORM_TIMING_
   printf("Clusterization timing (w/o disk IO): ");
   mTimer.Print();
@@ -54,7 +54,7 @@ int LookUp::groupFinder(int nRow, int nCol)
   }
 }
 
-int LookUp::findGroupID(int nRow, int nCol, const unsigned char patt[Cluster::kMaxPatternBytes])
+int LookUp::findGroupID(int nRow, int nCol, const unsigned char patt[Cluster::kMaxPatternBytes]) const
 {
   int nBits = nRow * nCol;
   // Small topology
@@ -63,8 +63,7 @@ int LookUp::findGroupID(int nRow, int nCol, const unsigned char patt[Cluster::kM
     if (ID >= 0)
       return ID;
     else { //small rare topology (inside groups)
-      int index = groupFinder(nRow, nCol);
-      return mDictionary.mGroupMap[index];
+      return findRareGroupID(nRow, nCol);
     }
   }
   // Big topology
@@ -73,11 +72,16 @@ int LookUp::findGroupID(int nRow, int nCol, const unsigned char patt[Cluster::kM
   if (ret != mDictionary.mCommonMap.end())
     return ret->second;
   else { // Big rare topology (inside groups)
-    int index = groupFinder(nRow, nCol);
-    return mDictionary.mGroupMap[index];
+    return findRareGroupID(nRow, nCol);
   }
 }
 
+int LookUp::findRareGroupID(int nRow, int nCol) const
+{
+  auto ret = mDictionary.mGroupMap.find(groupFinder(nRow, nCol));
+  return ret != mDictionary.mGroupMap.end() ? ret->second : CompCluster::InvalidPatternID;
+}
+
 bool LookUp::isGroup(int id) const
 {
   return mDictionary.isGroup(id);
@@ -15,6 +15,10 @@
 #include "ITSMFTReconstruction/RawPixelDecoder.h"
 #include "DPLUtils/DPLRawParser.h"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::itsmft;
 using namespace o2::framework;
 
@@ -66,8 +70,21 @@ int RawPixelDecoder<Mapping>::decodeNextTrigger()
   mNPixelsFiredROF = 0;
   mInteractionRecord.clear();
   int nLinksWithData = 0, nru = mRUDecodeVec.size();
+  mRUNLinksWithData.resize(nru);
+  mRULinkIR.resize(nru);
+  // the RUs are decoded independently, the interaction record and the statistics are collected in the RU order
+#ifdef WITH_OPENMP
+  omp_set_num_threads(mNThreads);
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int iru = 0; iru < nru; iru++) {
+    mRUNLinksWithData[iru] = decodeRUTrigger(iru, mRULinkIR[iru]);
+  }
   for (int iru = 0; iru < nru; iru++) {
-    nLinksWithData += decodeNextTrigger(iru);
+    if (mRUNLinksWithData[iru]) {
+      nLinksWithData += mRUNLinksWithData[iru];
+      updateInteractionRecord(mGBTLinks[mRULinkIR[iru]]);
+    }
     mNChipsFiredROF += mRUDecodeVec[iru].nChipsFired;
     for (int ic = mRUDecodeVec[iru].nChipsFired; ic--;) {
       mNPixelsFiredROF += mRUDecodeVec[iru].chipsData[ic].getData().size();
@@ -105,20 +122,33 @@ void RawPixelDecoder<Mapping>::startNewTF(InputRecord& inputs)
 /// Decode next trigger for given RU, return number of decoded GBT words
 template <class Mapping>
 int RawPixelDecoder<Mapping>::decodeNextTrigger(int iru)
+{
+  int linkIR = -1;
+  int ndec = decodeRUTrigger(iru, linkIR);
+  if (ndec) {
+    updateInteractionRecord(mGBTLinks[linkIR]);
+  }
+  return ndec;
+}
+
+///______________________________________________________________
+/// Decode next trigger for given RU, return number of links with data and in linkIR the 1st of them with the
+/// earliest interaction record. Touches only the RU and its links, so that different RUs can be decoded in parallel
+template <class Mapping>
+int RawPixelDecoder<Mapping>::decodeRUTrigger(int iru, int& linkIR)
 {
   auto& ru = mRUDecodeVec[iru];
   ru.clear();
   int ndec = 0; // number of yet non-empty links
+  linkIR = -1;
   for (int il = 0; il < RUDecodeData::MaxLinksPerRU; il++) {
     auto* link = getGBTLink(ru.links[il]);
     if (link) {
       auto res = link->collectROFCableData(mMAP);
       if (res == GBTLink::DataSeen) { // at the moment process only DataSeen
         ndec++;
-        if (mInteractionRecord > link->ir) { // update interaction record RSTOD: do we need to set it for every chip?
-          mInteractionRecord = link->ir;
-          mInteractionRecordHB = o2::raw::RDHUtils::getHeartBeatIR(*link->lastRDH);
-          mTrigger = link->trigger;
+        if (linkIR < 0 || mGBTLinks[linkIR].ir > link->ir) {
+          linkIR = ru.links[il];
         }
       }
     }
@@ -129,6 +159,18 @@ int RawPixelDecoder<Mapping>::decodeNextTrigger(int iru)
   return ndec;
 }
 
+///______________________________________________________________
+/// Update the interaction record if the one of the link is earlier
+template <class Mapping>
+void RawPixelDecoder<Mapping>::updateInteractionRecord(const GBTLink& link)
+{
+  if (mInteractionRecord > link.ir) { // RSTOD: do we need to set it for every chip?
+    mInteractionRecord = link.ir;
+    mInteractionRecordHB = o2::raw::RDHUtils::getHeartBeatIR(*link.lastRDH);
+    mTrigger = link.trigger;
+  }
+}
+
 ///______________________________________________________________
 /// Setup links checking the very RDH of every input
 template <class Mapping>
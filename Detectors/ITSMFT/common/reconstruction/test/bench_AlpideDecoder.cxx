@@ -0,0 +1,80 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   bench_AlpideDecoder.cxx
+/// \brief  Decoding of the ALPIDE payload of a cable as a function of the chip occupancy
+
+#include "benchmark/benchmark.h"
+#include "ITSMFTReconstruction/AlpideCoder.h"
+#include "ITSMFTReconstruction/PayLoadCont.h"
+#include "ITSMFTReconstruction/PixelData.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace o2::itsmft;
+
+namespace
+{
+/// nChips chips with nClusters clusters of up to 3x3 pixels each, encoded one after the other as on a cable
+void encodeChips(int nChips, int nClusters, PayLoadCont& buffer)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> rowDist(0, AlpideCoder::NRows - 3), colDist(0, AlpideCoder::NCols - 3), stepDist(0, 2);
+  AlpideCoder coder;
+  ChipPixelData chipData;
+  std::vector<std::pair<int, int>> pixels;
+  for (int iChip = 0; iChip < nChips; iChip++) {
+    pixels.clear();
+    for (int iClus = 0; iClus < nClusters; iClus++) {
+      int row = rowDist(gen), col = colDist(gen);
+      for (int iPix = 0; iPix < 5; iPix++) {
+        pixels.emplace_back(row + stepDist(gen), col + stepDist(gen));
+      }
+    }
+    std::sort(pixels.begin(), pixels.end());
+    pixels.erase(std::unique(pixels.begin(), pixels.end()), pixels.end());
+    chipData.clear();
+    for (const auto& pix : pixels) {
+      chipData.getData().emplace_back(pix.first, pix.second);
+    }
+    buffer.ensureFreeCapacity(40 * (2 + pixels.size()));
+    coder.encodeChip(buffer, chipData, iChip % 9, iChip * 8);
+  }
+}
+} // namespace
+
+// arguments: number of clusters per chip
+static void BM_AlpideDecoder(benchmark::State& state)
+{
+  PayLoadCont encoded;
+  encodeChips(1000, state.range(0), encoded);
+  PayLoadCont buffer;
+  ChipPixelData chipData;
+  size_t nPixels = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    buffer = encoded;
+    state.ResumeTiming();
+    nPixels = 0;
+    int res;
+    while ((res = AlpideCoder::decodeChip(chipData, buffer)) > 0) {
+      nPixels += res;
+    }
+  }
+  state.counters["pixels"] = nPixels;
+  state.SetBytesProcessed(state.iterations() * encoded.getSize());
+}
+
+BENCHMARK(BM_AlpideDecoder)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
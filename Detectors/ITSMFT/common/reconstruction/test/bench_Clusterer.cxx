@@ -0,0 +1,106 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   bench_Clusterer.cxx
+/// \brief  Clusterization of a time frame of ITS digits as a function of the number of threads
+
+#include "benchmark/benchmark.h"
+#include "ITSMFTReconstruction/ChipMappingITS.h"
+#include "ITSMFTReconstruction/Clusterer.h"
+#include "ITSMFTReconstruction/DigitPixelReader.h"
+#include "DataFormatsITSMFT/Digit.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace o2::itsmft;
+
+namespace
+{
+/// nROFs strobes with nChipsFired random chips each, fired by up to 5 clusters of a few pixels
+void makeDigits(int nROFs, int nChipsFired, std::vector<Digit>& digits, std::vector<ROFRecord>& rofs)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> chipDist(0, ChipMappingITS::getNChips() - 1), rowDist(2, SegmentationAlpide::NRows - 3),
+    colDist(2, SegmentationAlpide::NCols - 3), nClusDist(1, 5), sizeDist(1, 8), stepDist(-1, 1);
+  std::vector<int> chips;
+  std::vector<Digit> chipDigits;
+  for (int iROF = 0; iROF < nROFs; iROF++) {
+    chips.clear();
+    for (int i = 0; i < nChipsFired; i++) {
+      chips.push_back(chipDist(gen));
+    }
+    std::sort(chips.begin(), chips.end());
+    chips.erase(std::unique(chips.begin(), chips.end()), chips.end());
+    int firstEntry = digits.size();
+    for (auto chip : chips) {
+      chipDigits.clear();
+      for (int iClus = nClusDist(gen); iClus--;) {
+        int row = rowDist(gen), col = colDist(gen);
+        for (int iPix = sizeDist(gen); iPix--;) {
+          chipDigits.emplace_back(chip, row + stepDist(gen), col + stepDist(gen));
+        }
+      }
+      std::sort(chipDigits.begin(), chipDigits.end(), [](const Digit& a, const Digit& b) {
+        return a.getColumn() == b.getColumn() ? a.getRow() < b.getRow() : a.getColumn() < b.getColumn();
+      });
+      chipDigits.erase(std::unique(chipDigits.begin(), chipDigits.end(), [](const Digit& a, const Digit& b) {
+                         return a.getColumn() == b.getColumn() && a.getRow() == b.getRow();
+                       }),
+                       chipDigits.end());
+      digits.insert(digits.end(), chipDigits.begin(), chipDigits.end());
+    }
+    o2::InteractionRecord ir(0, iROF);
+    rofs.emplace_back(ir, iROF, firstEntry, digits.size() - firstEntry);
+  }
+}
+} // namespace
+
+// arguments: number of chips fired per ROF, number of threads
+static void BM_Clusterer(benchmark::State& state)
+{
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> digROFs;
+  makeDigits(32, state.range(0), digits, digROFs);
+
+  Clusterer clusterer;
+  clusterer.setNChips(ChipMappingITS::getNChips());
+  clusterer.setNThreads(state.range(1));
+  std::vector<CompClusterExt> compClusters;
+  std::vector<unsigned char> patterns;
+  std::vector<ROFRecord> clusROFs;
+  for (auto _ : state) {
+    compClusters.clear();
+    patterns.clear();
+    clusROFs.clear();
+    DigitPixelReader reader;
+    reader.setDigits(digits);
+    reader.setROFRecords(digROFs);
+    reader.init();
+    clusterer.process(reader, (std::vector<Cluster>*)nullptr, &compClusters, &patterns, &clusROFs);
+  }
+  state.counters["clusters"] = compClusters.size();
+  state.counters["pixels/s"] = benchmark::Counter(digits.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int nChipsFired : {200, 2000, 12000}) {
+    for (int nThreads : {1, 2, 4, 8}) {
+      bench->Args({nChipsFired, nThreads});
+    }
+  }
+}
+
+BENCHMARK(BM_Clusterer)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
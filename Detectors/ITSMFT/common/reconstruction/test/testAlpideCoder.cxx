@@ -0,0 +1,255 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITSMFT AlpideCoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITSMFTReconstruction/AlpideCoder.h"
+#include "ITSMFTReconstruction/PayLoadCont.h"
+#include "ITSMFTReconstruction/PixelData.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace o2::itsmft;
+
+namespace
+{
+using Pixels = std::vector<std::pair<int, int>>; // (row, col)
+
+struct EncodedChip {
+  Pixels pixels; ///< sorted in column/row, as decoded
+  int chipInModule;
+  int roFlags;
+};
+
+/// random chips: empty ones, isolated pixels (DATASHORT) and blobs of adjacent pixels (mostly DATALONG)
+std::vector<EncodedChip> encodeChips(int nChips, PayLoadCont& buffer)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> typeDist(0, 3), rowDist(0, AlpideCoder::NRows - 4), colDist(0, AlpideCoder::NCols - 4),
+    nDist(1, 30), stepDist(0, 3), flagsDist(0, AlpideCoder::MaskROFlags);
+  AlpideCoder coder;
+  ChipPixelData chipData;
+  std::vector<EncodedChip> chips;
+  for (int iChip = 0; iChip < nChips; iChip++) {
+    auto& chip = chips.emplace_back();
+    chip.chipInModule = iChip % 9;
+    chip.roFlags = flagsDist(gen);
+    int type = typeDist(gen);
+    for (int i = type ? nDist(gen) : 0; i--;) {
+      int row = rowDist(gen), col = colDist(gen);
+      chip.pixels.emplace_back(row, col);
+      for (int iPix = type == 1 ? 0 : 8; iPix--;) { // a blob of up to 9 pixels around the first one
+        chip.pixels.emplace_back(row + stepDist(gen), col + stepDist(gen));
+      }
+    }
+    std::sort(chip.pixels.begin(), chip.pixels.end()); // the encoder expects row/col order
+    chip.pixels.erase(std::unique(chip.pixels.begin(), chip.pixels.end()), chip.pixels.end());
+    chipData.clear();
+    for (const auto& pix : chip.pixels) {
+      chipData.getData().emplace_back(pix.first, pix.second);
+    }
+    buffer.ensureFreeCapacity(40 * (2 + chip.pixels.size()));
+    coder.encodeChip(buffer, chipData, chip.chipInModule, iChip * 8, chip.roFlags);
+    std::sort(chip.pixels.begin(), chip.pixels.end(), [](const auto& a, const auto& b) {
+      return a.second == b.second ? a.first < b.first : a.second < b.second;
+    });
+  }
+  return chips;
+}
+
+Pixels getPixels(const ChipPixelData& chipData)
+{
+  Pixels pixels;
+  for (const auto& pix : chipData.getData()) {
+    pixels.emplace_back(pix.getRow(), pix.getCol());
+  }
+  return pixels;
+}
+
+/// straightforward byte by byte decoding, which AlpideCoder::decodeChip must reproduce exactly,
+/// including the return code and the position in the buffer on corrupted or truncated data
+int decodeChipByBytes(ChipPixelData& chipData, PayLoadCont& buffer)
+{
+  using AC = AlpideCoder;
+  uint8_t dataC = 0, timestamp = 0;
+  uint16_t region = 0;
+  int nRightCHits = 0;
+  uint16_t rightColHits[2 * AC::NRows];
+  uint16_t colDPrev = 0xffff;
+  uint32_t expectInp = AC::ExpectChipHeader | AC::ExpectChipEmpty;
+  chipData.clear();
+  auto hitPosition = [](uint16_t addr) { // row and whether the hit is in the right column
+    uint16_t row = addr >> 1;
+    bool rightC = (row & 0x1) ? !(addr & 0x1) : (addr & 0x1);
+    return std::make_pair(row, rightC);
+  };
+  while (buffer.next(dataC)) {
+    uint8_t dataCM = dataC & (~AC::MaskChipID);
+    if ((expectInp & AC::ExpectChipEmpty) && dataCM == AC::CHIPEMPTY) {
+      chipData.setChipID(dataC & AC::MaskChipID);
+      if (!buffer.next(timestamp)) {
+        return AC::Error;
+      }
+      continue;
+    }
+    if ((expectInp & AC::ExpectChipHeader) && dataCM == AC::CHIPHEADER) {
+      chipData.setChipID(dataC & AC::MaskChipID);
+      if (!buffer.next(timestamp)) {
+        return AC::Error;
+      }
+      expectInp = AC::ExpectRegion;
+      continue;
+    }
+    if ((expectInp & AC::ExpectRegion) && (dataC & AC::REGION) == AC::REGION) {
+      region = dataC & AC::MaskRegion;
+      expectInp = AC::ExpectData;
+      continue;
+    }
+    if ((expectInp & AC::ExpectChipTrailer) && dataCM == AC::CHIPTRAILER) {
+      chipData.setROFlags(dataC & AC::MaskROFlags);
+      colDPrev++;
+      for (int ihr = 0; ihr < nRightCHits; ihr++) {
+        chipData.getData().emplace_back(rightColHits[ihr], colDPrev);
+      }
+      break;
+    }
+    if (expectInp & AC::ExpectData) {
+      if (!AC::isData(dataC)) {
+        return AC::Error;
+      }
+      uint16_t dataS = dataC << 8;
+      if (!buffer.next(dataC)) {
+        return AC::Error;
+      }
+      dataS |= dataC;
+      uint16_t pixID = dataS & AC::MaskPixID;
+      uint16_t colD = (region * AC::NDColInReg + ((dataS & AC::MaskEncoder) >> 10)) << 1;
+      if (colD != colDPrev) {
+        colDPrev++;
+        for (int ihr = 0; ihr < nRightCHits; ihr++) {
+          chipData.getData().emplace_back(rightColHits[ihr], colDPrev);
+        }
+        colDPrev = colD;
+        nRightCHits = 0;
+      }
+      uint8_t hitMap = 0;
+      if ((dataS & (~AC::MaskDColID)) == AC::DATALONG && !buffer.next(hitMap)) {
+        // the leading hit is stored before the hit map is read
+        auto [row, rightC] = hitPosition(pixID);
+        if (!rightC) {
+          chipData.getData().emplace_back(row, colD);
+        }
+        return AC::Error;
+      }
+      for (int ip = -1; ip < AC::HitMapSize; ip++) { // the leading hit, then the ones of the hit map
+        if (ip >= 0 && !(hitMap & (0x1 << ip))) {
+          continue;
+        }
+        auto [row, rightC] = hitPosition(pixID + ip + 1);
+        if (rightC) {
+          rightColHits[nRightCHits++] = row;
+        } else {
+          chipData.getData().emplace_back(row, colD);
+        }
+      }
+      expectInp = AC::ExpectChipTrailer | AC::ExpectData | AC::ExpectRegion;
+      continue;
+    }
+    if (!dataC) {
+      buffer.clear();
+      break;
+    }
+    return AC::Error;
+  }
+  return chipData.getData().size();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(AlpideCoder_dataLong)
+{
+  // a 2x2 blob in a double column is a single DATALONG record with its hit map
+  AlpideCoder coder;
+  ChipPixelData chipData;
+  for (auto [row, col] : std::vector<std::pair<int, int>>{{10, 20}, {10, 21}, {11, 20}, {11, 21}}) {
+    chipData.getData().emplace_back(row, col);
+  }
+  PayLoadCont buffer;
+  buffer.ensureFreeCapacity(100);
+  coder.encodeChip(buffer, chipData, 3, 0);
+  // chip header (2), region (1), DATALONG (2) and its hit map (1), chip trailer (1)
+  BOOST_CHECK_EQUAL(buffer.getSize(), size_t(7));
+  uint8_t record = buffer[3];
+  BOOST_CHECK_EQUAL(uint32_t(record & 0xc0), AlpideCoder::DATALONG >> 8);
+
+  ChipPixelData decoded;
+  BOOST_CHECK_EQUAL(AlpideCoder::decodeChip(decoded, buffer), 4);
+  BOOST_CHECK_EQUAL(decoded.getChipID(), 3);
+  Pixels expected{{10, 20}, {11, 20}, {10, 21}, {11, 21}};
+  auto pixels = getPixels(decoded);
+  BOOST_CHECK(pixels == expected);
+}
+
+BOOST_AUTO_TEST_CASE(AlpideCoder_roundTrip)
+{
+  PayLoadCont buffer;
+  auto chips = encodeChips(500, buffer);
+  ChipPixelData chipData;
+  for (const auto& chip : chips) {
+    if (chip.pixels.empty()) { // empty chips are skipped by the decoder
+      continue;
+    }
+    BOOST_REQUIRE_EQUAL(AlpideCoder::decodeChip(chipData, buffer), int(chip.pixels.size()));
+    BOOST_CHECK_EQUAL(chipData.getChipID(), chip.chipInModule);
+    BOOST_CHECK_EQUAL(int(chipData.getROFlags()), chip.roFlags);
+    BOOST_CHECK(getPixels(chipData) == chip.pixels);
+  }
+  BOOST_CHECK_EQUAL(AlpideCoder::decodeChip(chipData, buffer), 0);
+}
+
+BOOST_AUTO_TEST_CASE(AlpideCoder_truncatedAndCorrupted)
+{
+  PayLoadCont encoded;
+  encodeChips(12, encoded);
+  const std::vector<uint8_t> data(encoded.getPtr(), encoded.getEnd());
+  std::mt19937 gen(54321);
+  std::uniform_int_distribution<int> byteDist(0, 255);
+
+  auto compare = [](const std::vector<uint8_t>& input) {
+    PayLoadCont buffer, reference;
+    buffer.add(input.data(), input.size());
+    reference.add(input.data(), input.size());
+    ChipPixelData chipData, referenceData;
+    while (true) {
+      int res = AlpideCoder::decodeChip(chipData, buffer);
+      BOOST_REQUIRE_EQUAL(res, decodeChipByBytes(referenceData, reference));
+      BOOST_REQUIRE_EQUAL(buffer.getPtr() - buffer.getEnd(), reference.getPtr() - reference.getEnd());
+      BOOST_REQUIRE(getPixels(chipData) == getPixels(referenceData));
+      if (res <= 0) {
+        break;
+      }
+      BOOST_CHECK_EQUAL(chipData.getChipID(), referenceData.getChipID());
+      BOOST_CHECK_EQUAL(chipData.getROFlags(), referenceData.getROFlags());
+    }
+  };
+
+  for (size_t size = 0; size <= data.size(); size++) {
+    compare(std::vector<uint8_t>(data.begin(), data.begin() + size));
+  }
+  for (int i = 0; i < 200; i++) {
+    auto corrupted = data;
+    corrupted[gen() % corrupted.size()] = byteDist(gen);
+    compare(corrupted);
+  }
+}
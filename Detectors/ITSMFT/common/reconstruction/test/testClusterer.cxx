@@ -0,0 +1,207 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITSMFT Clusterer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITSMFTReconstruction/ChipMappingITS.h"
+#include "ITSMFTReconstruction/Clusterer.h"
+#include "ITSMFTReconstruction/DigitPixelReader.h"
+#include "DataFormatsITSMFT/Digit.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace o2::itsmft;
+using MCTruth = o2::dataformats::MCTruthContainer<o2::MCCompLabel>;
+
+namespace
+{
+/// nROFs strobes 2 BCs apart with nChipsFired random chips each, fired by up to 5 clusters of a
+/// few pixels. In every other strobe, half of the chips of the previous one fire again with the
+/// same pixels, to be masked. Every pixel gets the label of its cluster, some a second one.
+void makeDigits(int nROFs, int nChipsFired, std::vector<Digit>& digits, std::vector<ROFRecord>& rofs, MCTruth& labels)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> chipDist(0, ChipMappingITS::getNChips() - 1), rowDist(2, SegmentationAlpide::NRows - 3),
+    colDist(2, SegmentationAlpide::NCols - 3), nClusDist(1, 5), sizeDist(1, 8), stepDist(-1, 1), extraLabelDist(0, 9);
+  std::map<int, std::vector<std::pair<Digit, int>>> prevChips, chips; // digits of each chip with their track
+  int nTracks = 0;
+  for (int iROF = 0; iROF < nROFs; iROF++) {
+    chips.clear();
+    if (iROF % 2) {
+      int nRepeated = prevChips.size() / 2;
+      for (auto it = prevChips.begin(); nRepeated--; ++it) {
+        chips.insert(*it);
+      }
+    }
+    for (int i = 0; i < nChipsFired; i++) {
+      int chip = chipDist(gen);
+      auto& chipDigits = chips[chip];
+      for (int iClus = nClusDist(gen); iClus--; nTracks++) {
+        int row = rowDist(gen), col = colDist(gen);
+        for (int iPix = sizeDist(gen); iPix--;) {
+          chipDigits.emplace_back(Digit(chip, row + stepDist(gen), col + stepDist(gen)), nTracks);
+        }
+      }
+    }
+    int firstEntry = digits.size();
+    for (auto& [chip, chipDigits] : chips) {
+      std::sort(chipDigits.begin(), chipDigits.end(), [](const auto& a, const auto& b) {
+        return a.first.getColumn() == b.first.getColumn() ? a.first.getRow() < b.first.getRow() : a.first.getColumn() < b.first.getColumn();
+      });
+      chipDigits.erase(std::unique(chipDigits.begin(), chipDigits.end(), [](const auto& a, const auto& b) {
+                         return a.first.getColumn() == b.first.getColumn() && a.first.getRow() == b.first.getRow();
+                       }),
+                       chipDigits.end());
+      for (const auto& [digit, track] : chipDigits) {
+        labels.addElement(digits.size(), o2::MCCompLabel(track, 0, 0));
+        if (extraLabelDist(gen) == 0) {
+          labels.addElement(digits.size(), o2::MCCompLabel(track + 1, 0, 0));
+        }
+        digits.push_back(digit);
+      }
+    }
+    prevChips.swap(chips);
+    o2::InteractionRecord ir(2 * iROF, 0);
+    rofs.emplace_back(ir, iROF, firstEntry, digits.size() - firstEntry);
+  }
+}
+
+struct Output {
+  std::vector<CompClusterExt> clusters;
+  std::vector<unsigned char> patterns;
+  std::vector<ROFRecord> rofs;
+  MCTruth labels;
+};
+
+Output clusterize(int nThreads, const std::vector<Digit>& digits, const std::vector<ROFRecord>& rofs, const MCTruth& labels)
+{
+  Clusterer clusterer;
+  clusterer.setNChips(ChipMappingITS::getNChips());
+  clusterer.setMaxBCSeparationToMask(3);
+  clusterer.setNThreads(nThreads);
+  DigitPixelReader reader;
+  reader.setDigits(digits);
+  reader.setROFRecords(rofs);
+  reader.setDigitsMCTruth(&labels);
+  reader.init();
+  Output output;
+  clusterer.process(reader, (std::vector<Cluster>*)nullptr, &output.clusters, &output.patterns, &output.rofs, &output.labels);
+  return output;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(Clusterer_sameOutputForAnyNumberOfThreads)
+{
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> rofs;
+  MCTruth labels;
+  makeDigits(32, 300, digits, rofs, labels);
+
+  const auto expected = clusterize(1, digits, rofs, labels);
+  BOOST_REQUIRE(!expected.clusters.empty());
+  BOOST_REQUIRE_EQUAL(expected.rofs.size(), rofs.size());
+
+  for (int nThreads : {2, 3, 8}) {
+    const auto output = clusterize(nThreads, digits, rofs, labels);
+
+    BOOST_REQUIRE_EQUAL(output.clusters.size(), expected.clusters.size());
+    for (size_t i = 0; i < expected.clusters.size(); i++) {
+      BOOST_CHECK_EQUAL(output.clusters[i].getChipID(), expected.clusters[i].getChipID());
+      BOOST_CHECK_EQUAL(output.clusters[i].getRow(), expected.clusters[i].getRow());
+      BOOST_CHECK_EQUAL(output.clusters[i].getCol(), expected.clusters[i].getCol());
+      BOOST_CHECK_EQUAL(output.clusters[i].getPatternID(), expected.clusters[i].getPatternID());
+    }
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(output.patterns.begin(), output.patterns.end(), expected.patterns.begin(), expected.patterns.end());
+
+    BOOST_REQUIRE_EQUAL(output.rofs.size(), expected.rofs.size());
+    for (size_t i = 0; i < expected.rofs.size(); i++) {
+      BOOST_CHECK(output.rofs[i].getBCData() == expected.rofs[i].getBCData());
+      BOOST_CHECK_EQUAL(output.rofs[i].getROFrame(), expected.rofs[i].getROFrame());
+      BOOST_CHECK_EQUAL(output.rofs[i].getFirstEntry(), expected.rofs[i].getFirstEntry());
+      BOOST_CHECK_EQUAL(output.rofs[i].getNEntries(), expected.rofs[i].getNEntries());
+    }
+
+    BOOST_REQUIRE_EQUAL(output.labels.getIndexedSize(), expected.labels.getIndexedSize());
+    for (size_t i = 0; i < expected.labels.getIndexedSize(); i++) {
+      auto clusterLabels = output.labels.getLabels(i), expectedLabels = expected.labels.getLabels(i);
+      BOOST_REQUIRE_EQUAL(clusterLabels.size(), expectedLabels.size());
+      BOOST_CHECK(std::equal(clusterLabels.begin(), clusterLabels.end(), expectedLabels.begin()));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Clusterer_masksPixelsOfCloseStrobes)
+{
+  // Strobes at BC 0, 2 and 6, with a mask separation of 3 BCs. In the 2nd strobe, the chips of the 1st one
+  // fire the same pixel again, to be masked, and a new one. The 3rd strobe is too far from the 2nd for any
+  // masking. Depending on the number of threads the masking is done within a batch or across batches.
+  const int nChips = 200, nNewChips = 10;
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> rofs;
+  MCTruth labels;
+  auto addROF = [&](int bc, const std::vector<std::pair<int, int>>& chipCols) {
+    int firstEntry = digits.size();
+    for (auto [chip, col] : chipCols) {
+      labels.addElement(digits.size(), o2::MCCompLabel(chip, col, 0));
+      digits.emplace_back(chip, 100, col);
+    }
+    rofs.emplace_back(o2::InteractionRecord(bc, 0), rofs.size(), firstEntry, digits.size() - firstEntry);
+  };
+  std::vector<std::pair<int, int>> rof0, rof1, rof2;
+  for (int chip = 0; chip < nChips + nNewChips; chip++) {
+    if (chip < nChips) {
+      rof0.emplace_back(chip, 100);
+      rof1.emplace_back(chip, 100);
+      rof1.emplace_back(chip, 200);
+      rof2.emplace_back(chip, 100);
+    } else {
+      rof1.emplace_back(chip, 100);
+    }
+  }
+  addROF(0, rof0);
+  addROF(2, rof1);
+  addROF(6, rof2);
+  // one cluster per pixel left after the masking
+  std::vector<std::pair<int, int>> rof1Unmasked;
+  for (auto [chip, col] : rof1) {
+    if (chip >= nChips || col != 100) {
+      rof1Unmasked.emplace_back(chip, col);
+    }
+  }
+
+  for (int nThreads : {1, 2, 8}) {
+    const auto output = clusterize(nThreads, digits, rofs, labels);
+    BOOST_REQUIRE_EQUAL(output.rofs.size(), size_t(3));
+    int iROF = 0;
+    for (const auto& expectedROF : {rof0, rof1Unmasked, rof2}) {
+      const auto& rof = output.rofs[iROF++];
+      BOOST_REQUIRE_EQUAL(rof.getNEntries(), int(expectedROF.size()));
+      for (size_t i = 0; i < expectedROF.size(); i++) {
+        const auto& cluster = output.clusters[rof.getFirstEntry() + i];
+        BOOST_CHECK_EQUAL(cluster.getChipID(), expectedROF[i].first);
+        BOOST_CHECK_EQUAL(cluster.getRow(), 100);
+        BOOST_CHECK_EQUAL(cluster.getCol(), expectedROF[i].second);
+        auto clusterLabels = output.labels.getLabels(rof.getFirstEntry() + i);
+        BOOST_REQUIRE_EQUAL(clusterLabels.size(), size_t(1));
+        BOOST_CHECK(clusterLabels[0] == o2::MCCompLabel(expectedROF[i].first, expectedROF[i].second, 0));
+      }
+    }
+  }
+}
@@ -0,0 +1,159 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITSMFT RawPixelDecoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITSMFTSimulation/MC2RawEncoder.h"
+#include "ITSMFTReconstruction/ChipMappingITS.h"
+#include "ITSMFTReconstruction/RawPixelDecoder.h"
+#include "DataFormatsITSMFT/Digit.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "DetectorsRaw/SimpleRawReader.h"
+#include "CommonConstants/LHCConstants.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace o2::itsmft;
+
+namespace
+{
+using Pixels = std::vector<std::tuple<int, int, int>>; // (chip, row, col)
+
+const std::string RawName = "testRawPixelDecoder.raw", CFGName = "testRawPixelDecoder.cfg";
+
+struct ROFPixels {
+  o2::InteractionRecord ir;
+  uint32_t nChipsFired = 0;
+  uint32_t nPixelsFired = 0;
+  Pixels pixels; ///< sorted when written, in the order of the decoder when decoded
+};
+
+Pixels getSortedPixels(const std::vector<Digit>& digits)
+{
+  Pixels pixels;
+  for (const auto& digit : digits) {
+    pixels.emplace_back(digit.getChipIndex(), digit.getRow(), digit.getColumn());
+  }
+  std::sort(pixels.begin(), pixels.end());
+  return pixels;
+}
+
+/// writes nROFs of random digits on the staves of layer 0, each read out by 3 links, to the raw file
+/// and returns the pixels of every ROF with its interaction record
+std::vector<ROFPixels> writeRawData(int nROFs)
+{
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> firedDist(0, 2), nPixDist(1, 20), rowDist(0, SegmentationAlpide::NRows - 1),
+    colDist(0, SegmentationAlpide::NCols - 1);
+  MC2RawEncoderITS m2r;
+  m2r.setContinuousReadout(true);
+  m2r.setDefaultSinkName(RawName);
+  const int nRUs = ChipMappingITS::getNStavesOnLr(0), nChips = ChipMappingITS::getNChipsPerLr(0);
+  m2r.setMinMaxRUSW(0, nRUs - 1);
+  const auto& mp = m2r.getMapping();
+  for (int ruID = 0; ruID < nRUs; ruID++) {
+    auto& ru = m2r.getCreateRUDecode(ruID);
+    for (int il = 0; il < 3; il++) {
+      ru.links[il] = m2r.addGBTLink();
+      auto* link = m2r.getGBTLink(ru.links[il]);
+      link->lanes = mp.getCablesOnRUType(ru.ruInfo->ruType) & (0x7 << (3 * il));
+      link->idInCRU = 3 * (ruID % 4) + il;
+      link->cruID = ruID / 4;
+      link->feeID = mp.RUSW2FEEId(ruID, il);
+      link->endPointID = 0;
+      m2r.getWriter().registerLink(link->feeID, link->cruID, link->idInCRU, link->endPointID, RawName);
+    }
+  }
+
+  std::vector<ROFPixels> rofs;
+  std::vector<Digit> digits;
+  for (int iROF = 0; iROF < nROFs; iROF++) {
+    digits.clear();
+    for (int chip = 0; chip < nChips; chip++) {
+      if (firedDist(gen)) {
+        continue;
+      }
+      Pixels chipPixels;
+      for (int iPix = nPixDist(gen); iPix--;) {
+        chipPixels.emplace_back(chip, rowDist(gen), colDist(gen));
+      }
+      std::sort(chipPixels.begin(), chipPixels.end());
+      chipPixels.erase(std::unique(chipPixels.begin(), chipPixels.end()), chipPixels.end());
+      for (auto [chipID, row, col] : chipPixels) {
+        digits.emplace_back(chipID, row, col);
+      }
+    }
+    auto& rof = rofs.emplace_back();
+    rof.ir = o2::InteractionRecord(iROF * 400 % o2::constants::lhc::LHCMaxBunches, iROF * 400 / o2::constants::lhc::LHCMaxBunches);
+    rof.pixels = getSortedPixels(digits);
+    m2r.digits2raw(digits, rof.ir);
+  }
+  m2r.getWriter().writeConfFile(ChipMappingITS::getName(), "RAWDATA", CFGName);
+  m2r.finalize();
+  return rofs;
+}
+
+std::vector<ROFPixels> decode(int nThreads)
+{
+  RawDecoderITS decoder;
+  decoder.setNThreads(nThreads);
+  o2::raw::SimpleRawReader reader(CFGName);
+  std::vector<ROFPixels> rofs;
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> rofRecords;
+  while (reader.loadNextTF()) {
+    decoder.startNewTF(*reader.getInputRecord());
+    while (decoder.decodeNextTrigger()) {
+      auto& rof = rofs.emplace_back();
+      rof.nChipsFired = decoder.getNChipsFiredROF();
+      rof.nPixelsFired = decoder.getNPixelsFiredROF();
+      digits.clear();
+      decoder.fillDecodedDigits(digits, rofRecords);
+      rof.ir = rofRecords.back().getBCData();
+      for (const auto& digit : digits) {
+        rof.pixels.emplace_back(digit.getChipIndex(), digit.getRow(), digit.getColumn());
+      }
+    }
+  }
+  return rofs;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(RawPixelDecoder_sameOutputForAnyNumberOfThreads)
+{
+  const auto written = writeRawData(50);
+  const auto expected = decode(1);
+  BOOST_REQUIRE_EQUAL(expected.size(), written.size());
+  for (size_t i = 0; i < written.size(); i++) {
+    BOOST_CHECK(expected[i].ir == written[i].ir);
+    auto pixels = expected[i].pixels;
+    std::sort(pixels.begin(), pixels.end());
+    BOOST_CHECK(pixels == written[i].pixels);
+    BOOST_CHECK_EQUAL(expected[i].nPixelsFired, written[i].pixels.size());
+  }
+
+  const auto rofs = decode(4);
+  BOOST_REQUIRE_EQUAL(rofs.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    BOOST_CHECK(rofs[i].ir == expected[i].ir);
+    BOOST_CHECK_EQUAL(rofs[i].nChipsFired, expected[i].nChipsFired);
+    BOOST_CHECK_EQUAL(rofs[i].nPixelsFired, expected[i].nPixelsFired);
+    BOOST_CHECK(rofs[i].pixels == expected[i].pixels);
+  }
+  std::remove(RawName.c_str());
+  std::remove(CFGName.c_str());
+}
@@ -0,0 +1,49 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   EntropyDecoderSpec.h
+/// \brief  Device decoding the CTF of ITS/MFT into the compact clusters
+
+#ifndef O2_ITSMFT_ENTROPYDECODER_
+#define O2_ITSMFT_ENTROPYDECODER_
+
+#include "Framework/DataProcessorSpec.h"
+#include "Framework/Task.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "Headers/DataHeader.h"
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace itsmft
+{
+
+class EntropyDecoderSpec : public Task
+{
+ public:
+  EntropyDecoderSpec(o2::detectors::DetID det);
+  ~EntropyDecoderSpec() override = default;
+  void init(InitContext& ic) final;
+  void run(ProcessingContext& pc) final;
+
+ private:
+  o2::detectors::DetID mDet;
+  o2::header::DataOrigin mOrigin = o2::header::gDataOriginInvalid;
+  int mNThreads = 1;
+};
+
+/// create a processor spec decoding <DET>/CTFDATA into the clusters, patterns and ROF records of ITS or MFT
+framework::DataProcessorSpec getEntropyDecoderSpec(o2::detectors::DetID det);
+
+} // namespace itsmft
+} // namespace o2
+
+#endif
@@ -0,0 +1,51 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   EntropyEncoderSpec.h
+/// \brief  Device encoding the ITS/MFT compact clusters into the CTF of the detector
+
+#ifndef O2_ITSMFT_ENTROPYENCODER_
+#define O2_ITSMFT_ENTROPYENCODER_
+
+#include "Framework/DataProcessorSpec.h"
+#include "Framework/Task.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "Headers/DataHeader.h"
+#include <vector>
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace itsmft
+{
+
+class EntropyEncoderSpec : public Task
+{
+ public:
+  EntropyEncoderSpec(o2::detectors::DetID det);
+  ~EntropyEncoderSpec() override = default;
+  void init(InitContext& ic) final;
+  void run(ProcessingContext& pc) final;
+
+ private:
+  o2::detectors::DetID mDet;
+  o2::header::DataOrigin mOrigin = o2::header::gDataOriginInvalid;
+  int mNThreads = 1;
+  std::vector<char> mBuffer;
+};
+
+/// create a processor spec encoding the clusters, patterns and ROF records of ITS or MFT into <DET>/CTFDATA
+framework::DataProcessorSpec getEntropyEncoderSpec(o2::detectors::DetID det);
+
+} // namespace itsmft
+} // namespace o2
+
+#endif
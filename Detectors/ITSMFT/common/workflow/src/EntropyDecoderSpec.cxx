@@ -0,0 +1,78 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   EntropyDecoderSpec.cxx
+/// \brief  Device decoding the CTF of ITS/MFT into the compact clusters
+
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+#include "Framework/ConfigParamRegistry.h"
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "ITSMFTReconstruction/CTFCoder.h"
+#include "ITSMFTWorkflow/EntropyDecoderSpec.h"
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace itsmft
+{
+
+EntropyDecoderSpec::EntropyDecoderSpec(o2::detectors::DetID det) : mDet(det)
+{
+  assert(det == o2::detectors::DetID::ITS || det == o2::detectors::DetID::MFT);
+  mOrigin = det == o2::detectors::DetID::ITS ? o2::header::gDataOriginITS : o2::header::gDataOriginMFT;
+}
+
+void EntropyDecoderSpec::init(InitContext& ic)
+{
+  mNThreads = ic.options().get<int>("nthreads");
+}
+
+void EntropyDecoderSpec::run(ProcessingContext& pc)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto buffer = pc.inputs().get<gsl::span<char>>("ctf");
+
+  std::vector<ROFRecord> rofs;
+  std::vector<CompClusterExt> compClusters;
+  std::vector<unsigned char> patterns;
+  CTFCoder::decode(mDet, buffer.data(), buffer.size(), rofs, compClusters, patterns, mNThreads);
+
+  pc.outputs().snapshot(Output{mOrigin, "COMPCLUSTERS", 0, Lifetime::Timeframe}, compClusters);
+  pc.outputs().snapshot(Output{mOrigin, "PATTERNS", 0, Lifetime::Timeframe}, patterns);
+  pc.outputs().snapshot(Output{mOrigin, mDet == o2::detectors::DetID::ITS ? "ITSClusterROF" : "MFTClusterROF", 0, Lifetime::Timeframe}, rofs);
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  LOG(INFO) << "Decoded " << compClusters.size() << " " << mDet.getName() << " clusters in " << rofs.size() << " ROFs from "
+            << buffer.size() << " bytes in " << elapsed.count() << " ms";
+}
+
+DataProcessorSpec getEntropyDecoderSpec(o2::detectors::DetID det)
+{
+  auto orig = det == o2::detectors::DetID::ITS ? o2::header::gDataOriginITS : o2::header::gDataOriginMFT;
+  std::vector<OutputSpec> outputs;
+  outputs.emplace_back(orig, "COMPCLUSTERS", 0, Lifetime::Timeframe);
+  outputs.emplace_back(orig, "PATTERNS", 0, Lifetime::Timeframe);
+  outputs.emplace_back(orig, det == o2::detectors::DetID::ITS ? "ITSClusterROF" : "MFTClusterROF", 0, Lifetime::Timeframe);
+
+  return DataProcessorSpec{
+    det == o2::detectors::DetID::ITS ? "its-entropy-decoder" : "mft-entropy-decoder",
+    Inputs{{"ctf", orig, "CTFDATA", 0, Lifetime::Timeframe}},
+    outputs,
+    AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(det)},
+    Options{{"nthreads", VariantType::Int, 2, {"number of threads decoding the columns in parallel"}}}};
+}
+
+} // namespace itsmft
+} // namespace o2
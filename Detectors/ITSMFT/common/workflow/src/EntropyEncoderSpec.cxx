@@ -0,0 +1,75 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   EntropyEncoderSpec.cxx
+/// \brief  Device encoding the ITS/MFT compact clusters into the CTF of the detector
+
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+#include "Framework/ConfigParamRegistry.h"
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "ITSMFTReconstruction/CTFCoder.h"
+#include "ITSMFTWorkflow/EntropyEncoderSpec.h"
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace itsmft
+{
+
+EntropyEncoderSpec::EntropyEncoderSpec(o2::detectors::DetID det) : mDet(det)
+{
+  assert(det == o2::detectors::DetID::ITS || det == o2::detectors::DetID::MFT);
+  mOrigin = det == o2::detectors::DetID::ITS ? o2::header::gDataOriginITS : o2::header::gDataOriginMFT;
+}
+
+void EntropyEncoderSpec::init(InitContext& ic)
+{
+  mNThreads = ic.options().get<int>("nthreads");
+}
+
+void EntropyEncoderSpec::run(ProcessingContext& pc)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto compClusters = pc.inputs().get<gsl::span<o2::itsmft::CompClusterExt>>("compClusters");
+  auto patterns = pc.inputs().get<gsl::span<unsigned char>>("patterns");
+  auto rofs = pc.inputs().get<gsl::span<o2::itsmft::ROFRecord>>("ROframes");
+
+  CTFCoder::encode(mDet, rofs, compClusters, patterns, mBuffer, mNThreads);
+  pc.outputs().snapshot(Output{mOrigin, "CTFDATA", 0, Lifetime::Timeframe}, mBuffer);
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  size_t inputSize = rofs.size_bytes() + compClusters.size_bytes() + patterns.size_bytes();
+  LOG(INFO) << "Encoded " << compClusters.size() << " " << mDet.getName() << " clusters in " << rofs.size() << " ROFs ("
+            << inputSize << " bytes) to " << mBuffer.size() << " bytes in " << elapsed.count() << " ms";
+}
+
+DataProcessorSpec getEntropyEncoderSpec(o2::detectors::DetID det)
+{
+  auto orig = det == o2::detectors::DetID::ITS ? o2::header::gDataOriginITS : o2::header::gDataOriginMFT;
+  std::vector<InputSpec> inputs;
+  inputs.emplace_back("compClusters", orig, "COMPCLUSTERS", 0, Lifetime::Timeframe);
+  inputs.emplace_back("patterns", orig, "PATTERNS", 0, Lifetime::Timeframe);
+  inputs.emplace_back("ROframes", orig, det == o2::detectors::DetID::ITS ? "ITSClusterROF" : "MFTClusterROF", 0, Lifetime::Timeframe);
+
+  return DataProcessorSpec{
+    det == o2::detectors::DetID::ITS ? "its-entropy-encoder" : "mft-entropy-encoder",
+    inputs,
+    Outputs{{orig, "CTFDATA", 0, Lifetime::Timeframe}},
+    AlgorithmSpec{adaptFromTask<EntropyEncoderSpec>(det)},
+    Options{{"nthreads", VariantType::Int, 2, {"number of threads coding the columns in parallel"}}}};
+}
+
+} // namespace itsmft
+} // namespace o2
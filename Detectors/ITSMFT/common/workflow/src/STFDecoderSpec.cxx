@@ -53,6 +53,7 @@ void STFDecoder<Mapping>::init(InitContext& ic)
   LOG(INFO) << "STF decoder for " << Mapping::getName();
   mDecoder = std::make_unique<RawPixelDecoder<Mapping>>();
   mDecoder->init();
+  mDecoder->setNThreads(ic.options().get<int>("nthreads"));
 
   auto detID = Mapping::getDetID();
 
@@ -69,6 +70,7 @@ void STFDecoder<Mapping>::init(InitContext& ic)
     mClusterer = std::make_unique<Clusterer>();
     mClusterer->setGeometry(geom);
     mClusterer->setNChips(Mapping::getNChips());
+    mClusterer->setNThreads(ic.options().get<int>("nthreads"));
 
     // settings for the fired pixel overflow masking
     const auto& alpParams = DPLAlpideParam<Mapping::getDetID()>::Instance();
@@ -175,7 +177,7 @@ DataProcessorSpec getSTFDecoderITSSpec(bool doClusters, bool doPatterns, bool do
     Inputs{{"stf", ConcreteDataTypeMatcher{orig, "RAWDATA"}, Lifetime::Timeframe}},
     outputs,
     AlgorithmSpec{adaptFromTask<STFDecoder<ChipMappingITS>>(doClusters, doPatterns, doDigits, dict)},
-    Options{}};
+    Options{{"nthreads", VariantType::Int, 1, {"number of threads decoding the RUs and clusterizing the chips in parallel"}}}};
 }
 
 DataProcessorSpec getSTFDecoderMFTSpec(bool doClusters, bool doPatterns, bool doDigits, const std::string& dict)
@@ -202,7 +204,7 @@ DataProcessorSpec getSTFDecoderMFTSpec(bool doClusters, bool doPatterns, bool do
     Inputs{{"stf", ConcreteDataTypeMatcher{orig, "RAWDATA"}, Lifetime::Timeframe}},
     outputs,
     AlgorithmSpec{adaptFromTask<STFDecoder<ChipMappingITS>>(doClusters, doPatterns, doDigits, dict)},
-    Options{}};
+    Options{{"nthreads", VariantType::Int, 1, {"number of threads decoding the RUs and clusterizing the chips in parallel"}}}};
 }
 
 } // namespace itsmft
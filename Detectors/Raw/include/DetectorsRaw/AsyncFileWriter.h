@@ -0,0 +1,100 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef DETECTOR_BASE_ASYNCFILEWRITER_H
+#define DETECTOR_BASE_ASYNCFILEWRITER_H
+
+/// @file   AsyncFileWriter.h
+/// @brief  Writes buffers to (multiple) files from a dedicated I/O thread
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace o2
+{
+namespace raw
+{
+
+/// Buffers handed over to write() are queued and written, in order for every
+/// file, by a single I/O thread, which collects all the buffers queued for a
+/// file in one vectored write. The producers only block when more than
+/// maxQueuedBytes are waiting. The written buffers are recycled by getBuffer().
+///
+/// With direct I/O, the files are opened with O_DIRECT and the data goes
+/// through an aligned staging buffer, the unaligned tail being written when
+/// the file is closed.
+class AsyncFileWriter
+{
+ public:
+  AsyncFileWriter(bool directIO = false, size_t maxQueuedBytes = 256 * 1024 * 1024);
+  ~AsyncFileWriter();
+
+  /// create (truncate) the file, return its id
+  int addFile(const std::string& name);
+  /// queue the content of the buffer for writing to the file
+  void write(int fileID, std::vector<char>&& buffer);
+  /// an empty buffer, possibly recycled from one which was already written
+  std::vector<char> getBuffer();
+  /// write everything which is queued and close all files
+  void close();
+
+  bool isDirectIO() const { return mDirectIO; }
+  size_t getBytesWritten() const { return mBytesWritten; }
+  /// time spent by the I/O thread in the write calls, in seconds
+  double getWriteTime() const { return mWriteTime; }
+  /// false if any write failed
+  bool isOK() const { return mOK; }
+
+ private:
+  struct File {
+    std::string name;
+    int fd = -1;
+    char* staging = nullptr; // aligned buffer for direct I/O
+    size_t stagingSize = 0;  // bytes in the staging buffer
+  };
+  struct Item {
+    int fileID;
+    std::vector<char> data;
+  };
+
+  void run();
+  void writeFile(File& file, const std::vector<Item*>& items);
+  void writeStaged(File& file, const char* data, size_t size);
+  bool writeAll(File& file, const char* data, size_t size);
+  void closeFile(File& file);
+
+  static constexpr size_t StagingSize = 4 * 1024 * 1024; // multiple of the block size of any device
+  static constexpr size_t Alignment = 4096;
+
+  bool mDirectIO = false;
+  size_t mMaxQueuedBytes = 0;
+  std::deque<File> mFiles; // deque: the I/O thread keeps pointers while files are added
+  std::deque<Item> mQueue;
+  size_t mQueuedBytes = 0;
+  std::vector<std::vector<char>> mFreeBuffers;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  bool mStop = false;
+  std::atomic<bool> mOK{true}; // set by the I/O thread, read by the producer without the lock
+  std::atomic<size_t> mBytesWritten{0};
+  std::atomic<double> mWriteTime{0};
+  std::thread mThread;
+};
+
+} // namespace raw
+} // namespace o2
+
+#endif
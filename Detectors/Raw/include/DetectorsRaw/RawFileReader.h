@@ -133,10 +133,24 @@ class RawFileReader
     size_t readNextHBF(char* buff);
     size_t readNextTF(char* buff);
 
+    // zero-copy access to the memory mapped input (see RawFileReader::setMemoryMapped):
+    // pointer to the next HBF/TF in the mapping if it is stored contiguously, nullptr otherwise,
+    // in which case readNextHBF/readNextTF should be used.
+    // skipNextHBF/skipNextTF move to the next HBF/TF without reading and return the skipped size
+    const char* getNextHBFPtr() const;
+    const char* getNextTFPtr() const;
+    size_t skipNextHBF();
+    size_t skipNextTF();
+
     void print(bool verbose = false, const std::string& pref = "") const;
     std::string describe() const;
 
    private:
+    int getHBFEnd(int ibl) const;
+    int getTFEnd(int ibl) const;
+    const char* getMappedPtr(int ibl, int iblEnd) const;
+    void adviseNextTF() const;
+
     const RawFileReader* reader = nullptr;
   };
 
@@ -156,6 +170,7 @@ class RawFileReader
   void setDefaultDataDescription(const o2::header::DataDescription d) { mDefDataDescription = d; }
   int getNLinks() const { return mLinksData.size(); }
   int getNFiles() const { return mFiles.size(); }
+  const std::string& getFileName(int i) const { return mFileNames[i]; }
 
   uint32_t getNextTFToRead() const { return mNextTF2Read; }
   void setNextTFToRead(uint32_t tf) { mNextTF2Read = tf; }
@@ -174,6 +189,19 @@ class RawFileReader
   int getVerbosity() const { return mVerbosity; }
   uint32_t getCheckErrors() const { return mCheckErrors; }
 
+  // read the files through a read-only memory mapping rather than fread, must be set before init()
+  void setMemoryMapped(bool v = true) { mMemoryMapped = v; }
+  bool isMemoryMapped() const { return mMemoryMapped; }
+  const char* getMappedData(int fileID) const { return fileID < int(mMappedFiles.size()) ? mMappedFiles[fileID].data : nullptr; }
+
+  // number of threads used to preprocess the files in init(), 0 for the number of cores
+  void setNThreads(int n = 0) { mNThreads = n > 0 ? n : 0; }
+  int getNThreads() const { return mNThreads; }
+
+  // store the RDH index of every file in a sidecar file <file>.rdhidx, and reuse it in later runs
+  void setCacheIndex(bool v = true) { mCacheIndex = v; }
+  bool getCacheIndex() const { return mCacheIndex; }
+
   void setNominalSPageSize(int n = 0x1 << 20) { mNominalSPageSize = n > (0x1 << 15) ? n : (0x1 << 15); }
   int getNominalSPageSize() const { return mNominalSPageSize; }
 
@@ -192,8 +220,20 @@ class RawFileReader
   static InputsMap parseInput(const std::string& confUri);
 
  private:
+  // RDHs of a single file, collected independently from the other files
+  struct RDHScan {
+    std::vector<std::pair<size_t, RDH>> rdhs; // offset of every RDH and its copy
+    size_t endPos = 0;                        // position in the file where the scan has stopped
+    bool ok = true;
+  };
+
   int getLinkLocalID(const RDH& rdh, o2::header::DataOrigin orig);
-  bool preprocessFile(int ifl);
+  bool scanFile(int ifl, RDHScan& scan) const;
+  bool loadIndexCache(int ifl, RDHScan& scan) const;
+  void storeIndexCache(int ifl, const RDHScan& scan) const;
+  bool preprocessFile(int ifl, const RDHScan& scan);
+  bool mapFile(int ifl);
+  void adviseWillNeed(int ifl, size_t offset, size_t size) const;
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
@@ -205,6 +245,14 @@ class RawFileReader
   std::vector<std::string> mFileNames; // input file names
   std::vector<FILE*> mFiles;           // input file handlers
   std::vector<OrDesc> mDataSpecs;      // data origin and description for every input file
+  struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+  };
+  std::vector<MappedFile> mMappedFiles; //! memory mapping of every input file, if requested
+  bool mMemoryMapped = false;
+  bool mCacheIndex = false;
+  int mNThreads = 0;
   bool mInitDone = false;
   std::unordered_map<LinkSpec_t, int> mLinkEntries; // mapping between RDH specs and link entry in the mLinksData
   std::vector<LinkData> mLinksData;                 // info on links data in the files
@@ -21,12 +21,14 @@
 #include <string>
 #include <string_view>
 #include <functional>
+#include <memory>
 #include <mutex>
 
 #include <Rtypes.h>
 #include "Headers/RAWDataHeader.h"
 #include "DetectorsRaw/HBFUtils.h"
 #include "DetectorsRaw/RDHUtils.h"
+#include "DetectorsRaw/AsyncFileWriter.h"
 
 namespace o2
 {
@@ -48,13 +50,15 @@ class RawFileWriter
   /// output file handler with its own lock
   struct OutputFile {
     FILE* handler = nullptr;
+    int asyncID = -1; // file ID in the asynchronous writer, if used
     std::mutex fileMtx;
     OutputFile() = default;
-    OutputFile(const OutputFile& src) : handler(src.handler) {}
+    OutputFile(const OutputFile& src) : handler(src.handler), asyncID(src.asyncID) {}
     OutputFile& operator=(const OutputFile& src)
     {
       if (this != &src) {
         handler = src.handler;
+        asyncID = src.asyncID;
       }
       return *this;
     }
@@ -178,6 +182,13 @@ class RawFileWriter
   int getSuperPageSize() const { return mSuperPageSize; }
   void setSuperPageSize(int nbytes);
 
+  /// write the superpages from a dedicated I/O thread, optionally with O_DIRECT; must be set before registering links
+  void setAsyncIO(bool v, bool directIO = false);
+  bool isAsyncIO() const { return mAsyncIO; }
+
+  /// total number of bytes written by all links
+  size_t getNBytesWritten() const;
+
   /// get highest IR seen so far
   IR getIRMax() const;
 
@@ -269,6 +280,10 @@ class RawFileWriter
   int mSuperPageSize = 1024 * 1024; // super page size
   bool mStartTFOnNewSPage = true;   // every TF must start on a new SPage
   RoMode_t mROMode = NotSet;
+  bool mAsyncIO = false;  // flush superpages from the I/O thread
+  bool mDirectIO = false; // use O_DIRECT in asynchronous mode
+
+  std::unique_ptr<AsyncFileWriter> mAsyncWriter; //! I/O thread used in asynchronous mode
 
   ClassDefNV(RawFileWriter, 1);
 }; // namespace raw
@@ -0,0 +1,281 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   AsyncFileWriter.cxx
+/// @brief  Writes buffers to (multiple) files from a dedicated I/O thread
+
+#include "DetectorsRaw/AsyncFileWriter.h"
+#include "Framework/Logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace o2::raw;
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+//_____________________________________________________________________
+AsyncFileWriter::AsyncFileWriter(bool directIO, size_t maxQueuedBytes) : mDirectIO(directIO), mMaxQueuedBytes(maxQueuedBytes)
+{
+#ifndef O_DIRECT
+  if (mDirectIO) {
+    LOG(WARNING) << "Direct I/O is not supported on this platform, using buffered I/O";
+    mDirectIO = false;
+  }
+#endif
+  mThread = std::thread(&AsyncFileWriter::run, this);
+}
+
+//_____________________________________________________________________
+AsyncFileWriter::~AsyncFileWriter()
+{
+  close();
+}
+
+//_____________________________________________________________________
+int AsyncFileWriter::addFile(const std::string& name)
+{
+  int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  int fd = -1;
+#ifdef O_DIRECT
+  if (mDirectIO) {
+    fd = ::open(name.c_str(), flags | O_DIRECT, 0644);
+    if (fd < 0 && errno == EINVAL) { // e.g. tmpfs does not support it
+      LOG(WARNING) << "Direct I/O is not supported for " << name << ", using buffered I/O";
+    }
+  }
+#endif
+  bool direct = fd >= 0;
+  if (fd < 0) {
+    fd = ::open(name.c_str(), flags, 0644);
+  }
+  if (fd < 0) {
+    LOG(ERROR) << "Failed to open output file " << name << ": " << strerror(errno);
+    throw std::runtime_error(std::string("cannot open output file ") + name);
+  }
+  File file;
+  file.name = name;
+  file.fd = fd;
+  if (direct && posix_memalign(reinterpret_cast<void**>(&file.staging), Alignment, StagingSize)) {
+    ::close(fd);
+    throw std::runtime_error("cannot allocate direct I/O staging buffer");
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  mFiles.push_back(file);
+  return mFiles.size() - 1;
+}
+
+//_____________________________________________________________________
+std::vector<char> AsyncFileWriter::getBuffer()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mFreeBuffers.empty()) {
+    return {};
+  }
+  auto buffer = std::move(mFreeBuffers.back());
+  mFreeBuffers.pop_back();
+  return buffer;
+}
+
+//_____________________________________________________________________
+void AsyncFileWriter::write(int fileID, std::vector<char>&& buffer)
+{
+  if (buffer.empty()) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    // always accept a buffer when nothing is pending, however large it is
+    mCondition.wait(lock, [this, &buffer]() { return mQueuedBytes == 0 || mQueuedBytes + buffer.size() <= mMaxQueuedBytes; });
+    mQueuedBytes += buffer.size();
+    mQueue.push_back(Item{fileID, std::move(buffer)});
+  }
+  mCondition.notify_all();
+}
+
+//_____________________________________________________________________
+void AsyncFileWriter::close()
+{
+  if (!mThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mCondition.notify_all();
+  mThread.join();
+  for (auto& file : mFiles) {
+    closeFile(file);
+  }
+  mFiles.clear();
+  mFreeBuffers.clear();
+}
+
+//_____________________________________________________________________
+void AsyncFileWriter::run()
+{
+  std::vector<Item> batch;
+  std::vector<std::vector<Item*>> perFile;
+  std::vector<File*> files;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mCondition.wait(lock, [this]() { return mStop || !mQueue.empty(); });
+      if (mQueue.empty()) {
+        return; // stopped and nothing left to write
+      }
+      batch.clear();
+      std::move(mQueue.begin(), mQueue.end(), std::back_inserter(batch));
+      mQueue.clear();
+      files.resize(mFiles.size());
+      for (size_t i = 0; i < mFiles.size(); i++) {
+        files[i] = &mFiles[i];
+      }
+    }
+    // group the buffers by file, keeping their order
+    perFile.resize(files.size());
+    size_t nBytes = 0;
+    for (auto& item : batch) {
+      perFile[item.fileID].push_back(&item);
+      nBytes += item.data.size();
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < files.size(); i++) {
+      if (!perFile[i].empty()) {
+        writeFile(*files[i], perFile[i]);
+        perFile[i].clear();
+      }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mWriteTime = mWriteTime + elapsed.count(); // only the I/O thread writes it
+      mBytesWritten += nBytes;
+      mQueuedBytes -= nBytes;
+      for (auto& item : batch) {
+        if (mFreeBuffers.size() < 64) {
+          item.data.clear();
+          mFreeBuffers.push_back(std::move(item.data));
+        }
+      }
+    }
+    mCondition.notify_all();
+  }
+}
+
+//_____________________________________________________________________
+void AsyncFileWriter::writeFile(File& file, const std::vector<Item*>& items)
+{
+  if (file.staging) {
+    for (auto* item : items) {
+      writeStaged(file, item->data.data(), item->data.size());
+    }
+    return;
+  }
+  std::vector<iovec> iov;
+  iov.reserve(items.size());
+  for (auto* item : items) {
+    iov.push_back(iovec{item->data.data(), item->data.size()});
+  }
+  size_t first = 0;
+  while (first < iov.size()) {
+    auto res = ::writev(file.fd, &iov[first], std::min<size_t>(iov.size() - first, IOV_MAX));
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "Failed to write to " << file.name << ": " << strerror(errno);
+      mOK = false;
+      return;
+    }
+    size_t written = res;
+    while (written) { // skip what was written, possibly only part of a buffer
+      if (written >= iov[first].iov_len) {
+        written -= iov[first++].iov_len;
+      } else {
+        iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+        iov[first].iov_len -= written;
+        written = 0;
+      }
+    }
+  }
+}
+
+//_____________________________________________________________________
+void AsyncFileWriter::writeStaged(File& file, const char* data, size_t size)
+{
+  // O_DIRECT requires aligned buffers, sizes and offsets: go through the staging buffer
+  while (size) {
+    auto n = std::min(size, StagingSize - file.stagingSize);
+    memcpy(file.staging + file.stagingSize, data, n);
+    file.stagingSize += n;
+    data += n;
+    size -= n;
+    if (file.stagingSize == StagingSize) {
+      writeAll(file, file.staging, StagingSize);
+      file.stagingSize = 0;
+    }
+  }
+}
+
+//_____________________________________________________________________
+bool AsyncFileWriter::writeAll(File& file, const char* data, size_t size)
+{
+  while (size) {
+    auto res = ::write(file.fd, data, size);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "Failed to write to " << file.name << ": " << strerror(errno);
+      mOK = false;
+      return false;
+    }
+    data += res;
+    size -= res;
+  }
+  return true;
+}
+
+//_____________________________________________________________________
+void AsyncFileWriter::closeFile(File& file)
+{
+  if (file.fd < 0) {
+    return;
+  }
+  if (file.staging) {
+#ifdef O_DIRECT
+    if (file.stagingSize % Alignment) { // the unaligned tail cannot be written with O_DIRECT
+      fcntl(file.fd, F_SETFL, fcntl(file.fd, F_GETFL) & ~O_DIRECT);
+    }
+#endif
+    writeAll(file, file.staging, file.stagingSize);
+    free(file.staging);
+    file.staging = nullptr;
+    file.stagingSize = 0;
+  }
+  if (::close(file.fd) < 0) {
+    LOG(ERROR) << "Failed to close " << file.name << ": " << strerror(errno);
+    mOK = false;
+  }
+  file.fd = -1;
+}
@@ -25,6 +25,13 @@
 
 #include <Common/Configuration.h>
 
+#include <atomic>
+#include <cerrno>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace o2::raw;
 namespace o2h = o2::header;
 
@@ -96,17 +103,23 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
   size_t sz = 0;
   int ibl = nextBlock2Read, nbl = blocks.size();
   bool error = false;
+  adviseNextTF();
   while (ibl < nbl) {
     const auto& blc = blocks[ibl];
     if (blc.orbit != blocks[nextBlock2Read].orbit) {
       break;
     }
     ibl++;
-    auto fl = reader->mFiles[blc.fileID];
-    if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
-      LOGF(ERROR, "Failed to read for the %s a bloc:", describe());
-      blc.print();
-      error = true;
+    auto mapped = reader->getMappedData(blc.fileID);
+    if (mapped) {
+      memcpy(buff + sz, mapped + blc.offset, blc.size);
+    } else {
+      auto fl = reader->mFiles[blc.fileID];
+      if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
+        LOGF(ERROR, "Failed to read for the %s a bloc:", describe());
+        blc.print();
+        error = true;
+      }
     }
     sz += blc.size;
   }
@@ -114,6 +127,103 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
   return error ? 0 : sz; // in case of the error we ignore the data
 }
 
+//____________________________________________
+int RawFileReader::LinkData::getHBFEnd(int ibl) const
+{
+  // index of the 1st block after the HBF starting at block ibl
+  int iend = ibl, nbl = blocks.size();
+  while (iend < nbl && blocks[iend].orbit == blocks[ibl].orbit) {
+    iend++;
+  }
+  return iend;
+}
+
+//____________________________________________
+int RawFileReader::LinkData::getTFEnd(int ibl) const
+{
+  // index of the 1st block after the TF starting at block ibl
+  int iend = ibl, nbl = blocks.size();
+  while (iend < nbl && blocks[iend].tfID == blocks[ibl].tfID) {
+    iend++;
+  }
+  return iend;
+}
+
+//____________________________________________
+const char* RawFileReader::LinkData::getMappedPtr(int ibl, int iblEnd) const
+{
+  // pointer to the mapped data of blocks [ibl:iblEnd) if they are contiguous in the same file
+  if (ibl >= iblEnd) {
+    return nullptr;
+  }
+  auto mapped = reader->getMappedData(blocks[ibl].fileID);
+  if (!mapped) {
+    return nullptr;
+  }
+  for (int i = ibl + 1; i < iblEnd; i++) {
+    if (blocks[i].fileID != blocks[ibl].fileID || blocks[i].offset != blocks[i - 1].offset + blocks[i - 1].size) {
+      return nullptr;
+    }
+  }
+  return mapped + blocks[ibl].offset;
+}
+
+//____________________________________________
+const char* RawFileReader::LinkData::getNextHBFPtr() const
+{
+  return getMappedPtr(nextBlock2Read, getHBFEnd(nextBlock2Read));
+}
+
+//____________________________________________
+const char* RawFileReader::LinkData::getNextTFPtr() const
+{
+  return getMappedPtr(nextBlock2Read, getTFEnd(nextBlock2Read));
+}
+
+//____________________________________________
+size_t RawFileReader::LinkData::skipNextHBF()
+{
+  adviseNextTF();
+  size_t sz = 0;
+  int iend = getHBFEnd(nextBlock2Read);
+  for (; nextBlock2Read < iend; nextBlock2Read++) {
+    sz += blocks[nextBlock2Read].size;
+  }
+  return sz;
+}
+
+//____________________________________________
+size_t RawFileReader::LinkData::skipNextTF()
+{
+  adviseNextTF();
+  size_t sz = 0;
+  int iend = getTFEnd(nextBlock2Read);
+  for (; nextBlock2Read < iend; nextBlock2Read++) {
+    sz += blocks[nextBlock2Read].size;
+  }
+  return sz;
+}
+
+//____________________________________________
+void RawFileReader::LinkData::adviseNextTF() const
+{
+  // when starting to read a TF from the mapping, ask the kernel to read ahead the following one
+  int nbl = blocks.size();
+  if (nextBlock2Read >= nbl || !blocks[nextBlock2Read].testFlag(LinkBlock::StartTF) || !reader->getMappedData(blocks[nextBlock2Read].fileID)) {
+    return;
+  }
+  int ibl = getTFEnd(nextBlock2Read), iend = ibl < nbl ? getTFEnd(ibl) : nbl;
+  while (ibl < iend) { // coalesce contiguous blocks
+    int inext = ibl + 1;
+    size_t size = blocks[ibl].size;
+    while (inext < iend && blocks[inext].fileID == blocks[ibl].fileID && blocks[inext].offset == blocks[ibl].offset + size) {
+      size += blocks[inext++].size;
+    }
+    reader->adviseWillNeed(blocks[ibl].fileID, blocks[ibl].offset, size);
+    ibl = inext;
+  }
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getNextTFSize() const
 {
@@ -361,31 +471,172 @@ int RawFileReader::getLinkLocalID(const RDH& rdh, const o2::header::DataOrigin o
 }
 
 //_____________________________________________________________________
-bool RawFileReader::preprocessFile(int ifl)
+bool RawFileReader::scanFile(int ifl, RDHScan& scan) const
+{
+  // collect the RDHs of the file, this does not modify the reader and can run for all files in parallel
+  auto mapped = getMappedData(ifl);
+  size_t pos = 0;
+  if (mapped) {
+    size_t fileSize = mMappedFiles[ifl].size;
+    while (pos < fileSize) {
+      if (fileSize - pos < sizeof(RDH)) {
+        LOG(ERROR) << "EOF was unexpected, only " << fileSize - pos << " bytes were read for RDH";
+        scan.ok = false;
+        break;
+      }
+      const auto& rdh = *reinterpret_cast<const RDH*>(mapped + pos);
+      if (!(scan.ok = RDHUtils::checkRDH(rdh))) {
+        break;
+      }
+      if (rdh.offsetToNext == 0) {
+        LOG(ERROR) << "RDH at offset " << pos << " does not point to the next page";
+        scan.ok = false;
+        break;
+      }
+      if (rdh.offsetToNext > fileSize - pos) { // truncated file, the last page must not point beyond the mapping
+        LOG(ERROR) << "RDH at offset " << pos << " points to the next page at " << pos + rdh.offsetToNext
+                   << ", beyond the end of the file at " << fileSize;
+        scan.ok = false;
+        auto& rdhCopy = scan.rdhs.emplace_back(pos, rdh).second;
+        RDHUtils::setOffsetToNext(rdhCopy, fileSize - pos);
+        pos = fileSize;
+        break;
+      }
+      scan.rdhs.emplace_back(pos, rdh);
+      pos += rdh.offsetToNext;
+    }
+  } else {
+    FILE* fl = mFiles[ifl];
+    rewind(fl);
+    RDH rdh;
+    long int nr = 0;
+    int readBytes = sizeof(RDH);
+    while ((nr = fread(&rdh, 1, readBytes, fl))) {
+      if (nr < readBytes) {
+        LOG(ERROR) << "EOF was unexpected, only " << nr << " bytes were read for RDH";
+        scan.ok = false;
+        break;
+      }
+      if (!(scan.ok = RDHUtils::checkRDH(rdh))) {
+        break;
+      }
+      scan.rdhs.emplace_back(pos, rdh);
+      pos += rdh.offsetToNext;
+      if (fseek(fl, pos, SEEK_SET)) {
+        break;
+      }
+    }
+    pos = ftell(fl);
+  }
+  scan.endPos = pos;
+  return scan.ok;
+}
+
+namespace
+{
+// header of the RDH index cache file
+struct IndexCacheHeader {
+  char magic[8] = {'O', '2', 'R', 'D', 'H', 'I', 'D', 'X'};
+  uint32_t version = 1;
+  uint32_t sizeofRDH = 0;
+  uint64_t fileSize = 0;  // size and modification time of the indexed file
+  int64_t fileMTime = 0;  // the cache is ignored if they changed
+  uint64_t nRDH = 0;
+  uint64_t endPos = 0;
+  uint32_t ok = 0;
+  uint32_t reserved = 0;
+};
+
+bool getFileStat(const std::string& name, uint64_t& size, int64_t& mtime)
+{
+  struct stat st;
+  if (stat(name.c_str(), &st)) {
+    return false;
+  }
+  size = st.st_size;
+  mtime = st.st_mtime;
+  return true;
+}
+
+std::string getIndexCacheName(const std::string& name)
+{
+  return name + ".rdhidx";
+}
+} // namespace
+
+//_____________________________________________________________________
+bool RawFileReader::loadIndexCache(int ifl, RDHScan& scan) const
+{
+  IndexCacheHeader ref, hdr;
+  ref.sizeofRDH = sizeof(RDH);
+  if (!getFileStat(mFileNames[ifl], ref.fileSize, ref.fileMTime)) {
+    return false;
+  }
+  auto cacheName = getIndexCacheName(mFileNames[ifl]);
+  FILE* fl = fopen(cacheName.c_str(), "rb");
+  if (!fl) {
+    return false;
+  }
+  bool ok = fread(&hdr, sizeof(hdr), 1, fl) == 1 &&
+            !memcmp(hdr.magic, ref.magic, sizeof(ref.magic)) && hdr.version == ref.version && hdr.sizeofRDH == ref.sizeofRDH &&
+            hdr.fileSize == ref.fileSize && hdr.fileMTime == ref.fileMTime && hdr.endPos <= hdr.fileSize;
+  if (ok) {
+    scan.rdhs.resize(hdr.nRDH);
+    ok = fread(scan.rdhs.data(), sizeof(scan.rdhs[0]), hdr.nRDH, fl) == hdr.nRDH;
+  }
+  fclose(fl);
+  if (!ok) {
+    LOGF(WARNING, "Ignoring invalid or outdated index cache %s", cacheName);
+    scan = RDHScan();
+    return false;
+  }
+  scan.endPos = hdr.endPos;
+  scan.ok = hdr.ok;
+  LOGF(INFO, "File %3d : index of %zu RDH loaded from %s", ifl, scan.rdhs.size(), cacheName);
+  return true;
+}
+
+//_____________________________________________________________________
+void RawFileReader::storeIndexCache(int ifl, const RDHScan& scan) const
 {
-  // preprocess file, check RDH data, build statistics
-  FILE* fl = mFiles[ifl];
+  IndexCacheHeader hdr;
+  hdr.sizeofRDH = sizeof(RDH);
+  if (!getFileStat(mFileNames[ifl], hdr.fileSize, hdr.fileMTime)) {
+    return;
+  }
+  hdr.nRDH = scan.rdhs.size();
+  hdr.endPos = scan.endPos;
+  hdr.ok = scan.ok;
+  // write to a temporary file first, so that a concurrent reader never sees a partial cache
+  auto cacheName = getIndexCacheName(mFileNames[ifl]);
+  auto tmpName = cacheName + ".tmp" + std::to_string(getpid());
+  FILE* fl = fopen(tmpName.c_str(), "wb");
+  if (!fl) {
+    LOGF(WARNING, "Cannot write index cache %s", cacheName);
+    return;
+  }
+  bool ok = fwrite(&hdr, sizeof(hdr), 1, fl) == 1 &&
+            fwrite(scan.rdhs.data(), sizeof(scan.rdhs[0]), scan.rdhs.size(), fl) == scan.rdhs.size();
+  ok &= fclose(fl) == 0;
+  if (!ok || rename(tmpName.c_str(), cacheName.c_str())) {
+    LOGF(WARNING, "Failed to write index cache %s", cacheName);
+    remove(tmpName.c_str());
+  }
+}
+
+//_____________________________________________________________________
+bool RawFileReader::preprocessFile(int ifl, const RDHScan& scan)
+{
+  // preprocess RDHs of the file, check RDH data, build statistics
   mCurrentFileID = ifl;
-  RDH rdh;
 
   LinkSpec_t specPrev = 0xffffffffffffffff;
   int lIDPrev = -1;
   mMultiLinkFile = false;
-  rewind(fl);
-  long int nr = 0;
   mPosInFile = 0;
   int nRDHread = 0;
-  bool ok = true;
-  int readBytes = sizeof(RDH);
-  while ((nr = fread(&rdh, 1, readBytes, fl))) {
-    if (nr < readBytes) {
-      LOG(ERROR) << "EOF was unexpected, only " << nr << " bytes were read for RDH";
-      ok = false;
-      break;
-    }
-    if (!(ok = RDHUtils::checkRDH(rdh))) {
-      break;
-    }
+  for (const auto& [pos, rdh] : scan.rdhs) {
+    mPosInFile = pos;
     nRDHread++;
     LinkSpec_t spec = createSpec(mDataSpecs[mCurrentFileID].first, RDHUtils::getSubSpec(rdh));
     int lID = lIDPrev;
@@ -398,14 +649,9 @@ bool RawFileReader::preprocessFile(int ifl)
     }
     bool newSPage = lID != lIDPrev;
     mLinksData[lID].preprocessCRUPage(rdh, newSPage);
-    //
-    mPosInFile += rdh.offsetToNext;
-    if (fseek(fl, mPosInFile, SEEK_SET)) {
-      break;
-    }
     lIDPrev = lID;
   }
-  mPosInFile = ftell(fl);
+  mPosInFile = scan.endPos;
   if (lIDPrev != -1) { // close last block
     auto& lastBlock = mLinksData[lIDPrev].blocks.back();
     lastBlock.size = mPosInFile - lastBlock.offset;
@@ -413,7 +659,42 @@ bool RawFileReader::preprocessFile(int ifl)
 
   LOGF(INFO, "File %3d : %9li bytes scanned, %6d RDH read for %4d links from %s",
        mCurrentFileID, mPosInFile, nRDHread, int(mLinkEntries.size()), mFileNames[mCurrentFileID]);
-  return ok;
+  return scan.ok;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::mapFile(int ifl)
+{
+  // map the file for reading, falling back to fread on failure
+  struct stat st;
+  int fd = fileno(mFiles[ifl]);
+  if (fstat(fd, &st) || st.st_size == 0) {
+    LOGF(WARNING, "Cannot get the size of %s, it will not be memory mapped", mFileNames[ifl]);
+    return false;
+  }
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    LOGF(WARNING, "Failed to memory map %s (%s), it will be read with fread", mFileNames[ifl], strerror(errno));
+    return false;
+  }
+  // the data is read once, front to back, and should not stay in the page cache at the expense of other data
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+  mMappedFiles[ifl].data = reinterpret_cast<const char*>(data);
+  mMappedFiles[ifl].size = st.st_size;
+  return true;
+}
+
+//_____________________________________________________________________
+void RawFileReader::adviseWillNeed(int ifl, size_t offset, size_t size) const
+{
+  // madvise requires page aligned address
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  const auto& mf = mMappedFiles[ifl];
+  size_t start = offset & ~(pageSize - 1);
+  size_t end = std::min(offset + size, mf.size);
+  if (start < end) {
+    madvise(const_cast<char*>(mf.data) + start, end - start, MADV_WILLNEED);
+  }
 }
 
 //_____________________________________________________________________
@@ -434,6 +715,12 @@ void RawFileReader::clear()
   mLinkEntries.clear();
   mOrderedIDs.clear();
   mLinksData.clear();
+  for (auto& mf : mMappedFiles) {
+    if (mf.data) {
+      munmap(const_cast<char*>(mf.data), mf.size);
+    }
+  }
+  mMappedFiles.clear();
   for (auto fl : mFiles) {
     fclose(fl);
   }
@@ -488,8 +775,43 @@ bool RawFileReader::init()
 
   int nf = mFiles.size();
   bool ok = true;
+  if (mMemoryMapped) {
+    mMappedFiles.resize(nf);
+    int nMapped = 0;
+    for (int i = 0; i < nf; i++) {
+      nMapped += mFiles[i] && mapFile(i);
+    }
+    LOGF(INFO, "%d out of %d files are memory mapped", nMapped, nf);
+  }
+
+  // The files are scanned for RDHs in parallel, the links are then built
+  // from the RDHs of every file, in order, as the same link may continue
+  // across files.
+  std::vector<RDHScan> scans(nf);
+  std::atomic<int> nextFile{0};
+  auto scanFiles = [this, &scans, &nextFile, nf]() {
+    for (int i = nextFile++; i < nf; i = nextFile++) {
+      if (mCacheIndex && loadIndexCache(i, scans[i])) {
+        continue;
+      }
+      scanFile(i, scans[i]);
+      if (mCacheIndex) {
+        storeIndexCache(i, scans[i]);
+      }
+    }
+  };
+  int nThreads = std::min(nf, mNThreads > 0 ? mNThreads : int(std::max(1u, std::thread::hardware_concurrency())));
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nThreads; i++) {
+    threads.emplace_back(scanFiles);
+  }
+  scanFiles();
+  for (auto& t : threads) {
+    t.join();
+  }
   for (int i = 0; i < nf; i++) {
-    ok &= preprocessFile(i);
+    ok &= preprocessFile(i, scans[i]);
+    scans[i] = RDHScan(); // release memory
   }
   mOrderedIDs.resize(mLinksData.size());
   for (int i = mLinksData.size(); i--;) {
@@ -31,6 +31,7 @@
 
 #include <unistd.h>
 #include <algorithm>
+#include <chrono>
 #include <unordered_map>
 #include <cctype>
 #include <string>
@@ -43,9 +44,12 @@ namespace o2h = o2::header;
 class rawReaderSpecs : public o2f::Task
 {
  public:
-  explicit rawReaderSpecs(const std::string& config, bool tfAsMessage = false, bool outPerRoute = true, int loop = 1, uint32_t delay_us = 0)
-    : mLoop(loop), mHBFPerMessage(!tfAsMessage), mOutPerRoute(outPerRoute), mDelayUSec(delay_us), mReader(std::make_unique<o2::raw::RawFileReader>(config))
+  explicit rawReaderSpecs(const std::string& config, bool tfAsMessage = false, bool outPerRoute = true, int loop = 1, uint32_t delay_us = 0,
+                          bool mmap = false, bool benchmark = false, bool cacheIndex = false)
+    : mLoop(loop), mHBFPerMessage(!tfAsMessage), mOutPerRoute(outPerRoute), mDelayUSec(delay_us), mBenchmark(benchmark), mReader(std::make_unique<o2::raw::RawFileReader>(config))
   {
+    mReader->setMemoryMapped(mmap);
+    mReader->setCacheIndex(cacheIndex);
     LOG(INFO) << "Number of loops over whole data requested: " << mLoop;
     if (mHBFPerMessage) {
       LOG(INFO) << "Every link TF will be sent as multipart of HBF messages";
@@ -54,6 +58,12 @@ class rawReaderSpecs : public o2f::Task
     }
     LOG(INFO) << "A message per " << (mOutPerRoute ? "route" : "link") << " will be sent";
     LOG(INFO) << "Delay of " << mDelayUSec << " microseconds will be added between TFs";
+    if (mmap) {
+      LOG(INFO) << "Input files will be memory mapped, contiguous data will be sent without copy";
+    }
+    if (mBenchmark) {
+      LOG(INFO) << "Benchmark mode: data is read but not sent, the reading rate is reported";
+    }
   }
 
   void init(o2f::InitContext& ic) final
@@ -109,7 +119,9 @@ class rawReaderSpecs : public o2f::Task
         }
         LOG(INFO) << "Starting new loop " << loopsDone << " from the beginning of data";
       } else {
-        LOGF(INFO, "Finished: payload of %zu bytes in %zu messages sent for %d TFs", sentSize, sentMessages, mTFIDaccum);
+        LOGF(INFO, "Finished: payload of %zu bytes in %zu messages %s for %d TFs", sentSize, sentMessages, mBenchmark ? "read" : "sent", mTFIDaccum);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStartTime;
+        LOGF(INFO, "Read %.3f GB in %.3f s: %.3f GB/s", sentSize * 1e-9, elapsed.count(), elapsed.count() > 0 ? sentSize * 1e-9 / elapsed.count() : 0.);
         ctx.services().get<o2f::ControlService>().endOfStream();
         ctx.services().get<o2f::ControlService>().readyToQuit(o2f::QuitRequest::Me);
         mDone = true;
@@ -117,6 +129,10 @@ class rawReaderSpecs : public o2f::Task
       }
     }
 
+    if (mTFIDaccum == 0) {
+      mStartTime = std::chrono::steady_clock::now();
+    }
+
     // read next time frame
     size_t tfNParts = 0, tfSize = 0;
     LOG(INFO) << "Reading TF#" << mTFIDaccum << " (" << tfID << " at iteration " << loopsDone << ')';
@@ -140,8 +156,23 @@ class rawReaderSpecs : public o2f::Task
         auto hdMessage = device->NewMessage(headerStack.size());
         memcpy(hdMessage->GetData(), headerStack.data(), headerStack.size());
 
-        auto plMessage = device->NewMessage(hdrTmpl.payloadSize);
-        auto bread = mHBFPerMessage ? link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData())) : link.readNextTF(reinterpret_cast<char*>(plMessage->GetData()));
+        // with the memory mapped input, contiguous data is handed over without copy, the mapping
+        // is owned by the reader and stays valid for the lifetime of the device
+        FairMQMessagePtr plMessage;
+        size_t bread = 0;
+        auto mapped = mHBFPerMessage ? link.getNextHBFPtr() : link.getNextTFPtr();
+        if (mapped) {
+          plMessage = device->NewMessage(const_cast<char*>(mapped), hdrTmpl.payloadSize, [](void*, void*) {}, nullptr);
+          bread = mHBFPerMessage ? link.skipNextHBF() : link.skipNextTF();
+          if (mBenchmark) { // nobody will access the data, make sure that it is actually read from the file
+            for (size_t i = 0; i < bread; i += 4096) {
+              mPagesSum += mapped[i];
+            }
+          }
+        } else {
+          plMessage = device->NewMessage(hdrTmpl.payloadSize);
+          bread = mHBFPerMessage ? link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData())) : link.readNextTF(reinterpret_cast<char*>(plMessage->GetData()));
+        }
         if (bread != hdrTmpl.payloadSize) {
           LOG(ERROR) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
                      << " expected in TF=" << mTFIDaccum << " part=" << hdrTmpl.splitPayloadIndex;
@@ -183,7 +214,9 @@ class rawReaderSpecs : public o2f::Task
       usleep(mDelayUSec);
     }
 
-    if (mOutPerRoute) {
+    if (mBenchmark) {
+      // nothing is sent, only the reading is measured
+    } else if (mOutPerRoute) {
       for (auto& msgIt : messagesPerRoute) {
         LOG(INFO) << "Sending " << msgIt.second->Size() / 2 << " parts to channel " << msgIt.first;
         device->Send(*msgIt.second.get(), msgIt.first);
@@ -199,7 +232,7 @@ class rawReaderSpecs : public o2f::Task
       }
     }
 
-    LOGF(INFO, "Sent payload of %zu bytes in %zu parts in %zu messages for TF %d", tfSize, tfNParts,
+    LOGF(INFO, "%s payload of %zu bytes in %zu parts in %zu messages for TF %d", mBenchmark ? "Read" : "Sent", tfSize, tfNParts,
          (mOutPerRoute ? messagesPerRoute.size() : messagesPerLink.size()), mTFIDaccum);
     sentSize += tfSize;
     sentMessages += tfNParts;
@@ -215,10 +248,13 @@ class rawReaderSpecs : public o2f::Task
   bool mHBFPerMessage = true;                      // true: send TF as multipart of HBFs, false: single message per TF
   bool mOutPerRoute = true;                        // true: send 1 large output route, otherwise 1 outpur per link
   bool mDone = false;                              // processing is over or not
+  bool mBenchmark = false;                         // read the data without sending it, report the rate
+  std::chrono::steady_clock::time_point mStartTime; // start of the reading, for the rate
+  uint64_t mPagesSum = 0;                          // to touch the mapped pages in benchmark mode
   std::unique_ptr<o2::raw::RawFileReader> mReader; // matching engine
 };
 
-o2f::DataProcessorSpec getReaderSpec(std::string config, bool tfAsMessage, bool outPerRoute, int loop, uint32_t delay_us)
+o2f::DataProcessorSpec getReaderSpec(std::string config, bool tfAsMessage, bool outPerRoute, int loop, uint32_t delay_us, bool mmap, bool benchmark, bool cacheIndex)
 {
   // check which inputs are present in files to read
   o2f::Outputs outputs;
@@ -235,13 +271,13 @@ o2f::DataProcessorSpec getReaderSpec(std::string config, bool tfAsMessage, bool
     "raw-file-reader",
     o2f::Inputs{},
     outputs,
-    o2f::AlgorithmSpec{o2f::adaptFromTask<rawReaderSpecs>(config, tfAsMessage, outPerRoute, loop, delay_us)},
+    o2f::AlgorithmSpec{o2f::adaptFromTask<rawReaderSpecs>(config, tfAsMessage, outPerRoute, loop, delay_us, mmap, benchmark, cacheIndex)},
     o2f::Options{}};
 }
 
-o2f::WorkflowSpec o2::raw::getRawFileReaderWorkflow(std::string inifile, bool tfAsMessage, bool outPerRoute, int loop, uint32_t delay_us)
+o2f::WorkflowSpec o2::raw::getRawFileReaderWorkflow(std::string inifile, bool tfAsMessage, bool outPerRoute, int loop, uint32_t delay_us, bool mmap, bool benchmark, bool cacheIndex)
 {
   o2f::WorkflowSpec specs;
-  specs.emplace_back(getReaderSpec(inifile, tfAsMessage, outPerRoute, loop, delay_us));
+  specs.emplace_back(getReaderSpec(inifile, tfAsMessage, outPerRoute, loop, delay_us, mmap, benchmark, cacheIndex));
   return specs;
 }
@@ -20,7 +20,8 @@ namespace o2
 namespace raw
 {
 
-framework::WorkflowSpec getRawFileReaderWorkflow(std::string inifile, bool tfAsMessage = false, bool outPerRoute = true, int loop = 0, uint32_t delay_us = 0);
+framework::WorkflowSpec getRawFileReaderWorkflow(std::string inifile, bool tfAsMessage = false, bool outPerRoute = true, int loop = 0, uint32_t delay_us = 0,
+                                                 bool mmap = false, bool benchmark = false, bool cacheIndex = false);
 
 } // namespace raw
 } // namespace o2
@@ -49,10 +49,20 @@ void RawFileWriter::close()
   // close all files
   for (auto& flh : mFName2File) {
     LOG(INFO) << "Closing output file " << flh.first;
-    fclose(flh.second.handler);
-    flh.second.handler = nullptr;
+    if (flh.second.handler) {
+      fclose(flh.second.handler);
+      flh.second.handler = nullptr;
+    }
   }
   mFName2File.clear();
+  if (mAsyncWriter) { // wait for the I/O thread to write what is still queued
+    mAsyncWriter->close();
+    LOGF(INFO, "Asynchronous writer: %zu bytes written in %.3f s of I/O", mAsyncWriter->getBytesWritten(), mAsyncWriter->getWriteTime());
+    if (!mAsyncWriter->isOK()) {
+      LOG(ERROR) << "Writing of the output files failed";
+    }
+    mAsyncWriter.reset();
+  }
 }
 
 //_____________________________________________________________________
@@ -89,7 +99,12 @@ RawFileWriter::LinkData& RawFileWriter::registerLink(uint16_t fee, uint16_t cru,
   auto sspec = RDHUtils::getSubSpec(cru, link, endpoint, fee);
   auto& linkData = mSSpec2Link[sspec];
   auto& file = mFName2File[std::string(outFileName)];
-  if (!file.handler) {
+  if (mAsyncIO && file.asyncID < 0) {
+    if (!mAsyncWriter) {
+      mAsyncWriter = std::make_unique<AsyncFileWriter>(mDirectIO);
+    }
+    file.asyncID = mAsyncWriter->addFile(outFileName);
+  } else if (!mAsyncIO && !file.handler) {
     if (!(file.handler = fopen(outFileName.c_str(), "wb"))) { // if file does not exist, create it
       LOG(ERROR) << "Failed to open output file " << outFileName;
       throw std::runtime_error(std::string("cannot open link output file ") + outFileName);
@@ -146,6 +161,27 @@ void RawFileWriter::setSuperPageSize(int nbytes)
   assert((mSuperPageSize % RDHUtils::MAXCRUPage) == 0); // make sure it is multiple of 8KB
 }
 
+//_____________________________________________________________________
+void RawFileWriter::setAsyncIO(bool v, bool directIO)
+{
+  if (!mFName2File.empty()) {
+    LOG(ERROR) << "Asynchronous I/O must be set before registering the links";
+    throw std::runtime_error("cannot change I/O mode with open output files");
+  }
+  mAsyncIO = v;
+  mDirectIO = v && directIO;
+}
+
+//_____________________________________________________________________
+size_t RawFileWriter::getNBytesWritten() const
+{
+  size_t nbytes = 0;
+  for (auto& lnk : mSSpec2Link) {
+    nbytes += lnk.second.nBytesWritten;
+  }
+  return nbytes;
+}
+
 //_____________________________________________________________________
 IR RawFileWriter::getIRMax() const
 {
@@ -367,18 +403,29 @@ void RawFileWriter::LinkData::flushSuperPage(bool keepLastPage)
   if (writer->mVerbosity) {
     LOGF(INFO, "Flushing super page of %u bytes for %s", pgSize, describe());
   }
-  writer->mFName2File.find(fileName)->second.write(buffer.data(), pgSize);
+  auto& file = writer->mFName2File.find(fileName)->second;
   auto toMove = buffer.size() - pgSize;
-  if (toMove) { // is there something left in the buffer, move it to the beginning of the buffer
-    if (toMove > pgSize) {
-      memcpy(buffer.data(), &buffer[pgSize], toMove);
-    } else {
-      memmove(buffer.data(), &buffer[pgSize], toMove);
+  if (writer->mAsyncWriter) { // hand the superpage over to the I/O thread and continue in a recycled buffer
+    auto next = writer->mAsyncWriter->getBuffer();
+    next.reserve(writer->mSuperPageSize);
+    next.assign(buffer.begin() + pgSize, buffer.end());
+    buffer.resize(pgSize);
+    writer->mAsyncWriter->write(file.asyncID, std::move(buffer));
+    buffer = std::move(next);
+  } else {
+    file.write(buffer.data(), pgSize);
+    if (toMove) { // is there something left in the buffer, move it to the beginning of the buffer
+      if (toMove > pgSize) {
+        memcpy(buffer.data(), &buffer[pgSize], toMove);
+      } else {
+        memmove(buffer.data(), &buffer[pgSize], toMove);
+      }
     }
     buffer.resize(toMove);
+  }
+  if (toMove) {
     lastRDHoffset -= pgSize;
   } else {
-    buffer.clear();
     lastRDHoffset = -1;
   }
 }
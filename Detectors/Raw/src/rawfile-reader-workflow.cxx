@@ -22,6 +22,9 @@ void customize(std::vector<o2::framework::ConfigParamSpec>& workflowOptions)
   workflowOptions.push_back(ConfigParamSpec{"message-per-tf", o2::framework::VariantType::Bool, false, {"send TF of each link as a single FMQ message rather than multipart with message per HB"}});
   workflowOptions.push_back(ConfigParamSpec{"output-per-link", o2::framework::VariantType::Bool, false, {"send message per Link rather than per FMQ output route"}});
   workflowOptions.push_back(ConfigParamSpec{"delay", o2::framework::VariantType::Float, 0.f, {"delay in seconds between consecutive TFs sending"}});
+  workflowOptions.push_back(ConfigParamSpec{"mmap", o2::framework::VariantType::Bool, false, {"memory map the input files and send contiguous data without copy"}});
+  workflowOptions.push_back(ConfigParamSpec{"benchmark", o2::framework::VariantType::Bool, false, {"read the data without sending it and report the reading rate"}});
+  workflowOptions.push_back(ConfigParamSpec{"cache-index", o2::framework::VariantType::Bool, false, {"store the index of every input file in a sidecar <file>.rdhidx and reuse it in later runs"}});
 }
 
 // ------------------------------------------------------------------
@@ -35,5 +38,8 @@ WorkflowSpec defineDataProcessing(ConfigContext const& configcontext)
   auto tfAsMessage = configcontext.options().get<bool>("message-per-tf");
   auto outPerRoute = !configcontext.options().get<bool>("output-per-link");
   uint32_t delay_us = uint32_t(1e6 * configcontext.options().get<int>("delay")); // delay in microseconds
-  return std::move(o2::raw::getRawFileReaderWorkflow(inifile, tfAsMessage, outPerRoute, loop, delay_us));
+  auto mmap = configcontext.options().get<bool>("mmap");
+  auto benchmark = configcontext.options().get<bool>("benchmark");
+  auto cacheIndex = configcontext.options().get<bool>("cache-index");
+  return std::move(o2::raw::getRawFileReaderWorkflow(inifile, tfAsMessage, outPerRoute, loop, delay_us, mmap, benchmark, cacheIndex));
 }
@@ -12,15 +12,18 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 #include <algorithm>
+#include <cstring>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <TRandom.h>
 #include <boost/test/unit_test.hpp>
 #include "Steer/InteractionSampler.h"
 #include "DetectorsRaw/HBFUtils.h"
 #include "DetectorsRaw/RDHUtils.h"
 #include "DetectorsRaw/RawFileWriter.h"
+#include "DetectorsRaw/AsyncFileWriter.h"
 #include "DetectorsRaw/SimpleRawReader.h"
 #include "DetectorsRaw/SimpleSTF.h"
 #include "CommonConstants/Triggers.h"
@@ -309,4 +312,140 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter)
   }
 }
 
+BOOST_AUTO_TEST_CASE(RawReaderMemoryMapped)
+{
+  // uses the files written by the RawReaderWriter test
+  RawFileReader readerF(CFGName), readerM(CFGName);
+  readerM.setMemoryMapped();
+  readerF.init();
+  readerM.init();
+  BOOST_REQUIRE(readerM.getNLinks() == readerF.getNLinks());
+  int nZeroCopy = 0;
+  std::vector<char> buffF, buffM;
+  for (int il = 0; il < readerF.getNLinks(); il++) {
+    auto& lnkF = readerF.getLink(il);
+    auto& lnkM = readerM.getLink(il);
+    while (auto sz = lnkF.getNextHBFSize()) {
+      BOOST_REQUIRE(lnkM.getNextHBFSize() == sz);
+      buffF.resize(sz);
+      BOOST_CHECK(lnkF.readNextHBF(buffF.data()) == sz);
+      auto ptr = lnkM.getNextHBFPtr();
+      if (ptr) { // contiguous in the mapped file
+        BOOST_CHECK(lnkM.skipNextHBF() == sz);
+        BOOST_CHECK(std::memcmp(ptr, buffF.data(), sz) == 0);
+        nZeroCopy++;
+      } else {
+        buffM.resize(sz);
+        BOOST_CHECK(lnkM.readNextHBF(buffM.data()) == sz);
+        BOOST_CHECK(buffM == buffF);
+      }
+    }
+    BOOST_CHECK(lnkM.getNextHBFSize() == 0);
+  }
+  BOOST_CHECK(nZeroCopy > 0);
+}
+
+BOOST_AUTO_TEST_CASE(RawReaderParallelIndex)
+{
+  // uses the files written by the RawReaderWriter test
+  auto compare = [](const RawFileReader& r0, const RawFileReader& r1) {
+    BOOST_REQUIRE(r0.getNLinks() == r1.getNLinks());
+    BOOST_CHECK(r0.getNTimeFrames() == r1.getNTimeFrames());
+    for (int il = 0; il < r0.getNLinks(); il++) {
+      const auto& l0 = r0.getLink(il);
+      const auto& l1 = r1.getLink(il);
+      BOOST_CHECK(l0.spec == l1.spec);
+      BOOST_CHECK(l0.nErrors == l1.nErrors);
+      BOOST_REQUIRE(l0.blocks.size() == l1.blocks.size());
+      for (size_t ib = 0; ib < l0.blocks.size(); ib++) {
+        const auto &b0 = l0.blocks[ib], &b1 = l1.blocks[ib];
+        BOOST_CHECK(b0.offset == b1.offset && b0.size == b1.size && b0.fileID == b1.fileID);
+        BOOST_CHECK(b0.tfID == b1.tfID && b0.orbit == b1.orbit && b0.flags == b1.flags);
+      }
+    }
+  };
+  RawFileReader serial(CFGName), parallel(CFGName), cached(CFGName), fromCache(CFGName);
+  serial.setNThreads(1);
+  parallel.setNThreads(4);
+  cached.setCacheIndex();
+  fromCache.setCacheIndex();
+  fromCache.setMemoryMapped();
+  BOOST_CHECK(serial.init());
+  BOOST_CHECK(parallel.init());
+  BOOST_CHECK(cached.init()); // writes the index cache
+  for (int i = 0; i < cached.getNFiles(); i++) {
+    BOOST_CHECK(std::ifstream(cached.getFileName(i) + ".rdhidx").good());
+  }
+  BOOST_CHECK(fromCache.init()); // reads it
+  compare(serial, parallel);
+  compare(serial, cached);
+  compare(serial, fromCache);
+  for (int i = 0; i < cached.getNFiles(); i++) {
+    std::remove((cached.getFileName(i) + ".rdhidx").c_str());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AsyncWriter)
+{
+  // files written through the I/O thread must have the content of the buffers in the order of submission
+  std::vector<std::string> names{"testdata_async0.raw", "testdata_async1.raw"};
+  std::vector<std::vector<char>> expected(names.size());
+  {
+    AsyncFileWriter writer(true, 64 * 1024); // small queue to exercise the backpressure, direct I/O if supported
+    std::vector<int> ids;
+    for (const auto& name : names) {
+      ids.push_back(writer.addFile(name));
+    }
+    for (int i = 0; i < 500; i++) {
+      auto ifl = i % names.size();
+      auto buffer = writer.getBuffer();
+      buffer.resize(1000 + 37 * i, char(i));
+      expected[ifl].insert(expected[ifl].end(), buffer.begin(), buffer.end());
+      writer.write(ids[ifl], std::move(buffer));
+    }
+    writer.close();
+    BOOST_CHECK(writer.isOK());
+    BOOST_CHECK(writer.getBytesWritten() == expected[0].size() + expected[1].size());
+  }
+  for (size_t ifl = 0; ifl < names.size(); ifl++) {
+    std::ifstream in(names[ifl], std::ios::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    BOOST_CHECK(content == expected[ifl]);
+    std::remove(names[ifl].c_str());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RawWriterAsyncIO)
+{
+  // the asynchronous mode of RawFileWriter must produce the same files as the synchronous one
+  std::vector<std::string> names{"testdata_sync.raw", "testdata_async.raw"};
+  for (int iw = 0; iw < 2; iw++) {
+    RawFileWriter writer;
+    writer.setSuperPageSize(16 * RDHUtils::MAXCRUPage);
+    writer.setAsyncIO(iw == 1);
+    for (int il = 0; il < NLinkPerCRU; il++) {
+      writer.registerLink(il, 0, il, 0, names[iw]);
+    }
+    std::vector<char> buffer;
+    IR ir = HBFUtils::Instance().getFirstIR();
+    for (int i = 0; i < 2000; i++) {
+      ir.bc = (ir.bc + 1500) % o2::constants::lhc::LHCMaxBunches;
+      ir.orbit += 1 + i % 3;
+      for (int il = 0; il < NLinkPerCRU; il++) {
+        buffer.assign(RDHUtils::GBTWord * (1 + (i * 7 + il * 131) % 1000), char(i + il));
+        writer.addData(il, 0, il, 0, ir, buffer);
+      }
+    }
+    writer.close();
+  }
+  std::vector<std::vector<char>> contents;
+  for (const auto& name : names) {
+    std::ifstream in(name, std::ios::binary);
+    contents.emplace_back((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(name.c_str());
+  }
+  BOOST_CHECK(contents[0].size() > 0);
+  BOOST_CHECK(contents[0] == contents[1]);
+}
+
 } // namespace o2
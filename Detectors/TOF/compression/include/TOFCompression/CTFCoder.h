@@ -0,0 +1,99 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFCoder.h
+/// @brief  Compressed time frame (CTF) coding of the TOF compressed raw data
+
+#ifndef O2_TOF_CTFCODER
+#define O2_TOF_CTFCODER
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "DetectorsCommonDataFormats/CTFCoder.h"
+
+namespace o2
+{
+namespace tof
+{
+
+/// column decomposition of the CRAWDATA messages of a time frame
+struct CTFTraits {
+  struct Header {
+    uint32_t nMessages = 0;
+    uint32_t nPages = 0;
+    uint32_t nCrates = 0;
+    uint32_t nFrames = 0;
+    uint32_t nHits = 0;
+    uint32_t nRawPages = 0; // pages which do not follow the compressed data format
+  };
+
+  enum Slots {
+    BLCmsgSubSpec,      // subspecification of the message
+    BLCmsgSize,         // bytes of the message
+    BLCmsgRaw,          // 1 if the message is not a sequence of pages, its bytes are in BLCrawBytes
+    BLCrawBytes,        // bytes of the raw messages
+    BLCrdhSize,         // 32 bit words of the RDH of the page
+    BLCrdhWords,        // words of the RDH, xor-ed with the ones of the previous RDH
+    BLCpageNWords,      // 32 bit words of the payload of the page
+    BLCpageRaw,         // 1 if the payload is not a sequence of crates, its words are in BLCrawWords
+    BLCrawWords,        // words of the raw pages
+    BLCcrateBC,         // crate header: bunch ID
+    BLCcrateInfo,       // crate header: slot enable mask and DRM ID
+    BLCcrateOrbitInc,   // crate orbit increment wrt the previous crate
+    BLCcrateNFrames,    // number of frames of the crate
+    BLCtrailerNDiag,    // crate trailer: number of diagnostic words
+    BLCtrailerInfo,     // crate trailer: event counter and the other bits
+    BLCdiagnostic,      // diagnostic words
+    BLCframeNHits,      // frame header: number of hits
+    BLCframeID,         // frame header: frame ID
+    BLCframeTRM,        // frame header: TRM ID and delta BC
+    BLChitTOT,          // packed hit: time over threshold
+    BLChitTime,         // packed hit: time in the frame
+    BLChitChan          // packed hit: channel, TDC ID and chain
+  };
+
+  using Columns = std::tuple<std::vector<uint32_t>, std::vector<uint32_t>, std::vector<uint8_t>, std::vector<uint8_t>,
+                             std::vector<uint8_t>, std::vector<uint32_t>, std::vector<uint32_t>, std::vector<uint8_t>, std::vector<uint32_t>,
+                             std::vector<uint16_t>, std::vector<uint32_t>, std::vector<uint32_t>, std::vector<uint16_t>,
+                             std::vector<uint8_t>, std::vector<uint32_t>, std::vector<uint32_t>,
+                             std::vector<uint16_t>, std::vector<uint8_t>, std::vector<uint8_t>,
+                             std::vector<uint16_t>, std::vector<uint16_t>, std::vector<uint8_t>>;
+};
+
+/// @class CTFCoder
+/// @brief Encodes the CRAWDATA messages of the Compressor into the TOF CTF and back.
+///
+/// The pages of the messages are split into their RDH and the fields of the
+/// crate, frame and hit words of the compressed data format. Pages and messages
+/// which cannot be parsed are kept as they are, the conversion is lossless.
+class CTFCoder
+{
+ public:
+  using Coder = o2::ctf::CTFCoder<CTFTraits>;
+
+  struct Message {
+    uint32_t subSpec = 0;
+    const char* data = nullptr;
+    size_t size = 0;
+  };
+
+  /// encode the messages of the time frame, replacing the content of the output
+  static void encode(const std::vector<Message>& messages, std::vector<char>& output, int nThreads = 1);
+
+  /// decode the CTF into the subspecifications and payloads of the messages.
+  /// Throws std::runtime_error if the CTF is not consistent.
+  static void decode(const char* data, size_t size, std::vector<uint32_t>& subSpecs, std::vector<std::vector<char>>& payloads, int nThreads = 1);
+};
+
+} // namespace tof
+} // namespace o2
+
+#endif /** O2_TOF_CTFCODER **/
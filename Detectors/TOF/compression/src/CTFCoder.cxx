@@ -0,0 +1,332 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFCoder.cxx
+/// @brief  Compressed time frame (CTF) coding of the TOF compressed raw data
+
+#include "TOFCompression/CTFCoder.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsRaw/RDHUtils.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace o2::tof;
+using RDHUtils = o2::raw::RDHUtils;
+
+namespace
+{
+constexpr uint32_t WordTypeBit = 0x80000000; // set for the crate header and trailer
+constexpr int NXorWords = sizeof(RDHUtils::RDHDef) / 4;
+
+uint32_t readWord(const char* ptr)
+{
+  uint32_t word;
+  std::memcpy(&word, ptr, sizeof(word));
+  return word;
+}
+
+/// check that the message is a sequence of pages made of an RDH and a payload of 32 bit words
+bool checkPages(const char* data, size_t size)
+{
+  for (size_t offset = 0; offset < size;) {
+    if (size - offset < sizeof(RDHUtils::RDHDef)) {
+      return false;
+    }
+    RDHUtils::RDHDef rdh;
+    std::memcpy(&rdh, data + offset, sizeof(rdh));
+    size_t headerSize = RDHUtils::getHeaderSize(rdh);
+    size_t memorySize = RDHUtils::getMemorySize(rdh);
+    if (headerSize == 0 || headerSize % 4 || memorySize < headerSize || (memorySize - headerSize) % 4 || memorySize > size - offset) {
+      return false;
+    }
+    offset += memorySize;
+  }
+  return true;
+}
+
+/// check that the words are a sequence of complete crates, as written by the Compressor
+bool checkCrates(const uint32_t* words, size_t n)
+{
+  size_t i = 0;
+  while (i < n) {
+    if (!(words[i] & WordTypeBit) || i + 1 >= n) { // crate header and orbit
+      return false;
+    }
+    i += 2;
+    size_t nFrames = 0;
+    while (i < n && !(words[i] & WordTypeBit)) { // frame header and hits
+      i += 1 + (words[i] & 0xffff);
+      if (++nFrames > 0xffff) {
+        return false;
+      }
+    }
+    if (i >= n) {
+      return false;
+    }
+    i += 1 + (words[i] & 0xf); // crate trailer and diagnostics
+  }
+  return i == n;
+}
+
+/// bounds checked sequential access to a decoded column
+template <typename T>
+class Cursor
+{
+ public:
+  Cursor(const std::vector<T>& column, const char* name) : mColumn(column), mName(name) {}
+  T next()
+  {
+    if (mPos >= mColumn.size()) {
+      throw std::runtime_error(std::string("TOF CTF: column ") + mName + " is exhausted");
+    }
+    return mColumn[mPos++];
+  }
+  void checkEnd() const
+  {
+    if (mPos != mColumn.size()) {
+      throw std::runtime_error(std::string("TOF CTF: ") + std::to_string(mColumn.size() - mPos) + " elements left in column " + mName);
+    }
+  }
+
+ private:
+  const std::vector<T>& mColumn;
+  const char* mName;
+  size_t mPos = 0;
+};
+} // namespace
+
+void CTFCoder::encode(const std::vector<Message>& messages, std::vector<char>& output, int nThreads)
+{
+  using T = CTFTraits;
+  CTFTraits::Header header;
+  CTFTraits::Columns columns;
+  auto& subSpec = std::get<T::BLCmsgSubSpec>(columns);
+  auto& msgSize = std::get<T::BLCmsgSize>(columns);
+  auto& msgRaw = std::get<T::BLCmsgRaw>(columns);
+  auto& rawBytes = std::get<T::BLCrawBytes>(columns);
+  auto& rdhSize = std::get<T::BLCrdhSize>(columns);
+  auto& rdhWords = std::get<T::BLCrdhWords>(columns);
+  auto& pageNWords = std::get<T::BLCpageNWords>(columns);
+  auto& pageRaw = std::get<T::BLCpageRaw>(columns);
+  auto& rawWords = std::get<T::BLCrawWords>(columns);
+  auto& crateBC = std::get<T::BLCcrateBC>(columns);
+  auto& crateInfo = std::get<T::BLCcrateInfo>(columns);
+  auto& crateOrbitInc = std::get<T::BLCcrateOrbitInc>(columns);
+  auto& crateNFrames = std::get<T::BLCcrateNFrames>(columns);
+  auto& trailerNDiag = std::get<T::BLCtrailerNDiag>(columns);
+  auto& trailerInfo = std::get<T::BLCtrailerInfo>(columns);
+  auto& diagnostic = std::get<T::BLCdiagnostic>(columns);
+  auto& frameNHits = std::get<T::BLCframeNHits>(columns);
+  auto& frameID = std::get<T::BLCframeID>(columns);
+  auto& frameTRM = std::get<T::BLCframeTRM>(columns);
+  auto& hitTOT = std::get<T::BLChitTOT>(columns);
+  auto& hitTime = std::get<T::BLChitTime>(columns);
+  auto& hitChan = std::get<T::BLChitChan>(columns);
+
+  std::array<uint32_t, NXorWords> prevRDH{};
+  uint32_t prevOrbit = 0;
+  std::vector<uint32_t> words;
+  for (const auto& msg : messages) {
+    if (msg.size > UINT32_MAX || (msg.size && !msg.data)) {
+      throw std::runtime_error("TOF CTF: invalid message of " + std::to_string(msg.size) + " bytes");
+    }
+    header.nMessages++;
+    subSpec.push_back(msg.subSpec);
+    msgSize.push_back(msg.size);
+    bool parse = checkPages(msg.data, msg.size);
+    msgRaw.push_back(!parse);
+    if (!parse) {
+      rawBytes.insert(rawBytes.end(), msg.data, msg.data + msg.size);
+      continue;
+    }
+    for (size_t offset = 0; offset < msg.size; header.nPages++) {
+      const char* page = msg.data + offset;
+      RDHUtils::RDHDef rdh;
+      std::memcpy(&rdh, page, sizeof(rdh));
+      size_t headerSize = RDHUtils::getHeaderSize(rdh);
+      size_t memorySize = RDHUtils::getMemorySize(rdh);
+      rdhSize.push_back(headerSize / 4);
+      for (size_t k = 0; k < headerSize / 4; k++) {
+        auto word = readWord(page + 4 * k);
+        if (k < NXorWords) {
+          rdhWords.push_back(word ^ prevRDH[k]);
+          prevRDH[k] = word;
+        } else {
+          rdhWords.push_back(word);
+        }
+      }
+      size_t nWords = (memorySize - headerSize) / 4;
+      pageNWords.push_back(nWords);
+      words.resize(nWords);
+      std::memcpy(words.data(), page + headerSize, nWords * 4);
+      offset += memorySize;
+      bool parseCrates = checkCrates(words.data(), nWords);
+      pageRaw.push_back(!parseCrates);
+      if (!parseCrates) {
+        header.nRawPages++;
+        rawWords.insert(rawWords.end(), words.begin(), words.end());
+        continue;
+      }
+      for (size_t i = 0; i < nWords; header.nCrates++) {
+        crateBC.push_back(words[i] & 0xfff);
+        crateInfo.push_back((words[i] >> 12) & 0x7ffff);
+        crateOrbitInc.push_back(words[i + 1] - prevOrbit);
+        prevOrbit = words[i + 1];
+        i += 2;
+        uint16_t nFrames = 0;
+        for (; !(words[i] & WordTypeBit); nFrames++) {
+          uint32_t nHits = words[i] & 0xffff;
+          frameNHits.push_back(nHits);
+          frameID.push_back((words[i] >> 16) & 0xff);
+          frameTRM.push_back((words[i] >> 24) & 0x7f);
+          for (uint32_t j = 1; j <= nHits; j++) {
+            hitTOT.push_back(words[i + j] & 0x7ff);
+            hitTime.push_back((words[i + j] >> 11) & 0x1fff);
+            hitChan.push_back(words[i + j] >> 24);
+          }
+          i += 1 + nHits;
+          header.nHits += nHits;
+        }
+        header.nFrames += nFrames;
+        crateNFrames.push_back(nFrames);
+        uint32_t nDiag = words[i] & 0xf;
+        trailerNDiag.push_back(nDiag);
+        trailerInfo.push_back((words[i] >> 4) & 0x7ffffff);
+        diagnostic.insert(diagnostic.end(), words.begin() + i + 1, words.begin() + i + 1 + nDiag);
+        i += 1 + nDiag;
+      }
+    }
+  }
+
+  Coder::encode(o2::detectors::DetID::TOF, header, columns, output, nThreads);
+}
+
+void CTFCoder::decode(const char* data, size_t size, std::vector<uint32_t>& subSpecs, std::vector<std::vector<char>>& payloads, int nThreads)
+{
+  using T = CTFTraits;
+  CTFTraits::Header header;
+  CTFTraits::Columns columns;
+  Coder::decode(o2::detectors::DetID::TOF, data, size, header, columns, nThreads);
+
+  Cursor<uint32_t> subSpec(std::get<T::BLCmsgSubSpec>(columns), "msgSubSpec");
+  Cursor<uint32_t> msgSize(std::get<T::BLCmsgSize>(columns), "msgSize");
+  Cursor<uint8_t> msgRaw(std::get<T::BLCmsgRaw>(columns), "msgRaw");
+  Cursor<uint8_t> rawBytes(std::get<T::BLCrawBytes>(columns), "rawBytes");
+  Cursor<uint8_t> rdhSize(std::get<T::BLCrdhSize>(columns), "rdhSize");
+  Cursor<uint32_t> rdhWords(std::get<T::BLCrdhWords>(columns), "rdhWords");
+  Cursor<uint32_t> pageNWords(std::get<T::BLCpageNWords>(columns), "pageNWords");
+  Cursor<uint8_t> pageRaw(std::get<T::BLCpageRaw>(columns), "pageRaw");
+  Cursor<uint32_t> rawWords(std::get<T::BLCrawWords>(columns), "rawWords");
+  Cursor<uint16_t> crateBC(std::get<T::BLCcrateBC>(columns), "crateBC");
+  Cursor<uint32_t> crateInfo(std::get<T::BLCcrateInfo>(columns), "crateInfo");
+  Cursor<uint32_t> crateOrbitInc(std::get<T::BLCcrateOrbitInc>(columns), "crateOrbitInc");
+  Cursor<uint16_t> crateNFrames(std::get<T::BLCcrateNFrames>(columns), "crateNFrames");
+  Cursor<uint8_t> trailerNDiag(std::get<T::BLCtrailerNDiag>(columns), "trailerNDiag");
+  Cursor<uint32_t> trailerInfo(std::get<T::BLCtrailerInfo>(columns), "trailerInfo");
+  Cursor<uint32_t> diagnostic(std::get<T::BLCdiagnostic>(columns), "diagnostic");
+  Cursor<uint16_t> frameNHits(std::get<T::BLCframeNHits>(columns), "frameNHits");
+  Cursor<uint8_t> frameID(std::get<T::BLCframeID>(columns), "frameID");
+  Cursor<uint8_t> frameTRM(std::get<T::BLCframeTRM>(columns), "frameTRM");
+  Cursor<uint16_t> hitTOT(std::get<T::BLChitTOT>(columns), "hitTOT");
+  Cursor<uint16_t> hitTime(std::get<T::BLChitTime>(columns), "hitTime");
+  Cursor<uint8_t> hitChan(std::get<T::BLChitChan>(columns), "hitChan");
+
+  subSpecs.resize(header.nMessages);
+  payloads.resize(header.nMessages);
+  std::array<uint32_t, NXorWords> prevRDH{};
+  uint32_t prevOrbit = 0;
+  for (uint32_t iMsg = 0; iMsg < header.nMessages; iMsg++) {
+    subSpecs[iMsg] = subSpec.next();
+    auto& payload = payloads[iMsg];
+    payload.resize(msgSize.next());
+    if (msgRaw.next()) {
+      for (auto& byte : payload) {
+        byte = rawBytes.next();
+      }
+      continue;
+    }
+    char* ptr = payload.data();
+    char* end = ptr + payload.size();
+    auto put = [&ptr, end](uint32_t word) {
+      if (end - ptr < 4) {
+        throw std::runtime_error("TOF CTF: page exceeds its message");
+      }
+      std::memcpy(ptr, &word, sizeof(word));
+      ptr += sizeof(word);
+    };
+    while (ptr < end) {
+      auto nRDHWords = rdhSize.next();
+      for (size_t k = 0; k < nRDHWords; k++) {
+        auto word = rdhWords.next();
+        if (k < NXorWords) {
+          word ^= prevRDH[k];
+          prevRDH[k] = word;
+        }
+        put(word);
+      }
+      auto nWords = pageNWords.next();
+      if (nWords > size_t(end - ptr) / 4) {
+        throw std::runtime_error("TOF CTF: page exceeds its message");
+      }
+      char* pageEnd = ptr + 4 * size_t(nWords);
+      if (pageRaw.next()) {
+        while (ptr < pageEnd) {
+          put(rawWords.next());
+        }
+        continue;
+      }
+      while (ptr < pageEnd) {
+        put(WordTypeBit | (crateInfo.next() << 12) | crateBC.next());
+        prevOrbit += crateOrbitInc.next();
+        put(prevOrbit);
+        for (auto nFrames = crateNFrames.next(); nFrames--;) {
+          uint32_t nHits = frameNHits.next();
+          put(nHits | (frameID.next() << 16) | (uint32_t(frameTRM.next()) << 24));
+          for (uint32_t j = 0; j < nHits; j++) {
+            put(hitTOT.next() | (hitTime.next() << 11) | (uint32_t(hitChan.next()) << 24));
+          }
+        }
+        uint32_t nDiag = trailerNDiag.next();
+        put(WordTypeBit | (trailerInfo.next() << 4) | nDiag);
+        for (uint32_t j = 0; j < nDiag; j++) {
+          put(diagnostic.next());
+        }
+      }
+      if (ptr != pageEnd) {
+        throw std::runtime_error("TOF CTF: crates exceed their page");
+      }
+    }
+  }
+  subSpec.checkEnd();
+  msgSize.checkEnd();
+  msgRaw.checkEnd();
+  rawBytes.checkEnd();
+  rdhSize.checkEnd();
+  rdhWords.checkEnd();
+  pageNWords.checkEnd();
+  pageRaw.checkEnd();
+  rawWords.checkEnd();
+  crateBC.checkEnd();
+  crateInfo.checkEnd();
+  crateOrbitInc.checkEnd();
+  crateNFrames.checkEnd();
+  trailerNDiag.checkEnd();
+  trailerInfo.checkEnd();
+  diagnostic.checkEnd();
+  frameNHits.checkEnd();
+  frameID.checkEnd();
+  frameTRM.checkEnd();
+  hitTOT.checkEnd();
+  hitTime.checkEnd();
+  hitChan.checkEnd();
+}
@@ -0,0 +1,46 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   EntropyDecoderSpec.h
+/// @brief  TOF entropy decoder task, TOF CTF into CRAWDATA messages
+
+#ifndef O2_TOF_ENTROPYDECODERSPEC
+#define O2_TOF_ENTROPYDECODERSPEC
+
+#include "Framework/Task.h"
+#include "Framework/DataProcessorSpec.h"
+#include <vector>
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace tof
+{
+
+class EntropyDecoderSpec : public Task
+{
+ public:
+  EntropyDecoderSpec() = default;
+  ~EntropyDecoderSpec() override = default;
+  void init(InitContext& ic) final;
+  void run(ProcessingContext& pc) final;
+
+ private:
+  int mNThreads = 1;
+};
+
+/// create a processor spec decoding TOF/CTFDATA into the TOF/CRAWDATA messages, with their original subspecifications
+framework::DataProcessorSpec getEntropyDecoderSpec();
+
+} // namespace tof
+} // namespace o2
+
+#endif /** O2_TOF_ENTROPYDECODERSPEC **/
@@ -0,0 +1,47 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   EntropyEncoderSpec.h
+/// @brief  TOF entropy encoder task, CRAWDATA messages into the TOF CTF
+
+#ifndef O2_TOF_ENTROPYENCODERSPEC
+#define O2_TOF_ENTROPYENCODERSPEC
+
+#include "Framework/Task.h"
+#include "Framework/DataProcessorSpec.h"
+#include <vector>
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace tof
+{
+
+class EntropyEncoderSpec : public Task
+{
+ public:
+  EntropyEncoderSpec() = default;
+  ~EntropyEncoderSpec() override = default;
+  void init(InitContext& ic) final;
+  void run(ProcessingContext& pc) final;
+
+ private:
+  int mNThreads = 1;
+  std::vector<char> mBuffer;
+};
+
+/// create a processor spec encoding all the TOF/CRAWDATA messages of the time frame into TOF/CTFDATA
+framework::DataProcessorSpec getEntropyEncoderSpec();
+
+} // namespace tof
+} // namespace o2
+
+#endif /** O2_TOF_ENTROPYENCODERSPEC **/
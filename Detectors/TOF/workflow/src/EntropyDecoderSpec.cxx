@@ -0,0 +1,66 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   EntropyDecoderSpec.cxx
+/// @brief  TOF entropy decoder task, TOF CTF into CRAWDATA messages
+
+#include "TOFWorkflow/EntropyDecoderSpec.h"
+#include "TOFCompression/CTFCoder.h"
+#include "Framework/ConfigParamRegistry.h"
+#include "Framework/ConcreteDataMatcher.h"
+#include "Headers/DataHeader.h"
+
+#include <chrono>
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace tof
+{
+
+void EntropyDecoderSpec::init(InitContext& ic)
+{
+  mNThreads = ic.options().get<int>("nthreads");
+}
+
+void EntropyDecoderSpec::run(ProcessingContext& pc)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto buffer = pc.inputs().get<gsl::span<char>>("ctf");
+
+  std::vector<uint32_t> subSpecs;
+  std::vector<std::vector<char>> payloads;
+  CTFCoder::decode(buffer.data(), buffer.size(), subSpecs, payloads, mNThreads);
+
+  /** send the messages with their original subspecification **/
+  size_t outputSize = 0;
+  for (size_t i = 0; i < payloads.size(); i++) {
+    pc.outputs().snapshot(Output{o2::header::gDataOriginTOF, "CRAWDATA", subSpecs[i], Lifetime::Timeframe}, payloads[i]);
+    outputSize += payloads[i].size();
+  }
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  LOG(INFO) << "Decoded " << payloads.size() << " TOF messages (" << outputSize << " bytes) from "
+            << buffer.size() << " bytes in " << elapsed.count() << " ms";
+}
+
+DataProcessorSpec getEntropyDecoderSpec()
+{
+  return DataProcessorSpec{
+    "tof-entropy-decoder",
+    Inputs{{"ctf", o2::header::gDataOriginTOF, "CTFDATA", 0, Lifetime::Timeframe}},
+    Outputs{OutputSpec(ConcreteDataTypeMatcher{o2::header::gDataOriginTOF, "CRAWDATA"})},
+    AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>()},
+    Options{{"nthreads", VariantType::Int, 2, {"number of threads decoding the columns in parallel"}}}};
+}
+
+} // namespace tof
+} // namespace o2
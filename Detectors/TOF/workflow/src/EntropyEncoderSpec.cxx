@@ -0,0 +1,67 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   EntropyEncoderSpec.cxx
+/// @brief  TOF entropy encoder task, CRAWDATA messages into the TOF CTF
+
+#include "TOFWorkflow/EntropyEncoderSpec.h"
+#include "TOFCompression/CTFCoder.h"
+#include "Framework/ConfigParamRegistry.h"
+#include "Framework/ConcreteDataMatcher.h"
+#include "Framework/DataRefUtils.h"
+#include "Headers/DataHeader.h"
+
+#include <chrono>
+
+using namespace o2::framework;
+
+namespace o2
+{
+namespace tof
+{
+
+void EntropyEncoderSpec::init(InitContext& ic)
+{
+  mNThreads = ic.options().get<int>("nthreads");
+}
+
+void EntropyEncoderSpec::run(ProcessingContext& pc)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  /** collect the messages **/
+  std::vector<CTFCoder::Message> messages;
+  size_t inputSize = 0;
+  for (auto& input : pc.inputs()) {
+    auto headerIn = DataRefUtils::getHeader<o2::header::DataHeader*>(input);
+    messages.push_back(CTFCoder::Message{headerIn->subSpecification, input.payload, headerIn->payloadSize});
+    inputSize += headerIn->payloadSize;
+  }
+
+  CTFCoder::encode(messages, mBuffer, mNThreads);
+  pc.outputs().snapshot(Output{o2::header::gDataOriginTOF, "CTFDATA", 0, Lifetime::Timeframe}, mBuffer);
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  LOG(INFO) << "Encoded " << messages.size() << " TOF messages (" << inputSize << " bytes) to "
+            << mBuffer.size() << " bytes in " << elapsed.count() << " ms";
+}
+
+DataProcessorSpec getEntropyEncoderSpec()
+{
+  return DataProcessorSpec{
+    "tof-entropy-encoder",
+    Inputs{{"crawdata", ConcreteDataTypeMatcher{o2::header::gDataOriginTOF, "CRAWDATA"}, Lifetime::Timeframe}},
+    Outputs{{o2::header::gDataOriginTOF, "CTFDATA", 0, Lifetime::Timeframe}},
+    AlgorithmSpec{adaptFromTask<EntropyEncoderSpec>()},
+    Options{{"nthreads", VariantType::Int, 2, {"number of threads coding the columns in parallel"}}}};
+}
+
+} // namespace tof
+} // namespace o2
@@ -0,0 +1,63 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CompressedClustersCoder.h
+/// \brief Entropy coding of the TPC CompressedClusters arrays
+#ifndef ALICEO2_TPC_COMPRESSEDCLUSTERSCODER_H_
+#define ALICEO2_TPC_COMPRESSEDCLUSTERSCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DataFormatsTPC/CompressedClusters.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+/// @class CompressedClustersCoder
+/// @brief Entropy codes every array of the CompressedClusters with the rANS
+/// block coder, with the frequency tables of the arrays built per time frame.
+///
+/// The encoded message starts with a Header holding the counters, followed by
+/// one rANS block per array, in the order defined by CompressedClustersHelpers.
+/// The message is self-contained, the blocks carry their frequency tables.
+/// The arrays are coded in parallel by nThreads threads.
+class CompressedClustersCoder
+{
+ public:
+  struct Header {
+    uint32_t magic = Magic;
+    uint16_t version = 1;
+    uint16_t nArrays = 0;
+    uint32_t nTracks = 0;
+    uint32_t nAttachedClusters = 0;
+    uint32_t nUnattachedClusters = 0;
+    uint32_t nAttachedClustersReduced = 0;
+    uint32_t nSliceRows = 0;
+    uint8_t nComppressionModes = 0;
+    uint8_t reserved[3] = {0, 0, 0};
+  };
+  static constexpr uint32_t Magic = 0x43435054; // "TPCC"
+
+  /// encode the clusters, replacing the content of the output
+  static void encode(const CompressedClusters& clusters, std::vector<char>& output, int nThreads = 1);
+
+  /// decode the message into the clusters, the arrays are stored in the flat buffer
+  /// which is also attached as flatdata of the clusters, ready to be streamed.
+  /// Throws std::runtime_error for messages which are not consistent.
+  static void decode(const char* data, size_t size, CompressedClusters& clusters, std::vector<char>& flatBuffer, int nThreads = 1);
+};
+
+} // namespace tpc
+} // namespace o2
+
+#endif
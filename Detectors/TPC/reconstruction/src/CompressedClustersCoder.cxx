@@ -0,0 +1,136 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CompressedClustersCoder.cxx
+/// \brief Entropy coding of the TPC CompressedClusters arrays
+
+#include "TPCReconstruction/CompressedClustersCoder.h"
+#include "DataFormatsTPC/CompressedClustersHelpers.h"
+#include "rANS/BlockCoder.h"
+#include "CommonUtils/ParallelUtils.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace o2::tpc;
+
+namespace
+{
+struct Array {
+  void* data;
+  size_t n;
+  size_t elementSize;
+};
+
+/// the arrays of the clusters, in the order of the flat layout
+std::vector<Array> getArrays(CompressedClusters& clusters)
+{
+  std::vector<Array> arrays;
+  auto collect = [&arrays](auto& /*ptr*/, auto count, auto&... ptrs) {
+    (arrays.push_back(Array{ptrs, count, sizeof(*ptrs)}), ...);
+    return size_t(0);
+  };
+  char* dummyptr = nullptr;
+  CompressedClustersHelpers::apply(collect, dummyptr, clusters);
+  return arrays;
+}
+
+std::vector<size_t> getSizes(const std::vector<Array>& arrays)
+{
+  std::vector<size_t> sizes;
+  for (const auto& array : arrays) {
+    sizes.push_back(array.n * array.elementSize);
+  }
+  return sizes;
+}
+} // namespace
+
+void CompressedClustersCoder::encode(const CompressedClusters& clusters, std::vector<char>& output, int nThreads)
+{
+  // the arrays are only read, the helper does not provide a const interface
+  auto arrays = getArrays(const_cast<CompressedClusters&>(clusters));
+  for (const auto& array : arrays) {
+    if (array.n && !array.data) {
+      throw std::runtime_error("invalid nullptr to array of " + std::to_string(array.n) + " element(s)");
+    }
+  }
+  std::vector<std::vector<char>> blocks(arrays.size());
+  o2::utils::runParallelLargestFirst(nThreads, getSizes(arrays), [&arrays, &blocks](size_t i) {
+    o2::rans::encode(arrays[i].data, arrays[i].n, arrays[i].elementSize, blocks[i]);
+  });
+
+  Header header;
+  header.nArrays = arrays.size();
+  header.nTracks = clusters.nTracks;
+  header.nAttachedClusters = clusters.nAttachedClusters;
+  header.nUnattachedClusters = clusters.nUnattachedClusters;
+  header.nAttachedClustersReduced = clusters.nAttachedClustersReduced;
+  header.nSliceRows = clusters.nSliceRows;
+  header.nComppressionModes = clusters.nComppressionModes;
+  size_t size = sizeof(Header);
+  for (const auto& block : blocks) {
+    size += block.size();
+  }
+  output.resize(size);
+  std::memcpy(output.data(), &header, sizeof(Header));
+  auto ptr = output.data() + sizeof(Header);
+  for (const auto& block : blocks) {
+    std::memcpy(ptr, block.data(), block.size());
+    ptr += block.size();
+  }
+}
+
+void CompressedClustersCoder::decode(const char* data, size_t size, CompressedClusters& clusters, std::vector<char>& flatBuffer, int nThreads)
+{
+  Header header;
+  if (size < sizeof(Header)) {
+    throw std::runtime_error("encoded TPC clusters: message of " + std::to_string(size) + " bytes is too small");
+  }
+  std::memcpy(&header, data, sizeof(Header));
+  if (header.magic != Magic || header.version != 1) {
+    throw std::runtime_error("encoded TPC clusters: unknown message format");
+  }
+  clusters = CompressedClusters();
+  clusters.nTracks = header.nTracks;
+  clusters.nAttachedClusters = header.nAttachedClusters;
+  clusters.nUnattachedClusters = header.nUnattachedClusters;
+  clusters.nAttachedClustersReduced = header.nAttachedClustersReduced;
+  clusters.nSliceRows = header.nSliceRows;
+  clusters.nComppressionModes = header.nComppressionModes;
+
+  // allocate the flat buffer for the counters and let the arrays point into it
+  char* dummyptr = nullptr;
+  auto calc_size = [](auto&... args) { return o2::algorithm::flatten::calc_size(args...); };
+  flatBuffer.resize(CompressedClustersHelpers::apply(calc_size, dummyptr, clusters));
+  CompressedClustersHelpers::restoreFrom(flatBuffer, clusters);
+  clusters.flatdata = flatBuffer.data();
+  clusters.flatdataSize = flatBuffer.size();
+
+  auto arrays = getArrays(clusters);
+  if (header.nArrays != arrays.size()) {
+    throw std::runtime_error("encoded TPC clusters: " + std::to_string(header.nArrays) + " arrays instead of " + std::to_string(arrays.size()));
+  }
+  // the blocks are located sequentially, the decoding is done in parallel
+  std::vector<std::pair<const char*, size_t>> blocks;
+  const char* ptr = data + sizeof(Header);
+  const char* end = data + size;
+  for (size_t i = 0; i < arrays.size(); i++) {
+    auto blockSize = o2::rans::getHeader(ptr, end - ptr).blockSize;
+    blocks.emplace_back(ptr, blockSize);
+    ptr += blockSize;
+  }
+  if (ptr != end) {
+    throw std::runtime_error("encoded TPC clusters: " + std::to_string(end - ptr) + " trailing bytes");
+  }
+  o2::utils::runParallelLargestFirst(nThreads, getSizes(arrays), [&arrays, &blocks](size_t i) {
+    o2::rans::decode(blocks[i].first, blocks[i].second, arrays[i].data, arrays[i].n, arrays[i].elementSize);
+  });
+}
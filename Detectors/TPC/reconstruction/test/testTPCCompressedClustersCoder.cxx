@@ -0,0 +1,134 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCCompressedClustersCoder.cxx
+/// \brief Round trip of the entropy coding of the TPC CompressedClusters
+
+#define BOOST_TEST_MODULE Test TPC CompressedClustersCoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "TPCReconstruction/CompressedClustersCoder.h"
+#include "DataFormatsTPC/CompressedClustersHelpers.h"
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace o2
+{
+namespace tpc
+{
+
+// fills the arrays of the clusters with random values of typical ranges, the arrays are stored in the buffer
+void fillClusters(CompressedClusters& clusters, std::vector<char>& buffer)
+{
+  std::mt19937 rng(42);
+  clusters.nTracks = 1000;
+  clusters.nAttachedClusters = 100000;
+  clusters.nAttachedClustersReduced = clusters.nAttachedClusters - clusters.nTracks;
+  clusters.nUnattachedClusters = 50000;
+  clusters.nSliceRows = 36 * 152;
+  clusters.nComppressionModes = 3;
+  char* dummyptr = nullptr;
+  auto calc_size = [](auto&... args) { return o2::algorithm::flatten::calc_size(args...); };
+  buffer.resize(CompressedClustersHelpers::apply(calc_size, dummyptr, clusters));
+  CompressedClustersHelpers::restoreFrom(buffer, clusters);
+
+  std::geometric_distribution<unsigned int> small(0.3), medium(0.01);
+  for (unsigned int i = 0; i < clusters.nAttachedClusters; i++) {
+    clusters.qTotA[i] = medium(rng);
+    clusters.qMaxA[i] = small(rng) * 10;
+    clusters.flagsA[i] = rng() % 100 ? 0 : 1 << (rng() % 8);
+    clusters.sigmaPadA[i] = small(rng);
+    clusters.sigmaTimeA[i] = small(rng);
+  }
+  for (unsigned int i = 0; i < clusters.nAttachedClustersReduced; i++) {
+    clusters.rowDiffA[i] = 1 + small(rng) % 3;
+    clusters.sliceLegDiffA[i] = rng() % 50 ? 0 : 1;
+    clusters.padResA[i] = medium(rng);
+    clusters.timeResA[i] = rng() % 2 ? medium(rng) : 0xffffff - medium(rng); // signed residuals
+  }
+  for (unsigned int i = 0; i < clusters.nTracks; i++) {
+    clusters.qPtA[i] = rng();
+    clusters.rowA[i] = rng() % 152;
+    clusters.sliceA[i] = rng() % 36;
+    clusters.timeA[i] = rng() % 500000;
+    clusters.padA[i] = rng() % 140;
+    clusters.nTrackClusters[i] = 50 + rng() % 100;
+  }
+  for (unsigned int i = 0; i < clusters.nUnattachedClusters; i++) {
+    clusters.qTotU[i] = medium(rng);
+    clusters.qMaxU[i] = small(rng) * 10;
+    clusters.flagsU[i] = 0;
+    clusters.padDiffU[i] = medium(rng);
+    clusters.timeDiffU[i] = medium(rng) * 16;
+    clusters.sigmaPadU[i] = small(rng);
+    clusters.sigmaTimeU[i] = small(rng);
+  }
+  for (unsigned int i = 0; i < clusters.nSliceRows; i++) {
+    clusters.nSliceRowClusters[i] = small(rng);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CompressedClustersCoder_RoundTrip)
+{
+  CompressedClusters clusters;
+  std::vector<char> flat;
+  fillClusters(clusters, flat);
+
+  std::vector<char> encoded, encodedMT;
+  CompressedClustersCoder::encode(clusters, encoded, 1);
+  CompressedClustersCoder::encode(clusters, encodedMT, 4);
+  BOOST_CHECK(encoded == encodedMT); // the threading must not change the result
+  BOOST_CHECK(encoded.size() < flat.size() / 2);
+
+  for (int nThreads : {1, 4}) {
+    CompressedClusters decoded;
+    std::vector<char> decodedFlat;
+    CompressedClustersCoder::decode(encoded.data(), encoded.size(), decoded, decodedFlat, nThreads);
+    BOOST_CHECK(decoded.nTracks == clusters.nTracks);
+    BOOST_CHECK(decoded.nAttachedClusters == clusters.nAttachedClusters);
+    BOOST_CHECK(decoded.nAttachedClustersReduced == clusters.nAttachedClustersReduced);
+    BOOST_CHECK(decoded.nUnattachedClusters == clusters.nUnattachedClusters);
+    BOOST_CHECK(decoded.nSliceRows == clusters.nSliceRows);
+    BOOST_CHECK(decoded.nComppressionModes == clusters.nComppressionModes);
+    BOOST_CHECK(decoded.flatdata == decodedFlat.data());
+    BOOST_CHECK(decodedFlat == flat);
+  }
+
+  // an empty time frame
+  CompressedClusters empty;
+  empty.nSliceRows = 0;
+  CompressedClustersCoder::encode(empty, encoded);
+  CompressedClusters decoded;
+  std::vector<char> decodedFlat;
+  CompressedClustersCoder::decode(encoded.data(), encoded.size(), decoded, decodedFlat);
+  BOOST_CHECK(decoded.nAttachedClusters == 0 && decodedFlat.empty());
+}
+
+BOOST_AUTO_TEST_CASE(CompressedClustersCoder_Errors)
+{
+  CompressedClusters clusters;
+  std::vector<char> flat;
+  fillClusters(clusters, flat);
+  std::vector<char> encoded;
+  CompressedClustersCoder::encode(clusters, encoded, 2);
+
+  CompressedClusters decoded;
+  std::vector<char> decodedFlat;
+  BOOST_CHECK_THROW(CompressedClustersCoder::decode(encoded.data(), encoded.size() - 4, decoded, decodedFlat, 2), std::runtime_error);
+  auto corrupted = encoded;
+  corrupted[sizeof(CompressedClustersCoder::Header) - 8]++; // one more slice row than encoded
+  BOOST_CHECK_THROW(CompressedClustersCoder::decode(corrupted.data(), corrupted.size(), decoded, decodedFlat, 2), std::runtime_error);
+}
+
+} // namespace tpc
+} // namespace o2
@@ -0,0 +1,30 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_TPC_ENTROPYDECODERSPEC_H
+#define O2_TPC_ENTROPYDECODERSPEC_H
+/// @file   EntropyDecoderSpec.h
+/// @brief  ProcessorSpec for the TPC cluster entropy decoding
+
+#include "Framework/DataProcessorSpec.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+/// create a processor spec decoding the TPC/ENCCLUSTERS message of the entropy encoder
+/// into the TPC/COMPCLUSTERS input of the cluster decompression
+framework::DataProcessorSpec getEntropyDecoderSpec();
+
+} // end namespace tpc
+} // end namespace o2
+
+#endif // O2_TPC_ENTROPYDECODERSPEC_H
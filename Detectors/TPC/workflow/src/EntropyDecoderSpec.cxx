@@ -0,0 +1,73 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   EntropyDecoderSpec.cxx
+/// @brief  ProcessorSpec for the TPC cluster entropy decoding
+
+#include "TPCWorkflow/EntropyDecoderSpec.h"
+#include "Headers/DataHeader.h"
+#include "Framework/ConfigParamRegistry.h"
+#include "Framework/SerializationMethods.h"
+#include "Framework/Logger.h"
+#include "DataFormatsTPC/CompressedClusters.h"
+#include "TPCReconstruction/CompressedClustersCoder.h"
+#include <chrono>
+#include <memory> // for make_shared
+#include <vector>
+
+using namespace o2::framework;
+using namespace o2::header;
+
+namespace o2
+{
+namespace tpc
+{
+
+DataProcessorSpec getEntropyDecoderSpec()
+{
+  struct ProcessAttributes {
+    int verbosity = 1;
+    int nThreads = 1;
+    std::vector<char> flatBuffer;
+  };
+
+  auto initFunction = [](InitContext& ic) {
+    auto processAttributes = std::make_shared<ProcessAttributes>();
+    processAttributes->nThreads = ic.options().get<int>("nthreads");
+
+    auto processingFct = [processAttributes](ProcessingContext& pc) {
+      // the message is raw when coming from the encoder and ROOT serialized when read from file
+      auto encoded = pc.inputs().get<std::vector<char>>("input");
+      auto start = std::chrono::steady_clock::now();
+      CompressedClusters clusters;
+      CompressedClustersCoder::decode(encoded.data(), encoded.size(), clusters, processAttributes->flatBuffer, processAttributes->nThreads);
+      // the arrays point into the reused flat buffer, the ROOT serialization of the snapshot copies them
+      // into the output message
+      pc.outputs().snapshot(Output{gDataOriginTPC, "COMPCLUSTERS", 0}, ROOTSerialized<CompressedClusters const>(clusters));
+      if (processAttributes->verbosity > 0) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        LOG(INFO) << "decoded " << clusters.nTracks << " track(s), " << clusters.nAttachedClusters << " attached and "
+                  << clusters.nUnattachedClusters << " unattached clusters from " << encoded.size() << " bytes in "
+                  << elapsed.count() << " ms";
+      }
+    };
+
+    return processingFct;
+  };
+
+  return DataProcessorSpec{"tpc-entropy-decoder", // process id
+                           {{"input", "TPC", "ENCCLUSTERS", 0, Lifetime::Timeframe}},
+                           {{"TPC", "COMPCLUSTERS", 0, Lifetime::Timeframe}},
+                           AlgorithmSpec(initFunction),
+                           Options{{"nthreads", VariantType::Int, 4, {"number of threads decoding the arrays in parallel"}}}};
+}
+
+} // namespace tpc
+} // namespace o2
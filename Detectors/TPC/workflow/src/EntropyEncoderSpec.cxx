@@ -15,21 +15,14 @@
 
 #include "TPCWorkflow/EntropyEncoderSpec.h"
 #include "Headers/DataHeader.h"
-#include "Framework/WorkflowSpec.h" // o2::framework::mergeInputs
-#include "Framework/DataRefUtils.h"
-#include "Framework/DataSpecUtils.h"
-#include "Framework/ControlService.h"
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/Logger.h"
 #include "DataFormatsTPC/CompressedClusters.h"
-//#include "TPCClusterDecompressor.cxx"
+#include "TPCReconstruction/CompressedClustersCoder.h"
+#include <chrono>
 #include <memory> // for make_shared
 #include <vector>
 
-// TEMP: as a test, the processor simply writes the data to file, remove this
-#include <TFile.h>
-#include <TTree.h>
-
 using namespace o2::framework;
 using namespace o2::header;
 
@@ -42,10 +35,13 @@ DataProcessorSpec getEntropyEncoderSpec()
 {
   struct ProcessAttributes {
     int verbosity = 1;
+    int nThreads = 1;
+    std::vector<char> buffer;
   };
 
   auto initFunction = [](InitContext& ic) {
     auto processAttributes = std::make_shared<ProcessAttributes>();
+    processAttributes->nThreads = ic.options().get<int>("nthreads");
 
     auto processingFct = [processAttributes](ProcessingContext& pc) {
       auto compressed = pc.inputs().get<CompressedClusters*>("input");
@@ -53,16 +49,16 @@ DataProcessorSpec getEntropyEncoderSpec()
         LOG(ERROR) << "invalid input";
         return;
       }
-      LOG(INFO) << "input data with " << compressed->nTracks << " track(s) and " << compressed->nAttachedClusters << " attached clusters";
-
-      std::unique_ptr<TFile> testFile(TFile::Open("tpc-cluster-encoder.root", "RECREATE"));
-      testFile->WriteObject(compressed.get(), "TPCCompressedClusters");
-      testFile->Write();
-      testFile->Close();
-
-      //o2::tpc::ClusterNativeAccess clustersNativeDecoded; // Cluster native access structure as used by the tracker
-      //std::vector<o2::tpc::ClusterNative> clusterBuffer; // std::vector that will hold the actual clusters, clustersNativeDecoded will point inside here
-      //mDecoder.decompress(clustersCompressed, clustersNativeDecoded, clusterBuffer, param); // Run decompressor
+      auto start = std::chrono::steady_clock::now();
+      auto& buffer = processAttributes->buffer;
+      CompressedClustersCoder::encode(*compressed, buffer, processAttributes->nThreads);
+      pc.outputs().snapshot(Output{gDataOriginTPC, "ENCCLUSTERS", 0}, buffer);
+      if (processAttributes->verbosity > 0) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        LOG(INFO) << "encoded " << compressed->nTracks << " track(s), " << compressed->nAttachedClusters << " attached and "
+                  << compressed->nUnattachedClusters << " unattached clusters (" << compressed->flatdataSize << " bytes) to "
+                  << buffer.size() << " bytes in " << elapsed.count() << " ms";
+      }
     };
 
     return processingFct;
@@ -70,8 +66,9 @@ DataProcessorSpec getEntropyEncoderSpec()
 
   return DataProcessorSpec{"tpc-entropy-encoder", // process id
                            {{"input", "TPC", "COMPCLUSTERS", 0, Lifetime::Timeframe}},
-                           {},
-                           AlgorithmSpec(initFunction)};
+                           {{"TPC", "ENCCLUSTERS", 0, Lifetime::Timeframe}},
+                           AlgorithmSpec(initFunction),
+                           Options{{"nthreads", VariantType::Int, 4, {"number of threads coding the arrays in parallel"}}}};
 }
 
 } // namespace tpc
@@ -23,6 +23,7 @@
 #include "TPCWorkflow/ClusterDecoderRawSpec.h"
 #include "TPCWorkflow/CATrackerSpec.h"
 #include "TPCWorkflow/EntropyEncoderSpec.h"
+#include "TPCWorkflow/EntropyDecoderSpec.h"
 #include "Algorithm/RangeTokenizer.h"
 #include "TPCBase/Digit.h"
 #include "DataFormatsTPC/Constants.h"
@@ -407,6 +408,15 @@ framework::WorkflowSpec getWorkflow(std::vector<int> const& tpcSectors, std::vec
     specs.emplace_back(o2::tpc::getEntropyEncoderSpec());
   }
 
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  //
+  // entropy decoder process
+  //
+  // selected by input type 'encoded-clusters', restores the compressed clusters
+  if (inputType == InputType::EncodedClusters) {
+    specs.emplace_back(o2::tpc::getEntropyDecoderSpec());
+  }
+
   //////////////////////////////////////////////////////////////////////////////////////////////
   //
   // a writer process for tracks
@@ -473,6 +483,26 @@ framework::WorkflowSpec getWorkflow(std::vector<int> const& tpcSectors, std::vec
                                            std::move(ccldef))());                                    //
   }
 
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  //
+  // a writer process for the entropy encoded clusters
+  //
+  // selected by output type 'encoded-clusters'
+  if (runClusterEncoder && !isEnabled(OutputType::DisableWriter)) {
+    const char* processName = "tpc-enccluster-writer";
+    const char* defaultFileName = "tpc-encclusters.root";
+    const char* defaultTreeName = "tpcrec";
+
+    // the branch name matches the one of the encoded cluster reader
+    auto encldef = BranchDefinition<std::vector<char>>{InputSpec{"inputEncCl", "TPC", "ENCCLUSTERS"}, //
+                                                       "TPCEncodedClusters_0", "enccluster-branch-name"}; //
+
+    specs.push_back(MakeRootTreeWriterSpec(processName, defaultFileName, defaultTreeName,            //
+                                           MakeRootTreeWriterSpec::TerminationPolicy::Process,       //
+                                           MakeRootTreeWriterSpec::TerminationCondition{checkReady}, //
+                                           std::move(encldef))());                                   //
+  }
+
   return std::move(specs);
 }
 
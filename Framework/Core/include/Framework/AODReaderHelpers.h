@@ -14,6 +14,14 @@
 #include "Framework/TableBuilder.h"
 #include "Framework/AlgorithmSpec.h"
 
+#include <memory>
+#include <string>
+
+namespace arrow
+{
+class Buffer;
+}
+
 namespace o2
 {
 namespace framework
@@ -24,6 +32,12 @@ namespace readers
 struct AODReaderHelpers {
   static AlgorithmSpec rootFileReaderCallback();
   static AlgorithmSpec run2ESDConverterCallback();
+
+  /// Memory map the arrow IPC file @a filename.
+  /// @return a zero copy view of the part of the file in the IPC stream
+  /// format, i.e. without the file header and footer, which is what a
+  /// TableConsumer expects, or nullptr if the file cannot be used.
+  static std::shared_ptr<arrow::Buffer> mapArrowStream(std::string const& filename);
 };
 
 } // namespace readers
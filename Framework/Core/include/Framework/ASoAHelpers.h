@@ -16,10 +16,9 @@
 
 #include <arrow/compute/context.h>
 
-// arrow 15.0
-//#include <arrow/compute/kernels/sort_to_indices.h>
-
+#include <array>
 #include <iterator>
+#include <string>
 #include <tuple>
 #include <utility>
 
@@ -62,65 +61,65 @@ bool sameCategory(std::pair<uint64_t, uint64_t> const& a, std::pair<uint64_t, ui
   return a.first < b.first;
 }
 
-template <typename T2, typename ARRAY, typename T>
-std::vector<std::pair<uint64_t, uint64_t>> doGroupTable(const T& inTable, const std::string& categoryColumnName, int minCatSize)
+/// The column used to group the rows of the tables for block combinations.
+/// Floating point columns need a positive @a binWidth.
+struct CategoryColumn {
+  std::string name;
+  double binWidth = 0;
+};
+
+/// Categories can be negative, while the grouped indices store them as
+/// unsigned: flipping the sign bit keeps them in the same order.
+inline uint64_t categoryKey(int64_t category)
 {
-  auto arrowTable = inTable.asArrowTable();
-  auto columnIndex = arrowTable->schema()->GetFieldIndex(categoryColumnName);
-  auto chunkedArray = arrowTable->column(columnIndex)->data();
+  return static_cast<uint64_t>(category) ^ (uint64_t{1} << 63);
+}
 
-  uint64_t ind = 0;
-  std::vector<std::pair<uint64_t, uint64_t>> groupedIndices;
-  groupedIndices.reserve(arrowTable->num_rows());
-  for (uint64_t ci = 0; ci < chunkedArray->num_chunks(); ++ci) {
-    auto chunk = chunkedArray->chunk(ci);
-    // Note: assuming that the table is not empty
-    T2 const* data = std::static_pointer_cast<ARRAY>(chunk)->raw_values();
-    for (uint64_t ai = 0; ai < chunk->length(); ++ai) {
-      groupedIndices.emplace_back(data[ai], ind);
-      ind++;
-    }
+template <typename T>
+std::vector<std::pair<uint64_t, uint64_t>> groupTable(const T& inTable, const std::string& categoryColumnName, int minCatSize, double binWidth = 0)
+{
+  framework::GroupIndex index;
+  auto status = framework::groupByColumn(inTable.asArrowTable(), categoryColumnName, &index, binWidth);
+  if (status.ok() == false) {
+    throw std::runtime_error("Combinations: " + status.ToString());
   }
 
-  // Do a stable sort so that same categories entries are
-  // grouped together.
-  std::stable_sort(groupedIndices.begin(), groupedIndices.end());
-
-  // Remove categories of too small size
-  if (minCatSize > 1) {
-    auto catBegin = groupedIndices.begin();
-    while (catBegin != groupedIndices.end()) {
-      auto catEnd = std::upper_bound(catBegin, groupedIndices.end(), *catBegin, sameCategory);
-      if (std::distance(catBegin, catEnd) < minCatSize) {
-        catEnd = groupedIndices.erase(catBegin, catEnd);
-      }
-      catBegin = catEnd;
+  // Categories of too small size are skipped
+  std::vector<std::pair<uint64_t, uint64_t>> groupedIndices;
+  groupedIndices.reserve(index.indices.size());
+  for (size_t ci = 0; ci < index.size(); ++ci) {
+    if (index.offsets[ci + 1] - index.offsets[ci] < static_cast<uint64_t>(minCatSize)) {
+      continue;
+    }
+    auto key = index.unsignedCategories ? static_cast<uint64_t>(index.categories[ci]) : categoryKey(index.categories[ci]);
+    for (auto ri = index.offsets[ci]; ri < index.offsets[ci + 1]; ++ri) {
+      groupedIndices.emplace_back(key, index.indices[ri]);
     }
   }
 
   return groupedIndices;
 }
 
-template <typename T>
-auto groupTable(const T& inTable, const std::string& categoryColumnName, int minCatSize)
+/// Group all the @a tables, doing it only once for those which share the
+/// same underlying arrow table, e.g. when combining a table with itself.
+template <typename... Ts>
+auto groupTables(const CategoryColumn& category, int minCatSize, const Ts&... tables)
 {
-  auto arrowTable = inTable.asArrowTable();
-  auto columnIndex = arrowTable->schema()->GetFieldIndex(categoryColumnName);
-  auto dataType = arrowTable->column(columnIndex)->type();
-  if (dataType->id() == arrow::Type::UINT64) {
-    return doGroupTable<uint64_t, arrow::UInt64Array>(inTable, categoryColumnName, minCatSize);
-  }
-  if (dataType->id() == arrow::Type::INT64) {
-    return doGroupTable<int64_t, arrow::Int64Array>(inTable, categoryColumnName, minCatSize);
-  }
-  if (dataType->id() == arrow::Type::UINT32) {
-    return doGroupTable<uint32_t, arrow::UInt32Array>(inTable, categoryColumnName, minCatSize);
-  }
-  if (dataType->id() == arrow::Type::INT32) {
-    return doGroupTable<int32_t, arrow::Int32Array>(inTable, categoryColumnName, minCatSize);
-  }
-  // FIXME: Should we support other types as well?
-  throw std::runtime_error("Combinations: category column must be of integral type");
+  constexpr auto k = sizeof...(Ts);
+  std::array<std::vector<std::pair<uint64_t, uint64_t>>, k> groupedIndices;
+  std::array<arrow::Table const*, k> arrowTables{tables.asArrowTable().get()...};
+  size_t tableIndex = 0;
+  auto group = [&](auto const& table) {
+    for (size_t ti = 0; ti < tableIndex; ++ti) {
+      if (arrowTables[ti] == arrowTables[tableIndex]) {
+        groupedIndices[tableIndex++] = groupedIndices[ti];
+        return;
+      }
+    }
+    groupedIndices[tableIndex++] = groupTable(table, category.name, minCatSize, category.binWidth);
+  };
+  (group(tables), ...);
+  return groupedIndices;
 }
 
 // Synchronize categories so as groupedIndices contain elements only of categories common to all tables
@@ -294,15 +293,18 @@ template <typename... Ts>
 struct CombinationsBlockUpperIndexPolicy : public CombinationsIndexPolicyBase<Ts...> {
   using IndicesType = typename generate_tuple_type<uint64_t, sizeof...(Ts)>::type;
 
-  CombinationsBlockUpperIndexPolicy(const std::string& categoryColumnName, const Ts&... tables) : CombinationsIndexPolicyBase<Ts...>(tables...)
+  CombinationsBlockUpperIndexPolicy(const std::string& categoryColumnName, const Ts&... tables) : CombinationsBlockUpperIndexPolicy(CategoryColumn{categoryColumnName}, tables...)
+  {
+  }
+
+  CombinationsBlockUpperIndexPolicy(const CategoryColumn& category, const Ts&... tables) : CombinationsIndexPolicyBase<Ts...>(tables...)
   {
     constexpr auto k = sizeof...(Ts);
     if (this->mIsEnd) {
       return;
     }
 
-    int tableIndex = 0;
-    ((this->mGroupedIndices[tableIndex++] = groupTable(tables, categoryColumnName, 1)), ...);
+    this->mGroupedIndices = groupTables(category, 1, tables...);
 
     // Synchronize categories across tables
     // FIXME: This wouldn't be necessary if tables were always the same, are they?
@@ -383,7 +385,11 @@ template <typename... Ts>
 struct CombinationsBlockStrictlyUpperIndexPolicy : public CombinationsIndexPolicyBase<Ts...> {
   using IndicesType = typename generate_tuple_type<uint64_t, sizeof...(Ts)>::type;
 
-  CombinationsBlockStrictlyUpperIndexPolicy(const std::string& categoryColumnName, const Ts&... tables) : CombinationsIndexPolicyBase<Ts...>(tables...)
+  CombinationsBlockStrictlyUpperIndexPolicy(const std::string& categoryColumnName, const Ts&... tables) : CombinationsBlockStrictlyUpperIndexPolicy(CategoryColumn{categoryColumnName}, tables...)
+  {
+  }
+
+  CombinationsBlockStrictlyUpperIndexPolicy(const CategoryColumn& category, const Ts&... tables) : CombinationsIndexPolicyBase<Ts...>(tables...)
   {
     constexpr auto k = sizeof...(Ts);
     if (((tables.size() < k) || ...)) {
@@ -391,8 +397,7 @@ struct CombinationsBlockStrictlyUpperIndexPolicy : public CombinationsIndexPolic
       return;
     }
 
-    int tableIndex = 0;
-    ((this->mGroupedIndices[tableIndex++] = groupTable(tables, categoryColumnName, k)), ...);
+    this->mGroupedIndices = groupTables(category, k, tables...);
 
     // Synchronize categories across tables
     // FIXME: This wouldn't be necessary if tables were always the same, are they?
@@ -477,7 +482,11 @@ template <typename... Ts>
 struct CombinationsBlockFullIndexPolicy : public CombinationsIndexPolicyBase<Ts...> {
   using IndicesType = typename generate_tuple_type<uint64_t, sizeof...(Ts)>::type;
 
-  CombinationsBlockFullIndexPolicy(const std::string& categoryColumnName, const Ts&... tables) : CombinationsIndexPolicyBase<Ts...>(tables...)
+  CombinationsBlockFullIndexPolicy(const std::string& categoryColumnName, const Ts&... tables) : CombinationsBlockFullIndexPolicy(CategoryColumn{categoryColumnName}, tables...)
+  {
+  }
+
+  CombinationsBlockFullIndexPolicy(const CategoryColumn& category, const Ts&... tables) : CombinationsIndexPolicyBase<Ts...>(tables...)
   {
     if (this->mIsEnd) {
       return;
@@ -485,28 +494,7 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsIndexPolicyBase<Ts.
 
     constexpr auto k = sizeof...(Ts);
 
-    // FIXME: What is preferred from DPL/Framework internals point-of-view?
-    // grouping arrow tables directly vs C++ vectors / tuples / ...
-
-    // Grouping with arrow
-    // Note: this expects the input table to be already sorted by category
-    // Could use arrow's SortToIndices from arrow 15.0 for sorting (or sth based on that)
-    //std::vector<arrow::Table> ranges;
-    //ranges.reserve(k);
-    //auto groupTableArrow = [&] (const auto& inputTable) {
-    //  arrow::compute::FunctionContext ctx;
-    //  arrow::compute::Datum outRanges;
-    //  SortedGroupByKernel groupBy{{categoryColumnName}};
-    //  auto result = groupBy.Call(&ctx, arrow::compute::Datum(inputTable.asArrowTable()), &outRanges);
-    //  if (result.ok() == false) {
-    //    throw std::runtime_error("Combinations: cannot slice table for grouping");
-    //  }
-    //  ranges.emplace_back(arrow::util::get<std::shared_ptr<arrow::Table>>(outRanges.value));
-    //};
-
-    // Grouping with C++ containers - based on RCombinedDS
-    int tableIndex = 0;
-    ((this->mGroupedIndices[tableIndex++] = groupTable(tables, categoryColumnName, 1)), ...);
+    this->mGroupedIndices = groupTables(category, 1, tables...);
     for_<k>([this](auto i) {
       std::get<i.value>(this->mCurrentIndices) = 0;
     });
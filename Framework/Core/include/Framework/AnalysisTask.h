@@ -91,6 +91,9 @@ struct WritingCursor<soa::Table<PC...>> {
   bool resetCursor(TableBuilder& builder)
   {
     mBuilder = &builder;
+    if (mSizeHint >= 0) {
+      mBuilder->setSizeHint(mSizeHint);
+    }
     cursor = std::move(FFL(builder.cursor<persistent_table_t>()));
     mCount = -1;
     return true;
@@ -103,6 +106,13 @@ struct WritingCursor<soa::Table<PC...>> {
     mBuilder->reserve(typename persistent_table_t::columns{}, size);
   }
 
+  /// preallocate @a size rows for the tables created at each
+  /// subsequent invocation of the task.
+  void setSizeHint(int64_t size)
+  {
+    mSizeHint = size;
+  }
+
   decltype(FFL(std::declval<cursor_t>())) cursor;
 
  private:
@@ -122,6 +132,7 @@ struct WritingCursor<soa::Table<PC...>> {
   /// able to do all-columns methods like reserve.
   TableBuilder* mBuilder = nullptr;
   int64_t mCount = -1;
+  int64_t mSizeHint = -1;
 };
 
 /// This helper class allow you to declare things which will be crated by a
@@ -422,19 +433,24 @@ struct AnalysisDataProcessorBuilder {
       {
         using groupingMetadata = typename aod::MetadataTrait<G>::metadata;
         auto indexColumnName = std::string("f") + groupingMetadata::label() + "ID";
-        arrow::compute::FunctionContext ctx;
-        /// prepare slices and offsets for all associated tables that have index
-        /// to grouping table
+        /// group once all the associated tables that have an index to the
+        /// grouping table, so that each slice is then found in O(1)
         ///
         auto splitter = [&](auto&& x) {
           if (hasIndexTo<std::decay_t<G>>(typename std::decay_t<decltype(x)>::persistent_columns_t{})) {
-            auto result = o2::framework::sliceByColumn(&ctx, indexColumnName,
-                                                       x.asArrowTable(),
-                                                       &groups[framework::has_type_at<std::decay_t<decltype(x)>>(associated_pack_t{})],
-                                                       &offsets[framework::has_type_at<std::decay_t<decltype(x)>>(associated_pack_t{})]);
+            constexpr auto index = framework::has_type_at<std::decay_t<decltype(x)>>(associated_pack_t{});
+            auto result = o2::framework::groupByColumn(x.asArrowTable(), indexColumnName, &groups[index]);
             if (result.ok() == false) {
               throw std::runtime_error("Cannot split collection");
             }
+            // tables which are not sorted by the index are sliced in runs
+            // of equal values, one per grouping element
+            if (groups[index].sorted == false) {
+              result = o2::framework::groupByRuns(x.asArrowTable(), indexColumnName, &groups[index]);
+              if (result.ok() == false) {
+                throw std::runtime_error("Cannot split collection");
+              }
+            }
           }
         };
 
@@ -450,7 +466,6 @@ struct AnalysisDataProcessorBuilder {
             constexpr auto index = framework::has_type_at<std::decay_t<decltype(x)>>(associated_pack_t{});
             selections[index] = &x.getSelectedRows();
             starts[index] = selections[index]->begin();
-            offsets[index].push_back(std::get<xt>(at).tableSize());
           }
         };
         std::apply(
@@ -507,29 +522,43 @@ struct AnalysisDataProcessorBuilder {
         return std::make_tuple(prepareArgument<A>()...);
       }
 
+      /// @return the rows of the associated table @a index which belong to
+      /// the current grouping element. Empty if there are none.
+      std::pair<uint64_t, uint64_t> currentRange(size_t index)
+      {
+        auto& group = groups[index];
+        auto& cursor = cursors[index];
+        while (cursor < group.size() && group.categories[cursor] < static_cast<int64_t>(position)) {
+          ++cursor;
+        }
+        if (cursor < group.size() && group.categories[cursor] == static_cast<int64_t>(position)) {
+          return {group.offsets[cursor], group.offsets[cursor + 1] - group.offsets[cursor]};
+        }
+        return {group.offsets[cursor], 0};
+      }
+
       template <typename A1>
       auto prepareArgument()
       {
         constexpr auto index = framework::has_type_at<A1>(associated_pack_t{});
         if (hasIndexTo<G>(typename std::decay_t<A1>::persistent_columns_t{})) {
+          auto [start, count] = currentRange(index);
+          auto groupedElementsTable = o2::framework::sliceTable(std::get<A1>(*mAt).asArrowTable(), start, count);
           if constexpr (soa::is_soa_filtered_t<std::decay_t<A1>>::value) {
-            auto groupedElementsTable = arrow::util::get<std::shared_ptr<arrow::Table>>(((groups[index])[position]).value);
-
             // for each grouping element we need to slice the selection vector
-            auto start_iterator = std::lower_bound(starts[index], selections[index]->end(), (offsets[index])[position]);
-            auto stop_iterator = std::lower_bound(start_iterator, selections[index]->end(), (offsets[index])[position + 1]);
+            auto start_iterator = std::lower_bound(starts[index], selections[index]->end(), start);
+            auto stop_iterator = std::lower_bound(start_iterator, selections[index]->end(), start + count);
             starts[index] = stop_iterator;
             soa::SelectionVector slicedSelection{start_iterator, stop_iterator};
             std::transform(slicedSelection.begin(), slicedSelection.end(), slicedSelection.begin(),
                            [&](int64_t idx) {
-                             return idx - static_cast<int64_t>((offsets[index])[position]);
+                             return idx - static_cast<int64_t>(start);
                            });
 
-            std::decay_t<A1> typedTable{{groupedElementsTable}, std::move(slicedSelection), (offsets[index])[position]};
+            std::decay_t<A1> typedTable{{groupedElementsTable}, std::move(slicedSelection), start};
             return typedTable;
           } else {
-            auto groupedElementsTable = arrow::util::get<std::shared_ptr<arrow::Table>>(((groups[index])[position]).value);
-            std::decay_t<A1> typedTable{{groupedElementsTable}, (offsets[index])[position]};
+            std::decay_t<A1> typedTable{{groupedElementsTable}, start};
             return typedTable;
           }
         } else {
@@ -542,8 +571,8 @@ struct AnalysisDataProcessorBuilder {
       typename grouping_t::iterator mGroupingElement;
       uint64_t position = 0;
 
-      std::array<std::vector<arrow::compute::Datum>, sizeof...(A)> groups;
-      std::array<std::vector<uint64_t>, sizeof...(A)> offsets;
+      std::array<framework::GroupIndex, sizeof...(A)> groups;
+      std::array<size_t, sizeof...(A)> cursors{};
       std::array<soa::SelectionVector const*, sizeof...(A)> selections;
       std::array<soa::SelectionVector::const_iterator, sizeof...(A)> starts;
     };
@@ -709,8 +738,10 @@ struct OutputManager<HistogramRegistry> {
     return true;
   }
 
-  static bool postRun(EndOfStreamContext&, HistogramRegistry&)
+  static bool postRun(EndOfStreamContext& context, HistogramRegistry& what)
   {
+    what.merge();
+    context.outputs().snapshot(what.ref(), *what.list());
     return true;
   }
 };
@@ -859,9 +890,13 @@ DataProcessorSpec adaptAnalysisTask(char const* name, Args&&... args)
     std::apply([&ic](auto&&... x) { return (OptionManager<std::decay_t<decltype(x)>>::prepare(ic, x), ...); }, tupledTask);
 
     auto& callbacks = ic.services().get<CallbackService>();
-    auto endofdatacb = [task](EndOfStreamContext& eosContext) {
+    auto endofdatacb = [task, expressionInfos](EndOfStreamContext& eosContext) {
       auto tupledTask = o2::framework::to_tuple_refs(*task.get());
       std::apply([&eosContext](auto&&... x) { return (OutputManager<std::decay_t<decltype(x)>>::postRun(eosContext, x), ...); }, tupledTask);
+      if (expressionInfos.empty() == false) {
+        auto stats = expressions::getFilterCacheStats();
+        LOG(INFO) << "Filter cache: " << stats.hits << " hits, " << stats.misses << " misses";
+      }
       eosContext.services().get<ControlService>().readyToQuit(QuitRequest::Me);
     };
     callbacks.set(CallbackService::Id::EndOfStream, endofdatacb);
@@ -47,6 +47,7 @@ class FairMQMessage;
 
 namespace arrow
 {
+class Buffer;
 class Schema;
 
 namespace ipc
@@ -99,6 +100,11 @@ class DataAllocator
 
   void adoptChunk(const Output&, char*, size_t, fairmq_free_fn*, void*);
 
+  /// Send an arrow IPC stream which is already available in @a stream, e.g.
+  /// a memory mapped file, without copying it. The buffer is kept alive
+  /// until it has been sent.
+  void adoptArrowStream(const Output&, std::shared_ptr<arrow::Buffer> stream);
+
   /// Generic helper to create an object which is owned by the framework and
   /// returned as a reference to the own object.
   /// Note: decltype(auto) will deduce the return type from the expression and it
@@ -19,12 +19,35 @@
 
 #include "rapidjson/fwd.h"
 
+#include <map>
+#include <memory>
+#include <string>
+
+namespace arrow
+{
+class Schema;
+namespace io
+{
+class OutputStream;
+}
+namespace ipc
+{
+class RecordBatchWriter;
+}
+} // namespace arrow
+
 namespace o2
 {
 namespace framework
 {
 using namespace rapidjson;
 
+/// The format used to store a table
+enum struct DataOutputFormat {
+  Root, /// as a TTree in a ROOT file shared with the other tables
+  Arrow /// as arrow record batches in an IPC (i.e. Feather V2) file of its own
+};
+
 struct DataOutputDescriptor {
   /// Holds information concerning the writing of aod tables.
   /// The information includes the table specification, treename,
@@ -33,6 +56,7 @@ struct DataOutputDescriptor {
   std::string tablename = "";
   std::string treename = "";
   std::vector<std::string> colnames;
+  DataOutputFormat format = DataOutputFormat::Root;
   std::unique_ptr<data_matcher::DataDescriptorMatcher> matcher;
 
   DataOutputDescriptor(std::string sin);
@@ -77,8 +101,18 @@ struct DataOutputDirector {
   // get the matching TFile
   TFile* getDataOutputFile(DataOutputDescriptor* dod,
                            int ntf, int ntfmerge, std::string filemode);
+  // get the arrow writer for a DataOutputDescriptor with
+  // format == DataOutputFormat::Arrow
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> getArrowOutputWriter(DataOutputDescriptor* dod,
+                                                                      int ntf, int ntfmerge,
+                                                                      std::shared_ptr<arrow::Schema> schema);
   void closeDataOutputFiles();
 
+  // name of the arrow file holding the table with the given description,
+  // next to the ROOT file rootFilename (with or without its .root
+  // extension). Shared by the writer and the AOD reader.
+  static std::string arrowFilename(std::string const& rootFilename, std::string const& description);
+
   void setDefaultfname(std::string dfn);
 
   void printOut();
@@ -93,6 +127,15 @@ struct DataOutputDirector {
   std::vector<int> fcnts;
   std::vector<TFile*> fouts;
 
+  // the arrow files, one per table/file name
+  struct ArrowOutput {
+    DataOutputDescriptor* dod = nullptr;
+    int fcnt = -1;
+    std::shared_ptr<arrow::io::OutputStream> stream;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+  };
+  std::map<std::string, ArrowOutput> arrowouts;
+
   std::tuple<std::string, std::string, int> readJsonDocument(Document* doc);
 };
 
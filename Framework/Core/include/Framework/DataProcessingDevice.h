@@ -29,21 +29,39 @@
 
 #include <fairmq/FairMQDevice.h>
 #include <fairmq/FairMQParts.h>
+#include <fairmq/FairMQPoller.h>
 
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
 namespace o2::framework
 {
 
 struct InputChannelInfo;
 struct DeviceState;
+struct ComputingTask;
 
 /// A device actually carrying out all the DPL
 /// Data Processing needs.
 class DataProcessingDevice : public FairMQDevice
 {
  public:
+  /// How ConditionalRun waits for new inputs.
+  enum struct InputPolling {
+    /// Probe each input channel with a zero timeout and back off when idle.
+    Busy,
+    /// Block on a single poller over all the input channels, waking up on
+    /// the first readable one or when a timer needs to be serviced.
+    Event
+  };
+
   DataProcessingDevice(DeviceSpec const& spec, ServiceRegistry&, DeviceState& state);
+  ~DataProcessingDevice() override;
   void Init() final;
   void PreRun() final;
   void PostRun() final;
@@ -55,6 +73,17 @@ class DataProcessingDevice : public FairMQDevice
   bool handleData(FairMQParts&, InputChannelInfo&);
   bool tryDispatchComputation();
   void error(const char* msg);
+  /// @return the maximum time in ms we can block waiting for inputs
+  int inputPollTimeout() const;
+  /// Start / stop the threads processing timeslices when
+  /// DeviceSpec::nThreads is larger than 1.
+  void startWorkers();
+  void stopWorkers();
+  /// Main loop of a worker thread: pick up pending tasks and process them.
+  void runWorker(std::string const& monitoringUrl);
+  /// Invoke the processing callbacks on a given task. Nothing is sent,
+  /// this is done by the device thread once the task is completed.
+  void processTask(ComputingTask& task);
 
  private:
   /// The specification used to create the initial state of this device
@@ -84,6 +113,20 @@ class DataProcessingDevice : public FairMQDevice
   uint64_t mBeginIterationTimestamp = 0;     /// The timestamp of when the current ConditionalRun was started
   DataProcessingStats mStats;                /// Stats about the actual data processing.
   int mCurrentBackoff = 0;                   /// The current exponential backoff value.
+  InputPolling mInputPolling = InputPolling::Busy; /// How we wait for new inputs.
+  int mInputPollTimeout = 100;                     /// Max time (ms) we block in event driven mode.
+  bool mWasActive = false;                         /// Whether the last iteration did any work.
+  FairMQPollerPtr mInputPoller;                    /// Poller over all the input channels, in event driven mode.
+
+  std::vector<std::thread> mWorkers;                                  /// Threads processing timeslices, if nThreads > 1.
+  std::mutex mTasksMutex;                                             /// Protects the task queues below.
+  std::condition_variable mTaskAvailable;                             /// Notified when a task is pending.
+  std::condition_variable mTaskCompleted;                             /// Notified when a task is completed.
+  std::deque<std::unique_ptr<ComputingTask>> mPendingTasks;           /// Tasks waiting for a worker.
+  std::map<uint64_t, std::unique_ptr<ComputingTask>> mCompletedTasks; /// Completed tasks waiting to be sent, by sequence.
+  uint64_t mNextTaskSequence = 0;                                     /// Sequence number of the next task to dispatch.
+  uint64_t mNextTaskToSend = 0;                                       /// Sequence number of the next task to send.
+  bool mStopWorkers = false;                                          /// Whether the workers should exit.
 };
 
 } // namespace o2::framework
@@ -61,6 +61,13 @@ struct DataProcessorSpec {
   /// put, but this is actually to be handled in the actual DeviceSpec.
   size_t inputTimeSliceId = 0;
   size_t maxInputTimeslices = 1;
+  /// How many worker threads should be used to process different timeslices
+  /// within the same device. Unlike time pipelining, this does not duplicate
+  /// the process, so the state created at init time (geometry, calibration,
+  /// etc.) is shared. The processing callback must be safe to invoke
+  /// concurrently when this is larger than 1. Outputs are still sent in the
+  /// same order the computations were dispatched.
+  size_t nThreads = 1;
 };
 
 } // namespace o2::framework
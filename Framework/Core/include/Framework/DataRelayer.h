@@ -18,6 +18,7 @@
 #include "Framework/TimesliceIndex.h"
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 class FairMQMessage;
@@ -31,14 +32,24 @@ class Monitoring;
 namespace framework
 {
 
+struct InputMatcherIndex;
+
 /// Helper struct to hold statistics about the relaying process.
 struct DataRelayerStats {
   uint64_t malformedInputs = 0;         /// Malformed inputs which the user attempted to process
   uint64_t droppedComputations = 0;     /// How many computations have been dropped because one of the inputs was late
   uint64_t droppedIncomingMessages = 0; /// How many messages have been dropped (not relayed) because they were late
   uint64_t relayedMessages = 0;         /// How many messages have been successfully relayed
+  uint64_t pipelineLength = 0;          /// How many timeslices can currently be in flight
+  uint64_t occupiedSlots = 0;           /// How many timeslices were in flight at the last relay
+  uint64_t cachedBytes = 0;             /// How many bytes are currently held in the cache
+  uint64_t pipelineResizes = 0;         /// How many times the pipeline length was adapted
 };
 
+/// Caches the incoming messages until the CompletionPolicy decides they are
+/// ready to be processed. It is only used by the device thread: the worker
+/// threads of a multithreaded device receive the inputs already extracted
+/// from the cache.
 class DataRelayer
 {
  public:
@@ -56,6 +67,7 @@ class DataRelayer
               std::vector<InputRoute> const& routes,
               monitoring::Monitoring&,
               TimesliceIndex&);
+  ~DataRelayer();
 
   /// This invokes the appropriate `InputRoute::danglingChecker` on every
   /// entry in the cache and if it returns true, it creates a new
@@ -88,6 +100,13 @@ class DataRelayer
   /// Tune the maximum number of in flight timeslices this can handle.
   void setPipelineLength(size_t s);
 
+  /// Let the number of in flight timeslices adapt at runtime, between
+  /// @a minLength and @a maxLength. The pipeline grows when a new timeslice
+  /// arrives and all the slots are taken, unless more than @a memoryBudget
+  /// bytes are already cached (0 means no limit). It shrinks back when
+  /// the extra slots are not used or the budget is exceeded.
+  void setAdaptivePipeline(size_t minLength, size_t maxLength, size_t memoryBudget);
+
   /// @return the current stats about the data relaying process
   DataRelayerStats const& getStats() const;
 
@@ -99,6 +118,11 @@ class DataRelayer
   void clear();
 
  private:
+  /// @return true if a new slot was added to the pipeline.
+  bool maybeGrowPipeline();
+  /// Drop unused slots at the end of the pipeline, if they are not needed.
+  void maybeShrinkPipeline();
+
   monitoring::Monitoring& mMetrics;
 
   /// This is the actual cache of all the parts in flight.
@@ -114,6 +138,9 @@ class DataRelayer
   CompletionPolicy mCompletionPolicy;
   std::vector<size_t> mDistinctRoutesIndex;
   std::vector<data_matcher::DataDescriptorMatcher> mInputMatchers;
+  /// Used to find the matchers in mInputMatchers which need to be evaluated
+  /// for a given message.
+  std::unique_ptr<InputMatcherIndex> mInputMatcherIndex;
   std::vector<data_matcher::VariableContext> mVariableContextes;
   std::vector<int> mCachedStateMetrics;
 
@@ -122,6 +149,14 @@ class DataRelayer
   static std::vector<std::string> sQueriesMetricsNames;
 
   DataRelayerStats mStats;
+
+  /// Limits for the adaptive pipeline. Disabled when mMaxPipelineLength is 0.
+  size_t mMinPipelineLength = 0;
+  size_t mMaxPipelineLength = 0;
+  size_t mMemoryBudget = 0;
+  /// Bookkeeping to decide when to shrink the pipeline
+  size_t mRelaysSinceResize = 0;
+  size_t mMaxOccupiedSlots = 0;
 };
 
 } // namespace framework
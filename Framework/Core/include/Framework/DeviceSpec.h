@@ -55,6 +55,8 @@ struct DeviceSpec {
   size_t inputTimesliceId;
   /// The maximum number of time pipelining for this device.
   size_t maxInputTimeslices;
+  /// The number of threads used to process timeslices within this device.
+  size_t nThreads = 1;
   /// The completion policy to use for this device.
   CompletionPolicy completionPolicy;
   DispatchPolicy dispatchPolicy;
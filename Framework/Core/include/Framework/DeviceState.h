@@ -11,6 +11,7 @@
 #define O2_FRAMEWORK_DEVICESTATE_H_
 
 #include "Framework/ChannelInfo.h"
+#include <atomic>
 #include <vector>
 #include <string>
 #include <map>
@@ -34,7 +35,9 @@ enum struct StreamingState {
 struct DeviceState {
   std::vector<InputChannelInfo> inputChannelInfos;
   StreamingState streaming = StreamingState::Streaming;
-  bool quitRequested = false;
+  /// Set by the ControlService on the device thread, read by the worker
+  /// threads of a multithreaded device.
+  std::atomic<bool> quitRequested = false;
 };
 
 } // namespace o2::framework
@@ -268,10 +268,20 @@ Operations createOperations(Filter const& expression);
 bool isSchemaCompatible(gandiva::SchemaPtr const& Schema, Operations const& opSpecs);
 gandiva::NodePtr createExpressionTree(Operations const& opSpecs,
                                       gandiva::SchemaPtr const& Schema);
+/// Compiling a gandiva filter is expensive, so the filters are cached for the
+/// lifetime of the process, keyed on the schema and on the condition.
 std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
                                               gandiva::ConditionPtr condition);
 std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
                                               Operations const& opSpecs);
+
+/// Statistics about the cache used by createFilter
+struct FilterCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+};
+FilterCacheStats getFilterCacheStats();
+
 void updateExpressionInfos(expressions::Filter const& filter, std::vector<ExpressionInfo>& eInfos);
 gandiva::ConditionPtr createCondition(gandiva::NodePtr node);
 } // namespace o2::framework::expressions
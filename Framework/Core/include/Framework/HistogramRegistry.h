@@ -25,38 +25,62 @@
 #include "THn.h"
 #include "THnSparse.h"
 
+#include "TList.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <variant>
+#include <vector>
 namespace o2
 {
 
 namespace framework
 {
+/// Uniform binning of one axis of a histogram
+struct AxisSpec {
+  AxisSpec(unsigned int nBins_, double min_, double max_)
+    : nBins(nBins_),
+      min(min_),
+      max(max_)
+  {
+  }
+
+  unsigned int nBins;
+  double min;
+  double max;
+};
+
 /// Data sctructure that will allow to construct a fully qualified TH* histogram
-/// Currently only supports TH1F
+/// The kind can be TH1, TH2, TH3 or THn, followed by the type of the bins
+/// (F, D or I). One axis is needed per dimension.
 struct HistogramConfigSpec {
   HistogramConfigSpec(char const* const kind_, unsigned int nBins_, double xmin_, double xmax_)
     : kind(kind_),
-      nBins(nBins_),
-      xmin(xmin_),
-      xmax(xmax_)
+      axes{{nBins_, xmin_, xmax_}}
+  {
+  }
+
+  HistogramConfigSpec(char const* const kind_, std::vector<AxisSpec> axes_)
+    : kind(kind_),
+      axes(std::move(axes_))
   {
   }
 
   HistogramConfigSpec()
     : kind(""),
-      nBins(1),
-      xmin(0),
-      xmax(1)
+      axes{{1, 0, 1}}
   {
   }
   HistogramConfigSpec(HistogramConfigSpec const& other) = default;
   HistogramConfigSpec(HistogramConfigSpec&& other) = default;
 
   std::string kind;
-  unsigned int nBins;
-  double xmin;
-  double xmax;
+  std::vector<AxisSpec> axes;
 };
 
 /// Data structure containing histogram specification for the HistogramRegistry
@@ -86,8 +110,57 @@ struct HistogramSpec {
   HistogramConfigSpec config;
 };
 
+/// Binning of one axis, with the arithmetic to find a bin precomputed.
+/// Bin 0 is the underflow and bin nBins + 1 the overflow, like in ROOT.
+struct FlatAxis {
+  uint32_t nBins;
+  double min;
+  double max;
+  double scale;
+  /// Distance between consecutive bins of this axis in the flat array
+  uint32_t stride;
+
+  inline uint32_t bin(double value) const
+  {
+    if (value < min) {
+      return 0;
+    }
+    if (!(value < max)) {
+      return nBins + 1;
+    }
+    auto b = static_cast<uint32_t>((value - min) * scale);
+    return 1 + (b < nBins ? b : nBins - 1);
+  }
+};
+
+/// The bins of all the histograms of a registry filled by one thread
+struct HistogramShard {
+  static constexpr uint32_t MAX_REGISTRY_SIZE = 512;
+  std::array<std::vector<double>, MAX_REGISTRY_SIZE> sumw;
+  /// Only allocated once a weighted fill happened
+  std::array<std::vector<double>, MAX_REGISTRY_SIZE> sumw2;
+  std::array<uint64_t, MAX_REGISTRY_SIZE> entries{};
+};
+
+/// Compile time handle of a histogram of a registry, made of the hash of its
+/// name and of its number of axes, e.g.
+///   using EtaPhi = HistogramKey<compile_time_hash("etaphi"), 2>;
+/// so that the number of coordinates passed to fill() is checked by the
+/// compiler.
+template <uint32_t id_, size_t nAxes_>
+struct HistogramKey {
+  static constexpr uint32_t id = id_;
+  static constexpr size_t nAxes = nAxes_;
+};
+
 /// Histogram registry for an analysis task that allows to define needed histograms
 /// and serves as the container/wrapper to fill them
+///
+/// Histograms can be filled either directly via get(), or with fill<Key>(),
+/// where Key is a HistogramKey. The latter is lock free: each thread fills
+/// its own flat copy of the bins and the copies are added to the ROOT
+/// histograms only by merge(), which happens when the registry is published
+/// at the end of the stream.
 class HistogramRegistry
 {
  public:
@@ -95,7 +168,8 @@ class HistogramRegistry
     : name(name_),
       enabled(enable),
       mRegistryKey(),
-      mRegistryValue()
+      mRegistryValue(),
+      mShards(std::make_unique<ShardStore>())
   {
     mRegistryKey.fill(0u);
     for (auto& spec : specs) {
@@ -103,21 +177,74 @@ class HistogramRegistry
     }
   }
 
+  /// @return the TH1, TH2 or TH3 whose name hashes to @a id, e.g.
+  /// get<compile_time_hash("eta")>(), the hash being computed at compile
+  /// time.
+  template <uint32_t id>
+  auto& get() const
+  {
+    return mRegistryValue[find(id)];
+  }
+
+  /// @return the THn whose name hashes to @a id
+  template <uint32_t id>
+  auto& getTHn() const
+  {
+    return mRegistryValueN[find(id)];
+  }
+
+  /// @return the TH1, TH2 or TH3 called @a name. The name is hashed at run
+  /// time, use get<id>() in the event loop.
   auto& get(char const* const name) const
   {
-    const uint32_t id = compile_time_hash(name);
-    const uint32_t i = imask(id);
-    if (O2_BUILTIN_LIKELY(id == mRegistryKey[i])) {
-      return mRegistryValue[i];
+    return mRegistryValue[find(compile_time_hash(name))];
+  }
+
+  /// @return the THn called @a name. The name is hashed at run time.
+  auto& getTHn(char const* const name) const
+  {
+    return mRegistryValueN[find(compile_time_hash(name))];
+  }
+
+  template <typename Key, typename... Ts>
+  void fill(Ts... positions)
+  {
+    fillWeighted<Key>(1., positions...);
+  }
+
+  template <typename Key, typename... Ts>
+  void fillWeighted(double weight, Ts... positions)
+  {
+    static_assert(sizeof...(Ts) == Key::nAxes, "Wrong number of coordinates to fill histogram");
+    auto i = find(Key::id);
+    auto const& axes = mAxes[i];
+    assert(axes.size() == Key::nAxes && "HistogramKey does not match the number of axes of the histogram");
+    size_t cell = 0;
+    size_t axis = 0;
+    ((cell += axes[axis].bin(static_cast<double>(positions)) * axes[axis].stride, ++axis), ...);
+
+    auto& shard = localShard();
+    auto& sumw = shard.sumw[i];
+    if (O2_BUILTIN_UNLIKELY(sumw.empty())) {
+      sumw.resize(mCells[i], 0.);
     }
-    for (auto j = 1u; j < MAX_REGISTRY_SIZE; ++j) {
-      if (id == mRegistryKey[imask(j + i)]) {
-        return mRegistryValue[imask(j + i)];
+    sumw[cell] += weight;
+    shard.entries[i]++;
+    if (weight != 1. || shard.sumw2[i].empty() == false) {
+      auto& sumw2 = shard.sumw2[i];
+      if (sumw2.empty()) {
+        // Up to now all the weights were 1
+        sumw2 = sumw;
+        sumw2[cell] -= weight;
       }
+      sumw2[cell] += weight * weight;
     }
-    throw std::runtime_error("No match found!");
   }
 
+  /// Add the bins filled by all threads via fill<Key>() to the histograms.
+  /// No thread should be filling while this happens.
+  void merge();
+
   // @return the associated OutputSpec
   OutputSpec const spec()
   {
@@ -131,22 +258,48 @@ class HistogramRegistry
     return OutputRef{this->name, 0};
   }
 
+  /// @return a list with all the histograms, not owning them
+  std::unique_ptr<TList> list() const;
+
   /// lookup distance counter for benchmarking
   mutable uint32_t lookup = 0;
 
  private:
-  void insert(HistogramSpec& spec)
-  {
-    uint32_t i = imask(spec.id);
-    for (auto j = 0u; j < MAX_REGISTRY_SIZE; ++j) {
-      if (mRegistryValue[imask(j + i)].get() == nullptr) {
-        mRegistryKey[imask(j + i)] = spec.id;
-        mRegistryValue[imask(j + i)] = {std::make_unique<TH1F>(spec.name.data(), spec.readableName.data(), spec.config.nBins, spec.config.xmin, spec.config.xmax)};
-        lookup += j;
-        return;
+  void insert(HistogramSpec& spec);
+  HistogramShard& createShard();
+
+  uint32_t find(uint32_t id) const
+  {
+    const uint32_t i = imask(id);
+    if (O2_BUILTIN_LIKELY(id == mRegistryKey[i])) {
+      return i;
+    }
+    for (auto j = 1u; j < MAX_REGISTRY_SIZE; ++j) {
+      if (id == mRegistryKey[imask(j + i)]) {
+        return imask(j + i);
       }
     }
-    throw std::runtime_error("Internal array is full.");
+    throw std::runtime_error("No match found!");
+  }
+
+  /// The shard of the calling thread. A few registries are cached per
+  /// thread, so that the lookup does not need any lock.
+  HistogramShard& localShard()
+  {
+    struct CacheEntry {
+      uint64_t serial = 0;
+      HistogramShard* shard = nullptr;
+    };
+    static thread_local std::array<CacheEntry, 4> cache;
+    for (auto& entry : cache) {
+      if (O2_BUILTIN_LIKELY(entry.serial == mShards->serial)) {
+        return *entry.shard;
+      }
+    }
+    auto& shard = createShard();
+    std::rotate(cache.rbegin(), cache.rbegin() + 1, cache.rend());
+    cache[0] = {mShards->serial, &shard};
+    return shard;
   }
 
   inline constexpr uint32_t imask(uint32_t i) const
@@ -160,8 +313,21 @@ class HistogramRegistry
   /// which seems to be both reasonably large and allowing for very fast lookup
   static constexpr uint32_t mask = 0x1FF;
   static constexpr uint32_t MAX_REGISTRY_SIZE = mask + 1;
+  static_assert(MAX_REGISTRY_SIZE == HistogramShard::MAX_REGISTRY_SIZE);
   std::array<uint32_t, MAX_REGISTRY_SIZE> mRegistryKey;
   std::array<std::unique_ptr<TH1>, MAX_REGISTRY_SIZE> mRegistryValue;
+  std::array<std::unique_ptr<THnBase>, MAX_REGISTRY_SIZE> mRegistryValueN;
+  std::array<std::vector<FlatAxis>, MAX_REGISTRY_SIZE> mAxes;
+  std::array<size_t, MAX_REGISTRY_SIZE> mCells{};
+
+  struct ShardStore {
+    ShardStore();
+    /// Unique for each registry, as the address could be reused
+    uint64_t serial;
+    std::mutex mutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<HistogramShard>>> shards;
+  };
+  std::unique_ptr<ShardStore> mShards;
 };
 
 } // namespace framework
@@ -58,7 +58,8 @@ struct InputSpec;
 ///       information
 /// - (d) @ref TableConsumer
 /// - (e) boost serializable types
-/// - (f) span over messageable type T
+/// - (f) span over messageable type T, or read only view type declaring
+///       `is_flat_view`, e.g. MCTruthContainerView
 /// - (g) std::vector of messageable type or type with ROOT dictionary
 /// - (h) messageable type T
 /// - (i) pointer type T* for types with ROOT dictionary or messageable types
@@ -69,7 +70,7 @@ struct InputSpec;
 /// - (c) const char* to payload content
 /// - (d) unique_ptr of TableConsumer
 /// - (e) object by move
-/// - (f) span object over original payload
+/// - (f) span or view object over original payload
 /// - (g) vector by move
 /// - (h) reference to object
 /// - (i) object with pointer-like behavior (unique_ptr)
@@ -277,6 +278,16 @@ class InputRecord
       }
 
       // implementation (f)
+    } else if constexpr (is_flat_view<T>::value) {
+      // substitution for read only views over a flat payload
+      // @return view object borrowing the message memory
+      auto header = header::get<const header::DataHeader*>(ref.header);
+      assert(header);
+      if (header->payloadSerializationMethod != o2::header::gSerializationMethodNone) {
+        throw std::runtime_error("Inconsistent serialization method for extracting flat view at " + std::string(ref.spec->binding));
+      }
+      return T(gsl::span<char const>(ref.payload, header->payloadSize));
+
     } else if constexpr (is_span<T>::value) {
       // substitution for span of messageable objects
       // FIXME: there will be std::span in C++20
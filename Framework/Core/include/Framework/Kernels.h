@@ -19,11 +19,13 @@
 #include <arrow/util/variant.h>
 
 #include <string>
+#include <vector>
 
 namespace arrow
 {
 class Array;
 class DataType;
+class Table;
 
 namespace compute
 {
@@ -94,11 +96,54 @@ class ARROW_EXPORT SortedGroupByKernel : public arrow::compute::UnaryKernel
   GroupByOptions mOptions;
 };
 
+/// The rows of a table grouped by the value of one of its columns. The rows
+/// of the category categories[i] are indices[offsets[i]] ...
+/// indices[offsets[i + 1] - 1], in their original order.
+struct GroupIndex {
+  /// The categories present in the table, in ascending order
+  std::vector<int64_t> categories;
+  /// Has categories.size() + 1 entries
+  std::vector<uint64_t> offsets;
+  std::vector<uint64_t> indices;
+  /// True if the table was already sorted by the column, i.e. indices[i] == i
+  bool sorted = true;
+  /// True for UINT64 columns. The categories are then the values bit-cast
+  /// to int64_t, in ascending order of the unsigned values.
+  bool unsignedCategories = false;
+
+  size_t size() const
+  {
+    return categories.size();
+  }
+};
+
+/// Build the GroupIndex for the column @a key of @a table in O(N), using a
+/// counting sort when the categories are dense enough. Integral columns are
+/// grouped by value, floating point ones in bins of @a binWidth, i.e. a
+/// value v belongs to the category floor(v / binWidth).
+arrow::Status groupByColumn(std::shared_ptr<arrow::Table> const& table,
+                            std::string const& key,
+                            GroupIndex* index,
+                            double binWidth = 0);
+
+/// Build a GroupIndex with one category for each run of consecutive equal
+/// values of the column @a key of @a table, numbered 0, 1, ... in the order
+/// of the runs. This is how tables which are not sorted by @a key are
+/// sliced by sliceByColumn and by the GroupSlicer of the analysis tasks.
+arrow::Status groupByRuns(std::shared_ptr<arrow::Table> const& table,
+                          std::string const& key,
+                          GroupIndex* index);
+
+/// @return the rows [start, start + count) of @a table, without copying them.
+std::shared_ptr<arrow::Table> sliceTable(std::shared_ptr<arrow::Table> const& table, uint64_t start, uint64_t count);
+
 /// Slice a given table is a vector of tables each containing a slice.
 /// @a outputSlices the arrow tables in which the original @a inputTable
 /// is split into.
 /// @a offset the offset in the original table at which the corresponding
 /// slice was split.
+/// If the table is not sorted by @a key, it is sliced in runs of equal
+/// values, see groupByRuns.
 arrow::Status sliceByColumn(arrow::compute::FunctionContext* context,
                             std::string const& key,
                             arrow::compute::Datum const& inputTable,
@@ -90,6 +90,26 @@ class ServiceRegistry
     O2_BUILTIN_UNREACHABLE();
   }
 
+  /// Register a service for the given interface I, replacing the one
+  /// which was registered before, if any. This allows to give the
+  /// computations running in different threads their own instance of
+  /// the services which are not thread safe.
+  template <class I, class C>
+  void overrideService(C* service)
+  {
+    static_assert(std::is_base_of<I, C>::value == true,
+                  "Registered service is not derived from declared interface");
+    auto typeHash = TypeIdHelpers::uniqueId<std::decay_t<I>>();
+    auto serviceId = typeHash & MAX_SERVICES_MASK;
+    for (uint8_t i = 0; i < MAX_DISTANCE; ++i) {
+      if (mServices[i + serviceId].first == typeHash) {
+        mServices[i + serviceId].second = reinterpret_cast<ServicePtr>(service);
+        return;
+      }
+    }
+    registerService<I>(service);
+  }
+
   /// Get a service for the given interface T. The returned reference exposed to
   /// the user is actually of the last concrete type C registered, however this
   /// should not be a problem.
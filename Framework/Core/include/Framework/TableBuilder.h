@@ -421,6 +421,19 @@ class TableBuilder
   {
   }
 
+  /// Number of rows for which the columns are preallocated by persist()
+  /// and cursor(). Needs to be set before either of them is invoked, use
+  /// reserve() to expand existing columns.
+  void setSizeHint(int64_t nRows)
+  {
+    mSizeHint = nRows;
+  }
+
+  int64_t getSizeHint() const
+  {
+    return mSizeHint;
+  }
+
   /// Creates a lambda which is suitable to persist things
   /// in an arrow::Table
   template <typename... ARGS>
@@ -463,7 +476,7 @@ class TableBuilder
     constexpr int nColumns = sizeof...(ARGS);
     validate<ARGS...>(columnNames);
     mArrays.resize(nColumns);
-    makeBuilders<ARGS...>(columnNames, 1000);
+    makeBuilders<ARGS...>(columnNames, mSizeHint);
     makeFinalizer<ARGS...>();
 
     // Callback used to fill the builders
@@ -567,6 +580,7 @@ class TableBuilder
   arrow::MemoryPool* mMemoryPool;
   std::shared_ptr<arrow::Schema> mSchema;
   std::vector<std::shared_ptr<arrow::Array>> mArrays;
+  int64_t mSizeHint = 1000;
 };
 
 } // namespace framework
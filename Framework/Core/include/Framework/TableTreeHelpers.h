@@ -11,10 +11,26 @@
 #define FRAMEWORK_TABLETREE_H
 
 #include "TFile.h"
+#include "TROOT.h"
 #include "TTreeReader.h"
 #include "TTreeReaderValue.h"
+#include "TBufferFile.h"
+#include "TLeaf.h"
+#include "Bytes.h"
+#include "RConfigure.h"
 #include "TableBuilder.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
 // =============================================================================
 namespace o2
 {
@@ -330,6 +346,14 @@ class TableToTree
 //    t2t.AddAllColumns();
 //  . auto ta = t2t.Process();
 //
+// By default the branches holding one fixed size value per entry are read
+// in bulk, i.e. the baskets are decoded straight into the arrow buffers
+// rather than going through the TTreeReader one entry at a time. Use
+// TreeToTable t2t(tr, false) to disable this. With TreeToTable t2t(tr, true, n)
+// the bulk read branches are read with n threads, each of them using its own
+// handle on the file. This is only done for trees stored in a file which is
+// open read-only, the branches are read one after the other otherwise.
+//
 // .............................................................................
 class columnIterator
 {
@@ -359,12 +383,29 @@ class columnIterator
   EDataType dt;
   const char* cname;
 
+  // set when the branch is read in bulk, without the TTreeReaderValue
+  TBranch* bulkBranch = nullptr;
+
   arrow::MemoryPool* pool = arrow::default_memory_pool();
   std::shared_ptr<arrow::Field> field;
   std::shared_ptr<arrow::Array> ar;
 
  public:
-  columnIterator(TTreeReader* reader, const char* colname)
+  // can the branch br be read with the bulk API, i.e. does it hold exactly
+  // one value of a fundamental type per entry
+  static bool canBulkRead(TBranch* br)
+  {
+    if (br->IsA() != TBranch::Class() || br->GetListOfLeaves()->GetEntries() != 1) {
+      return false;
+    }
+    auto leaf = (TLeaf*)br->GetListOfLeaves()->At(0);
+    if (leaf->GetLeafCount() != nullptr || leaf->GetLenStatic() != 1) {
+      return false;
+    }
+    return br->SupportsBulkRead();
+  }
+
+  columnIterator(TTreeReader* reader, const char* colname, bool bulkRead = false)
   {
 
     // find branch
@@ -383,6 +424,9 @@ class columnIterator
 
     TClass* cl;
     br->GetExpectedType(cl, dt);
+    if (bulkRead && canBulkRead(br)) {
+      bulkBranch = br;
+    }
     // initialize the TTreeReaderValue<T>
     //            the corresponding arrow::TBuilder
     //            the column schema
@@ -392,43 +436,59 @@ class columnIterator
     switch (dt) {
       case EDataType::kFloat_t:
         field = std::make_shared<arrow::Field>(cname, arrow::float32());
-        var_f = new TTreeReaderValue<Float_t>(*reader, cname);
-        bui_f = new arrow::FloatBuilder(pool);
+        if (!bulkBranch) {
+          var_f = new TTreeReaderValue<Float_t>(*reader, cname);
+          bui_f = new arrow::FloatBuilder(pool);
+        }
         break;
       case EDataType::kDouble_t:
         field = std::make_shared<arrow::Field>(cname, arrow::float64());
-        var_d = new TTreeReaderValue<Double_t>(*reader, cname);
-        bui_d = new arrow::DoubleBuilder(pool);
+        if (!bulkBranch) {
+          var_d = new TTreeReaderValue<Double_t>(*reader, cname);
+          bui_d = new arrow::DoubleBuilder(pool);
+        }
         break;
       case EDataType::kUShort_t:
         field = std::make_shared<arrow::Field>(cname, arrow::uint16());
-        vs = new TTreeReaderValue<UShort_t>(*reader, cname);
-        bs = new arrow::UInt16Builder(pool);
+        if (!bulkBranch) {
+          vs = new TTreeReaderValue<UShort_t>(*reader, cname);
+          bs = new arrow::UInt16Builder(pool);
+        }
         break;
       case EDataType::kUInt_t:
         field = std::make_shared<arrow::Field>(cname, arrow::uint32());
-        vi = new TTreeReaderValue<UInt_t>(*reader, cname);
-        bi = new arrow::UInt32Builder(pool);
+        if (!bulkBranch) {
+          vi = new TTreeReaderValue<UInt_t>(*reader, cname);
+          bi = new arrow::UInt32Builder(pool);
+        }
         break;
       case EDataType::kULong64_t:
         field = std::make_shared<arrow::Field>(cname, arrow::uint64());
-        vl = new TTreeReaderValue<ULong64_t>(*reader, cname);
-        bl = new arrow::UInt64Builder(pool);
+        if (!bulkBranch) {
+          vl = new TTreeReaderValue<ULong64_t>(*reader, cname);
+          bl = new arrow::UInt64Builder(pool);
+        }
         break;
       case EDataType::kShort_t:
         field = std::make_shared<arrow::Field>(cname, arrow::int16());
-        var_s = new TTreeReaderValue<Short_t>(*reader, cname);
-        bui_s = new arrow::Int16Builder(pool);
+        if (!bulkBranch) {
+          var_s = new TTreeReaderValue<Short_t>(*reader, cname);
+          bui_s = new arrow::Int16Builder(pool);
+        }
         break;
       case EDataType::kInt_t:
         field = std::make_shared<arrow::Field>(cname, arrow::int32());
-        var_i = new TTreeReaderValue<Int_t>(*reader, cname);
-        bui_i = new arrow::Int32Builder(pool);
+        if (!bulkBranch) {
+          var_i = new TTreeReaderValue<Int_t>(*reader, cname);
+          bui_i = new arrow::Int32Builder(pool);
+        }
         break;
       case EDataType::kLong64_t:
         field = std::make_shared<arrow::Field>(cname, arrow::int64());
-        var_l = new TTreeReaderValue<Long64_t>(*reader, cname);
-        bui_l = new arrow::Int64Builder(pool);
+        if (!bulkBranch) {
+          var_l = new TTreeReaderValue<Long64_t>(*reader, cname);
+          bui_l = new arrow::Int64Builder(pool);
+        }
         break;
       default:
         LOG(FATAL) << "Type not handled: " << dt << std::endl;
@@ -481,6 +541,106 @@ class columnIterator
     return status;
   }
 
+  // is the column filled by bulkFill rather than by push
+  bool isBulk()
+  {
+    return bulkBranch != nullptr;
+  }
+
+  const char* Name()
+  {
+    return cname;
+  }
+
+  // decode the first nEntries entries of branch, basket by basket, into a
+  // single arrow buffer. branch is either bulkBranch or the branch with the
+  // same name of another handle on the same tree.
+  template <typename T>
+  void bulkFill(Long64_t nEntries, TBranch* branch)
+  {
+    std::shared_ptr<arrow::Buffer> buffer;
+    auto stat = arrow::AllocateBuffer(pool, nEntries * sizeof(T), &buffer);
+    if (!stat.ok()) {
+      LOG(FATAL) << "Can not allocate buffer for branch " << cname << ": " << stat.ToString();
+      return;
+    }
+    auto values = reinterpret_cast<T*>(buffer->mutable_data());
+
+    // the values in the basket are big endian, frombuf takes care of
+    // swapping them if needed
+    TBufferFile basket(TBuffer::kWrite, 32 * 1024);
+    Long64_t onFile = std::min(nEntries, branch->GetBasketEntry()[branch->GetWriteBasket()]);
+    Long64_t entry = 0;
+    while (entry < onFile) {
+      Long64_t count = branch->GetBulkRead().GetEntriesSerialized(entry, basket);
+      if (count <= 0) {
+        LOG(FATAL) << "Can not read entry " << entry << " of branch " << cname;
+        return;
+      }
+      count = std::min(count, onFile - entry);
+      char* data = basket.GetCurrent();
+      for (Long64_t i = 0; i < count; ++i) {
+        frombuf(data, values + entry + i);
+      }
+      entry += count;
+    }
+
+    // the last basket might still be in memory, e.g. when the tree was
+    // written without flushing it, so we need to read it entry by entry
+    if (entry < nEntries) {
+      auto address = branch->GetAddress();
+      T value;
+      branch->SetAddress(&value);
+      for (; entry < nEntries; ++entry) {
+        branch->GetEntry(entry);
+        values[entry] = value;
+      }
+      if (address) {
+        branch->SetAddress(address);
+      } else {
+        branch->ResetAddress();
+      }
+    }
+    ar = arrow::MakeArray(arrow::ArrayData::Make(field->type(), nEntries, {nullptr, buffer}, 0));
+  }
+
+  void bulkFill(Long64_t nEntries, TBranch* branch = nullptr)
+  {
+    if (!branch) {
+      branch = bulkBranch;
+    }
+    // switch according to dt
+    switch (dt) {
+      case EDataType::kFloat_t:
+        bulkFill<Float_t>(nEntries, branch);
+        break;
+      case EDataType::kDouble_t:
+        bulkFill<Double_t>(nEntries, branch);
+        break;
+      case EDataType::kUShort_t:
+        bulkFill<UShort_t>(nEntries, branch);
+        break;
+      case EDataType::kUInt_t:
+        bulkFill<UInt_t>(nEntries, branch);
+        break;
+      case EDataType::kULong64_t:
+        bulkFill<ULong64_t>(nEntries, branch);
+        break;
+      case EDataType::kShort_t:
+        bulkFill<Short_t>(nEntries, branch);
+        break;
+      case EDataType::kInt_t:
+        bulkFill<Int_t>(nEntries, branch);
+        break;
+      case EDataType::kLong64_t:
+        bulkFill<Long64_t>(nEntries, branch);
+        break;
+      default:
+        LOG(FATAL) << "Type not handled: " << dt << std::endl;
+        break;
+    }
+  }
+
   // copy the TTreeReaderValue to the arrow::TBuilder
   void push()
   {
@@ -532,6 +692,10 @@ class columnIterator
   // with this ar is prepared to be used in arrow::Table::Make
   void finish()
   {
+    // already done by bulkFill
+    if (bulkBranch) {
+      return;
+    }
     arrow::Status stat;
 
     // switch according to dt
@@ -576,6 +740,12 @@ class TreeToTable
   // the rows of a TTree
   TTreeReader* reader;
 
+  // read the fixed size branches with the bulk API
+  bool bulkRead;
+
+  // number of threads used to read the bulk branches
+  int nThreads;
+
   // a list of columnIterator*
   std::vector<std::shared_ptr<columnIterator>> colits;
 
@@ -583,12 +753,15 @@ class TreeToTable
   // corresponding table columns
   void push()
   {
-    for (auto colit : colits)
-      colit->push();
+    for (auto colit : colits) {
+      if (!colit->isBulk()) {
+        colit->push();
+      }
+    }
   }
 
  public:
-  TreeToTable(TTree* tree)
+  TreeToTable(TTree* tree, bool bulk = true, int threads = 1) : bulkRead(bulk), nThreads(threads)
   {
     // initialize the TTreeReader
     reader = new TTreeReader(tree);
@@ -603,7 +776,7 @@ class TreeToTable
   // add a column to be included in the arrow::table
   bool AddColumn(const char* colname)
   {
-    auto colit = std::make_shared<columnIterator>(reader, colname);
+    auto colit = std::make_shared<columnIterator>(reader, colname, bulkRead);
     auto stat = colit->Status();
     if (stat)
       colits.push_back(std::move(colit));
@@ -628,7 +801,7 @@ class TreeToTable
       auto br = (TBranch*)branchList->At(ii);
 
       // IMPROVE: make sure that a column is not added more than one time
-      auto colit = std::make_shared<columnIterator>(reader, br->GetName());
+      auto colit = std::make_shared<columnIterator>(reader, br->GetName(), bulkRead);
       if (colit->Status()) {
         colits.push_back(std::move(colit));
       } else {
@@ -652,7 +825,52 @@ class TreeToTable
   // do the looping with the TTreeReader
   void Fill()
   {
-    // copy all values from the tree to the table builders
+    // the bulk columns are filled one branch at a time, in parallel if
+    // possible
+    std::vector<std::shared_ptr<columnIterator>> bulkColits;
+    for (auto colit : colits) {
+      if (colit->isBulk()) {
+        bulkColits.push_back(colit);
+      }
+    }
+    auto tree = reader->GetTree();
+    auto nEntries = tree->GetEntries();
+    auto bulkFill = [nEntries](std::shared_ptr<columnIterator> colit) { colit->bulkFill(nEntries); };
+#ifdef R__USE_IMT
+    // A TTree and its branches must not be used by more than one thread, so
+    // each task opens the file again and reads the branch of its own copy of
+    // the tree. This needs the tree to be complete on a file which does not
+    // change while we read it.
+    auto file = tree->GetCurrentFile();
+    if (nThreads > 1 && bulkColits.size() > 1 && file && !file->IsWritable()) {
+      std::string fileName = file->GetName();
+      std::string dirPath = tree->GetDirectory()->GetPath();
+      dirPath = dirPath.substr(dirPath.find(":/") + 2);
+      std::string treePath = dirPath.empty() ? tree->GetName() : dirPath + "/" + tree->GetName();
+      auto taskFill = [nEntries, &fileName, &treePath](std::shared_ptr<columnIterator> colit) {
+        std::unique_ptr<TFile> taskFile(TFile::Open(fileName.c_str(), "READ"));
+        auto taskTree = taskFile ? (TTree*)taskFile->Get(treePath.c_str()) : nullptr;
+        auto taskBranch = taskTree ? taskTree->GetBranch(colit->Name()) : nullptr;
+        if (!taskBranch) {
+          LOG(FATAL) << "Can not locate branch " << colit->Name() << " in " << fileName << ":" << treePath;
+          return;
+        }
+        colit->bulkFill(nEntries, taskBranch);
+      };
+      ROOT::EnableThreadSafety();
+      ROOT::TThreadExecutor pool(nThreads);
+      pool.Foreach(taskFill, bulkColits);
+    } else {
+      std::for_each(bulkColits.begin(), bulkColits.end(), bulkFill);
+    }
+#else
+    std::for_each(bulkColits.begin(), bulkColits.end(), bulkFill);
+#endif
+    if (bulkColits.size() == colits.size()) {
+      return;
+    }
+
+    // copy all the other values from the tree to the table builders
     reader->Restart();
     while (reader->Next())
       push();
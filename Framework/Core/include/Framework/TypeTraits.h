@@ -106,6 +106,16 @@ template <typename T>
 struct is_span<T, std::conditional_t<false, typename T::value_type, void>> : std::is_same<gsl::span<typename T::value_type>, T> {
 };
 
+// Detect whether a class is a read only view which can be built directly over
+// a flat message payload, i.e. it defines `is_flat_view` and has a constructor
+// taking a gsl::span<const char>. E.g. o2::dataformats::MCTruthContainerView
+template <typename T, typename _ = void>
+struct is_flat_view : std::false_type {
+};
+template <typename T>
+struct is_flat_view<T, std::conditional_t<false, typename T::is_flat_view, void>> : T::is_flat_view {
+};
+
 // Detect whether a class has a ROOT dictionary
 // This member detector idiom is implemented using SFINAE idiom to look for
 // a 'Class()' method.
@@ -0,0 +1,110 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "AODFilePrefetcher.h"
+#include "Framework/Logger.h"
+
+#include <algorithm>
+
+namespace o2::framework
+{
+
+AODFilePrefetcher::AODFilePrefetcher(std::vector<std::string> filenames, Reader reader, size_t maxAhead, size_t memoryBudget)
+  : mFilenames{std::move(filenames)},
+    mReader{std::move(reader)},
+    mMaxAhead{std::max(maxAhead, size_t{1})},
+    mMemoryBudget{memoryBudget},
+    mThread{[this]() { run(); }}
+{
+}
+
+AODFilePrefetcher::~AODFilePrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mCondition.notify_all();
+  mThread.join();
+}
+
+void AODFilePrefetcher::run()
+{
+  for (auto& filename : mFilenames) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      // We always allow for at least one file to be waiting, otherwise a
+      // file larger than the budget would block everything.
+      auto canRead = [this]() {
+        return mStop || mReady.empty() || (mReady.size() < mMaxAhead && (mMemoryBudget == 0 || mReadyBytes < mMemoryBudget));
+      };
+      while (canRead() == false) {
+        mIdle = true;
+        mCondition.notify_all();
+        mCondition.wait(lock);
+      }
+      mIdle = false;
+      if (mStop) {
+        return;
+      }
+    }
+    std::unique_ptr<AODFileContent> content;
+    try {
+      content = mReader(filename);
+    } catch (std::exception& e) {
+      LOG(ERROR) << "Error while reading " << filename << ": " << e.what();
+    }
+    if (content.get() == nullptr) {
+      content = std::make_unique<AODFileContent>();
+      content->filename = filename;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mReadyBytes += content->memoryUsage;
+      mReady.push_back(std::move(content));
+    }
+    mCondition.notify_all();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDone = true;
+  }
+  mCondition.notify_all();
+}
+
+std::unique_ptr<AODFileContent> AODFilePrefetcher::next()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mCondition.wait(lock, [this]() { return mReady.empty() == false || mDone; });
+  if (mReady.empty()) {
+    return nullptr;
+  }
+  auto content = std::move(mReady.front());
+  mReady.pop_front();
+  mReadyBytes -= content->memoryUsage;
+  // The background thread needs to check again if it can read more.
+  mIdle = false;
+  lock.unlock();
+  mCondition.notify_all();
+  return content;
+}
+
+size_t AODFilePrefetcher::ready()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mReady.size();
+}
+
+void AODFilePrefetcher::waitIdle()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mCondition.wait(lock, [this]() { return mIdle || mDone; });
+}
+
+} // namespace o2::framework
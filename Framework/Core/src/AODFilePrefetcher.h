@@ -0,0 +1,97 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_AODFILEPREFETCHER_H_
+#define O2_FRAMEWORK_AODFILEPREFETCHER_H_
+
+#include "Framework/Output.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace arrow
+{
+class Buffer;
+class Table;
+} // namespace arrow
+
+namespace o2::framework
+{
+
+/// All the tables which were read from a given AOD file, ready to be sent.
+struct AODFileContent {
+  std::string filename;
+  /// False if the file could not be opened
+  bool valid = false;
+  std::vector<std::pair<Output, std::shared_ptr<arrow::Table>>> tables;
+  /// Tables which are already serialised, e.g. memory mapped arrow files
+  std::vector<std::pair<Output, std::shared_ptr<arrow::Buffer>>> streams;
+  /// Bytes read from the storage, i.e. compressed
+  size_t bytesRead = 0;
+  /// Estimated size of the decoded tables
+  size_t memoryUsage = 0;
+  /// Time it took to open and decode the file
+  double readTimeMs = 0;
+};
+
+/// Reads a list of AOD files in a background thread, keeping up to a given
+/// number of them decoded ahead of the one being processed, and hands them
+/// out in order.
+class AODFilePrefetcher
+{
+ public:
+  using Reader = std::function<std::unique_ptr<AODFileContent>(std::string const&)>;
+
+  /// @a maxAhead is the maximum number of decoded files waiting to be
+  /// processed. Once more than @a memoryBudget bytes are waiting, no new
+  /// file is read, regardless of @a maxAhead. 0 means no limit.
+  AODFilePrefetcher(std::vector<std::string> filenames, Reader reader, size_t maxAhead, size_t memoryBudget);
+  ~AODFilePrefetcher();
+
+  /// @return the next file in the list, waiting for it to be read if
+  /// needed, or nullptr if all the files have been handed out.
+  std::unique_ptr<AODFileContent> next();
+
+  /// @return how many files are currently decoded and waiting
+  size_t ready();
+
+  /// Wait until the background thread cannot read any further file, either
+  /// because the limits are reached or because all the files were read.
+  void waitIdle();
+
+ private:
+  void run();
+
+  std::vector<std::string> mFilenames;
+  Reader mReader;
+  size_t mMaxAhead;
+  size_t mMemoryBudget;
+
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::deque<std::unique_ptr<AODFileContent>> mReady;
+  size_t mReadyBytes = 0;
+  bool mDone = false;
+  /// The background thread is waiting for files to be handed out
+  bool mIdle = false;
+  bool mStop = false;
+  std::thread mThread;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_AODFILEPREFETCHER_H_
@@ -10,28 +10,39 @@
 
 #include "Framework/AODReaderHelpers.h"
 #include "Framework/AnalysisDataModel.h"
+#include "AODFilePrefetcher.h"
 #include "DataProcessingHelpers.h"
 #include "Framework/RootTableBuilderHelpers.h"
+#include "Framework/TableTreeHelpers.h"
 #include "Framework/AlgorithmSpec.h"
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/ControlService.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/RawDeviceService.h"
 #include "Framework/DataSpecUtils.h"
+#include "Framework/DataOutputDirector.h"
 #include "Framework/SourceInfoHeader.h"
 #include "Framework/ChannelInfo.h"
 #include "Framework/Logger.h"
 
 #include <FairMQDevice.h>
+#include <Monitoring/Monitoring.h>
 #include <ROOT/RDataFrame.hxx>
 #include <TFile.h>
+#include <TROOT.h>
 
+#include <arrow/buffer.h>
+#include <arrow/io/file.h>
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 #include <arrow/io/interfaces.h>
 #include <arrow/table.h>
 #include <arrow/util/key_value_metadata.h>
 
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <sstream>
 #include <thread>
 
 namespace o2::framework::readers
@@ -284,6 +295,57 @@ AlgorithmSpec AODReaderHelpers::run2ESDConverterCallback()
   return callback;
 }
 
+std::shared_ptr<arrow::Buffer> AODReaderHelpers::mapArrowStream(std::string const& filename)
+{
+  // "ARROW1" plus padding, then the stream, the footer, the size of
+  // the footer and "ARROW1" again.
+  constexpr int64_t headerSize = 8;
+  constexpr int64_t trailerSize = 10;
+  constexpr char magic[] = "ARROW1";
+
+  struct MappedStream {
+    std::shared_ptr<arrow::io::MemoryMappedFile> file;
+    std::shared_ptr<arrow::Buffer> buffer;
+  };
+  auto mapped = std::make_shared<MappedStream>();
+  int64_t size = 0;
+  if (arrow::io::MemoryMappedFile::Open(filename, arrow::io::FileMode::READ, &mapped->file).ok() == false ||
+      mapped->file->GetSize(&size).ok() == false ||
+      size < headerSize + trailerSize ||
+      mapped->file->ReadAt(0, size, &mapped->buffer).ok() == false) {
+    return nullptr;
+  }
+  auto data = mapped->buffer->data();
+  if (memcmp(data, magic, 6) != 0 || memcmp(data + size - 6, magic, 6) != 0) {
+    return nullptr;
+  }
+  int32_t footerSize;
+  memcpy(&footerSize, data + size - trailerSize, sizeof(int32_t));
+  auto streamSize = size - headerSize - trailerSize - footerSize;
+  if (footerSize < 0 || streamSize <= 0) {
+    return nullptr;
+  }
+  mapped->buffer = arrow::SliceBuffer(mapped->buffer, headerSize, streamSize);
+  // The returned pointer keeps the file mapped.
+  return std::shared_ptr<arrow::Buffer>(mapped, mapped->buffer.get());
+}
+
+namespace
+{
+/// @return an estimate of the memory used by the fixed width columns
+/// of @a table
+size_t estimateTableSize(arrow::Table const& table)
+{
+  size_t result = 0;
+  for (auto& field : table.schema()->fields()) {
+    if (auto type = std::dynamic_pointer_cast<arrow::FixedWidthType>(field->type())) {
+      result += (type->bit_width() * table.num_rows() + 7) / 8;
+    }
+  }
+  return result;
+}
+} // namespace
+
 AlgorithmSpec AODReaderHelpers::rootFileReaderCallback()
 {
   auto callback = AlgorithmSpec{adaptStateful([](ConfigParamRegistry const& options,
@@ -307,44 +369,85 @@ AlgorithmSpec AODReaderHelpers::rootFileReaderCallback()
       filenames.push_back(filename);
     }
 
+    // Each parallel reader reads the files whose index is associated to
+    // their inputTimesliceId
+    assert(spec.inputTimesliceId < spec.maxInputTimeslices);
+    std::vector<std::string> ourFilenames;
+    for (size_t fi = spec.inputTimesliceId; fi < filenames.size(); fi += spec.maxInputTimeslices) {
+      ourFilenames.push_back(filenames[fi]);
+    }
+
     // analyze type of requested tables
     uint64_t readMask = calculateReadMask(spec.outputs, header::DataOrigin{"AOD"});
     std::vector<OutputRoute> unknowns;
     if (readMask & AODTypeMask::Unknown)
       unknowns = getListOfUnknown(spec.outputs);
 
-    auto counter = std::make_shared<int>(0);
-    return adaptStateless([readMask,
-                           unknowns,
-                           counter,
-                           filenames](DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
-      // Each parallel reader reads the files whose index is associated to
-      // their inputTimesliceId
-      assert(device.inputTimesliceId < device.maxInputTimeslices);
-      size_t fi = (*counter * device.maxInputTimeslices) + device.inputTimesliceId;
-      if (fi >= filenames.size()) {
-        LOG(info) << "All input files processed";
-        control.endOfStream();
-        control.readyToQuit(QuitRequest::Me);
-        return;
-      }
-      auto f = filenames[fi];
-      LOG(INFO) << "Processing " << f;
-      auto infile = std::make_unique<TFile>(f.c_str());
-      *counter += 1;
-      if (infile.get() == nullptr || infile->IsOpen() == false) {
-        LOG(ERROR) << "File not found: " + f;
-        return;
-      }
-      auto tableMaker = [&infile, &readMask, &outputs, &f](auto metadata, AODTypeMask mask, char const* treeName) {
+    // Tables for which the arrow files written by the AOD writer should be
+    // used, rather than the trees of the ROOT file.
+    std::set<std::string> arrowTables;
+    std::stringstream arrowTablesOption(options.get<std::string>("aod-arrow-tables"));
+    for (std::string table; std::getline(arrowTablesOption, table, ',');) {
+      arrowTables.insert(table);
+    }
+
+    // Number of threads used by TreeToTable to read the branches of a tree
+    // in parallel.
+    auto nThreads = options.get<int>("aod-reader-threads");
+
+    // Open a file and convert all the requested trees to arrow tables.
+    // This does not use any service, so that it can be done in advance.
+    auto readFile = [readMask, unknowns, arrowTables, nThreads](std::string const& f) {
+      auto content = std::make_unique<AODFileContent>();
+      content->filename = f;
+      content->valid = true;
+      auto start = std::chrono::steady_clock::now();
+
+      // The tables stored in arrow files are memory mapped and sent as they
+      // are. For a file foo.root, the table with description BAR is looked
+      // up in foo_BAR.arrow, which is what the AOD writer produces. The
+      // ROOT file is only opened if some table needs to be converted from
+      // a tree.
+      auto mapTable = [&arrowTables, &content, &f](Output const& output, std::string const& description) -> bool {
+        if (arrowTables.count("all") == 0 && arrowTables.count(description) == 0) {
+          return false;
+        }
+        auto fn = DataOutputDirector::arrowFilename(f, description);
+        auto stream = AODReaderHelpers::mapArrowStream(fn);
+        if (stream == nullptr) {
+          LOG(INFO) << "Unable to map arrow file " << fn << ", reading " << description << " from " << f;
+          return false;
+        }
+        content->streams.emplace_back(Output{output.origin, output.description, output.subSpec}, stream);
+        return true;
+      };
+      std::unique_ptr<TFile> infile;
+      auto getFile = [&infile, &content, &f]() -> TFile* {
+        if (infile.get() == nullptr && content->valid) {
+          infile.reset(TFile::Open(f.c_str()));
+          if (infile.get() == nullptr || infile->IsOpen() == false) {
+            LOG(ERROR) << "File not found: " + f;
+            content->valid = false;
+            infile.reset();
+          }
+        }
+        return infile.get();
+      };
+
+      auto tableMaker = [&getFile, &mapTable, &readMask, &content, &f](auto metadata, AODTypeMask mask, char const* treeName) {
         if (readMask & mask) {
           using table_t = typename decltype(metadata)::table_t;
-          std::unique_ptr<TTreeReader> reader = std::make_unique<TTreeReader>(treeName, infile.get());
+          auto output = Output{decltype(metadata)::origin(), decltype(metadata)::description()};
+          if (mapTable(output, output.description.as<std::string>()) || getFile() == nullptr) {
+            return;
+          }
+          std::unique_ptr<TTreeReader> reader = std::make_unique<TTreeReader>(treeName, getFile());
           if (reader->IsInvalid()) {
             LOGP(ERROR, "Requested {} tree not found in file {}", treeName, f);
           } else {
-            auto& builder = outputs.make<TableBuilder>(Output{decltype(metadata)::origin(), decltype(metadata)::description()});
+            TableBuilder builder;
             RootTableBuilderHelpers::convertASoA<table_t>(builder, *reader);
+            content->tables.emplace_back(std::move(output), builder.finalize());
           }
         }
       };
@@ -364,24 +467,88 @@ AlgorithmSpec AODReaderHelpers::rootFileReaderCallback()
         // loop over unknowns
         for (auto route : unknowns) {
           auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+          auto h = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
+          if (mapTable(Output(h), concrete.description.as<std::string>())) {
+            continue;
+          }
+          if (getFile() == nullptr) {
+            break;
+          }
 
           // get the tree from infile
           auto trname = concrete.description.str;
-          auto tr = (TTree*)infile.get()->Get(trname);
+          auto tr = (TTree*)getFile()->Get(trname);
           if (!tr) {
             LOG(ERROR) << "Tree " << trname << "is not contained in file " << f;
-            return;
+            break;
           }
 
-          // create a TreeToTable object
-          auto h = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
-          auto o = Output(h);
-          auto& t2t = outputs.make<TreeToTable>(o, tr);
+          // convert the tree to a table
+          TreeToTable t2t(tr, true, nThreads);
+          t2t.AddAllColumns();
+          content->tables.emplace_back(Output(h), t2t.Process());
+        }
+      }
 
-          // fill the table
-          t2t.Fill();
+      if (infile) {
+        content->bytesRead = infile->GetBytesRead();
+      }
+      for (auto& entry : content->tables) {
+        content->memoryUsage += estimateTableSize(*entry.second);
+      }
+      content->readTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      return content;
+    };
+
+    // If requested, the files are read in a background thread, ahead of
+    // the time they are needed.
+    std::shared_ptr<AODFilePrefetcher> prefetcher;
+    auto nPrefetch = options.get<int>("aod-reader-prefetch");
+    if (nPrefetch > 0) {
+      ROOT::EnableThreadSafety();
+      size_t memoryBudget = options.get<int>("aod-reader-prefetch-memory") * 1024ul * 1024ul;
+      prefetcher = std::make_shared<AODFilePrefetcher>(ourFilenames, readFile, nPrefetch, memoryBudget);
+    }
+
+    auto counter = std::make_shared<size_t>(0);
+    return adaptStateless([readFile,
+                           prefetcher,
+                           counter,
+                           ourFilenames](DataAllocator& outputs, ControlService& control, monitoring::Monitoring& monitoring) {
+      std::unique_ptr<AODFileContent> content;
+      if (prefetcher) {
+        content = prefetcher->next();
+      } else if (*counter < ourFilenames.size()) {
+        content = readFile(ourFilenames[*counter]);
+      }
+      if (content.get() == nullptr) {
+        LOG(info) << "All input files processed";
+        control.endOfStream();
+        control.readyToQuit(QuitRequest::Me);
+        return;
+      }
+      *counter += 1;
+      LOG(INFO) << "Processing " << content->filename;
+      if (content->valid == false) {
+        return;
+      }
+
+      for (auto& [output, table] : content->tables) {
+        auto writer = outputs.make<arrow::ipc::RecordBatchWriter>(output, table->schema());
+        auto writeStatus = writer->WriteTable(*table);
+        if (writeStatus.ok() == false) {
+          throw std::runtime_error("Unable to write table");
         }
       }
+      for (auto& [output, stream] : content->streams) {
+        outputs.adoptArrowStream(output, stream);
+      }
+
+      auto mb = content->bytesRead / (1024. * 1024.);
+      monitoring.send({mb, "aod_file_read_mb"});
+      monitoring.send({content->readTimeMs, "aod_file_read_time_ms"});
+      monitoring.send({content->readTimeMs > 0 ? 1000. * mb / content->readTimeMs : 0., "aod_file_read_mb_per_s"});
+      monitoring.send({(int)(prefetcher ? prefetcher->ready() : 0), "aod_files_prefetched"});
     });
   })};
 
@@ -37,6 +37,8 @@
 #include <ROOT/RDataFrame.hxx>
 #include <ROOT/RArrowDS.hxx>
 #include <ROOT/RVec.hxx>
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
 #include <chrono>
 #include <exception>
 #include <fstream>
@@ -334,6 +336,31 @@ DataProcessorSpec
           // a table can be saved in multiple ways
           // e.g. different selections of columns to different files
           for (auto d : ds) {
+            if (d->format == DataOutputFormat::Arrow) {
+              // the record batches are stored as they are, only
+              // dropping the columns which were not requested
+              auto toWrite = table;
+              if (d->colnames.size() > 0) {
+                std::vector<std::shared_ptr<arrow::Field>> fields;
+                std::vector<std::decay_t<decltype(table->column(0))>> columns;
+                for (auto cn : d->colnames) {
+                  auto idx = table->schema()->GetFieldIndex(cn);
+                  if (idx >= 0) {
+                    fields.push_back(table->schema()->field(idx));
+                    columns.push_back(table->column(idx));
+                  }
+                }
+                toWrite = arrow::Table::Make(std::make_shared<arrow::Schema>(fields), columns);
+              }
+              auto writer = dod->getArrowOutputWriter(d, ntf, ntfmerge, toWrite->schema());
+              if (writer) {
+                auto status = writer->WriteTable(*toWrite);
+                if (!status.ok()) {
+                  LOG(ERROR) << "Unable to write " << d->treename << ": " << status.ToString();
+                }
+              }
+              continue;
+            }
             TableToTree ta2tr(table,
                               dod->getDataOutputFile(d, ntf, ntfmerge, filemode),
                               d->treename.c_str());
@@ -364,7 +391,7 @@ DataProcessorSpec
      {"res-file", VariantType::String, {"Default name of the output file"}},
      {"res-mode", VariantType::String, {"Creation mode of the result files: NEW, CREATE, RECREATE, UPDATE"}},
      {"ntfmerge", VariantType::Int, {"Number of time frames to merge into one file"}},
-     {"keep", VariantType::String, {"Comma separated list of ORIGIN/DESCRIPTION/SUBSPECIFICATION:treename:col1/col2/..:filename"}}}};
+     {"keep", VariantType::String, {"Comma separated list of ORIGIN/DESCRIPTION/SUBSPECIFICATION:treename:col1/col2/..:filename[:root|arrow]"}}}};
 
   return spec;
 }
@@ -19,6 +19,7 @@
 
 #include <fairmq/FairMQDevice.h>
 
+#include <arrow/buffer.h>
 #include <arrow/ipc/writer.h>
 #include <arrow/type.h>
 #include <arrow/io/memory.h>
@@ -34,6 +35,60 @@ using DataHeader = o2::header::DataHeader;
 using DataDescription = o2::header::DataDescription;
 using DataProcessingHeader = o2::framework::DataProcessingHeader;
 
+namespace
+{
+arrow::Status writeTableStream(arrow::Table const& table, arrow::io::OutputStream* stream)
+{
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+  auto status = arrow::ipc::RecordBatchStreamWriter::Open(stream, table.schema(), &writer);
+  if (status.ok()) {
+    status = writer->WriteTable(table);
+  }
+  if (status.ok()) {
+    status = writer->Close();
+  }
+  return status;
+}
+
+/// @return an upper bound for the size of @a table once serialised, i.e.
+/// its buffers plus some room for the schema and the record batch headers.
+int64_t estimateStreamSize(arrow::Table const& table)
+{
+  int64_t size = 1024;
+  for (int ci = 0; ci < table.num_columns(); ++ci) {
+    auto const& chunks = table.column(ci)->data()->chunks();
+    size += 256 * (chunks.size() + 1);
+    for (auto const& chunk : chunks) {
+      for (auto const& buffer : chunk->data()->buffers) {
+        if (buffer) {
+          size += (buffer->size() + 7) & ~int64_t{7};
+        }
+      }
+    }
+  }
+  return size;
+}
+
+/// Serialise @a table into @a buffer. The backing message is reserved
+/// upfront with an estimate of the final size, so that the table is written
+/// only once and the message is normally not grown, and copied, meanwhile.
+void writeTableToBuffer(arrow::Table const& table, std::shared_ptr<FairMQResizableBuffer> buffer)
+{
+  auto status = buffer->Reserve(estimateStreamSize(table));
+  if (status.ok() == false) {
+    throw std::runtime_error("Unable to allocate buffer for table: " + status.ToString());
+  }
+  auto stream = std::make_shared<arrow::io::BufferOutputStream>(buffer);
+  status = writeTableStream(table, stream.get());
+  if (status.ok()) {
+    status = stream->Close();
+  }
+  if (status.ok() == false) {
+    throw std::runtime_error("Unable to Write table: " + status.ToString());
+  }
+}
+} // namespace
+
 DataAllocator::DataAllocator(TimingInfo* timingInfo,
                              ContextRegistry* contextRegistry,
                              const AllowedOutputRoutes& routes)
@@ -88,6 +143,29 @@ void DataAllocator::adoptChunk(const Output& spec, char* buffer, size_t size, fa
   context->add<MessageContext::TrivialObject>(std::move(headerMessage), channel, 0, buffer, size, freefn, hint);
 }
 
+namespace
+{
+void releaseArrowBuffer(void*, void* hint)
+{
+  delete reinterpret_cast<std::shared_ptr<arrow::Buffer>*>(hint);
+}
+} // namespace
+
+void DataAllocator::adoptArrowStream(const Output& spec, std::shared_ptr<arrow::Buffer> stream)
+{
+  std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
+  auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodArrow, stream->size());
+
+  // The hint owns a reference to the buffer, which is released by
+  // releaseArrowBuffer once the message is gone.
+  char* data = reinterpret_cast<char*>(const_cast<uint8_t*>(stream->data()));
+  size_t size = stream->size();
+  void* hint = new std::shared_ptr<arrow::Buffer>(std::move(stream));
+  fairmq_free_fn* freefn = &releaseArrowBuffer;
+  auto context = mContextRegistry->get<MessageContext>();
+  context->add<MessageContext::TrivialObject>(std::move(header), channel, 0, data, size, freefn, hint);
+}
+
 FairMQMessagePtr DataAllocator::headerMessageFromOutput(Output const& spec,                     //
                                                         std::string const& channel,             //
                                                         o2::header::SerializationMethod method, //
@@ -145,20 +223,12 @@ void DataAllocator::adopt(const Output& spec, TableBuilder* tb)
   auto creator = [device = context->proxy().getDevice()](size_t s) -> std::unique_ptr<FairMQMessage> { return device->NewMessage(s); };
   auto buffer = std::make_shared<FairMQResizableBuffer>(creator);
 
-  /// To finalise this we write the table to the buffer.
-  /// FIXME: most likely not a great idea. We should probably write to the buffer
-  ///        directly in the TableBuilder, incrementally.
+  /// To finalise this we write the table to the buffer, which is allocated
+  /// once with the final size of the stream.
   std::shared_ptr<TableBuilder> p(tb);
   auto finalizer = [payload = p](std::shared_ptr<FairMQResizableBuffer> b) -> void {
     auto table = payload->finalize();
-
-    auto stream = std::make_shared<arrow::io::BufferOutputStream>(b);
-    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
-    auto outBatch = arrow::ipc::RecordBatchStreamWriter::Open(stream.get(), table->schema(), &writer);
-    auto outStatus = writer->WriteTable(*table);
-    if (outStatus.ok() == false) {
-      throw std::runtime_error("Unable to Write table");
-    }
+    writeTableToBuffer(*table, b);
   };
 
   assert(context);
@@ -178,23 +248,15 @@ void DataAllocator::adopt(const Output& spec, TreeToTable* t2t)
   };
   auto buffer = std::make_shared<FairMQResizableBuffer>(creator);
 
-  /// To finalise this we write the table to the buffer.
-  /// FIXME: most likely not a great idea. We should probably write to the buffer
-  ///        directly in the TableBuilder, incrementally.
+  /// To finalise this we write the table to the buffer, which is allocated
+  /// once with the final size of the stream.
   std::shared_ptr<TreeToTable> p(t2t);
   auto finalizer = [payload = p](std::shared_ptr<FairMQResizableBuffer> b) -> void {
     auto table = payload->Finalize();
     LOG(INFO) << "DataAllocator Table created!";
     LOG(INFO) << "Number of columns " << table->num_columns();
     LOG(INFO) << "Number of rows    " << table->num_rows();
-
-    auto stream = std::make_shared<arrow::io::BufferOutputStream>(b);
-    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
-    auto outBatch = arrow::ipc::RecordBatchStreamWriter::Open(stream.get(), table->schema(), &writer);
-    auto outStatus = writer->WriteTable(*table);
-    if (outStatus.ok() == false) {
-      throw std::runtime_error("Unable to Write table");
-    }
+    writeTableToBuffer(*table, b);
   };
 
   assert(context);
@@ -12,6 +12,9 @@
 #include "rapidjson/document.h"
 #include "rapidjson/filereadstream.h"
 
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+
 namespace o2
 {
 namespace framework
@@ -24,6 +27,7 @@ DataOutputDescriptor::DataOutputDescriptor(std::string sin)
   // "origin/description/subSpec:treename:col1/col2/col3:filename"
   // the 1st part is used to create a DataDescriptorMatcher
   // the other parts are used to fill treename, colnames, and filename
+  // an optional 5th part selects the format, "root" (default) or "arrow"
   // remove all spaces
   auto s = remove_ws(sin);
 
@@ -92,6 +96,17 @@ DataOutputDescriptor::DataOutputDescriptor(std::string sin)
   if (!iter1->str().empty()) {
     filename = iter1->str();
   }
+
+  // get the format
+  ++iter1;
+  if (iter1 == end) {
+    return;
+  }
+  if (iter1->str() == "arrow") {
+    format = DataOutputFormat::Arrow;
+  } else if (!iter1->str().empty() && iter1->str() != "root") {
+    LOG(ERROR) << "Unknown output format " << iter1->str() << ", using root";
+  }
 }
 
 std::string DataOutputDescriptor::getFilename()
@@ -105,6 +120,7 @@ void DataOutputDescriptor::printOut()
   LOG(INFO) << "  table name: " << tablename;
   LOG(INFO) << "  file name : " << getFilename();
   LOG(INFO) << "  tree name : " << treename;
+  LOG(INFO) << "  format    : " << (format == DataOutputFormat::Arrow ? "arrow" : "root");
   if (colnames.empty()) {
     LOG(INFO) << "  columns   : all";
   } else {
@@ -313,6 +329,10 @@ std::tuple<std::string, std::string, int> DataOutputDirector::readJsonDocument(D
                 if (od.HasMember("filename")) {
                   s += od["filename"].GetString();
                 }
+                s += smc;
+                if (od.HasMember("format")) {
+                  s += od["format"].GetString();
+                }
 
                 // convert s to DataOutputDescription object
                 readString(s);
@@ -393,12 +413,70 @@ TFile* DataOutputDirector::getDataOutputFile(DataOutputDescriptor* dod,
   return fout;
 }
 
+std::shared_ptr<arrow::ipc::RecordBatchWriter>
+  DataOutputDirector::getArrowOutputWriter(DataOutputDescriptor* dod,
+                                           int ntf, int ntfmerge,
+                                           std::shared_ptr<arrow::Schema> schema)
+{
+  // one file per table/file name, the file mode is ignored and
+  // existing files are always replaced
+  auto& out = arrowouts[dod->tablename + ":" + dod->getFilename()];
+  if (out.dod == nullptr) {
+    out.dod = dod;
+  } else if (out.dod != dod) {
+    LOG(ERROR) << "Table " << dod->tablename << " is already written to " << dod->getFilename() << " in arrow format, ignoring " << dod->treename;
+    return nullptr;
+  }
+
+  // check if new version of file needs to be opened
+  int fcnt = (int)(ntf / ntfmerge);
+  if ((ntf % ntfmerge) == 0 && fcnt > out.fcnt) {
+    if (out.writer) {
+      out.writer->Close();
+      out.stream->Close();
+    }
+    out.writer.reset();
+    out.fcnt = fcnt;
+
+    auto fn = arrowFilename(dod->getFilename() + "_" + std::to_string(fcnt), dod->tablename);
+    std::shared_ptr<arrow::io::FileOutputStream> stream;
+    auto status = arrow::io::FileOutputStream::Open(fn, &stream);
+    if (status.ok()) {
+      out.stream = stream;
+      status = arrow::ipc::RecordBatchFileWriter::Open(out.stream.get(), schema, &out.writer);
+    }
+    if (!status.ok()) {
+      LOG(ERROR) << "Unable to open " << fn << ": " << status.ToString();
+      out.writer.reset();
+    }
+  }
+
+  return out.writer;
+}
+
+std::string DataOutputDirector::arrowFilename(std::string const& rootFilename, std::string const& description)
+{
+  std::string const extension = ".root";
+  auto base = rootFilename;
+  if (base.size() > extension.size() && base.compare(base.size() - extension.size(), extension.size(), extension) == 0) {
+    base.erase(base.size() - extension.size());
+  }
+  return base + "_" + description + ".arrow";
+}
+
 void DataOutputDirector::closeDataOutputFiles()
 {
   for (auto fout : fouts)
     if (fout) {
       fout->Close();
     }
+  for (auto& [name, out] : arrowouts) {
+    if (out.writer) {
+      out.writer->Close();
+      out.stream->Close();
+    }
+  }
+  arrowouts.clear();
 }
 
 void DataOutputDirector::printOut()
@@ -28,6 +28,7 @@
 #include "DataProcessingStatus.h"
 #include "DataProcessingHelpers.h"
 #include "DataRelayerHelpers.h"
+#include "InputPollingHelpers.h"
 
 #include "ScopedExit.h"
 
@@ -35,10 +36,12 @@
 #include <fairmq/FairMQSocket.h>
 #include <options/FairMQProgOptions.h>
 #include <Monitoring/Monitoring.h>
+#include <Monitoring/MonitoringFactory.h>
 #include <TMessage.h>
 #include <TClonesArray.h>
 
 #include <algorithm>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -48,21 +51,110 @@ using Key = o2::monitoring::tags::Key;
 using Value = o2::monitoring::tags::Value;
 using Metric = o2::monitoring::Metric;
 using Monitoring = o2::monitoring::Monitoring;
+using MonitoringFactory = o2::monitoring::MonitoringFactory;
 using DataHeader = o2::header::DataHeader;
 
 constexpr unsigned int MONITORING_QUEUE_SIZE = 100;
 constexpr unsigned int MIN_RATE_LOGGING = 60;
 
-// This should result in a minimum of 10Hz which should guarantee we do not use
-// much time when idle. We do not sleep at all when we are at less then 100us,
-// because that's what the default rate enforces in any case.
-constexpr int MAX_BACKOFF = 6;
-constexpr int MIN_BACKOFF_DELAY = 100;
-constexpr int BACKOFF_DELAY_STEP = 100;
+// The minimum number of in flight timeslices when the relayer pipeline
+// is adapted at runtime.
+constexpr size_t MIN_RELAYER_SLOTS = 2;
 
 namespace o2::framework
 {
 
+/// ControlService given to the computations running in the worker threads.
+/// The requests are recorded and replayed on the actual ControlService by
+/// the device thread, when the outputs of the computation are sent, so that
+/// they take effect in the order the timeslices were dispatched.
+class DeferredControlService : public ControlService
+{
+ public:
+  void readyToQuit(QuitRequest kind) final
+  {
+    mRequests.emplace_back([kind](ControlService& control) { control.readyToQuit(kind); });
+  }
+  void endOfStream() final
+  {
+    mRequests.emplace_back([](ControlService& control) { control.endOfStream(); });
+  }
+  void notifyStreamingState(StreamingState state) final
+  {
+    mRequests.emplace_back([state](ControlService& control) { control.notifyStreamingState(state); });
+  }
+  void replay(ControlService& control)
+  {
+    for (auto& request : mRequests) {
+      request(control);
+    }
+    mRequests.clear();
+  }
+
+ private:
+  std::vector<std::function<void(ControlService&)>> mRequests;
+};
+
+/// A timeslice being processed by one of the worker threads. Each task has
+/// its own set of contextes, so that the messages created for different
+/// timeslices do not get mixed up, and they can be sent in order by the
+/// device thread once the computation is completed. The services which are
+/// not thread safe are replaced in the ServiceRegistry of the task: the
+/// ControlService by a DeferredControlService and the Monitoring by the one
+/// of the worker thread.
+struct ComputingTask {
+  ComputingTask(FairMQDevice* device, std::vector<OutputRoute> const& outputs, ServiceRegistry const& services)
+    : fairMQContext{FairMQDeviceProxy{device}},
+      stringContext{FairMQDeviceProxy{device}},
+      dataFrameContext{FairMQDeviceProxy{device}},
+      rawBufferContext{FairMQDeviceProxy{device}},
+      contextRegistry{&fairMQContext, &stringContext, &dataFrameContext, &rawBufferContext},
+      allocator{&timingInfo, &contextRegistry, outputs},
+      serviceRegistry{services}
+  {
+    serviceRegistry.overrideService<ControlService>(&control);
+  }
+
+  uint64_t sequence = 0;
+  DataRelayer::RecordAction action;
+  TimingInfo timingInfo;
+  MessageContext fairMQContext;
+  StringContext stringContext;
+  ArrowContext dataFrameContext;
+  RawBufferContext rawBufferContext;
+  ContextRegistry contextRegistry;
+  DataAllocator allocator;
+  DeferredControlService control;
+  ServiceRegistry serviceRegistry;
+  std::vector<MessageSet> inputs;
+  /// The exception thrown by the processing callback, if any. It gets
+  /// rethrown and handled by the device thread.
+  std::exception_ptr error;
+  int processingCount = 0;
+  double elapsedTimeMs = 0;
+};
+
+namespace
+{
+/// Create an InputRecord which refers to the messages in @a inputs.
+InputRecord makeInputRecord(std::vector<InputRoute> const& schema, std::vector<MessageSet>& inputs)
+{
+  auto getter = [&inputs](size_t i, size_t partindex) -> DataRef {
+    if (inputs[i].size() > partindex) {
+      return DataRef{nullptr,
+                     static_cast<char const*>(inputs[i].at(partindex).header->GetData()),
+                     static_cast<char const*>(inputs[i].at(partindex).payload->GetData())};
+    }
+    return DataRef{nullptr, nullptr, nullptr};
+  };
+  auto nofPartsGetter = [&inputs](size_t i) -> size_t {
+    return inputs[i].size();
+  };
+  InputSpan span{getter, nofPartsGetter, inputs.size()};
+  return InputRecord{schema, std::move(span)};
+}
+} // namespace
+
 DataProcessingDevice::DataProcessingDevice(DeviceSpec const& spec, ServiceRegistry& registry, DeviceState& state)
   : mSpec{spec},
     mState{state},
@@ -97,10 +189,18 @@ DataProcessingDevice::DataProcessingDevice(DeviceSpec const& spec, ServiceRegist
   };
 
   if (spec.dispatchPolicy.action == DispatchPolicy::DispatchOp::WhenReady) {
+    if (spec.nThreads > 1) {
+      LOG(WARNING) << "Dispatching outputs when ready is not supported with multiple threads, sending them after the computation.";
+    }
     mFairMQContext.init(DispatchControl{dispatcher, matcher});
   }
 }
 
+DataProcessingDevice::~DataProcessingDevice()
+{
+  stopWorkers();
+}
+
 /// This  takes care  of initialising  the device  from its  specification. In
 /// particular it needs to:
 ///
@@ -119,6 +219,19 @@ void DataProcessingDevice::Init()
       }
     }
   }
+  auto* config = GetConfig();
+  if (config->Count("input-polling") && config->GetStringValue("input-polling") == "event") {
+    mInputPolling = InputPolling::Event;
+  }
+  if (config->Count("input-poll-timeout")) {
+    mInputPollTimeout = std::stoi(config->GetStringValue("input-poll-timeout"));
+  }
+  size_t relayerMaxSlots = config->Count("relayer-max-slots") ? std::stoul(config->GetStringValue("relayer-max-slots")) : 0;
+  size_t relayerMemoryBudget = config->Count("relayer-memory-budget") ? std::stoul(config->GetStringValue("relayer-memory-budget")) : 0;
+  if (relayerMaxSlots != 0 || relayerMemoryBudget != 0) {
+    auto maxSlots = relayerMaxSlots ? relayerMaxSlots : mRelayer.getParallelTimeslices();
+    mRelayer.setAdaptivePipeline(std::min(MIN_RELAYER_SLOTS, maxSlots), maxSlots, relayerMemoryBudget * 1024 * 1024);
+  }
   auto optionsRetriever(std::make_unique<FairOptionsRetriever>(mSpec.options, GetConfig()));
   mConfigRegistry = std::move(std::make_unique<ConfigParamRegistry>(std::move(optionsRetriever)));
 
@@ -165,12 +278,131 @@ void DataProcessingDevice::Init()
   }
 }
 
-void DataProcessingDevice::PreRun() { mServiceRegistry.get<CallbackService>()(CallbackService::Id::Start); }
+void DataProcessingDevice::PreRun()
+{
+  // The poller is created here, rather than in Init, so that all the
+  // channels are guaranteed to be bound / connected. Notice that the
+  // order of the channels in the poller matches mSpec.inputChannels,
+  // so that we can use the same index for both.
+  if (mInputPolling == InputPolling::Event && mSpec.inputChannels.empty() == false) {
+    std::vector<FairMQChannel*> channels;
+    for (auto& channel : mSpec.inputChannels) {
+      channels.push_back(&fChannels.at(channel.name).at(0));
+    }
+    mInputPoller = NewPoller(channels);
+  }
+  startWorkers();
+  mServiceRegistry.get<CallbackService>()(CallbackService::Id::Start);
+}
+
+void DataProcessingDevice::PostRun()
+{
+  stopWorkers();
+  mServiceRegistry.get<CallbackService>()(CallbackService::Id::Stop);
+  mInputPoller.reset();
+}
+
+void DataProcessingDevice::startWorkers()
+{
+  if (mSpec.nThreads <= 1 || mWorkers.empty() == false) {
+    return;
+  }
+  mStopWorkers = false;
+  auto* config = GetConfig();
+  auto monitoringUrl = config->Count("monitoring-backend") ? config->GetStringValue("monitoring-backend") : std::string{"no-op://"};
+  for (size_t ti = 0; ti < mSpec.nThreads; ++ti) {
+    mWorkers.emplace_back([this, monitoringUrl]() { this->runWorker(monitoringUrl); });
+  }
+}
+
+void DataProcessingDevice::stopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(mTasksMutex);
+    mStopWorkers = true;
+  }
+  mTaskAvailable.notify_all();
+  for (auto& worker : mWorkers) {
+    worker.join();
+  }
+  mWorkers.clear();
+  // Whatever was not sent at this point is simply dropped.
+  mPendingTasks.clear();
+  mCompletedTasks.clear();
+  mNextTaskToSend = mNextTaskSequence;
+}
 
-void DataProcessingDevice::PostRun() { mServiceRegistry.get<CallbackService>()(CallbackService::Id::Stop); }
+void DataProcessingDevice::runWorker(std::string const& monitoringUrl)
+{
+  // Monitoring is not thread safe, so each worker has its own.
+  auto monitoring = MonitoringFactory::Get(monitoringUrl);
+  monitoring->enableBuffering(MONITORING_QUEUE_SIZE);
+  while (true) {
+    std::unique_ptr<ComputingTask> task;
+    {
+      std::unique_lock<std::mutex> lock(mTasksMutex);
+      mTaskAvailable.wait(lock, [this]() { return mStopWorkers || mPendingTasks.empty() == false; });
+      if (mStopWorkers) {
+        return;
+      }
+      task = std::move(mPendingTasks.front());
+      mPendingTasks.pop_front();
+    }
+    task->serviceRegistry.overrideService<Monitoring>(monitoring.get());
+    processTask(*task);
+    monitoring->flushBuffer();
+    {
+      std::lock_guard<std::mutex> lock(mTasksMutex);
+      auto sequence = task->sequence;
+      mCompletedTasks.emplace(sequence, std::move(task));
+    }
+    mTaskCompleted.notify_all();
+  }
+}
+
+void DataProcessingDevice::processTask(ComputingTask& task)
+{
+  // Discarded inputs are only forwarded, see tryDispatchComputation.
+  if (task.action.op == CompletionPolicy::CompletionOp::Discard && mSpec.forwards.empty() == false) {
+    return;
+  }
+  InputRecord record = makeInputRecord(mSpec.inputs, task.inputs);
+  auto tStart = std::chrono::high_resolution_clock::now();
+  try {
+    if (mState.quitRequested == false) {
+      if (mStatefulProcess) {
+        ProcessingContext processContext{record, task.serviceRegistry, task.allocator};
+        mStatefulProcess(processContext);
+        task.processingCount++;
+      }
+      if (mStatelessProcess) {
+        ProcessingContext processContext{record, task.serviceRegistry, task.allocator};
+        mStatelessProcess(processContext);
+        task.processingCount++;
+      }
+    }
+  } catch (...) {
+    task.error = std::current_exception();
+  }
+  auto tEnd = std::chrono::high_resolution_clock::now();
+  task.elapsedTimeMs = std::chrono::duration<double, std::milli>(tEnd - tStart).count();
+}
 
 void DataProcessingDevice::Reset() { mServiceRegistry.get<CallbackService>()(CallbackService::Id::Reset); }
 
+int DataProcessingDevice::inputPollTimeout() const
+{
+  bool hasEnumerations = false;
+  // Completed computations are sent by this thread, so we cannot block
+  // for long while some are still running.
+  bool hasTimers = mNextTaskSequence != mNextTaskToSend;
+  for (auto& handler : mExpirationHandlers) {
+    hasEnumerations |= handler.lifetime == Lifetime::Enumeration;
+    hasTimers |= handler.lifetime == Lifetime::Timer;
+  }
+  return InputPollingHelpers::pollTimeout(mWasActive, mInputPollTimeout, hasEnumerations, hasTimers);
+}
+
 /// We drive the state loop ourself so that we will be able to support
 /// non-data triggers like those which are time based.
 bool DataProcessingDevice::ConditionalRun()
@@ -194,6 +426,10 @@ bool DataProcessingDevice::ConditionalRun()
     monitoring.send(Metric{(int)relayerStats.droppedComputations, "dropped_computations"}.addTag(Key::Subsystem, Value::DPL));
     monitoring.send(Metric{(int)relayerStats.droppedIncomingMessages, "dropped_incoming_messages"}.addTag(Key::Subsystem, Value::DPL));
     monitoring.send(Metric{(int)relayerStats.relayedMessages, "relayed_messages"}.addTag(Key::Subsystem, Value::DPL));
+    monitoring.send(Metric{(int)relayerStats.pipelineLength, "relayer_pipeline_length"}.addTag(Key::Subsystem, Value::DPL));
+    monitoring.send(Metric{(int)relayerStats.occupiedSlots, "relayer_occupied_slots"}.addTag(Key::Subsystem, Value::DPL));
+    monitoring.send(Metric{(int)(relayerStats.cachedBytes / 1024), "relayer_cached_kb"}.addTag(Key::Subsystem, Value::DPL));
+    monitoring.send(Metric{(int)relayerStats.pipelineResizes, "relayer_pipeline_resizes"}.addTag(Key::Subsystem, Value::DPL));
 
     monitoring.send(Metric{(int)stats.pendingInputs, "inputs/relayed/pending"}.addTag(Key::Subsystem, Value::DPL));
     monitoring.send(Metric{(int)stats.incomplete, "inputs/relayed/incomplete"}.addTag(Key::Subsystem, Value::DPL));
@@ -261,6 +497,11 @@ bool DataProcessingDevice::ConditionalRun()
   bool allDone = std::any_of(mState.inputChannelInfos.begin(), mState.inputChannelInfos.end(), [](const auto& info) {
     return info.state != InputChannelState::Pull;
   });
+  // In event driven mode we wait for the first readable channel, so that
+  // we do not spin on the inputs when there is nothing to do.
+  if (mInputPoller) {
+    mInputPoller->Poll(inputPollTimeout());
+  }
   // Whether or not all the channels are completed
   for (size_t ci = 0; ci < mSpec.inputChannels.size(); ++ci) {
     auto& channel = mSpec.inputChannels[ci];
@@ -272,6 +513,9 @@ bool DataProcessingDevice::ConditionalRun()
     if (info.state != InputChannelState::Running) {
       continue;
     }
+    if (mInputPoller && mInputPoller->CheckInput(ci) == false) {
+      continue;
+    }
     FairMQParts parts;
     auto result = this->Receive(parts, channel.name, 0, 0);
     if (result > 0) {
@@ -284,6 +528,7 @@ bool DataProcessingDevice::ConditionalRun()
   }
   active |= mRelayer.processDanglingInputs(mExpirationHandlers, mServiceRegistry);
   this->tryDispatchComputation();
+  mWasActive = active;
 
   sendRelayerMetrics();
   flushMetrics();
@@ -325,20 +570,13 @@ bool DataProcessingDevice::ConditionalRun()
     return true;
   }
   // Update the backoff factor
-  //
-  // In principle we should use 1/rate for MIN_BACKOFF_DELAY and (1/maxRate -
-  // 1/minRate)/ 2^MAX_BACKOFF for BACKOFF_DELAY_STEP. We hardcode the values
-  // for the moment to some sensible default.
-  if (active && mState.streaming != StreamingState::Idle) {
-    mCurrentBackoff = std::max(0, mCurrentBackoff - 1);
-  } else {
-    mCurrentBackoff = std::min(MAX_BACKOFF, mCurrentBackoff + 1);
-  }
+  mCurrentBackoff = InputPollingHelpers::nextBackoff(mCurrentBackoff, active && mState.streaming != StreamingState::Idle);
 
-  if (mCurrentBackoff != 0) {
-    auto delay = (rand() % ((1 << mCurrentBackoff) - 1)) * BACKOFF_DELAY_STEP;
-    if (delay > MIN_BACKOFF_DELAY) {
-      WaitFor(std::chrono::microseconds(delay - MIN_BACKOFF_DELAY));
+  // In event driven mode the poller already did the waiting for us.
+  if (mInputPoller == nullptr) {
+    auto delay = InputPollingHelpers::backoffDelay(mCurrentBackoff);
+    if (delay) {
+      WaitFor(std::chrono::microseconds(delay));
     }
   }
   return true;
@@ -530,19 +768,7 @@ bool DataProcessingDevice::tryDispatchComputation()
   // the execution.
   auto fillInputs = [&relayer, &inputsSchema, &currentSetOfInputs](TimesliceSlot slot) -> InputRecord {
     currentSetOfInputs = std::move(relayer.getInputsForTimeslice(slot));
-    auto getter = [&currentSetOfInputs](size_t i, size_t partindex) -> DataRef {
-      if (currentSetOfInputs[i].size() > partindex) {
-        return DataRef{nullptr,
-                       static_cast<char const*>(currentSetOfInputs[i].at(partindex).header->GetData()),
-                       static_cast<char const*>(currentSetOfInputs[i].at(partindex).payload->GetData())};
-      }
-      return DataRef{nullptr, nullptr, nullptr};
-    };
-    auto nofPartsGetter = [&currentSetOfInputs](size_t i) -> size_t {
-      return currentSetOfInputs[i].size();
-    };
-    InputSpan span{getter, nofPartsGetter, currentSetOfInputs.size()};
-    return InputRecord{inputsSchema, std::move(span)};
+    return makeInputRecord(inputsSchema, currentSetOfInputs);
   };
 
   // This is the thing which does the actual computation. No particular reason
@@ -693,6 +919,28 @@ bool DataProcessingDevice::tryDispatchComputation()
     }
   };
 
+  // Show in the GUI the state of the inputs of the given slot.
+  auto updateRelayerState = [&stats = mStats](TimesliceSlot slot, InputRecord& record, int validState) {
+    for (size_t ai = 0; ai != record.size(); ai++) {
+      auto cacheId = slot.index * record.size() + ai;
+      auto state = record.isValid(ai) ? validState : 0;
+      stats.relayerState.resize(std::max(cacheId + 1, stats.relayerState.size()), 0);
+      stats.relayerState[cacheId] = state;
+    }
+  };
+
+  // We forward inputs only when we consume them. If we simply Process them,
+  // we keep them for next message arriving.
+  auto postProcessing = [&forwards, &forwardInputs, &cleanTimers](DataRelayer::RecordAction const& action, InputRecord& record) {
+    if (action.op == CompletionPolicy::CompletionOp::Consume) {
+      if (forwards.empty() == false) {
+        forwardInputs(action.slot, record);
+      }
+    } else if (action.op == CompletionPolicy::CompletionOp::Process) {
+      cleanTimers(action.slot, record);
+    }
+  };
+
   auto calculateInputRecordLatency = [](InputRecord const& record, auto now) -> DataProcessingStats::InputLatency {
     DataProcessingStats::InputLatency result{static_cast<int>(-1), 0};
 
@@ -727,14 +975,105 @@ bool DataProcessingDevice::tryDispatchComputation()
     control.notifyStreamingState(state);
   };
 
+  // When running with multiple threads, the processing happens in the
+  // workers, however we still need to send their outputs from this thread
+  // and in the same order the computations were dispatched, doing what the
+  // single threaded code below does after the processing. During the end
+  // of stream we wait for all the computations to be completed.
+  auto flushCompletedTasks = [this, &currentSetOfInputs, &errorHandling, &forwardInputs, &forwards, &inputsSchema, &processingCount,
+                              &updateRelayerState, &postProcessing, &calculateTotalInputRecordSize, &calculateInputRecordLatency](bool wait) -> bool {
+    bool didWork = false;
+    while (mNextTaskToSend != mNextTaskSequence) {
+      std::unique_ptr<ComputingTask> task;
+      {
+        std::unique_lock<std::mutex> lock(mTasksMutex);
+        if (wait) {
+          StateMonitoring<DataProcessingStatus>::moveTo(DataProcessingStatus::IN_DPL_USER_CALLBACK);
+          mTaskCompleted.wait(lock, [this]() { return mCompletedTasks.count(mNextTaskToSend) != 0; });
+          StateMonitoring<DataProcessingStatus>::moveTo(DataProcessingStatus::IN_DPL_OVERHEAD);
+        }
+        auto ti = mCompletedTasks.find(mNextTaskToSend);
+        if (ti == mCompletedTasks.end()) {
+          break;
+        }
+        task = std::move(ti->second);
+        mCompletedTasks.erase(ti);
+      }
+      mNextTaskToSend++;
+      didWork = true;
+      currentSetOfInputs = std::move(task->inputs);
+      InputRecord record = makeInputRecord(inputsSchema, currentSetOfInputs);
+      auto& action = task->action;
+      if (action.op == CompletionPolicy::CompletionOp::Discard && forwards.empty() == false) {
+        forwardInputs(action.slot, record);
+        continue;
+      }
+      if (task->error) {
+        try {
+          std::rethrow_exception(task->error);
+        } catch (std::exception& e) {
+          errorHandling(e, record);
+        }
+      }
+      task->control.replay(mServiceRegistry.get<ControlService>());
+      processingCount += task->processingCount;
+      DataProcessor::doSend(*this, task->fairMQContext);
+      DataProcessor::doSend(*this, task->stringContext);
+      DataProcessor::doSend(*this, task->dataFrameContext);
+      DataProcessor::doSend(*this, task->rawBufferContext);
+      updateRelayerState(action.slot, record, 3);
+      mStats.lastElapsedTimeMs = task->elapsedTimeMs;
+      mStats.lastTotalProcessedSize = calculateTotalInputRecordSize(record);
+      mStats.lastLatency = calculateInputRecordLatency(record, std::chrono::high_resolution_clock::now());
+      postProcessing(action, record);
+    }
+    return didWork;
+  };
+
+  // Hand over the inputs for the given action to the workers. Discarded
+  // inputs which need to be forwarded also go through the workers, so that
+  // they are forwarded in order with the consumed ones.
+  auto dispatchTask = [this, &relayer, &timesliceIndex, &inputsSchema, &forwards, &updateRelayerState](DataRelayer::RecordAction const& action) {
+    auto task = std::make_unique<ComputingTask>(this, mSpec.outputs, mServiceRegistry);
+    task->sequence = mNextTaskSequence++;
+    task->action = action;
+    task->timingInfo.timeslice = timesliceIndex.getTimesliceForSlot(action.slot).value;
+    task->inputs = relayer.getInputsForTimeslice(action.slot);
+    if (action.op != CompletionPolicy::CompletionOp::Discard || forwards.empty()) {
+      InputRecord record = makeInputRecord(inputsSchema, task->inputs);
+      updateRelayerState(action.slot, record, 2);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mTasksMutex);
+      mPendingTasks.emplace_back(std::move(task));
+    }
+    mTaskAvailable.notify_one();
+  };
+
+  bool multithreaded = mWorkers.empty() == false;
+  bool flushed = false;
+  if (multithreaded) {
+    flushed = flushCompletedTasks(mState.streaming == StreamingState::EndOfStreaming);
+    // We do not take more computations out of the relayer if all the
+    // workers are already busy. They will stay there until the next
+    // iteration.
+    if (mNextTaskSequence - mNextTaskToSend >= mSpec.nThreads) {
+      return flushed;
+    }
+  }
+
   if (canDispatchSomeComputation() == false) {
-    return false;
+    return flushed;
   }
 
   for (auto action : getReadyActions()) {
     if (action.op == CompletionPolicy::CompletionOp::Wait) {
       continue;
     }
+    if (multithreaded) {
+      dispatchTask(action);
+      continue;
+    }
 
     prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot});
     InputRecord record = fillInputs(action.slot);
@@ -745,12 +1084,7 @@ bool DataProcessingDevice::tryDispatchComputation()
       }
     }
     auto tStart = std::chrono::high_resolution_clock::now();
-    for (size_t ai = 0; ai != record.size(); ai++) {
-      auto cacheId = action.slot.index * record.size() + ai;
-      auto state = record.isValid(ai) ? 2 : 0;
-      mStats.relayerState.resize(std::max(cacheId + 1, mStats.relayerState.size()), 0);
-      mStats.relayerState[cacheId] = state;
-    }
+    updateRelayerState(action.slot, record, 2);
     try {
       if (mState.quitRequested == false) {
         dispatchProcessing(action.slot, record);
@@ -758,28 +1092,16 @@ bool DataProcessingDevice::tryDispatchComputation()
     } catch (std::exception& e) {
       errorHandling(e, record);
     }
-    for (size_t ai = 0; ai != record.size(); ai++) {
-      auto cacheId = action.slot.index * record.size() + ai;
-      auto state = record.isValid(ai) ? 3 : 0;
-      mStats.relayerState.resize(std::max(cacheId + 1, mStats.relayerState.size()), 0);
-      mStats.relayerState[cacheId] = state;
-    }
+    updateRelayerState(action.slot, record, 3);
     auto tEnd = std::chrono::high_resolution_clock::now();
     mStats.lastElapsedTimeMs = std::chrono::duration<double, std::milli>(tEnd - tStart).count();
     mStats.lastTotalProcessedSize = calculateTotalInputRecordSize(record);
     mStats.lastLatency = calculateInputRecordLatency(record, tStart);
-    // We forward inputs only when we consume them. If we simply Process them,
-    // we keep them for next message arriving.
-    if (action.op == CompletionPolicy::CompletionOp::Consume) {
-      if (forwards.empty() == false) {
-        forwardInputs(action.slot, record);
-      }
-    } else if (action.op == CompletionPolicy::CompletionOp::Process) {
-      cleanTimers(action.slot, record);
-    }
+    postProcessing(action, record);
   }
-  // We now broadcast the end of stream if it was requested
-  if (mState.streaming == StreamingState::EndOfStreaming) {
+  // We now broadcast the end of stream if it was requested, making sure
+  // there are no computations still running in the workers.
+  if (mState.streaming == StreamingState::EndOfStreaming && mNextTaskSequence == mNextTaskToSend) {
     for (auto& channel : mSpec.outputChannels) {
       DataProcessingHelpers::sendEndOfStream(*this, channel);
     }
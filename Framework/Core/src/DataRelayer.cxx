@@ -38,8 +38,26 @@ namespace o2::framework
 constexpr int INVALID_INPUT = -1;
 
 // 16 is just some reasonable numer
-// The number should really be tuned at runtime for each processor.
+// The number can be tuned at runtime for each processor, using
+// setAdaptivePipeline().
 constexpr int DEFAULT_PIPELINE_LENGTH = 16;
+// How many relayed messages we look at before deciding if the
+// adaptive pipeline has too many slots.
+constexpr size_t ADAPTIVE_PIPELINE_WINDOW = 256;
+
+namespace
+{
+/// @return the size in bytes of all the messages in @a set
+size_t messageSetSize(MessageSet const& set)
+{
+  size_t result = 0;
+  for (auto& part : set) {
+    result += part.header ? part.header->GetSize() : 0;
+    result += part.payload ? part.payload->GetSize() : 0;
+  }
+  return result;
+}
+} // namespace
 
 // FIXME: do we really need to pass the forwards?
 DataRelayer::DataRelayer(const CompletionPolicy& policy,
@@ -50,7 +68,8 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
     mMetrics{metrics},
     mCompletionPolicy{policy},
     mDistinctRoutesIndex{DataRelayerHelpers::createDistinctRouteIndex(routes)},
-    mInputMatchers{DataRelayerHelpers::createInputMatchers(routes)}
+    mInputMatchers{DataRelayerHelpers::createInputMatchers(routes)},
+    mInputMatcherIndex{std::make_unique<InputMatcherIndex>(DataRelayerHelpers::createInputMatcherIndex(routes))}
 {
   setPipelineLength(DEFAULT_PIPELINE_LENGTH);
 
@@ -69,6 +88,8 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
   }
 }
 
+DataRelayer::~DataRelayer() = default;
+
 bool DataRelayer::processDanglingInputs(std::vector<ExpirationHandler> const& expirationHandlers,
                                         ServiceRegistry& services)
 {
@@ -121,6 +142,7 @@ bool DataRelayer::processDanglingInputs(std::vector<ExpirationHandler> const& ex
         part.parts.resize(1);
       }
       expirator.handler(services, part[0], timestamp.value);
+      mStats.cachedBytes += messageSetSize(part);
       didWork = true;
       mTimesliceIndex.markAsDirty(slot, true);
       assert(part[0].header != nullptr);
@@ -133,18 +155,50 @@ bool DataRelayer::processDanglingInputs(std::vector<ExpirationHandler> const& ex
 /// This does the mapping between a route and a InputSpec. The
 /// reason why these might diffent is that when you have timepipelining
 /// you have one route per timeslice, even if the type is the same.
+///
+/// Rather than trying all the matchers, we look up the (only) fully
+/// specified route which could match in @a matcherIndex and evaluate it
+/// together with the routes using generic matchers, in route order, so that
+/// the first matching route is still the one which gets picked.
 size_t matchToContext(void* data,
                       std::vector<DataDescriptorMatcher> const& matchers,
+                      InputMatcherIndex const& matcherIndex,
                       VariableContext& context)
 {
-  for (size_t ri = 0, re = matchers.size(); ri < re; ++ri) {
-    auto& matcher = matchers[ri];
-
-    if (matcher.match(reinterpret_cast<char const*>(data), context)) {
+  auto tryMatch = [data, &matchers, &context](size_t ri) -> bool {
+    if (matchers[ri].match(reinterpret_cast<char const*>(data), context)) {
       context.commit();
-      return ri;
+      return true;
     }
     context.discard();
+    return false;
+  };
+
+  auto dh = o2::header::get<DataHeader*>(data);
+  if (dh == nullptr) {
+    for (size_t ri = 0, re = matchers.size(); ri < re; ++ri) {
+      if (tryMatch(ri)) {
+        return ri;
+      }
+    }
+    return INVALID_INPUT;
+  }
+
+  auto candidate = matcherIndex.exact.find(InputMatcherIndex::Key{dh->dataOrigin, dh->dataDescription, dh->subSpecification});
+  bool hasCandidate = candidate != matcherIndex.exact.end();
+  for (auto ri : matcherIndex.generic) {
+    if (hasCandidate && candidate->second < ri) {
+      if (tryMatch(candidate->second)) {
+        return candidate->second;
+      }
+      hasCandidate = false;
+    }
+    if (tryMatch(ri)) {
+      return ri;
+    }
+  }
+  if (hasCandidate && tryMatch(candidate->second)) {
+    return candidate->second;
   }
   return INVALID_INPUT;
 }
@@ -189,12 +243,13 @@ DataRelayer::RelayChoice
   // function because while it's trivial now, the actual matchmaking will
   // become more complicated when we will start supporting ranges.
   auto getInputTimeslice = [& matchers = mInputMatchers,
+                            &matcherIndex = *mInputMatcherIndex,
                             &header,
                             &index](VariableContext& context)
     -> std::tuple<int, TimesliceId> {
     /// FIXME: for the moment we only use the first context and reset
     /// between one invokation and the other.
-    auto input = matchToContext(header->GetData(), matchers, context);
+    auto input = matchToContext(header->GetData(), matchers, matcherIndex, context);
 
     if (input == INVALID_INPUT) {
       return {
@@ -220,6 +275,7 @@ DataRelayer::RelayChoice
   // hence the first if.
   auto pruneCache = [&cache,
                      &cachedStateMetrics = mCachedStateMetrics,
+                     &cachedBytes = mStats.cachedBytes,
                      &numInputTypes,
                      &index,
                      &metrics](TimesliceSlot slot) {
@@ -230,6 +286,7 @@ DataRelayer::RelayChoice
     // will be ignored.
     assert(numInputTypes * slot.index < cache.size());
     for (size_t ai = slot.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
+      cachedBytes -= messageSetSize(cache[ai]);
       cache[ai].clear();
       cachedStateMetrics[ai] = 0;
     }
@@ -238,6 +295,7 @@ DataRelayer::RelayChoice
   // Actually save the header / payload in the slot
   auto saveInSlot = [&header,
                      &cachedStateMetrics = mCachedStateMetrics,
+                     &cachedBytes = mStats.cachedBytes,
                      &payload,
                      &cache,
                      &numInputTypes,
@@ -245,6 +303,7 @@ DataRelayer::RelayChoice
     auto cacheIdx = numInputTypes * slot.index + input;
     std::vector<PartRef>& parts = cache[cacheIdx].parts;
     cachedStateMetrics[cacheIdx] = 1;
+    cachedBytes += header->GetSize() + payload->GetSize();
     // TODO: make sure that multiple parts can only be added within the same call of
     // DataRelayer::relay
     PartRef entry{std::move(header), std::move(payload)};
@@ -308,6 +367,16 @@ DataRelayer::RelayChoice
     }
   }
 
+  // Keep track of how many slots are actually in use, so that we know
+  // if the pipeline can be shrunk.
+  size_t occupiedSlots = 0;
+  for (size_t ci = 0; ci < index.size(); ++ci) {
+    occupiedSlots += index.isValid(TimesliceSlot{ci}) ? 1 : 0;
+  }
+  mStats.occupiedSlots = occupiedSlots;
+  mMaxOccupiedSlots = std::max(mMaxOccupiedSlots, occupiedSlots + 1);
+  mRelaysSinceResize++;
+
   /// If we get a valid result, we can store the message in cache.
   if (input != INVALID_INPUT && TimesliceId::isValid(timeslice) && TimesliceSlot::isValid(slot)) {
     O2_SIGNPOST(O2_PROBE_DATARELAYER, timeslice.value, 0, 0, 0);
@@ -348,6 +417,13 @@ DataRelayer::RelayChoice
     return WillNotRelay;
   }
 
+  // If all the slots are taken, the skew between the oldest timeslice in
+  // flight and the incoming one is larger than what the pipeline can hold,
+  // so we try to make room for it rather than evicting the oldest one.
+  if (occupiedSlots == index.size()) {
+    maybeGrowPipeline();
+  }
+
   TimesliceIndex::ActionTaken action;
   std::tie(action, slot) = index.replaceLRUWith(pristineContext);
 
@@ -477,9 +553,11 @@ std::vector<o2::framework::MessageSet> DataRelayer::getInputsForTimeslice(Timesl
   // cache where to put them.
   auto moveHeaderPayloadToOutput = [&messages,
                                     &cachedStateMetrics = mCachedStateMetrics,
+                                    &cachedBytes = mStats.cachedBytes,
                                     &cache, &index, &numInputTypes, &metrics](TimesliceSlot s, size_t arg) {
     auto cacheId = s.index * numInputTypes + arg;
     cachedStateMetrics[cacheId] = 2;
+    cachedBytes -= messageSetSize(cache[cacheId]);
     // TODO: in the original implementation of the cache, there have been only two messages per entry,
     // check if the 2 above corresponds to the number of messages.
     if (cache[cacheId].size() > 0) {
@@ -506,6 +584,7 @@ std::vector<o2::framework::MessageSet> DataRelayer::getInputsForTimeslice(Timesl
     moveHeaderPayloadToOutput(slot, ai);
   }
   invalidateCacheFor(slot);
+  maybeShrinkPipeline();
 
   return std::move(messages);
 }
@@ -515,6 +594,7 @@ void DataRelayer::clear()
   for (auto& cache : mCache) {
     cache.clear();
   }
+  mStats.cachedBytes = 0;
   for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
     mTimesliceIndex.markAsInvalid(TimesliceSlot{s});
   }
@@ -534,9 +614,81 @@ void DataRelayer::setPipelineLength(size_t s)
 {
   mTimesliceIndex.resize(s);
   mVariableContextes.resize(s);
+  mStats.pipelineLength = s;
   publishMetrics();
 }
 
+void DataRelayer::setAdaptivePipeline(size_t minLength, size_t maxLength, size_t memoryBudget)
+{
+  assert(minLength > 0 && minLength <= maxLength);
+  mMinPipelineLength = minLength;
+  mMaxPipelineLength = maxLength;
+  mMemoryBudget = memoryBudget;
+  mRelaysSinceResize = 0;
+  mMaxOccupiedSlots = 0;
+  auto current = mTimesliceIndex.size();
+  if (current < minLength) {
+    setPipelineLength(minLength);
+  } else if (current > maxLength) {
+    maybeShrinkPipeline();
+  }
+}
+
+bool DataRelayer::maybeGrowPipeline()
+{
+  auto current = mTimesliceIndex.size();
+  if (mMaxPipelineLength == 0 || current >= mMaxPipelineLength) {
+    return false;
+  }
+  if (mMemoryBudget != 0 && mStats.cachedBytes >= mMemoryBudget) {
+    return false;
+  }
+  // Double the pipeline, so that we converge quickly to the required length.
+  auto newLength = std::min(mMaxPipelineLength, std::max<size_t>(current * 2, 1));
+  LOG(DEBUG) << "Growing the relayer pipeline from " << current << " to " << newLength << " slots";
+  setPipelineLength(newLength);
+  mStats.pipelineResizes++;
+  mRelaysSinceResize = 0;
+  mMaxOccupiedSlots = 0;
+  return true;
+}
+
+void DataRelayer::maybeShrinkPipeline()
+{
+  auto current = mTimesliceIndex.size();
+  if (mMaxPipelineLength == 0 || current <= mMinPipelineLength) {
+    return;
+  }
+  size_t target = current;
+  bool overBudget = mMemoryBudget != 0 && mStats.cachedBytes > mMemoryBudget;
+  if (overBudget) {
+    target = current / 2;
+  } else if (current > mMaxPipelineLength) {
+    target = mMaxPipelineLength;
+  } else if (mRelaysSinceResize >= ADAPTIVE_PIPELINE_WINDOW && mMaxOccupiedSlots * 4 <= current) {
+    // Less than a quarter of the slots were used in the last window,
+    // we keep twice as many as actually needed.
+    target = mMaxOccupiedSlots * 2;
+  } else {
+    return;
+  }
+  target = std::max(target, mMinPipelineLength);
+  // We can only drop the slots at the end which are not in use, since the
+  // others are referred to by index.
+  auto newLength = current;
+  while (newLength > target && mTimesliceIndex.isValid(TimesliceSlot{newLength - 1}) == false) {
+    newLength--;
+  }
+  if (newLength == current) {
+    return;
+  }
+  LOG(DEBUG) << "Shrinking the relayer pipeline from " << current << " to " << newLength << " slots";
+  setPipelineLength(newLength);
+  mStats.pipelineResizes++;
+  mRelaysSinceResize = 0;
+  mMaxOccupiedSlots = 0;
+}
+
 void DataRelayer::publishMetrics()
 {
   auto numInputTypes = mDistinctRoutesIndex.size();
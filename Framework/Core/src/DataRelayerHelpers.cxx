@@ -68,4 +68,20 @@ std::vector<DataDescriptorMatcher>
   return result;
 }
 
+InputMatcherIndex
+  DataRelayerHelpers::createInputMatcherIndex(std::vector<InputRoute> const& routes)
+{
+  InputMatcherIndex result;
+
+  for (size_t ri = 0; ri < routes.size(); ++ri) {
+    if (auto pval = std::get_if<ConcreteDataMatcher>(&routes[ri].matcher.matcher)) {
+      result.exact.emplace(InputMatcherIndex::Key{pval->origin, pval->description, pval->subSpec}, ri);
+    } else {
+      result.generic.push_back(ri);
+    }
+  }
+
+  return result;
+}
+
 } // namespace o2::framework
@@ -11,17 +11,57 @@
 #define O2_FRAMEWORK_DATARELAYERHELPERS_H_
 
 #include "Framework/InputRoute.h"
+#include "Headers/DataHeader.h"
+#include <functional>
+#include <unordered_map>
 #include <vector>
 
 namespace o2::framework
 {
 
+/// Lookup table to find which input route a message belongs to, without
+/// having to evaluate all the matchers. Routes which are fully specified
+/// (i.e. ConcreteDataMatcher) are indexed by (origin, description, subSpec),
+/// all the others (wildcards, variables) are kept in @a generic, in route
+/// order, and need to be evaluated one by one.
+struct InputMatcherIndex {
+  struct Key {
+    header::DataOrigin origin;
+    header::DataDescription description;
+    header::DataHeader::SubSpecificationType subSpec;
+
+    bool operator==(Key const& other) const
+    {
+      return origin == other.origin && description == other.description && subSpec == other.subSpec;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(Key const& key) const
+    {
+      size_t h = std::hash<uint64_t>{}(key.description.itg[0]);
+      h ^= std::hash<uint64_t>{}(key.description.itg[1]) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+      h ^= std::hash<uint64_t>{}((uint64_t(key.origin.itg[0]) << 32) | key.subSpec) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+      return h;
+    }
+  };
+
+  /// The first route with a given concrete matcher. Later ones (e.g. the
+  /// other timeslices of a time pipeline) would never be matched anyway.
+  std::unordered_map<Key, size_t, KeyHash> exact;
+  /// Indices of the routes which cannot be matched by key, sorted.
+  std::vector<size_t> generic;
+};
+
 struct DataRelayerHelpers {
   /// Calculate how many input routes there are, doublecounting different
   /// timeslices.
   static std::vector<size_t> createDistinctRouteIndex(std::vector<InputRoute> const&);
   /// This converts from InputRoute to the associated DataDescriptorMatcher.
   static std::vector<data_matcher::DataDescriptorMatcher> createInputMatchers(std::vector<InputRoute> const&);
+  /// Create the lookup table to be used to dispatch messages to the matchers
+  /// created by createInputMatchers.
+  static InputMatcherIndex createInputMatcherIndex(std::vector<InputRoute> const&);
 };
 
 } // namespace o2::framework
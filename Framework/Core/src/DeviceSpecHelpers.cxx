@@ -253,6 +253,7 @@ void DeviceSpecHelpers::processOutEdgeActions(std::vector<DeviceSpec>& devices,
     device.nSlots = processor.nSlots;
     device.inputTimesliceId = edge.producerTimeIndex;
     device.maxInputTimeslices = processor.maxInputTimeslices;
+    device.nThreads = processor.nThreads;
     device.resource = {acceptedOffer};
     devices.push_back(device);
     return devices.size() - 1;
@@ -457,6 +458,7 @@ void DeviceSpecHelpers::processInEdgeActions(std::vector<DeviceSpec>& devices,
     device.nSlots = processor.nSlots;
     device.inputTimesliceId = edge.timeIndex;
     device.maxInputTimeslices = processor.maxInputTimeslices;
+    device.nThreads = processor.nThreads;
     device.resource = {acceptedOffer};
 
     // FIXME: maybe I should use an std::map in the end
@@ -850,6 +852,10 @@ void DeviceSpecHelpers::prepareArguments(bool defaultQuiet, bool defaultStopped,
         realOdesc.add_options()("child-driver", bpo::value<std::string>());
         realOdesc.add_options()("rate", bpo::value<std::string>());
         realOdesc.add_options()("shm-segment-size", bpo::value<std::string>());
+        realOdesc.add_options()("input-polling", bpo::value<std::string>());
+        realOdesc.add_options()("input-poll-timeout", bpo::value<std::string>());
+        realOdesc.add_options()("relayer-max-slots", bpo::value<std::string>());
+        realOdesc.add_options()("relayer-memory-budget", bpo::value<std::string>());
         realOdesc.add_options()("session", bpo::value<std::string>());
         filterArgsFct(expansions.we_wordc, expansions.we_wordv, realOdesc);
         wordfree(&expansions);
@@ -950,6 +956,10 @@ boost::program_options::options_description DeviceSpecHelpers::getForwardedDevic
     ("control-port", bpo::value<std::string>(), "Utility port to be used by O2 Control")                        //
     ("rate", bpo::value<std::string>(), "rate for a data source device (Hz)")                                   //
     ("shm-segment-size", bpo::value<std::string>(), "size of the shared memory segment in bytes")               //
+    ("input-polling", bpo::value<std::string>(), "how to wait for inputs: busy (default) or event")             //
+    ("input-poll-timeout", bpo::value<std::string>(), "max time (ms) to block on inputs in event mode")         //
+    ("relayer-max-slots", bpo::value<std::string>(), "max number of in flight timeslices (0: fixed)")           //
+    ("relayer-memory-budget", bpo::value<std::string>(), "max MB of in flight timeslices (0: no limit)")        //
     ("session", bpo::value<std::string>(), "unique label for the shared memory session")                        //
     ("monitoring-backend", bpo::value<std::string>(), "monitoring connection string")                           //
     ("infologger-mode", bpo::value<std::string>(), "INFOLOGGER_MODE override")                                  //
@@ -19,6 +19,7 @@
 #include <unordered_map>
 #include <set>
 #include <algorithm>
+#include <mutex>
 
 using namespace o2::framework;
 
@@ -230,30 +231,62 @@ gandiva::ConditionPtr createCondition(gandiva::NodePtr node)
   return gandiva::TreeExprBuilder::MakeCondition(node);
 }
 
+namespace
+{
+/// The compiled filters, keyed on the textual representation of the schema
+/// and of the condition. The number of different filters in a device is
+/// small, so we never evict anything.
+struct FilterCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<gandiva::Filter>> filters;
+  FilterCacheStats stats;
+};
+
+FilterCache& filterCache()
+{
+  static FilterCache cache;
+  return cache;
+}
+} // namespace
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 createCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (s.ok())
-    return filter;
-  throw std::runtime_error(fmt::format("Failed to create filter: {}", s));
+  return createFilter(Schema, createCondition(createExpressionTree(opSpecs, Schema)));
 }
 
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
+  auto key = Schema->ToString() + "\n" + condition->ToString();
+  auto& cache = filterCache();
+  // We keep the lock while compiling, so that slices processed in parallel
+  // do not compile the same filter more than once.
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto cached = cache.filters.find(key);
+  if (cached != cache.filters.end()) {
+    cache.stats.hits++;
+    return cached->second;
+  }
+  cache.stats.misses++;
   std::shared_ptr<gandiva::Filter> filter;
   auto s = gandiva::Filter::Make(Schema,
                                  condition,
                                  &filter);
-  if (s.ok())
+  if (s.ok()) {
+    cache.filters.emplace(std::move(key), filter);
     return filter;
+  }
   throw std::runtime_error(fmt::format("Failed to create filter: {}", s));
 }
 
+FilterCacheStats getFilterCacheStats()
+{
+  auto& cache = filterCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.stats;
+}
+
 Selection createSelection(std::shared_ptr<arrow::Table> table, std::shared_ptr<gandiva::Filter> gfilter)
 {
   Selection selection;
@@ -66,8 +66,10 @@ arrow::Status FairMQResizableBuffer::Reserve(const int64_t capacity)
   }
   auto newMessage = mCreator(capacity);
   assert(!mMessage || capacity > mMessage->GetSize());
-  if (mMessage) {
-    memcpy(newMessage->GetData(), mMessage->GetData(), mMessage->GetSize());
+  // Only what was actually written needs to survive, not the whole
+  // backing message.
+  if (mMessage && this->size_ > 0) {
+    memcpy(newMessage->GetData(), mMessage->GetData(), this->size_);
   }
   mMessage = std::move(newMessage);
   assert(mMessage);
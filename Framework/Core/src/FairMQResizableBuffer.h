@@ -44,6 +44,7 @@ class FairMQResizableBuffer : public ::arrow::ResizableBuffer
   /// Reserve behaves as std::vector<T>::reserve()
   ///
   /// * If new capacity is greater than old capacity, reallocation happens
+  ///   and the first size() bytes are copied to the new message.
   /// * If new capacity is smaller than the old one, nothing happens.
   arrow::Status Reserve(const int64_t capacity) override;
 
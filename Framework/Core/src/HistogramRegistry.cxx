@@ -0,0 +1,228 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/HistogramRegistry.h"
+
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+namespace o2::framework
+{
+
+namespace
+{
+template <typename T>
+std::unique_ptr<TH1> createTH1(HistogramSpec const& spec)
+{
+  auto const& axes = spec.config.axes;
+  switch (axes.size()) {
+    case 1:
+      if constexpr (std::is_same_v<T, float>) {
+        return std::make_unique<TH1F>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max);
+      } else if constexpr (std::is_same_v<T, double>) {
+        return std::make_unique<TH1D>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max);
+      } else {
+        return std::make_unique<TH1I>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max);
+      }
+    case 2:
+      if constexpr (std::is_same_v<T, float>) {
+        return std::make_unique<TH2F>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max, axes[1].nBins, axes[1].min, axes[1].max);
+      } else if constexpr (std::is_same_v<T, double>) {
+        return std::make_unique<TH2D>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max, axes[1].nBins, axes[1].min, axes[1].max);
+      } else {
+        return std::make_unique<TH2I>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max, axes[1].nBins, axes[1].min, axes[1].max);
+      }
+    case 3:
+      if constexpr (std::is_same_v<T, float>) {
+        return std::make_unique<TH3F>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max, axes[1].nBins, axes[1].min, axes[1].max, axes[2].nBins, axes[2].min, axes[2].max);
+      } else if constexpr (std::is_same_v<T, double>) {
+        return std::make_unique<TH3D>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max, axes[1].nBins, axes[1].min, axes[1].max, axes[2].nBins, axes[2].min, axes[2].max);
+      } else {
+        return std::make_unique<TH3I>(spec.name.data(), spec.readableName.data(), axes[0].nBins, axes[0].min, axes[0].max, axes[1].nBins, axes[1].min, axes[1].max, axes[2].nBins, axes[2].min, axes[2].max);
+      }
+  }
+  throw std::runtime_error("Histogram " + spec.name + " of kind " + spec.config.kind + " has the wrong number of axes");
+}
+
+template <typename T>
+std::unique_ptr<THnBase> createTHn(HistogramSpec const& spec)
+{
+  auto const& axes = spec.config.axes;
+  std::vector<Int_t> nBins;
+  std::vector<Double_t> min;
+  std::vector<Double_t> max;
+  for (auto& axis : axes) {
+    nBins.push_back(axis.nBins);
+    min.push_back(axis.min);
+    max.push_back(axis.max);
+  }
+  return std::make_unique<THnT<T>>(spec.name.data(), spec.readableName.data(), axes.size(), nBins.data(), min.data(), max.data());
+}
+
+/// Bin type (F, D or I) of the histogram. Throws for the kinds which are not supported,
+/// e.g. THnSparse, and if the number of axes does not match the kind.
+char getBinType(HistogramSpec const& spec)
+{
+  auto kind = spec.config.kind.empty() ? std::string("TH1F") : spec.config.kind;
+  char dimension = kind.size() == 4 ? kind[2] : 0, type = kind.back();
+  if (kind.compare(0, 2, "TH") != 0 || (dimension != 'n' && (dimension < '1' || dimension > '3')) || (type != 'F' && type != 'D' && type != 'I')) {
+    throw std::runtime_error("Histogram " + spec.name + " is of the unsupported kind " + kind);
+  }
+  auto nAxes = spec.config.axes.size();
+  if (dimension == 'n' ? nAxes == 0 : nAxes != size_t(dimension - '0')) {
+    throw std::runtime_error("Histogram " + spec.name + " of kind " + kind + " has " + std::to_string(nAxes) + " axes");
+  }
+  return type;
+}
+
+uint64_t nextRegistrySerial()
+{
+  static std::atomic<uint64_t> serial{0};
+  return ++serial;
+}
+} // namespace
+
+HistogramRegistry::ShardStore::ShardStore()
+  : serial{nextRegistrySerial()}
+{
+}
+
+void HistogramRegistry::insert(HistogramSpec& spec)
+{
+  uint32_t i = imask(spec.id);
+  for (auto j = 0u; j < MAX_REGISTRY_SIZE; ++j) {
+    auto slot = imask(j + i);
+    if (mRegistryValue[slot].get() == nullptr && mRegistryValueN[slot].get() == nullptr) {
+      auto type = getBinType(spec);
+      if (spec.config.kind == "THn" + std::string(1, type)) {
+        if (type == 'D') {
+          mRegistryValueN[slot] = createTHn<double>(spec);
+        } else if (type == 'I') {
+          mRegistryValueN[slot] = createTHn<int>(spec);
+        } else {
+          mRegistryValueN[slot] = createTHn<float>(spec);
+        }
+      } else {
+        if (type == 'D') {
+          mRegistryValue[slot] = createTH1<double>(spec);
+        } else if (type == 'I') {
+          mRegistryValue[slot] = createTH1<int>(spec);
+        } else {
+          mRegistryValue[slot] = createTH1<float>(spec);
+        }
+      }
+      mRegistryKey[slot] = spec.id;
+
+      // Flat layout used by fill<Key>(), with the first axis varying fastest
+      // as in ROOT.
+      uint32_t stride = 1;
+      for (auto& axis : spec.config.axes) {
+        mAxes[slot].push_back(FlatAxis{axis.nBins, axis.min, axis.max, axis.nBins / (axis.max - axis.min), stride});
+        stride *= axis.nBins + 2;
+      }
+      mCells[slot] = stride;
+      lookup += j;
+      return;
+    }
+  }
+  throw std::runtime_error("Internal array is full.");
+}
+
+HistogramShard& HistogramRegistry::createShard()
+{
+  std::lock_guard<std::mutex> lock(mShards->mutex);
+  auto thread = std::this_thread::get_id();
+  for (auto& [id, shard] : mShards->shards) {
+    if (id == thread) {
+      return *shard;
+    }
+  }
+  mShards->shards.emplace_back(thread, std::make_unique<HistogramShard>());
+  return *mShards->shards.back().second;
+}
+
+void HistogramRegistry::merge()
+{
+  std::lock_guard<std::mutex> lock(mShards->mutex);
+  std::vector<Int_t> coordinates;
+  for (auto& [thread, shard] : mShards->shards) {
+    for (uint32_t i = 0; i < MAX_REGISTRY_SIZE; ++i) {
+      auto& sumw = shard->sumw[i];
+      if (sumw.empty()) {
+        continue;
+      }
+      auto& sumw2 = shard->sumw2[i].empty() ? sumw : shard->sumw2[i];
+      auto const& axes = mAxes[i];
+      coordinates.resize(axes.size());
+
+      TH1* histogram = mRegistryValue[i].get();
+      THnBase* histogramN = mRegistryValueN[i].get();
+      if (shard->sumw2[i].empty() == false) {
+        if (histogram && histogram->GetSumw2N() == 0) {
+          histogram->Sumw2();
+        } else if (histogramN && histogramN->GetCalculateErrors() == false) {
+          histogramN->Sumw2();
+        }
+      }
+      auto entries = histogram ? histogram->GetEntries() : histogramN->GetEntries();
+
+      for (size_t cell = 0; cell < sumw.size(); ++cell) {
+        if (sumw[cell] == 0. && sumw2[cell] == 0.) {
+          continue;
+        }
+        for (size_t a = 0; a < axes.size(); ++a) {
+          coordinates[a] = (cell / axes[a].stride) % (axes[a].nBins + 2);
+        }
+        if (histogram) {
+          auto bin = histogram->GetBin(coordinates[0],
+                                       coordinates.size() > 1 ? coordinates[1] : 0,
+                                       coordinates.size() > 2 ? coordinates[2] : 0);
+          histogram->AddBinContent(bin, sumw[cell]);
+          if (histogram->GetSumw2N() != 0) {
+            histogram->GetSumw2()->fArray[bin] += sumw2[cell];
+          }
+        } else {
+          auto bin = histogramN->GetBin(coordinates.data());
+          histogramN->AddBinContent(bin, sumw[cell]);
+          if (histogramN->GetCalculateErrors()) {
+            histogramN->AddBinError2(bin, sumw2[cell]);
+          }
+        }
+      }
+
+      if (histogram) {
+        histogram->ResetStats();
+        histogram->SetEntries(entries + shard->entries[i]);
+      } else {
+        histogramN->SetEntries(entries + shard->entries[i]);
+      }
+      sumw.clear();
+      shard->sumw2[i].clear();
+      shard->entries[i] = 0;
+    }
+  }
+}
+
+std::unique_ptr<TList> HistogramRegistry::list() const
+{
+  auto list = std::make_unique<TList>();
+  list->SetName(name.data());
+  for (uint32_t i = 0; i < MAX_REGISTRY_SIZE; ++i) {
+    if (mRegistryValue[i]) {
+      list->Add(mRegistryValue[i].get());
+    } else if (mRegistryValueN[i]) {
+      list->Add(mRegistryValueN[i].get());
+    }
+  }
+  return list;
+}
+
+} // namespace o2::framework
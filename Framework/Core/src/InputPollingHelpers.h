@@ -0,0 +1,70 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_INPUTPOLLINGHELPERS_H_
+#define O2_FRAMEWORK_INPUTPOLLINGHELPERS_H_
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace o2::framework
+{
+
+/// How DataProcessingDevice::ConditionalRun waits for its inputs, in both
+/// the busy (probe and back off) and the event driven (poller) modes.
+struct InputPollingHelpers {
+  // This should result in a minimum of 10Hz which should guarantee we do not use
+  // much time when idle. We do not sleep at all when we are at less then 100us,
+  // because that's what the default rate enforces in any case.
+  static constexpr int MAX_BACKOFF = 6;
+  static constexpr int MIN_BACKOFF_DELAY = 100;
+  static constexpr int BACKOFF_DELAY_STEP = 100;
+  // When waiting on inputs in event driven mode, this is the longest we
+  // block if a timer needs to be serviced.
+  static constexpr int MAX_TIMER_WAIT_MS = 1;
+
+  /// @return the new exponential backoff value, given whether the last
+  /// iteration did any work.
+  ///
+  /// In principle we should use 1/rate for MIN_BACKOFF_DELAY and (1/maxRate -
+  /// 1/minRate)/ 2^MAX_BACKOFF for BACKOFF_DELAY_STEP. We hardcode the values
+  /// for the moment to some sensible default.
+  static int nextBackoff(int backoff, bool active)
+  {
+    return active ? std::max(0, backoff - 1) : std::min(MAX_BACKOFF, backoff + 1);
+  }
+
+  /// @return how long (in us) to sleep in busy mode for the given backoff,
+  /// 0 if we should not sleep at all.
+  static int backoffDelay(int backoff)
+  {
+    if (backoff == 0) {
+      return 0;
+    }
+    auto delay = (rand() % ((1 << backoff) - 1)) * BACKOFF_DELAY_STEP;
+    return delay > MIN_BACKOFF_DELAY ? delay - MIN_BACKOFF_DELAY : 0;
+  }
+
+  /// @return the maximum time in ms the poller can block in event driven
+  /// mode. If we did something in the previous iteration, there might be
+  /// more already waiting for us, so we do not block. Enumerations are
+  /// generated as fast as possible, so they should never wait, while timers
+  /// need to be checked at least every MAX_TIMER_WAIT_MS.
+  static int pollTimeout(bool wasActive, int maxTimeout, bool hasEnumerations, bool hasTimers)
+  {
+    if (wasActive || hasEnumerations) {
+      return 0;
+    }
+    return hasTimers ? std::min(maxTimeout, MAX_TIMER_WAIT_MS) : maxTimeout;
+  }
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_INPUTPOLLINGHELPERS_H_
@@ -15,8 +15,12 @@
 #include <arrow/status.h>
 #include <arrow/type.h>
 #include <arrow/util/variant.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <iostream>
+#include <type_traits>
 
 using namespace arrow;
 using namespace arrow::compute;
@@ -101,8 +105,217 @@ Status SortedGroupByKernel::Call(FunctionContext* ctx, Datum const& inputTable,
   return arrow::Status::OK();
 }
 
+namespace
+{
+template <typename TYPE>
+void readCategories(ChunkedArray const& chunkedArray, double binWidth, std::vector<int64_t>& categories)
+{
+  using T = typename TYPE::c_type;
+  for (int ci = 0; ci < chunkedArray.num_chunks(); ++ci) {
+    auto chunk = std::static_pointer_cast<NumericArray<TYPE>>(chunkedArray.chunk(ci));
+    T const* data = chunk->raw_values();
+    for (int64_t ai = 0; ai < chunk->length(); ++ai) {
+      if constexpr (std::is_floating_point_v<T>) {
+        categories.push_back(static_cast<int64_t>(std::floor(data[ai] / binWidth)));
+      } else {
+        categories.push_back(static_cast<int64_t>(data[ai]));
+      }
+    }
+  }
+}
+
+void buildGroupIndex(std::vector<int64_t> const& categories, GroupIndex* index)
+{
+  auto n = categories.size();
+  index->categories.clear();
+  index->offsets.clear();
+  index->indices.resize(n);
+  index->sorted = std::is_sorted(categories.begin(), categories.end());
+
+  if (index->sorted) {
+    // Already grouped, a single pass is enough.
+    for (size_t ri = 0; ri < n; ++ri) {
+      index->indices[ri] = ri;
+      if (ri == 0 || categories[ri] != categories[ri - 1]) {
+        index->categories.push_back(categories[ri]);
+        index->offsets.push_back(ri);
+      }
+    }
+    index->offsets.push_back(n);
+    return;
+  }
+
+  auto [minIt, maxIt] = std::minmax_element(categories.begin(), categories.end());
+  auto min = *minIt;
+  uint64_t spread = static_cast<uint64_t>(*maxIt) - static_cast<uint64_t>(min);
+  if (spread < 2 * n + 1024) {
+    auto range = spread + 1;
+    // Counting sort, which keeps the original order within a category.
+    std::vector<uint64_t> positions(range + 1, 0);
+    for (auto category : categories) {
+      positions[category - min + 1]++;
+    }
+    for (size_t ci = 0; ci < range; ++ci) {
+      if (positions[ci + 1] != 0) {
+        index->categories.push_back(min + ci);
+        index->offsets.push_back(positions[ci]);
+      }
+      positions[ci + 1] += positions[ci];
+    }
+    index->offsets.push_back(n);
+    for (size_t ri = 0; ri < n; ++ri) {
+      index->indices[positions[categories[ri] - min]++] = ri;
+    }
+    return;
+  }
+
+  // Sparse categories, e.g. hashes: fall back to sorting.
+  std::vector<std::pair<int64_t, uint64_t>> sortedCategories;
+  sortedCategories.reserve(n);
+  for (size_t ri = 0; ri < n; ++ri) {
+    sortedCategories.emplace_back(categories[ri], ri);
+  }
+  std::stable_sort(sortedCategories.begin(), sortedCategories.end(),
+                   [](auto const& a, auto const& b) { return a.first < b.first; });
+  for (size_t ri = 0; ri < n; ++ri) {
+    index->indices[ri] = sortedCategories[ri].second;
+    if (ri == 0 || sortedCategories[ri].first != sortedCategories[ri - 1].first) {
+      index->categories.push_back(sortedCategories[ri].first);
+      index->offsets.push_back(ri);
+    }
+  }
+  index->offsets.push_back(n);
+}
+} // namespace
+
+namespace
+{
+/// Read the categories of the column @a key of @a table. Values of UINT64
+/// columns are bit-cast to int64_t and @a isUnsigned is set.
+arrow::Status readColumnCategories(std::shared_ptr<arrow::Table> const& table,
+                                   std::string const& key,
+                                   double binWidth,
+                                   std::vector<int64_t>& categories,
+                                   bool& isUnsigned)
+{
+  auto columnIndex = table->schema()->GetFieldIndex(key);
+  if (columnIndex < 0) {
+    return Status::Invalid("Unable to find column " + key);
+  }
+  auto chunkedArray = table->column(columnIndex)->data();
+  categories.reserve(table->num_rows());
+  isUnsigned = false;
+  switch (chunkedArray->type()->id()) {
+    case Type::INT8:
+      readCategories<Int8Type>(*chunkedArray, binWidth, categories);
+      break;
+    case Type::UINT8:
+      readCategories<UInt8Type>(*chunkedArray, binWidth, categories);
+      break;
+    case Type::INT16:
+      readCategories<Int16Type>(*chunkedArray, binWidth, categories);
+      break;
+    case Type::UINT16:
+      readCategories<UInt16Type>(*chunkedArray, binWidth, categories);
+      break;
+    case Type::INT32:
+      readCategories<Int32Type>(*chunkedArray, binWidth, categories);
+      break;
+    case Type::UINT32:
+      readCategories<UInt32Type>(*chunkedArray, binWidth, categories);
+      break;
+    case Type::INT64:
+      readCategories<Int64Type>(*chunkedArray, binWidth, categories);
+      break;
+    case Type::UINT64:
+      readCategories<UInt64Type>(*chunkedArray, binWidth, categories);
+      isUnsigned = true;
+      break;
+    case Type::FLOAT:
+    case Type::DOUBLE:
+      if (binWidth <= 0) {
+        return Status::Invalid("A positive bin width is needed to group by floating point column " + key);
+      }
+      if (chunkedArray->type()->id() == Type::FLOAT) {
+        readCategories<FloatType>(*chunkedArray, binWidth, categories);
+      } else {
+        readCategories<DoubleType>(*chunkedArray, binWidth, categories);
+      }
+      break;
+    default:
+      return Status::Invalid("Cannot group by column " + key + " of type " + chunkedArray->type()->ToString());
+  }
+  return arrow::Status::OK();
+}
+
+/// Flipping the sign bit maps the unsigned order of bit-cast uint64_t
+/// values onto the signed order, and back.
+void flipSignBits(std::vector<int64_t>& categories)
+{
+  for (auto& category : categories) {
+    category ^= std::numeric_limits<int64_t>::min();
+  }
+}
+} // namespace
+
+arrow::Status groupByColumn(std::shared_ptr<arrow::Table> const& table,
+                            std::string const& key,
+                            GroupIndex* index,
+                            double binWidth)
+{
+  std::vector<int64_t> categories;
+  bool isUnsigned;
+  ARROW_RETURN_NOT_OK(readColumnCategories(table, key, binWidth, categories, isUnsigned));
+  // Values above INT64_MAX would be negative once bit-cast, so the
+  // grouping is done on keys which keep their unsigned order.
+  if (isUnsigned) {
+    flipSignBits(categories);
+  }
+  buildGroupIndex(categories, index);
+  if (isUnsigned) {
+    flipSignBits(index->categories);
+  }
+  index->unsignedCategories = isUnsigned;
+  return arrow::Status::OK();
+}
+
+arrow::Status groupByRuns(std::shared_ptr<arrow::Table> const& table,
+                          std::string const& key,
+                          GroupIndex* index)
+{
+  std::vector<int64_t> categories;
+  bool isUnsigned;
+  ARROW_RETURN_NOT_OK(readColumnCategories(table, key, 0, categories, isUnsigned));
+  auto n = categories.size();
+  index->categories.clear();
+  index->offsets.clear();
+  index->indices.resize(n);
+  index->sorted = true;
+  index->unsignedCategories = false;
+  for (size_t ri = 0; ri < n; ++ri) {
+    index->indices[ri] = ri;
+    if (ri == 0 || categories[ri] != categories[ri - 1]) {
+      index->categories.push_back(index->categories.size());
+      index->offsets.push_back(ri);
+    }
+  }
+  index->offsets.push_back(n);
+  return arrow::Status::OK();
+}
+
+std::shared_ptr<arrow::Table> sliceTable(std::shared_ptr<arrow::Table> const& table, uint64_t start, uint64_t count)
+{
+  auto schema = table->schema();
+  std::vector<std::shared_ptr<Column>> slicedColumns;
+  slicedColumns.reserve(schema->num_fields());
+  for (int ci = 0; ci < schema->num_fields(); ++ci) {
+    slicedColumns.emplace_back(table->column(ci)->Slice(start, count));
+  }
+  return arrow::Table::Make(schema, slicedColumns);
+}
+
 /// Slice a given table is a vector of tables each containing a slice.
-arrow::Status sliceByColumn(FunctionContext* context, std::string const& key,
+arrow::Status sliceByColumn(FunctionContext*, std::string const& key,
                             Datum const& inputTable, std::vector<Datum>* outputSlices,
                             std::vector<uint64_t>* offsets)
 {
@@ -110,34 +323,23 @@ arrow::Status sliceByColumn(FunctionContext* context, std::string const& key,
     return Status::Invalid("Input Datum was not a table");
   }
 
-  // build all the ranges on the fly.
-  Datum outRanges;
-  SortedGroupByKernel groupBy({GroupByOptions{key}});
-  ARROW_RETURN_NOT_OK(groupBy.Call(context, inputTable, &outRanges));
-  auto ranges = util::get<std::shared_ptr<arrow::Table>>(outRanges.value);
-  outputSlices->reserve(ranges->num_rows());
+  auto table = arrow::util::get<std::shared_ptr<arrow::Table>>(inputTable.value);
+  // Tables which are not sorted are sliced in runs of equal values, as
+  // they always were.
+  GroupIndex index;
+  ARROW_RETURN_NOT_OK(groupByColumn(table, key, &index));
+  if (index.sorted == false) {
+    ARROW_RETURN_NOT_OK(groupByRuns(table, key, &index));
+  }
+  outputSlices->reserve(index.size());
   if (offsets) {
-    offsets->reserve(ranges->num_rows());
+    offsets->reserve(index.size());
   }
 
-  auto startChunks = ranges->column(0)->data();
-  assert(startChunks->num_chunks() == 1);
-  auto countChunks = ranges->column(1)->data();
-  assert(countChunks->num_chunks() == 1);
-  auto startData = std::static_pointer_cast<UInt64Array>(startChunks->chunk(0))->raw_values();
-  auto countData = std::static_pointer_cast<UInt64Array>(countChunks->chunk(0))->raw_values();
-
-  auto table = arrow::util::get<std::shared_ptr<arrow::Table>>(inputTable.value);
-  for (size_t ri = 0; ri < ranges->num_rows(); ++ri) {
-    auto start = startData[ri];
-    auto count = countData[ri];
-    auto schema = table->schema();
-    std::vector<std::shared_ptr<Column>> slicedColumns;
-    slicedColumns.reserve(schema->num_fields());
-    for (size_t ci = 0; ci < schema->num_fields(); ++ci) {
-      slicedColumns.emplace_back(table->column(ci)->Slice(start, count));
-    }
-    outputSlices->emplace_back(Datum(arrow::Table::Make(table->schema(), slicedColumns)));
+  for (size_t ci = 0; ci < index.size(); ++ci) {
+    auto start = index.offsets[ci];
+    auto count = index.offsets[ci + 1] - start;
+    outputSlices->emplace_back(Datum(sliceTable(table, start, count)));
     if (offsets) {
       offsets->emplace_back(start);
     }
@@ -193,6 +193,10 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
     {},
     readers::AODReaderHelpers::rootFileReaderCallback(),
     {ConfigParamSpec{"aod-file", VariantType::String, "aod.root", {"Input AOD file"}},
+     ConfigParamSpec{"aod-arrow-tables", VariantType::String, "", {"Comma separated list of tables (e.g. TRACKPAR) to read from <aod-file>_<table>.arrow rather than from the trees, or all"}},
+     ConfigParamSpec{"aod-reader-threads", VariantType::Int, 0, {"Number of threads used to read the branches of a tree in parallel, 1 or less to read them serially"}},
+     ConfigParamSpec{"aod-reader-prefetch", VariantType::Int, 0, {"Number of files to read ahead in a background thread, 0 to disable"}},
+     ConfigParamSpec{"aod-reader-prefetch-memory", VariantType::Int, 0, {"Stop reading ahead when this many MB are waiting, 0 for no limit"}},
      ConfigParamSpec{"start-value-enumeration", VariantType::Int64, 0ll, {"initial value for the enumeration"}},
      ConfigParamSpec{"end-value-enumeration", VariantType::Int64, -1ll, {"final value for the enumeration"}},
      ConfigParamSpec{"step-value-enumeration", VariantType::Int64, 1ll, {"step between one value and the other"}}}};
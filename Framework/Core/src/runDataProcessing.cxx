@@ -649,7 +649,11 @@ int doChild(int argc, char** argv, const o2::framework::DeviceSpec& spec)
       ConfigParamsHelper::populateBoostProgramOptions(optsDesc, spec.options, gHiddenDeviceOptions);
       optsDesc.add_options()("monitoring-backend", bpo::value<std::string>()->default_value("infologger://"), "monitoring backend info") //
         ("infologger-severity", bpo::value<std::string>()->default_value(""), "minimum FairLogger severity to send to InfoLogger")       //
-        ("infologger-mode", bpo::value<std::string>()->default_value(""), "INFOLOGGER_MODE override");
+        ("infologger-mode", bpo::value<std::string>()->default_value(""), "INFOLOGGER_MODE override")                                    //
+        ("input-polling", bpo::value<std::string>()->default_value("busy"), "how to wait for inputs: busy or event")                     //
+        ("input-poll-timeout", bpo::value<std::string>()->default_value("100"), "max time (ms) to block on inputs in event mode")        //
+        ("relayer-max-slots", bpo::value<std::string>()->default_value("0"), "max number of in flight timeslices (0: fixed)")            //
+        ("relayer-memory-budget", bpo::value<std::string>()->default_value("0"), "max MB of in flight timeslices (0: no limit)");
       r.fConfig.AddToCmdLineOptions(optsDesc, true);
     });
 
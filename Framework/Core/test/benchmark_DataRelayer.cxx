@@ -14,10 +14,12 @@
 #include "Framework/CompletionPolicyHelpers.h"
 #include "Framework/DataRelayer.h"
 #include "Framework/DataProcessingHeader.h"
+#include "Framework/WorkflowSpec.h"
 #include "../src/DataRelayerHelpers.h"
 #include <Monitoring/Monitoring.h>
 #include <fairmq/FairMQTransportFactory.h>
 #include <cstring>
+#include <string>
 
 using Monitoring = o2::monitoring::Monitoring;
 using namespace o2::framework;
@@ -239,4 +241,54 @@ static void BM_RelayMultipleRoutes(benchmark::State& state)
 
 BENCHMARK(BM_RelayMultipleRoutes);
 
+/// A device subscribing to range(0) different subspecs, e.g. one per link.
+/// Each iteration relays one message for the last subspec, which is the
+/// worst case when all the matchers need to be tried in turn. range(1) != 0
+/// adds a wildcard route at the end, which always needs to be evaluated.
+static void BM_RelayManyRoutes(benchmark::State& state)
+{
+  Monitoring metrics;
+  size_t nRoutes = state.range(0);
+
+  std::vector<InputRoute> inputs;
+  for (size_t ri = 0; ri < nRoutes; ++ri) {
+    InputSpec spec{"clusters" + std::to_string(ri), "TPC", "CLUSTERS", static_cast<DataHeader::SubSpecificationType>(ri)};
+    inputs.emplace_back(InputRoute{spec, ri, "Fake" + std::to_string(ri), 0});
+  }
+  if (state.range(1)) {
+    auto specs = o2::framework::select("tracks:TPC/TRACKS");
+    inputs.emplace_back(InputRoute{specs[0], nRoutes, "FakeWildcard", 0});
+  }
+
+  TimesliceIndex index;
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(4);
+
+  DataHeader dh;
+  dh.dataDescription = "CLUSTERS";
+  dh.dataOrigin = "TPC";
+  dh.subSpecification = nRoutes - 1;
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t timeslice = 0;
+
+  for (auto _ : state) {
+    DataProcessingHeader dph{timeslice++, 1};
+    Stack stack{dh, dph};
+    FairMQMessagePtr header = transport->CreateMessage(stack.size());
+    FairMQMessagePtr payload = transport->CreateMessage(1000);
+    memcpy(header->GetData(), stack.data(), stack.size());
+
+    relayer.relay(std::move(header), std::move(payload));
+    auto ready = relayer.getReadyToProcess();
+    assert(ready.size() == 1);
+    auto result = relayer.getInputsForTimeslice(ready[0].slot);
+    assert(result.at(nRoutes - 1).size() == 1);
+  }
+}
+
+BENCHMARK(BM_RelayManyRoutes)->Args({1, 0})->Args({1000, 0})->Args({1000, 1});
+
 BENCHMARK_MAIN();
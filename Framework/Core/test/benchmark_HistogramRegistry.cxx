@@ -61,7 +61,33 @@ static void BM_StandardNameLookup(benchmark::State& state)
     }
   }
 }
+/// Fill a 2D histogram through ROOT
+static void BM_StandardFill(benchmark::State& state)
+{
+  HistogramRegistry registry{"registry", true, {{"etaphi", "#Eta vs #Phi", {"TH2F", {{100, -2.0, 2.0}, {100, 0, 2 * M_PI}}}}}};
+  for (auto _ : state) {
+    auto& h = registry.get<compile_time_hash("etaphi")>();
+    for (auto i = 0; i < nLookups; ++i) {
+      h->Fill(-2. + (i % 400) * 0.01, (i % 628) * 0.01);
+    }
+  }
+}
+
+/// Fill a 2D histogram through the flat bins of the registry
+static void BM_FlatFill(benchmark::State& state)
+{
+  HistogramRegistry registry{"registry", true, {{"etaphi", "#Eta vs #Phi", {"TH2F", {{100, -2.0, 2.0}, {100, 0, 2 * M_PI}}}}}};
+  for (auto _ : state) {
+    for (auto i = 0; i < nLookups; ++i) {
+      registry.fill<HistogramKey<compile_time_hash("etaphi"), 2>>(-2. + (i % 400) * 0.01, (i % 628) * 0.01);
+    }
+    registry.merge();
+  }
+}
+
 BENCHMARK(BM_HashedNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 BENCHMARK(BM_StandardNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
+BENCHMARK(BM_StandardFill);
+BENCHMARK(BM_FlatFill);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include <benchmark/benchmark.h>
+
+#include "Framework/DataProcessingDevice.h"
+#include "../src/InputPollingHelpers.h"
+
+#include <fairmq/FairMQChannel.h>
+#include <fairmq/FairMQPoller.h>
+#include <fairmq/FairMQTransportFactory.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Compares the two ways DataProcessingDevice::ConditionalRun can wait for its
+// inputs: probing every channel with a zero timeout and backing off when idle
+// (--input-polling busy) or blocking on a single poller over all the channels
+// (--input-polling event). A producer thread sends one message every
+// range(1) microseconds, round robin on range(0) channels. Each iteration
+// waits for at least one message. We report the average end-to-end latency
+// and the CPU used by the receiving thread, relative to the wall time.
+// The backoff and the poll timeout are the ones of the device, from
+// InputPollingHelpers.
+
+using namespace o2::framework;
+using InputPolling = DataProcessingDevice::InputPolling;
+
+// Default of --input-poll-timeout
+constexpr int POLL_TIMEOUT_MS = 100;
+
+namespace
+{
+uint64_t nowInNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double threadCPUTime()
+{
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+} // namespace
+
+template <InputPolling MODE>
+static void BM_InputPolling(benchmark::State& state)
+{
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t nChannels = state.range(0);
+  auto period = std::chrono::microseconds(state.range(1));
+
+  std::vector<std::unique_ptr<FairMQChannel>> inputs;
+  std::vector<std::unique_ptr<FairMQChannel>> outputs;
+  std::vector<FairMQChannel*> pollerChannels;
+  for (size_t ci = 0; ci < nChannels; ++ci) {
+    auto address = "inproc://benchmark-input-polling-" + std::to_string(ci);
+    inputs.emplace_back(std::make_unique<FairMQChannel>("in" + std::to_string(ci), "pull", transport));
+    inputs.back()->Bind(address);
+    outputs.emplace_back(std::make_unique<FairMQChannel>("out" + std::to_string(ci), "push", transport));
+    outputs.back()->Connect(address);
+    pollerChannels.push_back(inputs.back().get());
+  }
+  auto poller = transport->CreatePoller(pollerChannels);
+
+  std::atomic<bool> stop = false;
+  std::thread producer([&outputs, &transport, &stop, period]() {
+    size_t next = 0;
+    while (stop == false) {
+      std::this_thread::sleep_for(period);
+      auto msg = transport->CreateMessage(sizeof(uint64_t));
+      uint64_t created = nowInNs();
+      memcpy(msg->GetData(), &created, sizeof(uint64_t));
+      outputs[next++ % outputs.size()]->Send(msg, 10);
+    }
+  });
+
+  double totalLatency = 0;
+  size_t nReceived = 0;
+  int backoff = 0;
+  auto receive = [&totalLatency, &nReceived, &transport](FairMQChannel& channel) -> bool {
+    auto msg = transport->CreateMessage();
+    if (channel.Receive(msg, 0) <= 0) {
+      return false;
+    }
+    uint64_t created;
+    memcpy(&created, msg->GetData(), sizeof(uint64_t));
+    totalLatency += (nowInNs() - created) * 1e-3;
+    nReceived++;
+    return true;
+  };
+
+  auto wallStart = nowInNs();
+  auto cpuStart = threadCPUTime();
+  for (auto _ : state) {
+    bool received = false;
+    while (received == false) {
+      if constexpr (MODE == InputPolling::Event) {
+        poller->Poll(InputPollingHelpers::pollTimeout(false, POLL_TIMEOUT_MS, false, false));
+        for (size_t ci = 0; ci < nChannels; ++ci) {
+          if (poller->CheckInput(ci)) {
+            received |= receive(*inputs[ci]);
+          }
+        }
+      } else {
+        for (size_t ci = 0; ci < nChannels; ++ci) {
+          received |= receive(*inputs[ci]);
+        }
+        backoff = InputPollingHelpers::nextBackoff(backoff, received);
+        auto delay = InputPollingHelpers::backoffDelay(backoff);
+        if (delay) {
+          std::this_thread::sleep_for(std::chrono::microseconds(delay));
+        }
+      }
+    }
+  }
+  double cpuTime = threadCPUTime() - cpuStart;
+  double wallTime = (nowInNs() - wallStart) * 1e-9;
+  stop = true;
+  producer.join();
+
+  state.counters["latency_us"] = nReceived ? totalLatency / nReceived : 0.;
+  state.counters["cpu_percent"] = 100. * cpuTime / wallTime;
+}
+
+BENCHMARK_TEMPLATE(BM_InputPolling, InputPolling::Busy)->Args({1, 100})->Args({16, 100})->Args({16, 10000})->UseRealTime();
+BENCHMARK_TEMPLATE(BM_InputPolling, InputPolling::Event)->Args({1, 100})->Args({16, 100})->Args({16, 10000})->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,86 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Framework AODFilePrefetcher
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "../src/AODFilePrefetcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestPrefetchInOrder)
+{
+  std::vector<std::string> filenames{"a.root", "b.root", "c.root", "d.root", "e.root"};
+  std::atomic<int> reads = 0;
+  auto reader = [&reads](std::string const& filename) {
+    reads++;
+    // Make sure the files complete at different times.
+    std::this_thread::sleep_for(std::chrono::milliseconds(filename[0] % 3));
+    auto content = std::make_unique<AODFileContent>();
+    content->filename = filename;
+    content->valid = filename != "c.root";
+    return content;
+  };
+
+  AODFilePrefetcher prefetcher(filenames, reader, 2, 0);
+  for (auto& filename : filenames) {
+    auto content = prefetcher.next();
+    BOOST_REQUIRE(content.get() != nullptr);
+    BOOST_CHECK_EQUAL(content->filename, filename);
+    BOOST_CHECK_EQUAL(content->valid, filename != "c.root");
+  }
+  BOOST_CHECK(prefetcher.next().get() == nullptr);
+  BOOST_CHECK_EQUAL(reads.load(), (int)filenames.size());
+}
+
+BOOST_AUTO_TEST_CASE(TestPrefetchLimits)
+{
+  std::vector<std::string> filenames(10, "file.root");
+  std::atomic<int> reads = 0;
+  auto reader = [&reads](std::string const& filename) {
+    reads++;
+    auto content = std::make_unique<AODFileContent>();
+    content->filename = filename;
+    content->memoryUsage = 100;
+    return content;
+  };
+
+  // At most 3 files are read ahead.
+  {
+    AODFilePrefetcher prefetcher(filenames, reader, 3, 0);
+    prefetcher.waitIdle();
+    BOOST_CHECK_EQUAL(reads.load(), 3);
+    BOOST_CHECK_EQUAL(prefetcher.ready(), 3);
+    prefetcher.next();
+    prefetcher.waitIdle();
+    BOOST_CHECK_EQUAL(reads.load(), 4);
+  }
+
+  // The memory budget allows for 2 files, but one of them is always read
+  // even if it would not fit.
+  reads = 0;
+  {
+    AODFilePrefetcher prefetcher(filenames, reader, 8, 150);
+    prefetcher.waitIdle();
+    BOOST_CHECK_EQUAL(reads.load(), 2);
+  }
+  reads = 0;
+  {
+    AODFilePrefetcher prefetcher(filenames, reader, 8, 50);
+    prefetcher.waitIdle();
+    BOOST_CHECK_EQUAL(reads.load(), 1);
+  }
+}
@@ -847,4 +847,15 @@ BOOST_AUTO_TEST_CASE(BlockCombinations)
     count++;
   }
   BOOST_CHECK_EQUAL(count, expectedFullPairs.size());
+
+  // Binned floating point category, bins of width 2
+  // [7] [0, 4], [2], [1, 6], [3, 5]
+  std::vector<std::tuple<int32_t, int32_t>> expectedBinnedPairs{{0, 4}, {1, 6}, {3, 5}};
+  count = 0;
+  for (auto& [c0, c1] : combinations(CombinationsBlockStrictlyUpperIndexPolicy(CategoryColumn{"floatZ", 2.}, testA, testA))) {
+    BOOST_CHECK_EQUAL(c0.x(), std::get<0>(expectedBinnedPairs[count]));
+    BOOST_CHECK_EQUAL(c1.x(), std::get<1>(expectedBinnedPairs[count]));
+    count++;
+  }
+  BOOST_CHECK_EQUAL(count, expectedBinnedPairs.size());
 }
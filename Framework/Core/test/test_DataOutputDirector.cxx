@@ -14,7 +14,14 @@
 #include <boost/test/unit_test.hpp>
 
 #include "Headers/DataHeader.h"
+#include "Framework/AODReaderHelpers.h"
 #include "Framework/DataOutputDirector.h"
+#include "Framework/TableBuilder.h"
+#include "Framework/TableConsumer.h"
+
+#include <arrow/buffer.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
 
 BOOST_AUTO_TEST_CASE(TestDataOutputDirector)
 {
@@ -124,3 +131,70 @@ BOOST_AUTO_TEST_CASE(TestDataOutputDirector)
   BOOST_CHECK_EQUAL(ds[1]->treename, std::string("due"));
   BOOST_CHECK_EQUAL(ds[1]->colnames.size(), 1);
 }
+
+BOOST_AUTO_TEST_CASE(TestDataOutputFormat)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+
+  DataOutputDirector dod;
+  auto dh = DataHeader(DataDescription{"UNO"},
+                       DataOrigin{"AOD"},
+                       DataHeader::SubSpecificationType{0});
+
+  dod.readString("AOD/UNO/0:tr1:c1:fn1,AOD/UNO/0:tr2:c1:fn1:arrow,AOD/UNO/0:tr3::fn1:root");
+  auto ds = dod.getDataOutputDescriptors(dh);
+  BOOST_REQUIRE_EQUAL(ds.size(), 3);
+  BOOST_CHECK(ds[0]->format == DataOutputFormat::Root);
+  BOOST_CHECK(ds[1]->format == DataOutputFormat::Arrow);
+  BOOST_CHECK(ds[2]->format == DataOutputFormat::Root);
+
+  std::string jsonString(R"({"OutputDirector": {"OutputDescriptions": [{"table": "AOD/UNO/0", "treename": "uno", "format": "arrow"}]}})");
+  dod.reset();
+  dod.readJsonString(jsonString);
+  ds = dod.getDataOutputDescriptors(dh);
+  BOOST_REQUIRE_EQUAL(ds.size(), 1);
+  BOOST_CHECK(ds[0]->format == DataOutputFormat::Arrow);
+}
+
+BOOST_AUTO_TEST_CASE(TestArrowWriteThenRead)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+  using namespace o2::framework::readers;
+
+  BOOST_CHECK_EQUAL(DataOutputDirector::arrowFilename("AO2D.root", "TRACKPAR"), "AO2D_TRACKPAR.arrow");
+  BOOST_CHECK_EQUAL(DataOutputDirector::arrowFilename("AO2D_0", "TRACKPAR"), "AO2D_0_TRACKPAR.arrow");
+
+  TableBuilder builder;
+  auto rowWriter = builder.persist<uint64_t, float>({"x", "y"});
+  for (auto i = 0; i < 100; ++i) {
+    rowWriter(0, i, 0.5f * i);
+  }
+  auto table = builder.finalize();
+
+  // write the table the way the AOD writer does
+  DataOutputDirector dod;
+  auto dh = DataHeader(DataDescription{"UNO"},
+                       DataOrigin{"AOD"},
+                       DataHeader::SubSpecificationType{0});
+  dod.readString("AOD/UNO/0:uno::arrowwritethenread:arrow");
+  auto ds = dod.getDataOutputDescriptors(dh);
+  BOOST_REQUIRE_EQUAL(ds.size(), 1);
+  auto writer = dod.getArrowOutputWriter(ds[0], 0, 1, table->schema());
+  BOOST_REQUIRE(writer != nullptr);
+  BOOST_REQUIRE(writer->WriteTable(*table).ok());
+  dod.closeDataOutputFiles();
+
+  // and read it back the way the AOD reader does, given the ROOT file
+  // written next to it
+  auto stream = AODReaderHelpers::mapArrowStream(DataOutputDirector::arrowFilename("arrowwritethenread_0.root", "UNO"));
+  BOOST_REQUIRE(stream != nullptr);
+  TableConsumer consumer(stream->data(), stream->size());
+  auto readBack = consumer.asArrowTable();
+  BOOST_REQUIRE(readBack != nullptr);
+  BOOST_CHECK(readBack->Equals(*table));
+
+  // a missing file is reported so that the reader can fall back to the tree
+  BOOST_CHECK(AODReaderHelpers::mapArrowStream("arrowwritethenread_1_UNO.arrow") == nullptr);
+}
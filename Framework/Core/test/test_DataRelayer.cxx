@@ -432,3 +432,124 @@ BOOST_AUTO_TEST_CASE(TestClear)
   auto ready3 = relayer.getReadyToProcess();
   BOOST_REQUIRE_EQUAL(ready3.size(), 0);
 }
+
+/// Test that the pipeline grows when more timeslices are in flight than
+/// slots available, unless the memory budget is exceeded.
+BOOST_AUTO_TEST_CASE(TestAdaptivePipeline)
+{
+  Monitoring metrics;
+  InputSpec spec1{"clusters", "TPC", "CLUSTERS"};
+  InputSpec spec2{"tracks", "TPC", "TRACKS"};
+
+  std::vector<InputRoute> inputs = {
+    InputRoute{spec1, 0, "Fake1", 0},
+    InputRoute{spec2, 1, "Fake2", 0},
+  };
+
+  DataHeader dh1;
+  dh1.dataDescription = "CLUSTERS";
+  dh1.dataOrigin = "TPC";
+  dh1.subSpecification = 0;
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  auto createMessage = [&transport](DataRelayer& relayer, DataHeader const& dh, DataProcessingHeader const& h) {
+    Stack stack{dh, h};
+    FairMQMessagePtr header = transport->CreateMessage(stack.size());
+    FairMQMessagePtr payload = transport->CreateMessage(1000);
+    memcpy(header->GetData(), stack.data(), stack.size());
+    return relayer.relay(std::move(header), std::move(payload));
+  };
+
+  // Only one of the two inputs is ever sent, so nothing can be consumed
+  // and all the timeslices stay in flight.
+  TimesliceIndex index;
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(2);
+  relayer.setAdaptivePipeline(1, 8, 0);
+  for (size_t i = 0; i < 6; ++i) {
+    createMessage(relayer, dh1, DataProcessingHeader{i, 1});
+  }
+  BOOST_CHECK_EQUAL(relayer.getStats().droppedComputations, 0);
+  BOOST_CHECK_EQUAL(relayer.getStats().pipelineLength, 8);
+  BOOST_CHECK_EQUAL(relayer.getParallelTimeslices(), 8);
+  BOOST_CHECK_EQUAL(relayer.getStats().pipelineResizes, 2);
+  BOOST_CHECK(relayer.getStats().cachedBytes >= 6 * 1000);
+
+  // Once the maximum is reached, the oldest timeslices get evicted.
+  for (size_t i = 6; i < 10; ++i) {
+    createMessage(relayer, dh1, DataProcessingHeader{i, 1});
+  }
+  BOOST_CHECK_EQUAL(relayer.getStats().droppedComputations, 2);
+  BOOST_CHECK_EQUAL(relayer.getStats().pipelineLength, 8);
+
+  // With a budget smaller than a single message, the pipeline never grows.
+  TimesliceIndex index2;
+  DataRelayer relayer2(policy, inputs, metrics, index2);
+  relayer2.setPipelineLength(2);
+  relayer2.setAdaptivePipeline(1, 8, 500);
+  for (size_t i = 0; i < 6; ++i) {
+    createMessage(relayer2, dh1, DataProcessingHeader{i, 1});
+  }
+  BOOST_CHECK_EQUAL(relayer2.getStats().pipelineLength, 2);
+  BOOST_CHECK_EQUAL(relayer2.getStats().droppedComputations, 4);
+}
+
+// Exact routes are looked up by key, but a wildcard route declared before
+// them still takes precedence, like when all the matchers are tried in turn.
+BOOST_AUTO_TEST_CASE(TestIndexedMatching)
+{
+  Monitoring metrics;
+  auto specs = o2::framework::select("wildcard:TPC/CLUSTERS");
+  InputSpec spec1{"tpc1", "TPC", "CLUSTERS", 1};
+  InputSpec spec2{"its0", "ITS", "CLUSTERS", 0};
+  InputSpec spec3{"its1", "ITS", "CLUSTERS", 1};
+
+  std::vector<InputRoute> inputs = {
+    InputRoute{specs[0], 0, "Fake0", 0},
+    InputRoute{spec1, 1, "Fake1", 0},
+    InputRoute{spec2, 2, "Fake2", 0},
+    InputRoute{spec3, 3, "Fake3", 0},
+  };
+
+  auto matcherIndex = DataRelayerHelpers::createInputMatcherIndex(inputs);
+  BOOST_REQUIRE_EQUAL(matcherIndex.generic.size(), 1);
+  BOOST_CHECK_EQUAL(matcherIndex.generic[0], 0);
+  BOOST_CHECK_EQUAL(matcherIndex.exact.size(), 3);
+
+  TimesliceIndex index;
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(4);
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  auto checkRoute = [&transport, &relayer](char const* origin, uint32_t subSpec, size_t timeslice, int expected) {
+    DataHeader dh;
+    dh.dataDescription = "CLUSTERS";
+    dh.dataOrigin = origin;
+    dh.subSpecification = subSpec;
+    DataProcessingHeader dph{timeslice, 1};
+    Stack stack{dh, dph};
+    FairMQMessagePtr header = transport->CreateMessage(stack.size());
+    FairMQMessagePtr payload = transport->CreateMessage(1000);
+    memcpy(header->GetData(), stack.data(), stack.size());
+    relayer.relay(std::move(header), std::move(payload));
+    auto ready = relayer.getReadyToProcess();
+    if (expected < 0) {
+      BOOST_CHECK_EQUAL(ready.size(), 0);
+      return;
+    }
+    BOOST_REQUIRE_EQUAL(ready.size(), 1);
+    auto result = relayer.getInputsForTimeslice(ready[0].slot);
+    BOOST_REQUIRE_EQUAL(result.size(), 4);
+    for (size_t ri = 0; ri < result.size(); ++ri) {
+      BOOST_CHECK_EQUAL(result.at(ri).size(), (int)ri == expected ? 1 : 0);
+    }
+  };
+
+  checkRoute("TPC", 1, 0, 0);
+  checkRoute("TPC", 7, 1, 0);
+  checkRoute("ITS", 0, 2, 2);
+  checkRoute("ITS", 1, 3, 3);
+  checkRoute("ITS", 2, 4, -1);
+}
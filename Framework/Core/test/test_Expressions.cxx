@@ -112,3 +112,22 @@ BOOST_AUTO_TEST_CASE(TestTreeParsing)
   BOOST_REQUIRE_EQUAL(uspecs[5].right, (DatumSpec{}));
   BOOST_REQUIRE_EQUAL(uspecs[5].result, (DatumSpec{5u, atype::FLOAT}));
 }
+
+BOOST_AUTO_TEST_CASE(TestFilterCache)
+{
+  auto schema = std::make_shared<arrow::Schema>(std::vector{std::make_shared<arrow::Field>("eta", arrow::float32()),
+                                                            std::make_shared<arrow::Field>("phi", arrow::float32())});
+  expressions::Filter f = (nodes::eta < 1.f) && (nodes::phi > 0.5f);
+  expressions::Filter g = (nodes::eta < 2.f) && (nodes::phi > 0.5f);
+
+  auto before = getFilterCacheStats();
+  auto first = createFilter(schema, createOperations(f));
+  auto second = createFilter(schema, createOperations(f));
+  auto other = createFilter(schema, createOperations(g));
+  auto after = getFilterCacheStats();
+
+  BOOST_CHECK(first.get() == second.get());
+  BOOST_CHECK(first.get() != other.get());
+  BOOST_CHECK_EQUAL(after.misses - before.misses, 2);
+  BOOST_CHECK_EQUAL(after.hits - before.hits, 1);
+}
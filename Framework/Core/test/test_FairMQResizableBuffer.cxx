@@ -145,3 +145,23 @@ BOOST_AUTO_TEST_CASE(TestStreaming)
 
   std::unique_ptr<FairMQMessage> payload = buffer->Finalise();
 }
+
+// Growing the buffer only copies what was written so far
+BOOST_AUTO_TEST_CASE(TestReserveCopiesUsedSize)
+{
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t allocated = 0;
+  FairMQResizableBuffer buffer{[&transport, &allocated](size_t size) -> std::unique_ptr<FairMQMessage> {
+    allocated += size;
+    return std::move(transport->CreateMessage(size));
+  }};
+  auto status = buffer.Resize(3, false);
+  BOOST_REQUIRE(status.ok());
+  memcpy(buffer.mutable_data(), "foo", 3);
+  status = buffer.Reserve(100000);
+  BOOST_REQUIRE(status.ok());
+  BOOST_REQUIRE_EQUAL(buffer.size(), 3);
+  BOOST_REQUIRE_EQUAL(buffer.capacity(), 100000);
+  BOOST_REQUIRE(strncmp((const char*)buffer.data(), "foo", 3) == 0);
+  BOOST_CHECK_EQUAL(allocated, 4096 + 100000);
+}
@@ -14,6 +14,8 @@
 #include "Framework/HistogramRegistry.h"
 #include <boost/test/unit_test.hpp>
 
+#include <thread>
+
 using namespace o2;
 using namespace o2::framework;
 
@@ -41,3 +43,69 @@ BOOST_AUTO_TEST_CASE(HistogramRegistryLookup)
   auto histo2 = r.get("histo").get();
   BOOST_REQUIRE_EQUAL(histo2->GetNbinsX(), 100);
 }
+
+BOOST_AUTO_TEST_CASE(HistogramRegistryUnsupportedKinds)
+{
+  using Specs = std::vector<HistogramSpec>;
+  BOOST_CHECK_THROW(HistogramRegistry("r", true, Specs{{"h", "h", {"THnSparseF", {{2, 0, 1}}}}}), std::runtime_error);
+  BOOST_CHECK_THROW(HistogramRegistry("r", true, Specs{{"h", "h", {"TH1X", 10, 0, 1}}}), std::runtime_error);
+  BOOST_CHECK_THROW(HistogramRegistry("r", true, Specs{{"h", "h", {"TH2F", 10, 0, 1}}}), std::runtime_error);
+  BOOST_CHECK_THROW(HistogramRegistry("r", true, Specs{{"h", "h", {"TH1D", {{2, 0, 1}, {2, 0, 1}}}}}), std::runtime_error);
+  BOOST_CHECK_THROW(HistogramRegistry("r", true, Specs{{"h", "h", {"THnI", std::vector<AxisSpec>{}}}}), std::runtime_error);
+  HistogramRegistry registry{"r", true, {{"h", "h", {"TH3I", {{2, 0, 1}, {3, 0, 1}, {4, 0, 1}}}}}};
+  BOOST_CHECK_EQUAL(registry.get("h")->GetNbinsZ(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramRegistryFlatFill)
+{
+  HistogramRegistry registry{"registry", true, {{"eta", "#Eta", {"TH1F", 4, -2.0, 2.0}}, {"etaphi", "#Eta vs #Phi", {"TH2D", {{4, -2.0, 2.0}, {2, 0, 2}}}}, {"ptetaphi", "p_{T} vs #Eta vs #Phi", {"THnF", {{5, 0, 5}, {4, -2.0, 2.0}, {2, 0, 2}}}}}};
+  BOOST_REQUIRE_EQUAL(registry.get("etaphi")->GetNbinsY(), 2);
+  BOOST_REQUIRE_EQUAL(registry.getTHn("ptetaphi")->GetNdimensions(), 3);
+
+  // A wrong number of coordinates, e.g. registry.fill<Eta>(1., 2.), does
+  // not compile.
+  using Eta = HistogramKey<compile_time_hash("eta"), 1>;
+  using EtaPhi = HistogramKey<compile_time_hash("etaphi"), 2>;
+  using PtEtaPhi = HistogramKey<compile_time_hash("ptetaphi"), 3>;
+  registry.fill<Eta>(-1.5);
+  registry.fill<Eta>(1.5);
+  registry.fill<Eta>(3.);
+  registry.fillWeighted<EtaPhi>(2., 0.5, 1.5);
+  registry.fill<PtEtaPhi>(1.5f, 0.5f, 0.5f);
+
+  // Nothing is visible before merging
+  BOOST_CHECK_EQUAL(registry.get("eta")->GetEntries(), 0);
+
+  // Fill from other threads as well
+  std::vector<std::thread> threads;
+  for (int ti = 0; ti < 4; ++ti) {
+    threads.emplace_back([&registry]() {
+      for (int i = 0; i < 1000; ++i) {
+        registry.fill<Eta>(-0.5);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  registry.merge();
+  auto& eta = registry.get<compile_time_hash("eta")>();
+  BOOST_CHECK_EQUAL(eta->GetEntries(), 4003);
+  BOOST_CHECK_EQUAL(eta->GetBinContent(1), 1);
+  BOOST_CHECK_EQUAL(eta->GetBinContent(2), 4000);
+  BOOST_CHECK_EQUAL(eta->GetBinContent(4), 1);
+  BOOST_CHECK_EQUAL(eta->GetBinContent(5), 1);
+
+  auto& etaphi = registry.get("etaphi");
+  BOOST_CHECK_EQUAL(etaphi->GetBinContent(3, 2), 2.);
+  BOOST_CHECK_EQUAL(etaphi->GetBinError(3, 2), 2.);
+
+  auto& ptetaphi = registry.getTHn<compile_time_hash("ptetaphi")>();
+  std::vector<Int_t> coordinates{2, 3, 1};
+  BOOST_CHECK_EQUAL(ptetaphi->GetBinContent(ptetaphi->GetBin(coordinates.data())), 1.);
+
+  // Merging twice does not add the bins again
+  registry.merge();
+  BOOST_CHECK_EQUAL(eta->GetBinContent(2), 4000);
+}
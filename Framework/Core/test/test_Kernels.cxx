@@ -105,3 +105,85 @@ BOOST_AUTO_TEST_CASE(TestWithSOATables)
   BOOST_CHECK_EQUAL(offsets[1], 2);
   BOOST_CHECK_EQUAL(offsets[2], 6);
 }
+
+BOOST_AUTO_TEST_CASE(TestGroupByColumn)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<int16_t, float, int64_t>({"x", "z", "h"});
+  rowWriter(0, 2, 1.5f, 1000000000);
+  rowWriter(0, -1, -0.5f, 7);
+  rowWriter(0, 2, 3.9f, 1000000000);
+  rowWriter(0, 0, -1.5f, 7);
+  rowWriter(0, -1, 0.1f, -1000000000);
+  auto table = builder.finalize();
+
+  // Dense categories, grouped with a counting sort
+  GroupIndex index;
+  BOOST_REQUIRE(groupByColumn(table, "x", &index).ok());
+  BOOST_CHECK_EQUAL(index.sorted, false);
+  BOOST_REQUIRE_EQUAL(index.size(), 3);
+  BOOST_CHECK_EQUAL(index.categories[0], -1);
+  BOOST_CHECK_EQUAL(index.categories[1], 0);
+  BOOST_CHECK_EQUAL(index.categories[2], 2);
+  std::vector<uint64_t> expectedOffsets{0, 2, 3, 5};
+  std::vector<uint64_t> expectedIndices{1, 4, 3, 0, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.offsets.begin(), index.offsets.end(), expectedOffsets.begin(), expectedOffsets.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.indices.begin(), index.indices.end(), expectedIndices.begin(), expectedIndices.end());
+
+  // Floating point columns need bins
+  BOOST_CHECK(groupByColumn(table, "z", &index).ok() == false);
+  BOOST_REQUIRE(groupByColumn(table, "z", &index, 2.).ok());
+  BOOST_REQUIRE_EQUAL(index.size(), 3);
+  BOOST_CHECK_EQUAL(index.categories[0], -1);
+  BOOST_CHECK_EQUAL(index.categories[1], 0);
+  BOOST_CHECK_EQUAL(index.categories[2], 1);
+  expectedIndices = {1, 3, 0, 4, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.indices.begin(), index.indices.end(), expectedIndices.begin(), expectedIndices.end());
+
+  // Sparse categories
+  BOOST_REQUIRE(groupByColumn(table, "h", &index).ok());
+  BOOST_REQUIRE_EQUAL(index.size(), 3);
+  BOOST_CHECK_EQUAL(index.categories[0], -1000000000);
+  BOOST_CHECK_EQUAL(index.categories[2], 1000000000);
+  expectedIndices = {4, 1, 3, 0, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.indices.begin(), index.indices.end(), expectedIndices.begin(), expectedIndices.end());
+
+  BOOST_CHECK(groupByColumn(table, "missing", &index).ok() == false);
+}
+
+BOOST_AUTO_TEST_CASE(TestUnsortedSlicesAndUnsignedCategories)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<int32_t, uint64_t>({"x", "u"});
+  rowWriter(0, 1, 0xFFFFFFFFFFFFFFFFul);
+  rowWriter(0, 1, 5);
+  rowWriter(0, 0, 0x8000000000000000ul);
+  rowWriter(0, 2, 5);
+  rowWriter(0, 1, 0xFFFFFFFFFFFFFFFFul);
+  auto table = builder.finalize();
+
+  // Tables which are not sorted are sliced in runs of equal values
+  arrow::compute::FunctionContext ctx;
+  std::vector<arrow::compute::Datum> slices;
+  std::vector<uint64_t> offsets;
+  BOOST_REQUIRE(sliceByColumn(&ctx, "x", table, &slices, &offsets).ok());
+  std::vector<uint64_t> expectedOffsets{0, 2, 3, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(offsets.begin(), offsets.end(), expectedOffsets.begin(), expectedOffsets.end());
+  BOOST_REQUIRE_EQUAL(slices.size(), 4);
+  BOOST_CHECK_EQUAL(arrow::util::get<std::shared_ptr<arrow::Table>>(slices[0].value)->num_rows(), 2);
+
+  GroupIndex index;
+  BOOST_REQUIRE(groupByRuns(table, "x", &index).ok());
+  BOOST_REQUIRE_EQUAL(index.size(), 4);
+  BOOST_CHECK_EQUAL(index.categories[3], 3);
+
+  // Values above INT64_MAX keep their unsigned order
+  BOOST_REQUIRE(groupByColumn(table, "u", &index).ok());
+  BOOST_CHECK_EQUAL(index.unsignedCategories, true);
+  BOOST_REQUIRE_EQUAL(index.size(), 3);
+  BOOST_CHECK_EQUAL(static_cast<uint64_t>(index.categories[0]), 5);
+  BOOST_CHECK_EQUAL(static_cast<uint64_t>(index.categories[1]), 0x8000000000000000ul);
+  BOOST_CHECK_EQUAL(static_cast<uint64_t>(index.categories[2]), 0xFFFFFFFFFFFFFFFFul);
+  std::vector<uint64_t> expectedIndices{1, 3, 2, 0, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.indices.begin(), index.indices.end(), expectedIndices.begin(), expectedIndices.end());
+}
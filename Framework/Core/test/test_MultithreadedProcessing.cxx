@@ -0,0 +1,75 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/AlgorithmSpec.h"
+#include "Framework/ControlService.h"
+#include "Framework/DataProcessorSpec.h"
+#include "Framework/runDataProcessing.h"
+#include "Framework/Logger.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace o2::framework;
+
+constexpr int NUMBER_OF_TIMESLICES = 64;
+
+// A producer -> processor -> consumer chain where the processor uses
+// multiple threads, each taking a different time to complete. The consumer
+// verifies that the outputs still arrive in order and fails otherwise.
+WorkflowSpec defineDataProcessing(ConfigContext const&)
+{
+  DataProcessorSpec producer{
+    "producer",
+    Inputs{},
+    {OutputSpec{"TST", "A", 0, Lifetime::Timeframe}},
+    AlgorithmSpec{adaptStateful([]() {
+      static int counter = 0;
+      return adaptStateless([](DataAllocator& outputs, ControlService& control) {
+        outputs.make<int>(Output{"TST", "A", 0}) = counter++;
+        if (counter == NUMBER_OF_TIMESLICES) {
+          control.endOfStream();
+          control.readyToQuit(QuitRequest::Me);
+        }
+      });
+    })}};
+
+  DataProcessorSpec processor{
+    "processor",
+    {InputSpec{"a", "TST", "A", 0, Lifetime::Timeframe}},
+    {OutputSpec{"TST", "B", 0, Lifetime::Timeframe}},
+    AlgorithmSpec{[](ProcessingContext& ctx) {
+      auto value = ctx.inputs().get<int>("a");
+      // Make sure the computations complete out of order.
+      std::this_thread::sleep_for(std::chrono::milliseconds((NUMBER_OF_TIMESLICES - value) % 7));
+      ctx.outputs().make<int>(Output{"TST", "B", 0}) = value;
+    }}};
+  processor.nThreads = 4;
+
+  DataProcessorSpec consumer{
+    "consumer",
+    {InputSpec{"b", "TST", "B", 0, Lifetime::Timeframe}},
+    Outputs{},
+    AlgorithmSpec{adaptStateful([]() {
+      static int expected = 0;
+      return adaptStateless([](InputRecord& inputs, ControlService& control) {
+        auto value = inputs.get<int>("b");
+        // Aborts the consumer, so that the whole workflow fails.
+        if (value != expected) {
+          LOG(FATAL) << "Expecting " << expected << " found " << value;
+        }
+        expected = value + 1;
+        if (expected == NUMBER_OF_TIMESLICES) {
+          control.readyToQuit(QuitRequest::All);
+        }
+      });
+    })}};
+
+  return WorkflowSpec{producer, processor, consumer};
+}
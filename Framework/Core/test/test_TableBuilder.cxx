@@ -172,6 +172,22 @@ BOOST_AUTO_TEST_CASE(TestTableBuilderBulk)
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestTableBuilderSizeHint)
+{
+  using namespace o2::framework;
+  TableBuilder builder;
+  BOOST_CHECK_EQUAL(builder.getSizeHint(), 1000);
+  builder.setSizeHint(3);
+  auto rowWriter = builder.persist<int, float>({"x", "y"});
+  for (int i = 0; i < 10; ++i) {
+    rowWriter(0, i, i * 0.5f);
+  }
+  auto table = builder.finalize();
+  BOOST_REQUIRE_EQUAL(table->num_rows(), 10);
+  auto p = std::dynamic_pointer_cast<arrow::NumericArray<arrow::Int32Type>>(table->column(0)->data()->chunk(0));
+  BOOST_CHECK_EQUAL(p->Value(9), 9);
+}
+
 BOOST_AUTO_TEST_CASE(TestTableBuilderMore)
 {
   using namespace o2::framework;
@@ -68,3 +68,97 @@ BOOST_AUTO_TEST_CASE(TreeToTableConversion)
 
   f1.Close();
 }
+
+BOOST_AUTO_TEST_CASE(TreeToTableBulkConversion)
+{
+  using namespace o2::framework;
+  Int_t ndp = 100000;
+
+  // Flush the baskets every 1000 entries so that we have more than one
+  // basket per branch, but keep the last ones in memory.
+  TFile f1("tree2tablebulk.root", "RECREATE");
+  TTree t1("t1", "a simple Tree with simple variables");
+  t1.SetAutoFlush(1000);
+  Float_t px;
+  Double_t random;
+  Int_t ev;
+  ULong64_t mask;
+  Short_t charge;
+  t1.Branch("px", &px, "px/F");
+  t1.Branch("random", &random, "random/D");
+  t1.Branch("ev", &ev, "ev/I");
+  t1.Branch("mask", &mask, "mask/l");
+  t1.Branch("charge", &charge, "charge/S");
+
+  for (Int_t i = 0; i < ndp + 17; i++) {
+    px = gRandom->Gaus();
+    random = gRandom->Rndm();
+    ev = i + 1;
+    mask = (ULong64_t)1 << (i % 64);
+    charge = i % 2 ? 1 : -1;
+    t1.Fill();
+  }
+
+  TreeToTable rowReader(&t1, false);
+  BOOST_REQUIRE_EQUAL(rowReader.AddAllColumns(), true);
+  auto rowTable = rowReader.Process();
+
+  TreeToTable bulkReader(&t1, true);
+  BOOST_REQUIRE_EQUAL(bulkReader.AddAllColumns(), true);
+  auto bulkTable = bulkReader.Process();
+
+  BOOST_REQUIRE_EQUAL(bulkTable->Validate().ok(), true);
+  BOOST_REQUIRE_EQUAL(bulkTable->num_rows(), ndp + 17);
+  BOOST_REQUIRE_EQUAL(bulkTable->num_columns(), 5);
+  BOOST_CHECK_EQUAL(bulkTable->Equals(*rowTable), true);
+
+  f1.Close();
+}
+
+BOOST_AUTO_TEST_CASE(TreeToTableParallelBulkConversion)
+{
+  using namespace o2::framework;
+  Int_t ndp = 10000;
+
+  {
+    TFile f1("tree2tableparallel.root", "RECREATE");
+    TTree t1("t1", "a simple Tree with simple variables");
+    t1.SetAutoFlush(1000);
+    Float_t px;
+    Double_t random;
+    Int_t ev;
+    ULong64_t mask;
+    t1.Branch("px", &px, "px/F");
+    t1.Branch("random", &random, "random/D");
+    t1.Branch("ev", &ev, "ev/I");
+    t1.Branch("mask", &mask, "mask/l");
+    for (Int_t i = 0; i < ndp + 17; i++) {
+      px = gRandom->Gaus();
+      random = gRandom->Rndm();
+      ev = i + 1;
+      mask = (ULong64_t)1 << (i % 64);
+      t1.Fill();
+    }
+    t1.Write();
+  }
+
+  // the tasks can only open their own handle on a file opened read-only
+  TFile f2("tree2tableparallel.root", "READ");
+  auto t2 = (TTree*)f2.Get("t1");
+  BOOST_REQUIRE(t2 != nullptr);
+
+  TreeToTable rowReader(t2, false);
+  BOOST_REQUIRE_EQUAL(rowReader.AddAllColumns(), true);
+  auto rowTable = rowReader.Process();
+
+  TreeToTable parallelReader(t2, true, 4);
+  BOOST_REQUIRE_EQUAL(parallelReader.AddAllColumns(), true);
+  auto parallelTable = parallelReader.Process();
+
+  BOOST_REQUIRE_EQUAL(parallelTable->Validate().ok(), true);
+  BOOST_REQUIRE_EQUAL(parallelTable->num_rows(), ndp + 17);
+  BOOST_REQUIRE_EQUAL(parallelTable->num_columns(), 4);
+  BOOST_CHECK_EQUAL(parallelTable->Equals(*rowTable), true);
+
+  f2.Close();
+}
@@ -323,6 +323,15 @@ class RootTreeWriter
   using MessageableVectorSpecialization = std::integral_constant<char, 2>;
   using ROOTTypeSpecialization = std::integral_constant<char, 3>;
 
+  // detect types which can be restored from a flat buffer, like the MCTruthContainer,
+  // those are also accepted as unserialized messages
+  template <typename T, typename _ = void>
+  struct has_flat_restore : std::false_type {
+  };
+  template <typename T>
+  struct has_flat_restore<T, std::void_t<decltype(std::declval<T&>().restore_from(std::declval<const char*>(), std::declval<size_t>()))>> : std::true_type {
+  };
+
   // the binary branch format is chosen for const char*
   // using internally a vector<char>, this involves for the moment a copy, investigate if ROOT
   // can write a simple array of chars and use a pointer
@@ -469,6 +478,19 @@ class RootTreeWriter
     template <typename S, typename std::enable_if_t<std::is_same<S, ROOTTypeSpecialization>::value, int> = 0>
     void fillData(InputContext& context, const char* key, TBranch* branch, size_t branchIdx)
     {
+      if constexpr (has_flat_restore<value_type>::value) {
+        // the object might have been sent in its flat representation, the
+        // object is then restored from the buffer without ROOT deserialization
+        auto ref = context.get(key);
+        auto header = o2::header::get<const o2::header::DataHeader*>(ref.header);
+        if (header && header->payloadSerializationMethod == o2::header::gSerializationMethodNone) {
+          value_type restored;
+          restored.restore_from(ref.payload, header->payloadSize);
+          mStore[branchIdx] = &restored;
+          branch->Fill();
+          return;
+        }
+      }
       auto data = context.get<typename std::add_pointer<value_type>::type>(key);
       // this is ugly but necessary because of the TTree API does not allow a const
       // object as input. Have to rely on that ROOT treats the object as const
@@ -59,6 +59,8 @@ class GPUKernelTemplate
 
   typedef GPUconstantref() MEM_CONSTANT(GPUConstantMem) processorType;
   GPUhdi() CONSTEXPRRET static GPUDataTypes::RecoStep GetRecoStep() { return GPUCA_RECO_STEP::NoRecoStep; }
+  // Kernels which already run their work in an OMP parallel loop on the host, their blocks must not be distributed over OMP threads as well
+  GPUhdi() CONSTEXPRRET static bool OMPParallelInternally() { return false; }
   MEM_TEMPLATE()
   GPUhdi() static processorType* Processor(MEM_TYPE(GPUConstantMem) & processors)
   {
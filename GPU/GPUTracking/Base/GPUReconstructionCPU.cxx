@@ -32,6 +32,7 @@
 #include "GPUMemoryResource.h"
 #include "GPUConstantMem.h"
 #include <atomic>
+#include <algorithm>
 
 #define GPUCA_LOGGING_PRINTF
 #include "GPULogging.h"
@@ -72,9 +73,26 @@ int GPUReconstructionCPUBackend::runKernelBackend(krnlSetup& _xyz, const Args&..
   }
   unsigned int num = y.num == 0 || y.num == -1 ? 1 : y.num;
   for (unsigned int k = 0; k < num; k++) {
-    for (unsigned int iB = 0; iB < x.nBlocks; iB++) {
+    if (mDeviceProcessingSettings.ompKernels && x.nBlocks > 1 && !T::OMPParallelInternally()) {
+      // Blocks are independent like on the GPU, distribute them over the OMP threads.
+      // Kernels with their own OMP loop keep it, nesting both would serialize the inner one.
+#ifdef WITH_OPENMP
+#pragma omp parallel num_threads(std::min<unsigned int>(mDeviceProcessingSettings.nThreads, x.nBlocks))
+#endif
+      {
+        typename T::GPUSharedMemory smem; // One per thread, reused by all its blocks
+#ifdef WITH_OPENMP
+#pragma omp for schedule(guided)
+#endif
+        for (unsigned int iB = 0; iB < x.nBlocks; iB++) {
+          T::template Thread<I>(x.nBlocks, 1, iB, 0, smem, T::Processor(*mHostConstantMem)[y.start + k], args...);
+        }
+      }
+    } else {
       typename T::GPUSharedMemory smem;
-      T::template Thread<I>(x.nBlocks, 1, iB, 0, smem, T::Processor(*mHostConstantMem)[y.start + k], args...);
+      for (unsigned int iB = 0; iB < x.nBlocks; iB++) {
+        T::template Thread<I>(x.nBlocks, 1, iB, 0, smem, T::Processor(*mHostConstantMem)[y.start + k], args...);
+      }
     }
   }
   return 0;
@@ -158,8 +176,13 @@ int GPUReconstructionCPU::ExitDevice()
   return 0;
 }
 
-void GPUReconstructionCPU::SetThreadCounts() { mThreadCount = mBlockCount = mConstructorBlockCount = mSelectorBlockCount = mHitsSorterBlockCount = mConstructorThreadCount = mSelectorThreadCount = mFinderThreadCount = mHitsSorterThreadCount = mHitsFinderThreadCount = mTRDThreadCount = mClustererThreadCount =
-                                                 mScanThreadCount = mConverterThreadCount = mCompression1ThreadCount = mCompression2ThreadCount = mCFDecodeThreadCount = mFitThreadCount = mITSThreadCount = mWarpSize = 1; }
+void GPUReconstructionCPU::SetThreadCounts()
+{
+  mThreadCount = mConstructorThreadCount = mSelectorThreadCount = mFinderThreadCount = mHitsSorterThreadCount = mHitsFinderThreadCount = mTRDThreadCount = mClustererThreadCount = mScanThreadCount = mConverterThreadCount = mCompression1ThreadCount =
+    mCompression2ThreadCount = mCFDecodeThreadCount = mFitThreadCount = mITSThreadCount = mWarpSize = 1;
+  // With ompKernels the blocks of a launch run on the OMP threads, so the kernels with a configurable block count need one block per thread
+  mBlockCount = mConstructorBlockCount = mSelectorBlockCount = mHitsSorterBlockCount = mDeviceProcessingSettings.ompKernels ? mDeviceProcessingSettings.nThreads : 1;
+}
 
 void GPUReconstructionCPU::SetThreadCounts(RecoStep step)
 {
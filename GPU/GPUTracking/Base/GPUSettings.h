@@ -129,6 +129,7 @@ struct GPUSettingsDeviceProcessing {
 #endif
 
   int nThreads;                       // Numnber of threads on CPU, 0 = auto-detect
+  bool ompKernels;                    // Parallelize with OMP over the blocks inside kernels instead of over slices
   int deviceNum;                      // Device number to use, in case the backend provides multiple devices (-1 = auto-select)
   int platformNum;                    // Platform to use, in case the backend provides multiple platforms (-1 = auto-select)
   bool globalInitMutex;               // Global mutex to synchronize initialization over multiple instances
@@ -1080,7 +1080,7 @@ int GPUChainTracking::RunTPCTrackingSlices_internal()
 
   bool error = false;
 #ifdef WITH_OPENMP
-#pragma omp parallel for num_threads(doGPU ? 1 : GetDeviceProcessingSettings().nThreads)
+#pragma omp parallel for num_threads(doGPU || GetDeviceProcessingSettings().ompKernels ? 1 : GetDeviceProcessingSettings().nThreads)
 #endif
   for (unsigned int iSlice = 0; iSlice < NSLICES; iSlice++) {
     GPUTPCTracker& trk = processors()->tpcTrackers[iSlice];
@@ -1336,7 +1336,7 @@ int GPUChainTracking::RunTPCTrackingSlices_internal()
   } else {
     mSliceSelectorReady = NSLICES;
 #ifdef WITH_OPENMP
-#pragma omp parallel for num_threads(doGPU ? 1 : GetDeviceProcessingSettings().nThreads)
+#pragma omp parallel for num_threads(doGPU || GetDeviceProcessingSettings().ompKernels ? 1 : GetDeviceProcessingSettings().nThreads)
 #endif
     for (unsigned int iSlice = 0; iSlice < NSLICES; iSlice++) {
       if (param().rec.GlobalTracking) {
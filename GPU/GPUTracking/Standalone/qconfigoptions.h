@@ -94,6 +94,7 @@ AddOption(mergerSortTracks, bool, false, "mergerSortTracks", 0, "Sort track indi
 AddOption(recoSteps, int, -1, "recoSteps", 0, "Bitmask for RecoSteps")
 AddOption(recoStepsGPU, int, -1, "recoStepsGPU", 0, "Bitmask for RecoSteps")
 AddOption(runMC, bool, false, "runMC", 0, "Process MC labels")
+AddOption(ompKernels, bool, false, "ompKernels", 0, "Parallelize with OMP over the blocks inside kernels instead of over slices")
 AddHelp("help", 'h')
 EndConfig()
 
@@ -13,6 +13,10 @@
 
 #include <iosfwd>
 #include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 class FairMQParts;
 
@@ -21,6 +25,20 @@ namespace o2
 namespace data_flow
 {
 
+/// Index which can be appended to a file of timeframes, so that any of
+/// them can be accessed without parsing the whole file. It is made of this
+/// header, the offsets of the nTimeframes timeframes in the file as uint64_t
+/// and, as last 8 bytes of the file, the offset of the header itself.
+struct TimeframeFileIndex {
+  // does not start like a DataHeader, so that the streaming parser can stop on it
+  static constexpr char sMagic[8] = {'T', 'F', 'I', 'N', 'D', 'E', 'X', '\0'};
+  static constexpr uint64_t sVersion = 1;
+
+  char magic[8] = {'T', 'F', 'I', 'N', 'D', 'E', 'X', '\0'};
+  uint64_t version = sVersion;
+  uint64_t nTimeframes = 0;
+};
+
 /// An helper function which takes a std::istream pointing
 /// to a naively persisted timeframe and pumps its parts to
 /// FairMQParts, ready to be shipped via FairMQ.
@@ -30,6 +48,46 @@ void streamTimeframe(std::istream& stream,
 
 void streamTimeframe(std::ostream& stream, FairMQParts& parts);
 
+/// Write all the parts of the timeframe to the file descriptor with
+/// vectored writes. Returns the number of bytes written.
+size_t streamTimeframe(int fd, FairMQParts& parts);
+
+/// Append the TimeframeFileIndex for the timeframes at the given offsets.
+void writeTimeframeIndex(int fd, std::vector<uint64_t> const& offsets);
+
+/// A file of timeframes mapped in memory. The parts of the timeframes are
+/// handed out as pointers into the mapping, which is private and writable,
+/// so that consumers may modify them in place. The timeframes are located
+/// via the TimeframeFileIndex when present, or by scanning the file.
+class MappedTimeframeFile
+{
+ public:
+  MappedTimeframeFile(std::string const& filename);
+  ~MappedTimeframeFile();
+  MappedTimeframeFile(MappedTimeframeFile const&) = delete;
+  MappedTimeframeFile& operator=(MappedTimeframeFile const&) = delete;
+
+  size_t getNTimeframes() const { return mOffsets.size(); }
+  /// True if the timeframes were located via the index trailer
+  bool hasIndex() const { return mHasIndex; }
+
+  /// Invoke onAddPart for every header and payload of the i-th timeframe,
+  /// then onSend.
+  void streamTimeframe(size_t i,
+                       std::function<void(FairMQParts& parts, char* buffer, size_t size)> onAddPart,
+                       std::function<void(FairMQParts& parts)> onSend) const;
+
+ private:
+  bool readIndex();
+  void scanTimeframes();
+
+  char* mData = nullptr;
+  size_t mSize = 0;
+  size_t mEnd = 0; // end of the timeframes, i.e. start of the index if any
+  bool mHasIndex = false;
+  std::vector<uint64_t> mOffsets;
+};
+
 } // namespace data_flow
 } // namespace o2
 
@@ -25,6 +25,8 @@ class TimeframeReaderDevice : public base::O2Device
  public:
   static constexpr const char* OptionKeyOutputChannelName = "output-channel-name";
   static constexpr const char* OptionKeyInputFileName = "input-file";
+  static constexpr const char* OptionKeyMemoryMapped = "mmap";
+  static constexpr const char* OptionKeyFirstTimeframe = "first-timeframe";
 
   /// Default constructor
   TimeframeReaderDevice();
@@ -41,6 +43,8 @@ class TimeframeReaderDevice : public base::O2Device
   std::string mOutChannelName;
   std::string mInFileName;
   std::fstream mFile;
+  bool mMemoryMapped = true;
+  size_t mFirstTimeframe = 0;
   std::vector<std::string> mSeen;
 };
 
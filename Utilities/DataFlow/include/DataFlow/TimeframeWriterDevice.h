@@ -12,14 +12,16 @@
 #define ALICEO2_TIMEFRAME_WRITER_DEVICE_H_
 
 #include "O2Device/O2Device.h"
-#include <fstream>
+#include <cstdint>
+#include <vector>
 
 namespace o2
 {
 namespace data_flow
 {
 
-/// A device which writes to file the timeframes.
+/// A device which writes to file the timeframes. Every file ends with a
+/// TimeframeFileIndex of the timeframes it contains.
 class TimeframeWriterDevice : public base::O2Device
 {
  public:
@@ -44,9 +46,13 @@ class TimeframeWriterDevice : public base::O2Device
   /// Overloads the Run() method of FairMQDevice
   void Run() final;
 
+  void closeFile();
+
   std::string mInChannelName;
   std::string mOutFileName;
-  std::fstream mFile;
+  int mFile = -1;
+  size_t mFileSize = 0;
+  std::vector<uint64_t> mTimeframeOffsets;
   size_t mMaxTimeframes;
   size_t mMaxFileSize;
   size_t mMaxFiles;
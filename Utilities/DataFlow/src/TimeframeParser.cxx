@@ -16,6 +16,16 @@
 #include <thread> // this_thread::sleep_for
 #include <chrono>
 #include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <sstream>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #include "DataFlow/TimeframeParser.h"
 #include "Headers/SubframeMetadata.h"
@@ -29,6 +39,10 @@ using DataHeader = o2::header::DataHeader;
 using DataDescription = o2::header::DataDescription;
 using IndexElement = o2::dataformats::IndexElement;
 
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
 namespace o2
 {
 namespace data_flow
@@ -115,7 +129,7 @@ void streamTimeframe(std::istream& stream,
           throw std::runtime_error(str.str());
         }
         // We get the full header size and read the rest of the header
-        state.headerBuffer = malloc(state.dh.headerSize);
+        state.headerBuffer = new char[state.dh.headerSize];
         memcpy(state.headerBuffer, &state.dh, sizeof(state.dh));
         LOG(INFO) << "Reading rest of the header of " << state.dh.headerSize - sizeof(state.dh) << " bytes\n";
         stream.read(reinterpret_cast<char*>(state.headerBuffer) + sizeof(state.dh),
@@ -149,9 +163,9 @@ void streamTimeframe(std::istream& stream,
       case PARSE_END_TIMEFRAME:
         LOG(INFO) << "In PARSE_END_TIMEFRAME\n";
         onSend(parts);
-        // Check if we have more. If not, we can declare success.
-        stream.peek();
-        if (stream.eof()) {
+        // Check if we have more. If not, we can declare success. The index
+        // trailer, if any, is not parsed here.
+        if (stream.peek() == TimeframeFileIndex::sMagic[0] || stream.eof()) {
           state.state = PARSE_END_STREAM;
         } else {
           state.state = PARSE_BEGIN_TIMEFRAME;
@@ -166,7 +180,9 @@ void streamTimeframe(std::istream& stream,
   }
 }
 
-void streamTimeframe(std::ostream& stream, FairMQParts& parts)
+namespace
+{
+void checkTimeframe(FairMQParts& parts)
 {
   if (parts.Size() < 2) {
     throw std::runtime_error("Expecting at least 2 parts\n");
@@ -194,11 +210,200 @@ void streamTimeframe(std::ostream& stream, FairMQParts& parts)
   }
 
   LOG(INFO) << "Everything is fine with received timeframe\n";
+}
+
+void writeFully(int fd, std::vector<iovec>& iov)
+{
+  size_t first = 0;
+  while (first < iov.size()) {
+    auto res = ::writev(fd, &iov[first], std::min<size_t>(iov.size() - first, IOV_MAX));
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("Failed to write timeframe: ") + strerror(errno));
+    }
+    size_t written = res;
+    // skip what was written, possibly only part of a buffer
+    while (first < iov.size() && written >= iov[first].iov_len) {
+      written -= iov[first++].iov_len;
+    }
+    if (written) {
+      iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+      iov[first].iov_len -= written;
+    }
+  }
+}
+} // namespace
+
+void streamTimeframe(std::ostream& stream, FairMQParts& parts)
+{
+  checkTimeframe(parts);
   for (size_t i = 0; i < parts.Size(); ++i) {
     stream.write(reinterpret_cast<const char*>(parts.At(i)->GetData()),
                  parts.At(i)->GetSize());
   }
 }
 
+size_t streamTimeframe(int fd, FairMQParts& parts)
+{
+  checkTimeframe(parts);
+  std::vector<iovec> iov;
+  iov.reserve(parts.Size());
+  size_t size = 0;
+  for (size_t i = 0; i < parts.Size(); ++i) {
+    if (parts.At(i)->GetSize()) {
+      iov.push_back(iovec{parts.At(i)->GetData(), parts.At(i)->GetSize()});
+      size += parts.At(i)->GetSize();
+    }
+  }
+  writeFully(fd, iov);
+  return size;
+}
+
+void writeTimeframeIndex(int fd, std::vector<uint64_t> const& offsets)
+{
+  auto position = ::lseek(fd, 0, SEEK_CUR);
+  if (position < 0) {
+    throw std::runtime_error(std::string("Cannot get the position of the timeframe index: ") + strerror(errno));
+  }
+  TimeframeFileIndex index;
+  index.nTimeframes = offsets.size();
+  uint64_t indexOffset = position;
+  std::vector<iovec> iov{
+    {&index, sizeof(index)},
+    {const_cast<uint64_t*>(offsets.data()), offsets.size() * sizeof(uint64_t)},
+    {&indexOffset, sizeof(indexOffset)}};
+  writeFully(fd, iov);
+}
+
+MappedTimeframeFile::MappedTimeframeFile(std::string const& filename)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open " + filename + ": " + strerror(errno));
+  }
+  struct stat st;
+  if (::fstat(fd, &st) < 0) {
+    ::close(fd);
+    throw std::runtime_error("Cannot stat " + filename + ": " + strerror(errno));
+  }
+  mSize = st.st_size;
+  if (mSize) {
+    auto ptr = ::mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Cannot map " + filename + ": " + strerror(errno));
+    }
+    mData = static_cast<char*>(ptr);
+    ::madvise(mData, mSize, MADV_SEQUENTIAL);
+  }
+  ::close(fd); // the mapping stays valid
+  mEnd = mSize;
+  if (!readIndex()) {
+    scanTimeframes();
+  }
+  LOG(INFO) << "Mapped " << filename << " with " << mOffsets.size() << " timeframes"
+            << (mHasIndex ? "" : " (no index)") << "\n";
+}
+
+MappedTimeframeFile::~MappedTimeframeFile()
+{
+  if (mData) {
+    ::munmap(mData, mSize);
+  }
+}
+
+bool MappedTimeframeFile::readIndex()
+{
+  if (mSize < sizeof(TimeframeFileIndex) + sizeof(uint64_t)) {
+    return false;
+  }
+  uint64_t indexOffset;
+  memcpy(&indexOffset, mData + mSize - sizeof(uint64_t), sizeof(uint64_t));
+  if (indexOffset > mSize - sizeof(TimeframeFileIndex) - sizeof(uint64_t)) {
+    return false;
+  }
+  TimeframeFileIndex index;
+  memcpy(&index, mData + indexOffset, sizeof(index));
+  if (memcmp(index.magic, TimeframeFileIndex::sMagic, sizeof(index.magic)) != 0 || index.version != TimeframeFileIndex::sVersion) {
+    return false;
+  }
+  // The offsets fill exactly the space between the header and the last 8
+  // bytes. Checking the number of timeframes against it before using it
+  // avoids any overflow with a corrupted index.
+  size_t offsetsSize = mSize - indexOffset - sizeof(index) - sizeof(uint64_t);
+  if (offsetsSize % sizeof(uint64_t) != 0 || index.nTimeframes != offsetsSize / sizeof(uint64_t)) {
+    return false;
+  }
+  mOffsets.resize(index.nTimeframes);
+  memcpy(mOffsets.data(), mData + indexOffset + sizeof(index), offsetsSize);
+  for (auto offset : mOffsets) {
+    if (offset > indexOffset || indexOffset - offset < sizeof(DataHeader)) {
+      mOffsets.clear();
+      return false;
+    }
+  }
+  mEnd = indexOffset;
+  mHasIndex = true;
+  return true;
+}
+
+void MappedTimeframeFile::scanTimeframes()
+{
+  // Same layout as parsed by the streaming parser: (header, payload) pairs,
+  // the timeframe being closed by the TIMEFRAMEINDEX pair.
+  size_t position = 0;
+  bool newTimeframe = true;
+  DataHeader dh;
+  while (position < mEnd) {
+    if (mData[position] == TimeframeFileIndex::sMagic[0]) {
+      mEnd = position; // an index which does not match the content, ignore it
+      break;
+    }
+    if (position + sizeof(DataHeader) > mEnd) {
+      throw std::runtime_error("Premature end of stream");
+    }
+    memcpy(&dh, mData + position, sizeof(dh));
+    if (dh.headerSize < sizeof(DataHeader) || position + dh.headerSize + dh.payloadSize > mEnd) {
+      throw std::runtime_error("Bad header or truncated file");
+    }
+    if (newTimeframe) {
+      mOffsets.push_back(position);
+    }
+    position += dh.headerSize + dh.payloadSize;
+    newTimeframe = dh == DataDescription("TIMEFRAMEINDEX");
+  }
+  if (!newTimeframe) {
+    throw std::runtime_error("Unexpected end of file");
+  }
+}
+
+void MappedTimeframeFile::streamTimeframe(size_t i,
+                                          std::function<void(FairMQParts& parts, char* buffer, size_t size)> onAddPart,
+                                          std::function<void(FairMQParts& parts)> onSend) const
+{
+  if (i >= mOffsets.size()) {
+    throw std::runtime_error("No timeframe " + std::to_string(i) + " in file");
+  }
+  FairMQParts parts;
+  size_t position = mOffsets[i];
+  DataHeader dh;
+  do {
+    if (position + sizeof(DataHeader) > mEnd) {
+      throw std::runtime_error("Unexpected end of file");
+    }
+    memcpy(&dh, mData + position, sizeof(dh));
+    if (dh.headerSize < sizeof(DataHeader) || position + dh.headerSize + dh.payloadSize > mEnd) {
+      throw std::runtime_error("Bad header or truncated file");
+    }
+    onAddPart(parts, mData + position, dh.headerSize);
+    position += dh.headerSize;
+    onAddPart(parts, mData + position, dh.payloadSize);
+    position += dh.payloadSize;
+  } while (!(dh == DataDescription("TIMEFRAMEINDEX")));
+  onSend(parts);
+}
+
 } // namespace data_flow
 } // namespace o2
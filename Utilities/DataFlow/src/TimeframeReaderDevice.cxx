@@ -16,6 +16,8 @@
 #include "Headers/DataHeader.h"
 #include <options/FairMQProgOptions.h>
 
+#include <memory>
+
 using DataHeader = o2::header::DataHeader;
 
 namespace o2
@@ -32,6 +34,8 @@ void TimeframeReaderDevice::InitTask()
 {
   mOutChannelName = GetConfig()->GetValue<std::string>(OptionKeyOutputChannelName);
   mInFileName = GetConfig()->GetValue<std::string>(OptionKeyInputFileName);
+  mMemoryMapped = GetConfig()->GetValue<bool>(OptionKeyMemoryMapped);
+  mFirstTimeframe = GetConfig()->GetValue<size_t>(OptionKeyFirstTimeframe);
   mSeen.clear();
 }
 
@@ -51,11 +55,27 @@ bool TimeframeReaderDevice::ConditionalRun()
   std::vector<std::string> files;
   files.push_back(mInFileName);
   for (auto&& fn : files) {
-    mFile.open(fn, std::ofstream::in | std::ofstream::binary);
     try {
-      streamTimeframe(mFile,
-                      addPartFn,
-                      sendFn);
+      if (mMemoryMapped) {
+        // The messages point into the mapping, which is released together
+        // with the last of them.
+        auto mapping = std::make_shared<MappedTimeframeFile>(fn);
+        auto addMappedPartFn = [this, &mapping](FairMQParts& parts, char* buffer, size_t size) {
+          parts.AddPart(this->NewMessage(
+            buffer,
+            size,
+            [](void* data, void* hint) { delete static_cast<std::shared_ptr<MappedTimeframeFile>*>(hint); },
+            new std::shared_ptr<MappedTimeframeFile>(mapping)));
+        };
+        for (size_t i = mFirstTimeframe; i < mapping->getNTimeframes(); ++i) {
+          mapping->streamTimeframe(i, addMappedPartFn, sendFn);
+        }
+      } else {
+        mFile.open(fn, std::ofstream::in | std::ofstream::binary);
+        streamTimeframe(mFile,
+                        addPartFn,
+                        sendFn);
+      }
     } catch (std::runtime_error& e) {
       LOG(ERROR) << e.what() << "\n";
     }
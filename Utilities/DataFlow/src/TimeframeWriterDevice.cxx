@@ -26,6 +26,11 @@
 #include <options/FairMQProgOptions.h>
 #include <boost/filesystem.hpp>
 
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
 using DataHeader = o2::header::DataHeader;
 using IndexElement = o2::dataformats::IndexElement;
 
@@ -35,7 +40,7 @@ namespace data_flow
 {
 
 TimeframeWriterDevice::TimeframeWriterDevice()
-  : O2Device{}, mInChannelName{}, mFile{}, mMaxTimeframes{}, mMaxFileSize{}, mMaxFiles{}, mFileCount{0}
+  : O2Device{}, mInChannelName{}, mMaxTimeframes{}, mMaxFileSize{}, mMaxFiles{}, mFileCount{0}
 {
 }
 
@@ -65,7 +70,13 @@ void TimeframeWriterDevice::Run()
         filename = base_path + std::to_string(mFileCount) + extension;
       }
       LOG(INFO) << "Opening " << filename << " for output\n";
-      mFile.open(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+      mFile = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (mFile < 0) {
+        LOG(ERROR) << "Cannot open " << filename << ": " << strerror(errno) << "\n";
+        return;
+      }
+      mFileSize = 0;
+      mTimeframeOffsets.clear();
       needsNewFile = false;
     }
 
@@ -73,10 +84,11 @@ void TimeframeWriterDevice::Run()
     if (Receive(timeframeParts, mInChannelName, 0, 100) <= 0)
       continue;
 
-    streamTimeframe(mFile, timeframeParts);
-    if ((mFile.tellp() > mMaxFileSize) || (streamedTimeframes++ > mMaxTimeframes)) {
-      mFile.flush();
-      mFile.close();
+    auto offset = mFileSize;
+    mFileSize += streamTimeframe(mFile, timeframeParts);
+    mTimeframeOffsets.push_back(offset);
+    if ((mFileSize > mMaxFileSize) || (streamedTimeframes++ > mMaxTimeframes)) {
+      closeFile();
       mFileCount++;
       needsNewFile = true;
     }
@@ -85,10 +97,17 @@ void TimeframeWriterDevice::Run()
 
 void TimeframeWriterDevice::PostRun()
 {
-  if (mFile.is_open()) {
-    mFile.flush();
-    mFile.close();
+  closeFile();
+}
+
+void TimeframeWriterDevice::closeFile()
+{
+  if (mFile < 0) {
+    return;
   }
+  writeTimeframeIndex(mFile, mTimeframeOffsets);
+  ::close(mFile);
+  mFile = -1;
 }
 
 } // namespace data_flow
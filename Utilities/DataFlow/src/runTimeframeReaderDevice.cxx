@@ -24,6 +24,14 @@ void addCustomOptions(bpo::options_description& options)
     (o2::data_flow::TimeframeReaderDevice::OptionKeyInputFileName,
      bpo::value<std::string>()->default_value("data.o2tf"),
      "Name of the input file");
+  options.add_options()
+    (o2::data_flow::TimeframeReaderDevice::OptionKeyMemoryMapped,
+     bpo::value<bool>()->default_value(true),
+     "Map the input file in memory and send its content without copies");
+  options.add_options()
+    (o2::data_flow::TimeframeReaderDevice::OptionKeyFirstTimeframe,
+     bpo::value<size_t>()->default_value(0),
+     "First timeframe to send (memory mapped mode only)");
   // clang-format on
 }
 
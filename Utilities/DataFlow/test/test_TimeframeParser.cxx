@@ -13,7 +13,11 @@
 #include "Headers/DataHeader.h"
 #include <FairMQParts.h>
 #include <istream>
+#include <fstream>
+#include <cstddef>
 #include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
 
 struct OneShotReadBuf : public std::streambuf {
   OneShotReadBuf(char* s, std::size_t n)
@@ -56,4 +60,80 @@ int main(int argc, char** argv)
     LOG(ERROR) << e.what() << std::endl;
     exit(1);
   }
+
+  // Write the timeframe twice to a file, with and without index, and read it
+  // back memory mapped.
+  for (bool withIndex : {true, false}) {
+    const char* filename = "test_TimeframeParser.o2tf";
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || write(fd, testBuffer.get(), testBufferSize) != (ssize_t)testBufferSize || write(fd, testBuffer.get(), testBufferSize) != (ssize_t)testBufferSize) {
+      LOG(ERROR) << "Cannot write " << filename << std::endl;
+      exit(1);
+    }
+    if (withIndex) {
+      o2::data_flow::writeTimeframeIndex(fd, {0, testBufferSize});
+    }
+    close(fd);
+
+    size_t nParts = 0, nSent = 0, partsSize = 0;
+    auto countParts = [&nParts, &partsSize](FairMQParts& p, char* buffer, size_t size) {
+      nParts++;
+      partsSize += size;
+    };
+    auto countSent = [&nSent](FairMQParts& p) { nSent++; };
+    try {
+      // the streaming parser must stop at the index
+      std::ifstream in(filename, std::ios::binary);
+      o2::data_flow::streamTimeframe(in, countParts, countSent);
+      if (nSent != 2 || partsSize != 2 * testBufferSize) {
+        LOG(ERROR) << "Streaming parser found " << nSent << " timeframes of " << partsSize << " bytes" << std::endl;
+        exit(1);
+      }
+      o2::data_flow::MappedTimeframeFile mapping(filename);
+      if (mapping.hasIndex() != withIndex || mapping.getNTimeframes() != 2) {
+        LOG(ERROR) << "Mapped file has " << mapping.getNTimeframes() << " timeframes" << std::endl;
+        exit(1);
+      }
+      size_t nStreamedParts = nParts / 2;
+      nParts = partsSize = nSent = 0;
+      mapping.streamTimeframe(1, countParts, countSent);
+      if (nSent != 1 || nParts != nStreamedParts || partsSize != testBufferSize) {
+        LOG(ERROR) << "Mapped timeframe has " << nParts << " parts of " << partsSize << " bytes" << std::endl;
+        exit(1);
+      }
+    } catch (std::runtime_error& e) {
+      LOG(ERROR) << e.what() << std::endl;
+      exit(1);
+    }
+    unlink(filename);
+  }
+
+  // An index with a corrupted number of timeframes, which would overflow
+  // the computation of its size, is ignored and the file is scanned.
+  {
+    const char* filename = "test_TimeframeParser_corrupted.o2tf";
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || write(fd, testBuffer.get(), testBufferSize) != (ssize_t)testBufferSize) {
+      LOG(ERROR) << "Cannot write " << filename << std::endl;
+      exit(1);
+    }
+    o2::data_flow::writeTimeframeIndex(fd, {0});
+    uint64_t nTimeframes = (uint64_t{1} << 61) - 1;
+    if (pwrite(fd, &nTimeframes, sizeof(nTimeframes), testBufferSize + offsetof(o2::data_flow::TimeframeFileIndex, nTimeframes)) != sizeof(nTimeframes)) {
+      LOG(ERROR) << "Cannot write " << filename << std::endl;
+      exit(1);
+    }
+    close(fd);
+    try {
+      o2::data_flow::MappedTimeframeFile mapping(filename);
+      if (mapping.hasIndex() || mapping.getNTimeframes() != 1) {
+        LOG(ERROR) << "Corrupted index was used, " << mapping.getNTimeframes() << " timeframes" << std::endl;
+        exit(1);
+      }
+    } catch (std::runtime_error& e) {
+      LOG(ERROR) << e.what() << std::endl;
+      exit(1);
+    }
+    unlink(filename);
+  }
 }
@@ -0,0 +1,86 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   BlockCoder.h
+/// @brief  rANS entropy coding of integer arrays into self-contained blocks
+
+#ifndef ALICEO2_RANS_BLOCKCODER_H
+#define ALICEO2_RANS_BLOCKCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace o2
+{
+namespace rans
+{
+
+/// A block holds everything needed to decode one array: the number of
+/// elements, and for every 16 bit plane of the elements (1 for 8 and 16 bit
+/// types, 2 for 32 bit types) the normalized frequency table, built from the
+/// data of the array itself, followed by the rANS stream. The 64 bit rANS
+/// coder runs NStreams interleaved states over the elements, which breaks
+/// the dependency chain of a single state.
+///
+/// Layout: BlockHeader, then per plane a PlaneHeader, the frequency table
+/// padded to 4 bytes and the 32 bit words of the stream. The buffers are
+/// accessed with memcpy and do not need to be aligned.
+struct BlockHeader {
+  uint64_t blockSize = 0; // bytes, including this header
+  uint64_t nElements = 0;
+  uint8_t elementSize = 0;
+  uint8_t nPlanes = 0;
+  uint8_t nStreams = 0;
+  uint8_t version = 1;
+  uint32_t reserved = 0;
+};
+
+struct PlaneHeader {
+  uint32_t nWords = 0;       // 32 bit words of the stream, 0 for a single symbol plane
+  uint32_t tableSize = 0;    // bytes of the frequency table, before padding
+  uint32_t alphabetSize = 0; // symbols in [min, min + alphabetSize)
+  uint16_t min = 0;
+  uint8_t probBits = 0; // frequencies are normalized to 1 << probBits
+  uint8_t reserved = 0;
+};
+
+constexpr int NStreams = 4;
+
+/// append the block encoding n elements of elementSize (1, 2 or 4) bytes to the output
+void encode(const void* data, size_t n, size_t elementSize, std::vector<char>& output);
+
+/// decode the block at the beginning of the buffer into n elements of elementSize bytes,
+/// return the size of the block. Throws std::runtime_error on malformed or truncated data,
+/// or if the block does not match n and elementSize.
+size_t decode(const char* buffer, size_t size, void* data, size_t n, size_t elementSize);
+
+/// header of the block at the beginning of the buffer, throws if the buffer is too small
+BlockHeader getHeader(const char* buffer, size_t size);
+
+template <typename T>
+void encode(const T* data, size_t n, std::vector<char>& output)
+{
+  static_assert(std::is_integral<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4), "only 8, 16 and 32 bit integers are supported");
+  encode(static_cast<const void*>(data), n, sizeof(T), output);
+}
+
+template <typename T>
+size_t decode(const char* buffer, size_t size, T* data, size_t n)
+{
+  static_assert(std::is_integral<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4), "only 8, 16 and 32 bit integers are supported");
+  return decode(buffer, size, static_cast<void*>(data), n, sizeof(T));
+}
+
+} // namespace rans
+} // namespace o2
+
+#endif // ALICEO2_RANS_BLOCKCODER_H
@@ -0,0 +1,488 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   BlockCoder.cxx
+/// @brief  rANS entropy coding of integer arrays into self-contained blocks
+
+#include "rANS/BlockCoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace o2
+{
+namespace rans
+{
+
+namespace
+{
+// 64 bit rANS state with 32 bit renormalization, following the public domain
+// rans64 coder of F. Giesen: the state is kept in [L, L << 32)
+constexpr uint64_t RansL = 1ull << 31;
+constexpr uint32_t MinProbBits = 12;
+constexpr uint32_t MaxProbBits = 20;
+
+struct EncSymbol {
+  uint64_t xMax;    // renormalize above this state
+  uint64_t rcpFreq; // fixed point reciprocal of the frequency
+  uint32_t bias;
+  uint32_t cmplFreq; // (1 << probBits) - freq
+  uint32_t rcpShift;
+};
+
+struct DecSymbol {
+  uint32_t start;
+  uint32_t freq;
+};
+
+inline uint64_t mulHi(uint64_t a, uint64_t b)
+{
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+}
+
+EncSymbol makeEncSymbol(uint32_t start, uint32_t freq, uint32_t probBits)
+{
+  // the encoding x' = (x / freq) << probBits + x % freq + start is done as
+  // x' = x + bias + q * cmplFreq, with the quotient q obtained by a multiplication
+  EncSymbol s;
+  s.xMax = ((RansL >> probBits) << 32) * freq;
+  s.cmplFreq = (1u << probBits) - freq;
+  if (freq < 2) {
+    // the reciprocal of 1 cannot be represented: q = x - 1 and the bias compensates
+    s.rcpFreq = ~0ull;
+    s.rcpShift = 0;
+    s.bias = start + (1u << probBits) - 1;
+  } else {
+    uint32_t shift = 0;
+    while (freq > (1u << shift)) {
+      shift++;
+    }
+    // ((1 << (shift + 63)) + freq - 1) / freq, split in two 64 bit divisions
+    uint64_t x0 = freq - 1;
+    uint64_t x1 = 1ull << (shift + 31);
+    uint64_t t1 = x1 / freq;
+    x0 += (x1 % freq) << 32;
+    uint64_t t0 = x0 / freq;
+    s.rcpFreq = t0 + (t1 << 32);
+    s.rcpShift = shift - 1;
+    s.bias = start;
+  }
+  return s;
+}
+
+inline void encPut(uint64_t& x, uint32_t*& ptr, const EncSymbol& s)
+{
+  if (x >= s.xMax) {
+    *--ptr = static_cast<uint32_t>(x);
+    x >>= 32;
+  }
+  uint64_t q = mulHi(x, s.rcpFreq) >> s.rcpShift;
+  x += s.bias + q * s.cmplFreq;
+}
+
+inline void append(std::vector<char>& output, const void* data, size_t size)
+{
+  auto pos = output.size();
+  output.resize(pos + size);
+  std::memcpy(output.data() + pos, data, size);
+}
+
+inline size_t padded(size_t size)
+{
+  return (size + 3) & ~size_t(3);
+}
+
+void writeVarInt(std::vector<char>& output, uint32_t v)
+{
+  while (v >= 0x80) {
+    output.push_back(static_cast<char>((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+  output.push_back(static_cast<char>(v));
+}
+
+uint32_t readVarInt(const char*& ptr, const char* end)
+{
+  uint32_t v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (ptr >= end) {
+      throw std::runtime_error("rANS: truncated frequency table");
+    }
+    auto byte = static_cast<uint8_t>(*ptr++);
+    v |= uint32_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return v;
+    }
+  }
+  throw std::runtime_error("rANS: malformed frequency table");
+}
+
+uint32_t getProbBits(size_t nDistinct)
+{
+  uint32_t bits = 0;
+  while ((size_t(1) << bits) < nDistinct) {
+    bits++;
+  }
+  return std::clamp(bits + 3, MinProbBits, MaxProbBits);
+}
+
+/// scale the counts such that they add up to 1 << probBits, keeping every present symbol
+std::vector<uint32_t> normalize(const std::vector<uint32_t>& counts, size_t total, uint32_t probBits)
+{
+  const uint64_t norm = 1ull << probBits;
+  std::vector<uint32_t> freqs(counts.size(), 0);
+  uint64_t sum = 0;
+  size_t imax = 0;
+  for (size_t i = 0; i < counts.size(); i++) {
+    if (counts[i]) {
+      freqs[i] = std::max<uint64_t>(1, counts[i] * norm / total);
+      sum += freqs[i];
+      if (counts[i] > counts[imax]) {
+        imax = i;
+      }
+    }
+  }
+  if (sum < norm) {
+    freqs[imax] += norm - sum;
+  } else if (sum > norm) {
+    // symbols raised to 1 made the sum too large, take the excess from the most frequent ones
+    std::vector<uint32_t> order;
+    for (size_t i = 0; i < freqs.size(); i++) {
+      if (freqs[i] > 1) {
+        order.push_back(i);
+      }
+    }
+    std::sort(order.begin(), order.end(), [&freqs](uint32_t a, uint32_t b) { return freqs[a] > freqs[b]; });
+    auto excess = sum - norm;
+    while (excess) {
+      for (auto i : order) {
+        auto take = std::min<uint64_t>(excess, freqs[i] / 2);
+        freqs[i] -= take;
+        excess -= take;
+        if (!excess) {
+          break;
+        }
+      }
+    }
+  }
+  return freqs;
+}
+
+template <typename U>
+inline uint32_t symbolAt(const U* data, size_t i, int shift)
+{
+  return (uint32_t(data[i]) >> shift) & 0xffff;
+}
+
+/// histogram of the symbols of the plane, counts[0] being the one of min
+template <typename U>
+std::vector<uint32_t> count(const U* data, size_t n, int shift, uint32_t& min)
+{
+  // successive increments of the same bin depend on each other, several
+  // histograms filled in turn let them overlap
+  constexpr int NHist = 4;
+  uint32_t max = 0;
+  min = 0;
+  if (sizeof(U) == 1) {
+    max = 0xff; // small enough to count directly
+  } else {
+    min = 0xffff;
+    for (size_t i = 0; i < n; i++) {
+      auto s = symbolAt(data, i, shift);
+      min = std::min(min, s);
+      max = std::max(max, s);
+    }
+  }
+  const size_t range = max - min + 1;
+  std::vector<uint32_t> hist(NHist * range, 0);
+  size_t i = 0;
+  for (; i + NHist <= n; i += NHist) {
+    for (int k = 0; k < NHist; k++) {
+      hist[k * range + symbolAt(data, i + k, shift) - min]++;
+    }
+  }
+  for (; i < n; i++) {
+    hist[symbolAt(data, i, shift) - min]++;
+  }
+  for (int k = 1; k < NHist; k++) {
+    for (size_t j = 0; j < range; j++) {
+      hist[j] += hist[k * range + j];
+    }
+  }
+  hist.resize(range);
+  if (sizeof(U) == 1) { // trim to the symbols present
+    auto first = std::find_if(hist.begin(), hist.end(), [](uint32_t c) { return c != 0; });
+    auto last = std::find_if(hist.rbegin(), hist.rend(), [](uint32_t c) { return c != 0; }).base();
+    min = first - hist.begin();
+    hist = std::vector<uint32_t>(first, last);
+  }
+  return hist;
+}
+
+template <typename U>
+void encodePlane(const U* data, size_t n, int shift, std::vector<char>& output)
+{
+  uint32_t min = 0;
+  auto counts = count(data, n, shift, min);
+  PlaneHeader plane;
+  plane.min = min;
+  plane.alphabetSize = counts.size();
+  auto headerPos = output.size();
+  append(output, &plane, sizeof(PlaneHeader));
+  if (plane.alphabetSize == 1) { // nothing to encode, the decoder fills the value
+    return;
+  }
+
+  auto nDistinct = plane.alphabetSize - std::count(counts.begin(), counts.end(), 0);
+  plane.probBits = getProbBits(nDistinct);
+  auto freqs = normalize(counts, n, plane.probBits);
+
+  // frequency table, runs of absent symbols are stored as 0 followed by the run length
+  auto tablePos = output.size();
+  for (uint32_t i = 0; i < plane.alphabetSize; i++) {
+    writeVarInt(output, freqs[i]);
+    if (!freqs[i]) {
+      uint32_t run = 1;
+      while (i + run < plane.alphabetSize && !freqs[i + run]) {
+        run++;
+      }
+      writeVarInt(output, run);
+      i += run - 1;
+    }
+  }
+  plane.tableSize = output.size() - tablePos;
+  output.resize(tablePos + padded(plane.tableSize), 0);
+
+  std::vector<EncSymbol> symbols(plane.alphabetSize);
+  uint32_t start = 0;
+  for (uint32_t i = 0; i < plane.alphabetSize; i++) {
+    if (freqs[i]) {
+      symbols[i] = makeEncSymbol(start, freqs[i], plane.probBits);
+      start += freqs[i];
+    }
+  }
+
+  // the stream is written backwards, every symbol emits at most one word
+  const size_t maxWords = n + 2 * NStreams;
+  std::unique_ptr<uint32_t[]> words(new uint32_t[maxWords]);
+  uint32_t* end = words.get() + maxWords;
+  uint32_t* ptr = end;
+  uint64_t x[NStreams];
+  std::fill(x, x + NStreams, RansL);
+  size_t i = n;
+  while (i % NStreams) { // the elements after the last complete group
+    --i;
+    encPut(x[i % NStreams], ptr, symbols[symbolAt(data, i, shift) - min]);
+  }
+  while (i) {
+    i -= NStreams;
+    for (int k = NStreams; k--;) {
+      encPut(x[k], ptr, symbols[symbolAt(data, i + k, shift) - min]);
+    }
+  }
+  for (int k = NStreams; k--;) {
+    ptr -= 2;
+    ptr[0] = static_cast<uint32_t>(x[k]);
+    ptr[1] = static_cast<uint32_t>(x[k] >> 32);
+  }
+  plane.nWords = end - ptr;
+  append(output, ptr, plane.nWords * sizeof(uint32_t));
+  std::memcpy(output.data() + headerPos, &plane, sizeof(PlaneHeader));
+}
+
+template <typename U, bool Merge>
+const char* decodePlane(const char* ptr, const char* end, U* data, size_t n, int shift)
+{
+  PlaneHeader plane;
+  if (size_t(end - ptr) < sizeof(PlaneHeader)) {
+    throw std::runtime_error("rANS: truncated block");
+  }
+  std::memcpy(&plane, ptr, sizeof(PlaneHeader));
+  ptr += sizeof(PlaneHeader);
+  if (plane.alphabetSize == 0 || uint32_t(plane.min) + plane.alphabetSize > (sizeof(U) == 1 ? 0x100u : 0x10000u)) {
+    throw std::runtime_error("rANS: invalid alphabet");
+  }
+  auto store = [data, shift](size_t i, uint32_t value) {
+    if (Merge) {
+      data[i] |= U(value) << shift;
+    } else {
+      data[i] = U(value) << shift;
+    }
+  };
+  if (plane.alphabetSize == 1) {
+    if (plane.nWords || plane.tableSize) {
+      throw std::runtime_error("rANS: invalid single symbol plane");
+    }
+    for (size_t i = 0; i < n; i++) {
+      store(i, plane.min);
+    }
+    return ptr;
+  }
+  if (plane.probBits < MinProbBits || plane.probBits > MaxProbBits || size_t(end - ptr) < padded(plane.tableSize)) {
+    throw std::runtime_error("rANS: invalid frequency table");
+  }
+
+  // frequency table
+  const uint32_t norm = 1u << plane.probBits, mask = norm - 1;
+  std::vector<DecSymbol> symbols(plane.alphabetSize, DecSymbol{0, 0});
+  std::vector<uint16_t> slots(norm);
+  const char* tablePtr = ptr;
+  const char* tableEnd = ptr + plane.tableSize;
+  uint32_t start = 0;
+  for (uint32_t i = 0; i < plane.alphabetSize; i++) {
+    auto freq = readVarInt(tablePtr, tableEnd);
+    if (!freq) {
+      auto run = readVarInt(tablePtr, tableEnd);
+      if (!run || run > plane.alphabetSize - i) {
+        throw std::runtime_error("rANS: malformed frequency table");
+      }
+      i += run - 1;
+      continue;
+    }
+    if (freq > norm - start) {
+      throw std::runtime_error("rANS: frequencies exceed the normalization");
+    }
+    symbols[i] = DecSymbol{start, freq};
+    std::fill(slots.begin() + start, slots.begin() + start + freq, i);
+    start += freq;
+  }
+  if (start != norm || tablePtr != tableEnd) {
+    throw std::runtime_error("rANS: frequencies do not match the normalization");
+  }
+  ptr += padded(plane.tableSize);
+
+  // stream
+  if (plane.nWords < 2 * NStreams || size_t(end - ptr) / sizeof(uint32_t) < plane.nWords) {
+    throw std::runtime_error("rANS: truncated stream");
+  }
+  const char* wordsEnd = ptr + plane.nWords * sizeof(uint32_t);
+  auto readWord = [&ptr, wordsEnd]() {
+    if (ptr >= wordsEnd) {
+      throw std::runtime_error("rANS: corrupted stream");
+    }
+    uint32_t w;
+    std::memcpy(&w, ptr, sizeof(uint32_t));
+    ptr += sizeof(uint32_t);
+    return w;
+  };
+  uint64_t x[NStreams];
+  for (int k = 0; k < NStreams; k++) {
+    x[k] = readWord();
+    x[k] |= uint64_t(readWord()) << 32;
+  }
+  const uint16_t min = plane.min;
+  const uint32_t probBits = plane.probBits;
+  auto get = [&](uint64_t& state, size_t i) {
+    auto sym = slots[state & mask];
+    const auto& s = symbols[sym];
+    store(i, sym + min);
+    state = s.freq * (state >> probBits) + (state & mask) - s.start;
+    if (state < RansL) {
+      state = (state << 32) | readWord();
+    }
+  };
+  size_t i = 0;
+  for (; i + NStreams <= n; i += NStreams) {
+    for (int k = 0; k < NStreams; k++) {
+      get(x[k], i + k);
+    }
+  }
+  for (; i < n; i++) {
+    get(x[i % NStreams], i);
+  }
+  // a consistent stream brings all states back to where the encoder started
+  if (ptr != wordsEnd || std::any_of(x, x + NStreams, [](uint64_t v) { return v != RansL; })) {
+    throw std::runtime_error("rANS: corrupted stream");
+  }
+  return ptr;
+}
+
+int getNPlanes(size_t n, size_t elementSize)
+{
+  if (elementSize != 1 && elementSize != 2 && elementSize != 4) {
+    throw std::invalid_argument("rANS: unsupported element size " + std::to_string(elementSize));
+  }
+  return n ? (elementSize == 4 ? 2 : 1) : 0;
+}
+
+} // namespace
+
+void encode(const void* data, size_t n, size_t elementSize, std::vector<char>& output)
+{
+  BlockHeader header;
+  header.nElements = n;
+  header.elementSize = elementSize;
+  header.nPlanes = getNPlanes(n, elementSize);
+  header.nStreams = NStreams;
+  auto headerPos = output.size();
+  append(output, &header, sizeof(BlockHeader));
+  if (elementSize == 1) {
+    if (n) {
+      encodePlane(static_cast<const uint8_t*>(data), n, 0, output);
+    }
+  } else if (elementSize == 2) {
+    if (n) {
+      encodePlane(static_cast<const uint16_t*>(data), n, 0, output);
+    }
+  } else {
+    for (int ip = 0; ip < header.nPlanes; ip++) {
+      encodePlane(static_cast<const uint32_t*>(data), n, 16 * ip, output);
+    }
+  }
+  header.blockSize = output.size() - headerPos;
+  std::memcpy(output.data() + headerPos, &header, sizeof(BlockHeader));
+}
+
+BlockHeader getHeader(const char* buffer, size_t size)
+{
+  BlockHeader header;
+  if (size < sizeof(BlockHeader)) {
+    throw std::runtime_error("rANS: truncated block header");
+  }
+  std::memcpy(&header, buffer, sizeof(BlockHeader));
+  if (header.version != 1 || header.nStreams != NStreams) {
+    throw std::runtime_error("rANS: unsupported block version " + std::to_string(header.version));
+  }
+  if (header.blockSize < sizeof(BlockHeader) || header.blockSize > size) {
+    throw std::runtime_error("rANS: block size " + std::to_string(header.blockSize) + " exceeds buffer size " + std::to_string(size));
+  }
+  return header;
+}
+
+size_t decode(const char* buffer, size_t size, void* data, size_t n, size_t elementSize)
+{
+  auto header = getHeader(buffer, size);
+  if (header.nElements != n || header.elementSize != elementSize || header.nPlanes != getNPlanes(n, elementSize)) {
+    throw std::runtime_error("rANS: block of " + std::to_string(header.nElements) + " elements of size " + std::to_string(int(header.elementSize)) +
+                             " does not match the expected " + std::to_string(n) + " of size " + std::to_string(elementSize));
+  }
+  const char* ptr = buffer + sizeof(BlockHeader);
+  const char* end = buffer + header.blockSize;
+  if (n) {
+    if (elementSize == 1) {
+      ptr = decodePlane<uint8_t, false>(ptr, end, static_cast<uint8_t*>(data), n, 0);
+    } else if (elementSize == 2) {
+      ptr = decodePlane<uint16_t, false>(ptr, end, static_cast<uint16_t*>(data), n, 0);
+    } else {
+      ptr = decodePlane<uint32_t, false>(ptr, end, static_cast<uint32_t*>(data), n, 0);
+      ptr = decodePlane<uint32_t, true>(ptr, end, static_cast<uint32_t*>(data), n, 16);
+    }
+  }
+  if (ptr != end) {
+    throw std::runtime_error("rANS: inconsistent block size");
+  }
+  return header.blockSize;
+}
+
+} // namespace rans
+} // namespace o2
@@ -0,0 +1,76 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_BlockCoder.cxx
+/// @brief  Throughput of the rANS block coder
+
+#include "benchmark/benchmark.h"
+#include "rANS/BlockCoder.h"
+#include <random>
+#include <vector>
+
+// geometrically distributed values, the benchmarks give the probability parameter in percent
+template <typename T>
+std::vector<T> generateData(size_t n, double p)
+{
+  std::mt19937 rng(12345);
+  std::geometric_distribution<uint32_t> geo(p);
+  std::vector<T> data(n);
+  for (auto& v : data) {
+    v = static_cast<T>(geo(rng));
+  }
+  return data;
+}
+
+template <typename T>
+static void BM_Encode(benchmark::State& state)
+{
+  auto data = generateData<T>(state.range(0), state.range(1) / 100.);
+  std::vector<char> buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    o2::rans::encode(data.data(), data.size(), buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size() * sizeof(T));
+  state.counters["ratio"] = double(data.size() * sizeof(T)) / buffer.size();
+}
+
+template <typename T>
+static void BM_Decode(benchmark::State& state)
+{
+  auto data = generateData<T>(state.range(0), state.range(1) / 100.);
+  std::vector<char> buffer;
+  o2::rans::encode(data.data(), data.size(), buffer);
+  std::vector<T> decoded(data.size());
+  for (auto _ : state) {
+    o2::rans::decode(buffer.data(), buffer.size(), decoded.data(), decoded.size());
+    benchmark::DoNotOptimize(decoded.data());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size() * sizeof(T));
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int n : {10000, 1000000}) {
+    for (int p : {50, 5, 1}) {
+      bench->Args({n, p});
+    }
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Encode, uint8_t)->Apply(CustomArguments);
+BENCHMARK_TEMPLATE(BM_Encode, uint16_t)->Apply(CustomArguments);
+BENCHMARK_TEMPLATE(BM_Encode, uint32_t)->Apply(CustomArguments);
+BENCHMARK_TEMPLATE(BM_Decode, uint8_t)->Apply(CustomArguments);
+BENCHMARK_TEMPLATE(BM_Decode, uint16_t)->Apply(CustomArguments);
+BENCHMARK_TEMPLATE(BM_Decode, uint32_t)->Apply(CustomArguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   test_BlockCoder.cxx
+/// @brief  Round trip tests of the rANS block coder
+
+#define BOOST_TEST_MODULE Test rANS BlockCoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "rANS/BlockCoder.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace o2::rans;
+
+template <typename T, typename Generator>
+std::vector<T> generate(size_t n, Generator gen)
+{
+  std::mt19937 rng(n);
+  std::vector<T> data(n);
+  for (auto& v : data) {
+    v = static_cast<T>(gen(rng));
+  }
+  return data;
+}
+
+template <typename T>
+size_t roundTrip(const std::vector<T>& data)
+{
+  std::vector<char> buffer{'x'}; // blocks are appended
+  encode(data.data(), data.size(), buffer);
+  std::vector<T> decoded(data.size(), T(0x55));
+  auto size = decode(buffer.data() + 1, buffer.size() - 1, decoded.data(), decoded.size());
+  BOOST_CHECK(size == buffer.size() - 1);
+  BOOST_CHECK(decoded == data);
+  return size;
+}
+
+BOOST_AUTO_TEST_CASE(BlockCoder_RoundTrip)
+{
+  // sizes around the number of interleaved streams and a few larger ones
+  for (size_t n : {0, 1, 2, 3, 4, 5, 7, 8, 9, 1000, 100003}) {
+    roundTrip(generate<uint8_t>(n, [](auto& rng) { return rng() % 7; }));
+    roundTrip(generate<int8_t>(n, [](auto&) { return -5; }));
+    roundTrip(generate<uint16_t>(n, [](auto& rng) { return rng(); }));
+    roundTrip(generate<int16_t>(n, [](auto& rng) { return int(rng() % 200) - 100; }));
+    roundTrip(generate<uint32_t>(n, [](auto& rng) { return rng(); }));
+    roundTrip(generate<int32_t>(n, [](auto& rng) { return -int(rng() % 1000); }));
+  }
+  // a dominant value with many rare ones stresses the normalization of the frequencies
+  roundTrip(generate<uint16_t>(70000, [](auto& rng) { return rng() % 20 ? 3 : rng(); }));
+}
+
+BOOST_AUTO_TEST_CASE(BlockCoder_Compression)
+{
+  std::geometric_distribution<int> geo(0.3);
+  auto data = generate<uint32_t>(1000000, [&geo](auto& rng) { return geo(rng); });
+  auto size = roundTrip(data);
+  // the entropy of this distribution is ~2.9 bits
+  BOOST_CHECK(size < data.size() * 3.1 / 8);
+  // a constant array costs only the headers
+  BOOST_CHECK(roundTrip(std::vector<uint32_t>(1000000, 12345678)) < 100);
+}
+
+BOOST_AUTO_TEST_CASE(BlockCoder_Errors)
+{
+  auto data = generate<uint16_t>(1000, [](auto& rng) { return rng() % 37; });
+  std::vector<char> buffer;
+  encode(data.data(), data.size(), buffer);
+  std::vector<uint16_t> decoded(data.size());
+  BOOST_CHECK_THROW(decode(buffer.data(), buffer.size() - 1, decoded.data(), decoded.size()), std::runtime_error);
+  BOOST_CHECK_THROW(decode(buffer.data(), buffer.size(), decoded.data(), decoded.size() - 1), std::runtime_error);
+  std::vector<uint32_t> wrongType(data.size());
+  BOOST_CHECK_THROW(decode(buffer.data(), buffer.size(), wrongType.data(), wrongType.size()), std::runtime_error);
+  // corrupted frequency table
+  auto corrupted = buffer;
+  corrupted[sizeof(BlockHeader) + sizeof(PlaneHeader)] ^= 0x5a;
+  BOOST_CHECK_THROW(decode(corrupted.data(), corrupted.size(), decoded.data(), decoded.size()), std::runtime_error);
+}